@@ -14,11 +14,115 @@
 #include "lib/ftl/files/unique_fd.h"
 #include "flutter/glue/trace_event.h"
 #include "lib/zip/unique_unzipper.h"
+#include "third_party/zlib/zlib.h"
 
 namespace blink {
+namespace {
+
+// See section 4.3 of the ZIP File Format Specification (APPNOTE.TXT). All
+// numbers are little endian.
+constexpr uint32_t kEndOfCentralDirectorySignature = 0x06054b50;
+constexpr size_t kEndOfCentralDirectorySize = 22;
+constexpr size_t kMaxArchiveCommentSize = 0xFFFF;
+constexpr uint32_t kCentralDirectoryHeaderSignature = 0x02014b50;
+constexpr size_t kCentralDirectoryHeaderSize = 46;
+constexpr uint32_t kLocalFileHeaderSignature = 0x04034b50;
+constexpr size_t kLocalFileHeaderSize = 30;
+constexpr uint16_t kEncryptedFlag = 1 << 0;
+constexpr uint16_t kMethodStored = 0;
+constexpr uint16_t kMethodDeflated = 8;
+// Sizes and offsets saturate at this value in ZIP64 archives.
+constexpr uint32_t kZip64Marker = 0xFFFFFFFF;
+
+uint16_t ReadUInt16(const uint8_t* data) {
+  return data[0] | (data[1] << 8);
+}
+
+uint32_t ReadUInt32(const uint8_t* data) {
+  return data[0] | (data[1] << 8) | (data[2] << 16) |
+         (static_cast<uint32_t>(data[3]) << 24);
+}
+
+// A range of a mapping that keeps the whole mapping alive.
+class MappingSlice : public fml::Mapping {
+ public:
+  MappingSlice(std::shared_ptr<fml::Mapping> mapping,
+               size_t offset,
+               size_t size)
+      : mapping_(std::move(mapping)), offset_(offset), size_(size) {}
+
+  ~MappingSlice() override = default;
+
+  size_t GetSize() const override { return size_; }
+
+  const uint8_t* GetMapping() const override {
+    return mapping_->GetMapping() + offset_;
+  }
+
+ private:
+  std::shared_ptr<fml::Mapping> mapping_;
+  size_t offset_;
+  size_t size_;
+
+  FTL_DISALLOW_COPY_AND_ASSIGN(MappingSlice);
+};
+
+class VectorMapping : public fml::Mapping {
+ public:
+  explicit VectorMapping(std::shared_ptr<const std::vector<uint8_t>> data)
+      : data_(std::move(data)) {}
+
+  ~VectorMapping() override = default;
+
+  size_t GetSize() const override { return data_->size(); }
+
+  const uint8_t* GetMapping() const override { return data_->data(); }
+
+ private:
+  std::shared_ptr<const std::vector<uint8_t>> data_;
+
+  FTL_DISALLOW_COPY_AND_ASSIGN(VectorMapping);
+};
+
+bool Inflate(const uint8_t* compressed,
+             size_t compressed_size,
+             std::vector<uint8_t>* data) {
+  z_stream stream = {};
+  stream.next_in = const_cast<Bytef*>(compressed);
+  stream.avail_in = compressed_size;
+  stream.next_out = data->data();
+  stream.avail_out = data->size();
+
+  // Entries hold raw deflate streams without a zlib header.
+  if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+    return false;
+  }
+  int result = inflate(&stream, Z_FINISH);
+  inflateEnd(&stream);
+
+  return result == Z_STREAM_END && stream.total_out == data->size();
+}
+
+}  // namespace
+
+constexpr size_t ZipAssetStore::kDefaultDecompressedCacheBytes;
 
 ZipAssetStore::ZipAssetStore(UnzipperProvider unzipper_provider)
-    : unzipper_provider_(std::move(unzipper_provider)) {
+    : ZipAssetStore(std::move(unzipper_provider), nullptr) {}
+
+ZipAssetStore::ZipAssetStore(UnzipperProvider unzipper_provider,
+                             std::unique_ptr<fml::Mapping> archive_mapping,
+                             size_t decompressed_cache_bytes)
+    : unzipper_provider_(std::move(unzipper_provider)),
+      archive_mapping_(std::move(archive_mapping)),
+      decompressed_cache_max_bytes_(decompressed_cache_bytes),
+      decompressed_cache_bytes_(0) {
+  if (archive_mapping_ && BuildStatCacheFromMapping()) {
+    return;
+  }
+
+  archive_mapping_ = nullptr;
+  stat_cache_.clear();
   BuildStatCache();
 }
 
@@ -33,6 +137,104 @@ bool ZipAssetStore::GetAsBuffer(const std::string& asset_name,
     return false;
   }
 
+  if (!archive_mapping_) {
+    return ReadWithUnzipper(found->second, data);
+  }
+
+  auto mapping = GetAsMapping(asset_name);
+  if (!mapping) {
+    return false;
+  }
+  data->assign(mapping->GetMapping(),
+               mapping->GetMapping() + mapping->GetSize());
+  return true;
+}
+
+std::unique_ptr<fml::Mapping> ZipAssetStore::GetAsMapping(
+    const std::string& asset_name) {
+  TRACE_EVENT0("flutter", "ZipAssetStore::GetAsMapping");
+  auto found = stat_cache_.find(asset_name);
+
+  if (found == stat_cache_.end()) {
+    return nullptr;
+  }
+
+  const CacheEntry& entry = found->second;
+
+  if (!archive_mapping_) {
+    auto data = std::make_shared<std::vector<uint8_t>>();
+    if (!ReadWithUnzipper(entry, data.get())) {
+      return nullptr;
+    }
+    return std::make_unique<VectorMapping>(std::move(data));
+  }
+
+  if (!entry.deflated) {
+    return std::make_unique<MappingSlice>(archive_mapping_, entry.data_offset,
+                                          entry.uncompressed_size);
+  }
+
+  DecompressedAsset data = GetDecompressed(asset_name, entry);
+  if (!data) {
+    return nullptr;
+  }
+  return std::make_unique<VectorMapping>(std::move(data));
+}
+
+size_t ZipAssetStore::decompressed_cache_bytes() const {
+  ftl::MutexLocker lock(&decompressed_cache_mutex_);
+  return decompressed_cache_bytes_;
+}
+
+ZipAssetStore::DecompressedAsset ZipAssetStore::GetDecompressed(
+    const std::string& asset_name,
+    const CacheEntry& entry) {
+  {
+    ftl::MutexLocker lock(&decompressed_cache_mutex_);
+    auto found = decompressed_cache_index_.find(asset_name);
+    if (found != decompressed_cache_index_.end()) {
+      decompressed_cache_.splice(decompressed_cache_.begin(),
+                                 decompressed_cache_, found->second);
+      return found->second->second;
+    }
+  }
+
+  // Decompress without holding the lock so that other assets may be served
+  // in the meantime. Should two threads race for the same asset, both
+  // decompress it and the first one to finish caches it.
+  TRACE_EVENT0("flutter", "ZipAssetStore::Decompress");
+  auto data = std::make_shared<std::vector<uint8_t>>(entry.uncompressed_size);
+  if (!Inflate(archive_mapping_->GetMapping() + entry.data_offset,
+               entry.compressed_size, data.get())) {
+    FTL_LOG(WARNING) << "Could not decompress asset: " << asset_name;
+    return nullptr;
+  }
+
+  if (data->size() > decompressed_cache_max_bytes_) {
+    return data;
+  }
+
+  ftl::MutexLocker lock(&decompressed_cache_mutex_);
+  if (decompressed_cache_index_.count(asset_name) != 0) {
+    return data;
+  }
+
+  decompressed_cache_.emplace_front(asset_name, data);
+  decompressed_cache_index_[asset_name] = decompressed_cache_.begin();
+  decompressed_cache_bytes_ += data->size();
+
+  while (decompressed_cache_bytes_ > decompressed_cache_max_bytes_) {
+    const auto& evicted = decompressed_cache_.back();
+    decompressed_cache_bytes_ -= evicted.second->size();
+    decompressed_cache_index_.erase(evicted.first);
+    decompressed_cache_.pop_back();
+  }
+
+  return data;
+}
+
+bool ZipAssetStore::ReadWithUnzipper(const CacheEntry& entry,
+                                     std::vector<uint8_t>* data) {
   auto unzipper = unzipper_provider_();
 
   if (!unzipper.is_valid()) {
@@ -41,7 +243,8 @@ bool ZipAssetStore::GetAsBuffer(const std::string& asset_name,
 
   int result = UNZ_OK;
 
-  result = unzGoToFilePos(unzipper.get(), &(found->second.file_pos));
+  unz_file_pos file_pos = entry.file_pos;
+  result = unzGoToFilePos(unzipper.get(), &file_pos);
   if (result != UNZ_OK) {
     FTL_LOG(WARNING) << "unzGetCurrentFileInfo failed, error=" << result;
     return false;
@@ -53,7 +256,7 @@ bool ZipAssetStore::GetAsBuffer(const std::string& asset_name,
     return false;
   }
 
-  data->resize(found->second.uncompressed_size);
+  data->resize(entry.uncompressed_size);
   int total_read = 0;
   while (total_read < static_cast<int>(data->size())) {
     int bytes_read = unzReadCurrentFile(
@@ -67,6 +270,114 @@ bool ZipAssetStore::GetAsBuffer(const std::string& asset_name,
   return true;
 }
 
+bool ZipAssetStore::BuildStatCacheFromMapping() {
+  TRACE_EVENT0("flutter", "ZipAssetStore::BuildStatCacheFromMapping");
+  const uint8_t* archive = archive_mapping_->GetMapping();
+  const size_t archive_size = archive_mapping_->GetSize();
+
+  if (archive == nullptr || archive_size < kEndOfCentralDirectorySize) {
+    return false;
+  }
+
+  // The end of central directory record is followed by a comment of unknown
+  // size. Search backwards for it. The comment may itself contain the
+  // signature, so the record must also account for the rest of the archive.
+  const size_t last_candidate = archive_size - kEndOfCentralDirectorySize;
+  const size_t first_candidate = last_candidate > kMaxArchiveCommentSize
+                                     ? last_candidate - kMaxArchiveCommentSize
+                                     : 0;
+  size_t end_offset = last_candidate + 1;
+  for (size_t offset = last_candidate + 1; offset-- > first_candidate;) {
+    if (ReadUInt32(archive + offset) == kEndOfCentralDirectorySignature &&
+        offset + kEndOfCentralDirectorySize +
+                ReadUInt16(archive + offset + 20) ==
+            archive_size) {
+      end_offset = offset;
+      break;
+    }
+  }
+  if (end_offset > last_candidate) {
+    return false;
+  }
+
+  const uint8_t* end_record = archive + end_offset;
+  const size_t entry_count = ReadUInt16(end_record + 10);
+  const uint32_t directory_size = ReadUInt32(end_record + 12);
+  const uint32_t directory_offset = ReadUInt32(end_record + 16);
+  if (directory_offset == kZip64Marker ||
+      static_cast<size_t>(directory_offset) + directory_size > end_offset) {
+    return false;
+  }
+
+  size_t offset = directory_offset;
+  for (size_t i = 0; i < entry_count; i++) {
+    if (offset + kCentralDirectoryHeaderSize > end_offset) {
+      return false;
+    }
+
+    const uint8_t* header = archive + offset;
+    if (ReadUInt32(header) != kCentralDirectoryHeaderSignature) {
+      return false;
+    }
+
+    const uint16_t flags = ReadUInt16(header + 8);
+    const uint16_t method = ReadUInt16(header + 10);
+    const uint32_t compressed_size = ReadUInt32(header + 20);
+    const uint32_t uncompressed_size = ReadUInt32(header + 24);
+    const uint16_t name_size = ReadUInt16(header + 28);
+    const uint16_t extra_size = ReadUInt16(header + 30);
+    const uint16_t comment_size = ReadUInt16(header + 32);
+    const uint32_t local_header_offset = ReadUInt32(header + 42);
+
+    const size_t next_offset = offset + kCentralDirectoryHeaderSize +
+                               name_size + extra_size + comment_size;
+    if (next_offset > end_offset) {
+      return false;
+    }
+    std::string file_name(
+        reinterpret_cast<const char*>(header + kCentralDirectoryHeaderSize),
+        name_size);
+    offset = next_offset;
+
+    if (uncompressed_size == 0) {
+      continue;
+    }
+
+    // Leave anything unusual to the unzipper.
+    if ((flags & kEncryptedFlag) != 0 ||
+        (method != kMethodStored && method != kMethodDeflated) ||
+        compressed_size == kZip64Marker || uncompressed_size == kZip64Marker ||
+        local_header_offset == kZip64Marker) {
+      return false;
+    }
+    if (method == kMethodStored && compressed_size != uncompressed_size) {
+      return false;
+    }
+
+    // The local header repeats the name but may carry different extra data.
+    if (static_cast<size_t>(local_header_offset) + kLocalFileHeaderSize >
+        archive_size) {
+      return false;
+    }
+    const uint8_t* local_header = archive + local_header_offset;
+    if (ReadUInt32(local_header) != kLocalFileHeaderSignature) {
+      return false;
+    }
+    const size_t data_offset = local_header_offset + kLocalFileHeaderSize +
+                               ReadUInt16(local_header + 26) +
+                               ReadUInt16(local_header + 28);
+    if (data_offset + compressed_size > archive_size) {
+      return false;
+    }
+
+    CacheEntry entry(data_offset, compressed_size, uncompressed_size,
+                     method == kMethodDeflated);
+    stat_cache_.emplace(std::move(file_name), std::move(entry));
+  }
+
+  return true;
+}
+
 void ZipAssetStore::BuildStatCache() {
   TRACE_EVENT0("flutter", "ZipAssetStore::BuildStatCache");
   auto unzipper = unzipper_provider_();
@@ -5,36 +5,103 @@
 #ifndef FLUTTER_ASSETS_ZIP_ASSET_STORE_H_
 #define FLUTTER_ASSETS_ZIP_ASSET_STORE_H_
 
+#include <list>
 #include <map>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "flutter/assets/unzipper_provider.h"
+#include "flutter/fml/mapping.h"
 #include "lib/ftl/macros.h"
 #include "lib/ftl/memory/ref_counted.h"
+#include "lib/ftl/synchronization/mutex.h"
+#include "lib/ftl/synchronization/thread_annotations.h"
 #include "third_party/zlib/contrib/minizip/unzip.h"
 
 namespace blink {
 
 class ZipAssetStore : public ftl::RefCountedThreadSafe<ZipAssetStore> {
  public:
+  // The default budget for assets that had to be decompressed and are kept
+  // around in case they are asked for again.
+  static constexpr size_t kDefaultDecompressedCacheBytes = 4 << 20;
+
   explicit ZipAssetStore(UnzipperProvider unzipper_provider);
+
+  // Serves assets straight out of |archive_mapping|, which must hold the same
+  // archive as the one |unzipper_provider| opens. The unzipper is only used if
+  // the archive cannot be read from the mapping.
+  ZipAssetStore(
+      UnzipperProvider unzipper_provider,
+      std::unique_ptr<fml::Mapping> archive_mapping,
+      size_t decompressed_cache_bytes = kDefaultDecompressedCacheBytes);
+
   ~ZipAssetStore();
 
   bool GetAsBuffer(const std::string& asset_name, std::vector<uint8_t>* data);
 
+  // Returns nullptr if there is no such asset. Assets stored without
+  // compression in a mapped archive are returned without being copied. The
+  // returned mapping remains valid after the store is gone.
+  std::unique_ptr<fml::Mapping> GetAsMapping(const std::string& asset_name);
+
+  size_t decompressed_cache_bytes() const;
+
  private:
   struct CacheEntry {
+    // Only used when reading through an unzipper.
     unz_file_pos file_pos;
     size_t uncompressed_size;
+    // Only used when reading from the mapped archive.
+    size_t data_offset;
+    size_t compressed_size;
+    bool deflated;
+
     CacheEntry(unz_file_pos p_file_pos, size_t p_uncompressed_size)
-        : file_pos(p_file_pos), uncompressed_size(p_uncompressed_size) {}
+        : file_pos(p_file_pos),
+          uncompressed_size(p_uncompressed_size),
+          data_offset(0),
+          compressed_size(0),
+          deflated(false) {}
+
+    CacheEntry(size_t p_data_offset,
+               size_t p_compressed_size,
+               size_t p_uncompressed_size,
+               bool p_deflated)
+        : file_pos(),
+          uncompressed_size(p_uncompressed_size),
+          data_offset(p_data_offset),
+          compressed_size(p_compressed_size),
+          deflated(p_deflated) {}
   };
 
+  using DecompressedAsset = std::shared_ptr<const std::vector<uint8_t>>;
+  // Most recently used first.
+  using DecompressedList = std::list<std::pair<std::string, DecompressedAsset>>;
+
   UnzipperProvider unzipper_provider_;
+  // Null unless assets are read from the mapped archive.
+  std::shared_ptr<fml::Mapping> archive_mapping_;
   std::map<std::string, CacheEntry> stat_cache_;
 
+  const size_t decompressed_cache_max_bytes_;
+  mutable ftl::Mutex decompressed_cache_mutex_;
+  DecompressedList decompressed_cache_
+      FTL_GUARDED_BY(decompressed_cache_mutex_);
+  std::unordered_map<std::string, DecompressedList::iterator>
+      decompressed_cache_index_ FTL_GUARDED_BY(decompressed_cache_mutex_);
+  size_t decompressed_cache_bytes_ FTL_GUARDED_BY(decompressed_cache_mutex_);
+
   void BuildStatCache();
 
+  bool BuildStatCacheFromMapping();
+
+  bool ReadWithUnzipper(const CacheEntry& entry, std::vector<uint8_t>* data);
+
+  DecompressedAsset GetDecompressed(const std::string& asset_name,
+                                    const CacheEntry& entry);
+
   FTL_DISALLOW_COPY_AND_ASSIGN(ZipAssetStore);
 };
 
@@ -0,0 +1,331 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/zip_asset_store.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "lib/ftl/files/eintr_wrapper.h"
+#include "third_party/gtest/include/gtest/gtest.h"
+#include "third_party/zlib/zlib.h"
+
+namespace blink {
+namespace {
+
+struct ZipEntry {
+  std::string name;
+  std::string data;
+  bool deflated;
+};
+
+void AppendUInt16(std::vector<uint8_t>* out, uint16_t value) {
+  out->push_back(value & 0xFF);
+  out->push_back(value >> 8);
+}
+
+void AppendUInt32(std::vector<uint8_t>* out, uint32_t value) {
+  AppendUInt16(out, value & 0xFFFF);
+  AppendUInt16(out, value >> 16);
+}
+
+void AppendBytes(std::vector<uint8_t>* out, const std::string& bytes) {
+  out->insert(out->end(), bytes.begin(), bytes.end());
+}
+
+void WriteUInt32(std::vector<uint8_t>* out, size_t offset, uint32_t value) {
+  for (size_t i = 0; i < 4; i++)
+    (*out)[offset + i] = (value >> (8 * i)) & 0xFF;
+}
+
+// A raw deflate stream, as ZIP entries hold.
+std::string Deflate(const std::string& data) {
+  z_stream stream = {};
+  EXPECT_EQ(deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, -MAX_WBITS,
+                         8, Z_DEFAULT_STRATEGY),
+            Z_OK);
+  std::string compressed(deflateBound(&stream, data.size()), '\0');
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  stream.avail_in = data.size();
+  stream.next_out = reinterpret_cast<Bytef*>(&compressed[0]);
+  stream.avail_out = compressed.size();
+  EXPECT_EQ(deflate(&stream, Z_FINISH), Z_STREAM_END);
+  compressed.resize(stream.total_out);
+  deflateEnd(&stream);
+  return compressed;
+}
+
+// Lays out a ZIP archive as described in APPNOTE.TXT.
+std::vector<uint8_t> BuildArchive(const std::vector<ZipEntry>& entries,
+                                  const std::string& comment = "") {
+  std::vector<uint8_t> archive;
+  std::vector<uint8_t> directory;
+  for (const ZipEntry& entry : entries) {
+    const std::string stored =
+        entry.deflated ? Deflate(entry.data) : entry.data;
+    const uint32_t crc =
+        crc32(0, reinterpret_cast<const Bytef*>(entry.data.data()),
+              entry.data.size());
+    const uint16_t method = entry.deflated ? 8 : 0;
+    const uint32_t local_header_offset = archive.size();
+
+    AppendUInt32(&archive, 0x04034b50);
+    AppendUInt16(&archive, 20);  // Version needed.
+    AppendUInt16(&archive, 0);   // Flags.
+    AppendUInt16(&archive, method);
+    AppendUInt32(&archive, 0);  // Time and date.
+    AppendUInt32(&archive, crc);
+    AppendUInt32(&archive, stored.size());
+    AppendUInt32(&archive, entry.data.size());
+    AppendUInt16(&archive, entry.name.size());
+    AppendUInt16(&archive, 0);  // Extra field.
+    AppendBytes(&archive, entry.name);
+    AppendBytes(&archive, stored);
+
+    AppendUInt32(&directory, 0x02014b50);
+    AppendUInt16(&directory, 20);  // Version made by.
+    AppendUInt16(&directory, 20);  // Version needed.
+    AppendUInt16(&directory, 0);   // Flags.
+    AppendUInt16(&directory, method);
+    AppendUInt32(&directory, 0);  // Time and date.
+    AppendUInt32(&directory, crc);
+    AppendUInt32(&directory, stored.size());
+    AppendUInt32(&directory, entry.data.size());
+    AppendUInt16(&directory, entry.name.size());
+    AppendUInt16(&directory, 0);  // Extra field.
+    AppendUInt16(&directory, 0);  // Comment.
+    AppendUInt16(&directory, 0);  // Disk.
+    AppendUInt16(&directory, 0);  // Internal attributes.
+    AppendUInt32(&directory, 0);  // External attributes.
+    AppendUInt32(&directory, local_header_offset);
+    AppendBytes(&directory, entry.name);
+  }
+
+  const uint32_t directory_offset = archive.size();
+  archive.insert(archive.end(), directory.begin(), directory.end());
+
+  AppendUInt32(&archive, 0x06054b50);
+  AppendUInt16(&archive, 0);  // Disk.
+  AppendUInt16(&archive, 0);  // Disk of the central directory.
+  AppendUInt16(&archive, entries.size());
+  AppendUInt16(&archive, entries.size());
+  AppendUInt32(&archive, directory.size());
+  AppendUInt32(&archive, directory_offset);
+  AppendUInt16(&archive, comment.size());
+  AppendBytes(&archive, comment);
+  return archive;
+}
+
+// The offset of the central directory of an archive without a comment.
+size_t DirectoryOffset(const std::vector<uint8_t>& archive) {
+  const uint8_t* field = &archive[archive.size() - 22 + 16];
+  return field[0] | (field[1] << 8) | (field[2] << 16) | (field[3] << 24);
+}
+
+class DataMapping : public fml::Mapping {
+ public:
+  explicit DataMapping(std::vector<uint8_t> data) : data_(std::move(data)) {}
+
+  size_t GetSize() const override { return data_.size(); }
+
+  const uint8_t* GetMapping() const override { return data_.data(); }
+
+ private:
+  const std::vector<uint8_t> data_;
+
+  FTL_DISALLOW_COPY_AND_ASSIGN(DataMapping);
+};
+
+// Holds the archive the unzipper reads, which needs a file.
+class ArchiveFile {
+ public:
+  explicit ArchiveFile(const std::vector<uint8_t>& archive) {
+    char path[] = "/tmp/zip_asset_store_unittests.XXXXXX";
+    const int fd = mkstemp(path);
+    EXPECT_NE(fd, -1);
+    EXPECT_EQ(HANDLE_EINTR(write(fd, archive.data(), archive.size())),
+              static_cast<ssize_t>(archive.size()));
+    close(fd);
+    path_ = path;
+  }
+
+  ~ArchiveFile() { unlink(path_.c_str()); }
+
+  // Counts the times the store falls back to the unzipper.
+  UnzipperProvider GetUnzipperProvider(int* call_count) const {
+    UnzipperProvider provider = GetUnzipperProviderForPath(path_);
+    return [provider, call_count]() {
+      (*call_count)++;
+      return provider();
+    };
+  }
+
+ private:
+  std::string path_;
+
+  FTL_DISALLOW_COPY_AND_ASSIGN(ArchiveFile);
+};
+
+std::string ToString(const fml::Mapping& mapping) {
+  return std::string(reinterpret_cast<const char*>(mapping.GetMapping()),
+                     mapping.GetSize());
+}
+
+const std::string kStoredData = "stored asset";
+const std::string kDeflatedData(5000, 'z');
+
+std::vector<ZipEntry> MakeEntries() {
+  return {{"assets/stored.txt", kStoredData, false},
+          {"assets/deflated.txt", kDeflatedData, true}};
+}
+
+void ExpectEntriesServed(ZipAssetStore* store) {
+  auto stored = store->GetAsMapping("assets/stored.txt");
+  ASSERT_TRUE(stored);
+  ASSERT_EQ(ToString(*stored), kStoredData);
+
+  auto deflated = store->GetAsMapping("assets/deflated.txt");
+  ASSERT_TRUE(deflated);
+  ASSERT_EQ(ToString(*deflated), kDeflatedData);
+
+  std::vector<uint8_t> buffer;
+  ASSERT_TRUE(store->GetAsBuffer("assets/deflated.txt", &buffer));
+  ASSERT_EQ(std::string(buffer.begin(), buffer.end()), kDeflatedData);
+
+  ASSERT_FALSE(store->GetAsMapping("assets/missing.txt"));
+  ASSERT_FALSE(store->GetAsBuffer("assets/missing.txt", &buffer));
+}
+
+}  // namespace
+
+TEST(ZipAssetStore, ServesStoredAndDeflatedEntriesFromMapping) {
+  const std::vector<uint8_t> archive = BuildArchive(MakeEntries());
+  ArchiveFile file(archive);
+  int unzipper_calls = 0;
+  auto mapping = std::make_unique<DataMapping>(archive);
+  const uint8_t* archive_start = mapping->GetMapping();
+  auto store = ftl::MakeRefCounted<ZipAssetStore>(
+      file.GetUnzipperProvider(&unzipper_calls), std::move(mapping));
+
+  ExpectEntriesServed(store.get());
+  ASSERT_EQ(unzipper_calls, 0);
+
+  // Stored entries are served out of the archive without a copy.
+  auto stored = store->GetAsMapping("assets/stored.txt");
+  ASSERT_GE(stored->GetMapping(), archive_start);
+  ASSERT_LT(stored->GetMapping(), archive_start + archive.size());
+
+  // And outlive the store.
+  store = ftl::RefPtr<ZipAssetStore>();
+  ASSERT_EQ(ToString(*stored), kStoredData);
+}
+
+TEST(ZipAssetStore, ServesEntriesWithUnzipper) {
+  ArchiveFile file(BuildArchive(MakeEntries()));
+  int unzipper_calls = 0;
+  auto store = ftl::MakeRefCounted<ZipAssetStore>(
+      file.GetUnzipperProvider(&unzipper_calls));
+
+  ExpectEntriesServed(store.get());
+  ASSERT_GT(unzipper_calls, 0);
+}
+
+TEST(ZipAssetStore, FindsDirectoryBeforeTrailingComment) {
+  // The comment holds what looks like the start of another end record.
+  const std::string comment = "PK\x05\x06 is not the end of this archive";
+  const std::vector<uint8_t> archive = BuildArchive(MakeEntries(), comment);
+  ArchiveFile file(archive);
+  int unzipper_calls = 0;
+  auto store = ftl::MakeRefCounted<ZipAssetStore>(
+      file.GetUnzipperProvider(&unzipper_calls),
+      std::make_unique<DataMapping>(archive));
+
+  ExpectEntriesServed(store.get());
+  ASSERT_EQ(unzipper_calls, 0);
+}
+
+TEST(ZipAssetStore, FallsBackToUnzipperForTruncatedArchive) {
+  const std::vector<uint8_t> archive = BuildArchive(MakeEntries());
+  ArchiveFile file(archive);
+  int unzipper_calls = 0;
+  std::vector<uint8_t> truncated(archive.begin(), archive.end() - 10);
+  auto store = ftl::MakeRefCounted<ZipAssetStore>(
+      file.GetUnzipperProvider(&unzipper_calls),
+      std::make_unique<DataMapping>(std::move(truncated)));
+
+  ASSERT_EQ(unzipper_calls, 1);
+  ExpectEntriesServed(store.get());
+}
+
+TEST(ZipAssetStore, FallsBackToUnzipperForMalformedDirectory) {
+  const std::vector<uint8_t> archive = BuildArchive(MakeEntries());
+  ArchiveFile file(archive);
+  int unzipper_calls = 0;
+  std::vector<uint8_t> malformed = archive;
+  malformed[DirectoryOffset(archive)] ^= 0xFF;
+  auto store = ftl::MakeRefCounted<ZipAssetStore>(
+      file.GetUnzipperProvider(&unzipper_calls),
+      std::make_unique<DataMapping>(std::move(malformed)));
+
+  ASSERT_EQ(unzipper_calls, 1);
+  ExpectEntriesServed(store.get());
+}
+
+TEST(ZipAssetStore, FallsBackToUnzipperForZip64Sizes) {
+  const std::vector<uint8_t> archive = BuildArchive(MakeEntries());
+  ArchiveFile file(archive);
+  int unzipper_calls = 0;
+  // Marks the uncompressed size of the first entry as held in ZIP64 extra
+  // data.
+  std::vector<uint8_t> zip64 = archive;
+  WriteUInt32(&zip64, DirectoryOffset(archive) + 24, 0xFFFFFFFF);
+  auto store = ftl::MakeRefCounted<ZipAssetStore>(
+      file.GetUnzipperProvider(&unzipper_calls),
+      std::make_unique<DataMapping>(std::move(zip64)));
+
+  ASSERT_EQ(unzipper_calls, 1);
+  ExpectEntriesServed(store.get());
+}
+
+TEST(ZipAssetStore, EvictsLeastRecentlyDecompressedOverBudget) {
+  const std::string data(1000, 'a');
+  const std::vector<uint8_t> archive =
+      BuildArchive({{"a", data, true},
+                    {"b", data, true},
+                    {"c", data, true},
+                    {"large", data + data + data, true}});
+  ArchiveFile file(archive);
+  int unzipper_calls = 0;
+  auto store = ftl::MakeRefCounted<ZipAssetStore>(
+      file.GetUnzipperProvider(&unzipper_calls),
+      std::make_unique<DataMapping>(archive), 2 * data.size());
+
+  // Decompressed assets stay alive while mapped, so their addresses tell
+  // whether a later request was served from the cache.
+  auto first_a = store->GetAsMapping("a");
+  auto first_b = store->GetAsMapping("b");
+  ASSERT_EQ(store->decompressed_cache_bytes(), 2 * data.size());
+  // Makes "b" the least recently used.
+  ASSERT_EQ(store->GetAsMapping("a")->GetMapping(), first_a->GetMapping());
+  auto first_c = store->GetAsMapping("c");
+  ASSERT_EQ(store->decompressed_cache_bytes(), 2 * data.size());
+
+  ASSERT_EQ(store->GetAsMapping("c")->GetMapping(), first_c->GetMapping());
+  ASSERT_EQ(store->GetAsMapping("a")->GetMapping(), first_a->GetMapping());
+  auto second_b = store->GetAsMapping("b");
+  ASSERT_NE(second_b->GetMapping(), first_b->GetMapping());
+  ASSERT_EQ(ToString(*second_b), data);
+
+  // Assets over the budget are never cached.
+  auto large = store->GetAsMapping("large");
+  ASSERT_EQ(large->GetSize(), 3 * data.size());
+  ASSERT_EQ(store->decompressed_cache_bytes(), 2 * data.size());
+  ASSERT_NE(store->GetAsMapping("large")->GetMapping(), large->GetMapping());
+  ASSERT_EQ(unzipper_calls, 0);
+}
+
+}  // namespace blink
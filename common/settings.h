@@ -23,10 +23,42 @@ struct Settings {
   bool start_paused = false;
   bool trace_startup = false;
   bool endless_trace_buffer = false;
+  // Where to write the trace events of the engine to, in the Chrome trace
+  // event format. Empty for nowhere.
+  std::string trace_file_path;
   bool enable_dart_profiling = false;
   bool use_test_fonts = false;
   bool dart_non_checked_mode = false;
   bool enable_software_rendering = false;
+  // The number of additional threads software rendered frames are rasterized
+  // on in tiles of the given size. Zero for either rasterizes on the GPU
+  // thread alone.
+  uint32_t software_raster_worker_count = 0;
+  uint32_t software_raster_tile_size = 0;
+  // Zero selects the defaults of the raster cache.
+  uint64_t raster_cache_max_bytes = 0;
+  uint32_t raster_cache_max_unused_frames = 0;
+  bool defer_raster_cache_population = false;
+  bool enable_partial_repaint = false;
+  uint32_t preroll_worker_count = 0;
+  // The number of frames that may be queued up between the UI and GPU
+  // threads. Zero selects the default.
+  uint32_t layer_tree_pipeline_depth = 0;
+  bool skip_stale_frames = false;
+  bool adaptive_frame_start = false;
+  // Whether pointer events are queued and dispatched once per frame, and
+  // whether moves are then resampled to the frame time.
+  bool batch_pointer_events = false;
+  bool resample_pointer_events = false;
+  // The number of threads images are decoded on and the size of the cache of
+  // decoded images. Zero selects the defaults.
+  uint32_t image_decode_worker_count = 0;
+  uint64_t decoded_image_cache_max_bytes = 0;
+  // The bytes the caches of the engine may hold in total before the largest
+  // are trimmed. Zero for no budget.
+  uint64_t memory_budget_bytes = 0;
+  // Where to stream the timings of rasterized frames to. Empty for nowhere.
+  std::string frame_timing_log_path;
   std::string aot_snapshot_path;
   std::string aot_vm_snapshot_data_filename;
   std::string aot_vm_snapshot_instr_filename;
@@ -42,6 +42,22 @@ const ftl::RefPtr<ftl::TaskRunner>& Threads::IO() {
   return Get().io_;
 }
 
+const ftl::RefPtr<ftl::TaskRunner>& Threads::UIHighPriority() {
+  const Threads& threads = Get();
+  return threads.ui_high_priority_ ? threads.ui_high_priority_ : threads.ui_;
+}
+
+const ftl::RefPtr<ftl::TaskRunner>& Threads::UILowPriority() {
+  const Threads& threads = Get();
+  return threads.ui_low_priority_ ? threads.ui_low_priority_ : threads.ui_;
+}
+
+void Threads::SetUIPriorityTaskRunners(ftl::RefPtr<ftl::TaskRunner> high,
+                                       ftl::RefPtr<ftl::TaskRunner> low) {
+  ui_high_priority_ = std::move(high);
+  ui_low_priority_ = std::move(low);
+}
+
 const Threads& Threads::Get() {
   FTL_CHECK(g_threads);
   return *g_threads;
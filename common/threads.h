@@ -23,6 +23,14 @@ class Threads {
   static const ftl::RefPtr<ftl::TaskRunner>& UI();
   static const ftl::RefPtr<ftl::TaskRunner>& IO();
 
+  // Runners that post to the UI thread ahead of or behind its regular tasks.
+  // Fall back to |UI| on embedders that do not support task priorities.
+  static const ftl::RefPtr<ftl::TaskRunner>& UIHighPriority();
+  static const ftl::RefPtr<ftl::TaskRunner>& UILowPriority();
+
+  void SetUIPriorityTaskRunners(ftl::RefPtr<ftl::TaskRunner> high,
+                                ftl::RefPtr<ftl::TaskRunner> low);
+
   static void Set(const Threads& settings);
 
  private:
@@ -32,6 +40,8 @@ class Threads {
   ftl::RefPtr<ftl::TaskRunner> gpu_;
   ftl::RefPtr<ftl::TaskRunner> ui_;
   ftl::RefPtr<ftl::TaskRunner> io_;
+  ftl::RefPtr<ftl::TaskRunner> ui_high_priority_;
+  ftl::RefPtr<ftl::TaskRunner> ui_low_priority_;
 };
 
 }  // namespace blink
@@ -365,9 +365,12 @@ bool RuntimeHolder::HandleAssetPlatformMessage(
   const auto& data = message->data();
   std::string asset_name(reinterpret_cast<const char*>(data.data()),
                          data.size());
-  std::vector<uint8_t> asset_data;
-  if (asset_store_ && asset_store_->GetAsBuffer(asset_name, &asset_data)) {
-    response->Complete(std::move(asset_data));
+  std::unique_ptr<fml::Mapping> asset_data;
+  if (asset_store_)
+    asset_data = asset_store_->GetAsMapping(asset_name);
+  if (asset_data) {
+    response->Complete(
+        blink::PlatformMessageBuffer::Create(std::move(asset_data)));
   } else {
     response->CompleteEmpty();
   }
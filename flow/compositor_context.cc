@@ -5,6 +5,7 @@
 #include "flutter/flow/compositor_context.h"
 
 #include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/gpu/GrContext.h"
 
 namespace flow {
 
@@ -19,6 +20,11 @@ void CompositorContext::BeginFrame(ScopedFrame& frame,
     frame_count_.Increment();
     frame_time_.Start();
 
+    frame.timing_.frame_number = frame_count_.count();
+    frame.timing_.raster_start = ftl::TimePoint::Now();
+    frame.raster_cache_hits_at_begin_ = raster_cache_.hit_count().count();
+    frame.raster_cache_misses_at_begin_ = raster_cache_.miss_count().count();
+
     if (process_info_ && process_info_->SampleNow()) {
       memory_usage_.Add(process_info_->GetResidentMemorySize());
     }
@@ -30,6 +36,22 @@ void CompositorContext::EndFrame(ScopedFrame& frame,
   raster_cache_.SweepAfterFrame();
   if (enable_instrumentation) {
     frame_time_.Stop();
+
+    FrameTiming& timing = frame.timing_;
+    timing.raster_time = ftl::TimePoint::Now() - timing.raster_start;
+    timing.raster_cache_hits =
+        raster_cache_.hit_count().count() - frame.raster_cache_hits_at_begin_;
+    timing.raster_cache_misses = raster_cache_.miss_count().count() -
+                                 frame.raster_cache_misses_at_begin_;
+    timing.raster_cache_bytes = raster_cache_.bytes_used();
+    if (frame.gr_context()) {
+      frame.gr_context()->getResourceCacheUsage(nullptr,
+                                                &timing.gpu_resource_bytes);
+    }
+    frame_timings_.Add(timing);
+    if (frame_timing_observer_) {
+      frame_timing_observer_(timing);
+    }
   }
 }
 
@@ -47,7 +69,9 @@ CompositorContext::ScopedFrame::ScopedFrame(CompositorContext& context,
     : context_(context),
       gr_context_(gr_context),
       canvas_(canvas),
-      instrumentation_enabled_(instrumentation_enabled) {
+      instrumentation_enabled_(instrumentation_enabled),
+      raster_cache_hits_at_begin_(0),
+      raster_cache_misses_at_begin_(0) {
   context_.BeginFrame(*this, instrumentation_enabled_);
 }
 
@@ -57,6 +81,23 @@ CompositorContext::ScopedFrame::~ScopedFrame() {
   context_.EndFrame(*this, instrumentation_enabled_);
 }
 
+void CompositorContext::SetPrerollWorkerCount(size_t count) {
+  if (count == 0) {
+    preroll_worker_pool_.reset();
+    return;
+  }
+
+  if (preroll_worker_pool_ && preroll_worker_pool_->worker_count() == count) {
+    return;
+  }
+
+  preroll_worker_pool_.reset(new PrerollWorkerPool(count));
+}
+
+void CompositorContext::SetFrameTimingObserver(FrameTimingObserver observer) {
+  frame_timing_observer_ = std::move(observer);
+}
+
 void CompositorContext::OnGrContextDestroyed() {
   raster_cache_.Clear();
 }
@@ -5,10 +5,13 @@
 #ifndef FLUTTER_FLOW_COMPOSITOR_CONTEXT_H_
 #define FLUTTER_FLOW_COMPOSITOR_CONTEXT_H_
 
+#include <functional>
 #include <memory>
 #include <string>
 
+#include "flutter/flow/frame_timing.h"
 #include "flutter/flow/instrumentation.h"
+#include "flutter/flow/preroll_worker_pool.h"
 #include "flutter/flow/process_info.h"
 #include "flutter/flow/raster_cache.h"
 #include "lib/ftl/macros.h"
@@ -27,6 +30,10 @@ class CompositorContext {
 
     GrContext* gr_context() const { return gr_context_; }
 
+    // What has been measured of the frame so far. Only recorded when
+    // instrumentation is enabled.
+    FrameTiming& timing() { return timing_; }
+
     ScopedFrame(ScopedFrame&& frame);
 
     ~ScopedFrame();
@@ -36,6 +43,10 @@ class CompositorContext {
     GrContext* gr_context_;
     SkCanvas* canvas_;
     const bool instrumentation_enabled_;
+    FrameTiming timing_;
+    // The raster cache counters when the frame began.
+    size_t raster_cache_hits_at_begin_;
+    size_t raster_cache_misses_at_begin_;
 
     ScopedFrame(CompositorContext& context,
                 GrContext* gr_context,
@@ -57,8 +68,18 @@ class CompositorContext {
 
   void OnGrContextDestroyed();
 
+  // Sets the number of threads, besides the one rasterizing frames, used to
+  // preroll layer trees. Zero prerolls on the rasterizing thread alone.
+  void SetPrerollWorkerCount(size_t count);
+
+  PrerollWorkerPool* preroll_worker_pool() const {
+    return preroll_worker_pool_.get();
+  }
+
   RasterCache& raster_cache() { return raster_cache_; }
 
+  const RasterCache& raster_cache() const { return raster_cache_; }
+
   const Counter& frame_count() const { return frame_count_; }
 
   const Stopwatch& frame_time() const { return frame_time_; }
@@ -67,6 +88,14 @@ class CompositorContext {
 
   const CounterValues& memory_usage() const { return memory_usage_; }
 
+  // The timings of the instrumented frames drawn most recently.
+  const FrameTimingHistory& frame_timings() const { return frame_timings_; }
+
+  // Called with the timing of every instrumented frame once it has been drawn.
+  using FrameTimingObserver = std::function<void(const FrameTiming& timing)>;
+
+  void SetFrameTimingObserver(FrameTimingObserver observer);
+
  private:
   RasterCache raster_cache_;
   std::unique_ptr<ProcessInfo> process_info_;
@@ -74,6 +103,9 @@ class CompositorContext {
   Stopwatch frame_time_;
   Stopwatch engine_time_;
   CounterValues memory_usage_;
+  FrameTimingHistory frame_timings_;
+  FrameTimingObserver frame_timing_observer_;
+  std::unique_ptr<PrerollWorkerPool> preroll_worker_pool_;
 
   void BeginFrame(ScopedFrame& frame, bool enable_instrumentation);
 
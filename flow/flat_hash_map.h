@@ -0,0 +1,263 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_FLAT_HASH_MAP_H_
+#define FLUTTER_FLOW_FLAT_HASH_MAP_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "lib/ftl/logging.h"
+#include "lib/ftl/macros.h"
+
+namespace flow {
+
+/// An open-addressing hash map with linear probing. All entries live in a
+/// single contiguous allocation so that lookups and insertions of new keys do
+/// not allocate unless the table needs to grow.
+///
+/// Erasing an entry leaves a tombstone behind instead of moving its
+/// neighbors. So, unlike insertions, erasures never invalidate iterators or
+/// references to other entries. This allows callers to collect iterators
+/// during a sweep and erase them afterwards. Tombstones are purged when the
+/// table is rehashed.
+template <class Key, class Value, class Hash, class Equal>
+class FlatHashMap {
+ public:
+  using value_type = std::pair<const Key, Value>;
+
+ private:
+  enum class SlotState : uint8_t {
+    kEmpty,
+    kFull,
+    kDeleted,
+  };
+
+  struct Slot {
+    SlotState state = SlotState::kEmpty;
+    size_t hash = 0;
+    typename std::aligned_storage<sizeof(value_type),
+                                  alignof(value_type)>::type storage;
+
+    value_type& value() { return *reinterpret_cast<value_type*>(&storage); }
+  };
+
+  template <bool IsConst>
+  class Iterator {
+   public:
+    using MapType =
+        typename std::conditional<IsConst, const FlatHashMap, FlatHashMap>::type;
+    using Reference =
+        typename std::conditional<IsConst, const value_type&, value_type&>::type;
+    using Pointer =
+        typename std::conditional<IsConst, const value_type*, value_type*>::type;
+
+    Iterator() : map_(nullptr), index_(0) {}
+
+    Iterator(MapType* map, size_t index) : map_(map), index_(index) {
+      SkipUnoccupied();
+    }
+
+    // Allow conversion from iterator to const_iterator.
+    operator Iterator<true>() const { return Iterator<true>(map_, index_); }
+
+    Reference operator*() const { return map_->slots_[index_].value(); }
+
+    Pointer operator->() const { return &map_->slots_[index_].value(); }
+
+    Iterator& operator++() {
+      index_++;
+      SkipUnoccupied();
+      return *this;
+    }
+
+    bool operator==(const Iterator& other) const {
+      return map_ == other.map_ && index_ == other.index_;
+    }
+
+    bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+   private:
+    friend class FlatHashMap;
+
+    MapType* map_;
+    size_t index_;
+
+    void SkipUnoccupied() {
+      while (index_ < map_->capacity_ &&
+             map_->slots_[index_].state != SlotState::kFull) {
+        index_++;
+      }
+    }
+  };
+
+ public:
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  FlatHashMap() : capacity_(0), size_(0), deleted_(0) {}
+
+  ~FlatHashMap() { clear(); }
+
+  size_t size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  // The number of slots in the table. Exposed for diagnostics.
+  size_t capacity() const { return capacity_; }
+
+  iterator begin() { return iterator(this, 0); }
+
+  iterator end() { return iterator(this, capacity_); }
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+
+  const_iterator end() const { return const_iterator(this, capacity_); }
+
+  iterator find(const Key& key) {
+    return iterator(this, FindIndex(key, Hash()(key)));
+  }
+
+  const_iterator find(const Key& key) const {
+    return const_iterator(this, FindIndex(key, Hash()(key)));
+  }
+
+  size_t count(const Key& key) const { return find(key) == end() ? 0 : 1; }
+
+  Value& operator[](const Key& key) {
+    const size_t hash = Hash()(key);
+
+    size_t index = FindIndex(key, hash);
+    if (index != capacity_) {
+      return slots_[index].value().second;
+    }
+
+    if ((size_ + deleted_ + 1) * 4 > capacity_ * 3) {
+      Rehash();
+    }
+
+    index = hash & (capacity_ - 1);
+    while (slots_[index].state == SlotState::kFull) {
+      index = (index + 1) & (capacity_ - 1);
+    }
+
+    Slot& slot = slots_[index];
+    if (slot.state == SlotState::kDeleted) {
+      deleted_--;
+    }
+    new (&slot.storage) value_type(key, Value());
+    slot.state = SlotState::kFull;
+    slot.hash = hash;
+    size_++;
+
+    return slot.value().second;
+  }
+
+  void erase(iterator it) {
+    FTL_DCHECK(it.map_ == this);
+    FTL_DCHECK(it.index_ < capacity_);
+    Slot& slot = slots_[it.index_];
+    FTL_DCHECK(slot.state == SlotState::kFull);
+    slot.value().~value_type();
+    slot.state = SlotState::kDeleted;
+    size_--;
+    deleted_++;
+  }
+
+  size_t erase(const Key& key) {
+    auto it = find(key);
+    if (it == end()) {
+      return 0;
+    }
+    erase(it);
+    return 1;
+  }
+
+  void clear() {
+    for (size_t i = 0; i < capacity_; i++) {
+      Slot& slot = slots_[i];
+      if (slot.state == SlotState::kFull) {
+        slot.value().~value_type();
+      }
+      slot.state = SlotState::kEmpty;
+    }
+    size_ = 0;
+    deleted_ = 0;
+  }
+
+ private:
+  static constexpr size_t kMinCapacity = 16;
+
+  std::unique_ptr<Slot[]> slots_;
+  size_t capacity_;  // Always zero or a power of two.
+  size_t size_;
+  size_t deleted_;
+
+  // Returns |capacity_| if the key is not present.
+  size_t FindIndex(const Key& key, size_t hash) const {
+    if (capacity_ == 0) {
+      return capacity_;
+    }
+
+    size_t index = hash & (capacity_ - 1);
+    for (size_t probes = 0; probes < capacity_; probes++) {
+      Slot& slot = slots_[index];
+      if (slot.state == SlotState::kEmpty) {
+        break;
+      }
+      if (slot.state == SlotState::kFull && slot.hash == hash &&
+          Equal()(slot.value().first, key)) {
+        return index;
+      }
+      index = (index + 1) & (capacity_ - 1);
+    }
+
+    return capacity_;
+  }
+
+  // Grows the table if necessary and purges all tombstones. Keeps the load
+  // factor after the rehash at or below one half.
+  void Rehash() {
+    size_t new_capacity = kMinCapacity;
+    while (new_capacity < capacity_ || (size_ + 1) * 2 > new_capacity) {
+      new_capacity *= 2;
+    }
+
+    std::unique_ptr<Slot[]> old_slots = std::move(slots_);
+    const size_t old_capacity = capacity_;
+
+    slots_.reset(new Slot[new_capacity]);
+    capacity_ = new_capacity;
+    deleted_ = 0;
+
+    for (size_t i = 0; i < old_capacity; i++) {
+      Slot& old_slot = old_slots[i];
+      if (old_slot.state != SlotState::kFull) {
+        continue;
+      }
+
+      size_t index = old_slot.hash & (capacity_ - 1);
+      while (slots_[index].state == SlotState::kFull) {
+        index = (index + 1) & (capacity_ - 1);
+      }
+
+      Slot& slot = slots_[index];
+      new (&slot.storage) value_type(std::move(old_slot.value()));
+      slot.state = SlotState::kFull;
+      slot.hash = old_slot.hash;
+      old_slot.value().~value_type();
+    }
+  }
+
+  FTL_DISALLOW_COPY_AND_ASSIGN(FlatHashMap);
+};
+
+}  // namespace flow
+
+#endif  // FLUTTER_FLOW_FLAT_HASH_MAP_H_
@@ -0,0 +1,123 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/flat_hash_map.h"
+
+#include <string>
+#include <vector>
+
+#include "third_party/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// Forces every key into the same probe sequence.
+struct CollidingHash {
+  size_t operator()(int key) const { return 42; }
+};
+
+struct IntEqual {
+  bool operator()(int lhs, int rhs) const { return lhs == rhs; }
+};
+
+using Map = flow::FlatHashMap<int, std::string, CollidingHash, IntEqual>;
+
+}  // namespace
+
+TEST(FlatHashMap, SimpleInitialization) {
+  Map map;
+  ASSERT_TRUE(map.empty());
+  ASSERT_EQ(map.size(), 0u);
+  ASSERT_TRUE(map.begin() == map.end());
+  ASSERT_TRUE(map.find(1) == map.end());
+}
+
+TEST(FlatHashMap, InsertAndFind) {
+  Map map;
+  map[1] = "one";
+  map[2] = "two";
+  ASSERT_EQ(map.size(), 2u);
+  ASSERT_EQ(map.find(1)->second, "one");
+  ASSERT_EQ(map.find(2)->second, "two");
+  ASSERT_EQ(map.count(3), 0u);
+
+  map[1] = "uno";
+  ASSERT_EQ(map.size(), 2u);
+  ASSERT_EQ(map[1], "uno");
+}
+
+TEST(FlatHashMap, GrowsPastInitialCapacity) {
+  Map map;
+  for (int i = 0; i < 1000; i++) {
+    map[i] = std::to_string(i);
+  }
+  ASSERT_EQ(map.size(), 1000u);
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_EQ(map.find(i)->second, std::to_string(i));
+  }
+}
+
+TEST(FlatHashMap, EraseKeepsProbeSequencesIntact) {
+  Map map;
+  map[1] = "one";
+  map[2] = "two";
+  map[3] = "three";
+
+  ASSERT_EQ(map.erase(2), 1u);
+  ASSERT_EQ(map.erase(2), 0u);
+  ASSERT_EQ(map.size(), 2u);
+
+  // Key 3 was probed past key 2 and must still be found.
+  ASSERT_EQ(map.find(3)->second, "three");
+
+  map[2] = "deux";
+  ASSERT_EQ(map.size(), 3u);
+  ASSERT_EQ(map.find(2)->second, "deux");
+}
+
+TEST(FlatHashMap, ErasingCollectedIteratorsIsSafe) {
+  Map map;
+  for (int i = 0; i < 100; i++) {
+    map[i] = std::to_string(i);
+  }
+
+  std::vector<Map::iterator> dead;
+  for (auto it = map.begin(); it != map.end(); ++it) {
+    if (it->first % 2 == 0) {
+      dead.push_back(it);
+    }
+  }
+
+  for (auto it : dead) {
+    map.erase(it);
+  }
+
+  ASSERT_EQ(map.size(), 50u);
+  size_t visited = 0;
+  for (auto it = map.begin(); it != map.end(); ++it) {
+    ASSERT_EQ(it->first % 2, 1);
+    visited++;
+  }
+  ASSERT_EQ(visited, 50u);
+}
+
+TEST(FlatHashMap, TombstonesDoNotGrowTheTable) {
+  Map map;
+  for (int i = 0; i < 10000; i++) {
+    map[i] = "value";
+    map.erase(i);
+  }
+  ASSERT_TRUE(map.empty());
+  ASSERT_LE(map.capacity(), 16u);
+}
+
+TEST(FlatHashMap, Clear) {
+  Map map;
+  map[1] = "one";
+  map[2] = "two";
+  map.clear();
+  ASSERT_TRUE(map.empty());
+  ASSERT_TRUE(map.find(1) == map.end());
+  map[1] = "one";
+  ASSERT_EQ(map.size(), 1u);
+}
@@ -0,0 +1,42 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/frame_timing.h"
+
+#include "lib/ftl/logging.h"
+
+namespace flow {
+
+constexpr size_t FrameTimingHistory::kDefaultCapacity;
+
+FrameTimingHistory::FrameTimingHistory(size_t capacity)
+    : capacity_(capacity), next_(0) {
+  FTL_DCHECK(capacity_ > 0);
+  frames_.reserve(capacity_);
+}
+
+FrameTimingHistory::~FrameTimingHistory() = default;
+
+void FrameTimingHistory::Add(const FrameTiming& timing) {
+  if (frames_.size() < capacity_) {
+    frames_.push_back(timing);
+    return;
+  }
+  frames_[next_] = timing;
+  next_ = (next_ + 1) % capacity_;
+}
+
+void FrameTimingHistory::GetFramesAfter(
+    uint64_t frame_number,
+    std::vector<FrameTiming>* frames) const {
+  // Once the history is full, |next_| points at the oldest frame.
+  for (size_t i = 0; i < frames_.size(); i++) {
+    const FrameTiming& timing = frames_[(next_ + i) % frames_.size()];
+    if (timing.frame_number > frame_number) {
+      frames->push_back(timing);
+    }
+  }
+}
+
+}  // namespace flow
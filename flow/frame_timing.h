@@ -0,0 +1,73 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_FRAME_TIMING_H_
+#define FLUTTER_FLOW_FRAME_TIMING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "lib/ftl/macros.h"
+#include "lib/ftl/time/time_delta.h"
+#include "lib/ftl/time/time_point.h"
+
+namespace flow {
+
+// What the compositor measured while drawing a single frame.
+struct FrameTiming {
+  // Numbers the frames drawn by a compositor context, starting at one.
+  uint64_t frame_number = 0;
+  ftl::TimePoint raster_start;
+  // How long the UI thread took to build the layer tree of the frame.
+  ftl::TimeDelta build_time;
+  // How long the frame took to rasterize and submit. Includes the preroll and
+  // paint times.
+  ftl::TimeDelta raster_time;
+  ftl::TimeDelta preroll_time;
+  ftl::TimeDelta paint_time;
+  // Lookups in the raster cache made while drawing this frame.
+  size_t raster_cache_hits = 0;
+  size_t raster_cache_misses = 0;
+  // The bytes held by the raster cache and by the resource cache of the GPU
+  // context once the frame was drawn.
+  size_t raster_cache_bytes = 0;
+  size_t gpu_resource_bytes = 0;
+};
+
+// The timings of the most recently drawn frames. Not thread safe.
+class FrameTimingHistory {
+ public:
+  // Five seconds worth of frames at 60Hz.
+  static constexpr size_t kDefaultCapacity = 300;
+
+  explicit FrameTimingHistory(size_t capacity = kDefaultCapacity);
+
+  ~FrameTimingHistory();
+
+  // Replaces the oldest frame if the history is full.
+  void Add(const FrameTiming& timing);
+
+  size_t size() const { return frames_.size(); }
+
+  size_t capacity() const { return capacity_; }
+
+  // Appends the frames numbered higher than |frame_number| to |frames|,
+  // oldest first.
+  void GetFramesAfter(uint64_t frame_number,
+                      std::vector<FrameTiming>* frames) const;
+
+ private:
+  const size_t capacity_;
+  std::vector<FrameTiming> frames_;
+  // Where the next frame goes once the history is full.
+  size_t next_;
+
+  FTL_DISALLOW_COPY_AND_ASSIGN(FrameTimingHistory);
+};
+
+}  // namespace flow
+
+#endif  // FLUTTER_FLOW_FRAME_TIMING_H_
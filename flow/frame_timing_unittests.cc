@@ -0,0 +1,83 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/frame_timing.h"
+
+#include <vector>
+
+#include "flutter/flow/compositor_context.h"
+#include "third_party/gtest/include/gtest/gtest.h"
+
+namespace {
+
+flow::FrameTiming MakeTiming(uint64_t frame_number) {
+  flow::FrameTiming timing;
+  timing.frame_number = frame_number;
+  return timing;
+}
+
+}  // namespace
+
+TEST(FrameTimingHistory, KeepsFramesInOrder) {
+  flow::FrameTimingHistory history(4);
+  for (uint64_t i = 1; i <= 3; i++) {
+    history.Add(MakeTiming(i));
+  }
+
+  std::vector<flow::FrameTiming> frames;
+  history.GetFramesAfter(0, &frames);
+  ASSERT_EQ(frames.size(), 3u);
+  for (size_t i = 0; i < frames.size(); i++) {
+    ASSERT_EQ(frames[i].frame_number, i + 1);
+  }
+}
+
+TEST(FrameTimingHistory, ReplacesOldestFramesWhenFull) {
+  flow::FrameTimingHistory history(4);
+  for (uint64_t i = 1; i <= 10; i++) {
+    history.Add(MakeTiming(i));
+  }
+  ASSERT_EQ(history.size(), 4u);
+
+  std::vector<flow::FrameTiming> frames;
+  history.GetFramesAfter(0, &frames);
+  ASSERT_EQ(frames.size(), 4u);
+  for (size_t i = 0; i < frames.size(); i++) {
+    ASSERT_EQ(frames[i].frame_number, i + 7);
+  }
+}
+
+TEST(FrameTimingHistory, ReturnsOnlyFramesAfterTheGivenOne) {
+  flow::FrameTimingHistory history(4);
+  for (uint64_t i = 1; i <= 6; i++) {
+    history.Add(MakeTiming(i));
+  }
+
+  std::vector<flow::FrameTiming> frames;
+  history.GetFramesAfter(4, &frames);
+  ASSERT_EQ(frames.size(), 2u);
+  ASSERT_EQ(frames[0].frame_number, 5u);
+  ASSERT_EQ(frames[1].frame_number, 6u);
+
+  frames.clear();
+  history.GetFramesAfter(6, &frames);
+  ASSERT_TRUE(frames.empty());
+}
+
+TEST(FrameTimingHistory, CompositorContextRecordsInstrumentedFrames) {
+  flow::CompositorContext context(nullptr);
+  std::vector<uint64_t> observed;
+  context.SetFrameTimingObserver([&observed](const flow::FrameTiming& timing) {
+    observed.push_back(timing.frame_number);
+  });
+
+  { context.AcquireFrame(nullptr, nullptr, true); }
+  { context.AcquireFrame(nullptr, nullptr, false); }
+  { context.AcquireFrame(nullptr, nullptr, true); }
+
+  ASSERT_EQ(context.frame_timings().size(), 2u);
+  ASSERT_EQ(observed.size(), 2u);
+  ASSERT_EQ(observed[0], 1u);
+  ASSERT_EQ(observed[1], 2u);
+}
@@ -0,0 +1,102 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Compares building and retiring a layer tree of about ten thousand layers
+// with every layer on the heap against one with all layers in a LayerArena.
+// Layers are added in the order SceneBuilder adds them and destroyed on
+// another thread, as the GPU thread does.
+
+#include <stdio.h>
+
+#include <thread>
+
+#include "flutter/flow/layers/clip_rect_layer.h"
+#include "flutter/flow/layers/layer_arena.h"
+#include "flutter/flow/layers/layer_tree.h"
+#include "flutter/flow/layers/opacity_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "lib/ftl/time/time_delta.h"
+#include "lib/ftl/time/time_point.h"
+
+namespace {
+
+constexpr size_t kFanOut = 10;
+constexpr size_t kDepth = 4;
+constexpr size_t kIterations = 100;
+
+std::unique_ptr<flow::Layer> MakeSubtree(flow::LayerArena* arena,
+                                         size_t depth) {
+  if (depth == 0) {
+    std::unique_ptr<flow::OpacityLayer> leaf(new (arena) flow::OpacityLayer());
+    leaf->set_alpha(128);
+    return std::move(leaf);
+  }
+
+  std::unique_ptr<flow::ContainerLayer> node;
+  if (depth % 2 == 0) {
+    std::unique_ptr<flow::TransformLayer> transform(
+        new (arena) flow::TransformLayer());
+    transform->set_transform(SkMatrix::MakeTrans(10, 10));
+    node = std::move(transform);
+  } else {
+    std::unique_ptr<flow::ClipRectLayer> clip(
+        new (arena) flow::ClipRectLayer());
+    clip->set_clip_rect(SkRect::MakeWH(400, 400));
+    node = std::move(clip);
+  }
+
+  for (size_t i = 0; i < kFanOut; i++) {
+    node->Add(MakeSubtree(arena, depth - 1));
+  }
+  return std::move(node);
+}
+
+struct Timings {
+  ftl::TimeDelta build = ftl::TimeDelta::Zero();
+  ftl::TimeDelta retire = ftl::TimeDelta::Zero();
+};
+
+Timings Measure(bool use_arena) {
+  Timings timings;
+  for (size_t i = 0; i < kIterations; i++) {
+    auto start = ftl::TimePoint::Now();
+    std::unique_ptr<flow::LayerTree> tree(new flow::LayerTree());
+    std::unique_ptr<flow::LayerArena> arena(
+        use_arena ? new flow::LayerArena() : nullptr);
+    std::unique_ptr<flow::Layer> root = MakeSubtree(arena.get(), kDepth);
+    tree->set_root_layer(std::move(root), std::move(arena));
+    timings.build = timings.build + (ftl::TimePoint::Now() - start);
+
+    std::thread retire_thread([&timings, &tree]() {
+      auto start = ftl::TimePoint::Now();
+      tree.reset();
+      timings.retire = timings.retire + (ftl::TimePoint::Now() - start);
+    });
+    retire_thread.join();
+  }
+  return timings;
+}
+
+double MicrosecondsPerIteration(ftl::TimeDelta delta) {
+  return static_cast<double>(delta.ToNanoseconds()) / 1000 / kIterations;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const size_t heap_allocations = flow::Layer::heap_allocation_count();
+  const Timings heap = Measure(false);
+  const size_t layers_per_tree =
+      (flow::Layer::heap_allocation_count() - heap_allocations) / kIterations;
+  const Timings arena = Measure(true);
+
+  printf("%zu layers, %zu iterations\n", layers_per_tree, kIterations);
+  printf("%8s %12s %12s\n", "", "build (us)", "retire (us)");
+  printf("%8s %12.1f %12.1f\n", "heap", MicrosecondsPerIteration(heap.build),
+         MicrosecondsPerIteration(heap.retire));
+  printf("%8s %12.1f %12.1f\n", "arena", MicrosecondsPerIteration(arena.build),
+         MicrosecondsPerIteration(arena.retire));
+
+  return 0;
+}
@@ -12,6 +12,14 @@ BackdropFilterLayer::BackdropFilterLayer() {}
 
 BackdropFilterLayer::~BackdropFilterLayer() {}
 
+void BackdropFilterLayer::Diff(DiffContext* context,
+                               const Layer* old_layer,
+                               const SkMatrix& matrix) const {
+  // The filter samples whatever was painted beneath it, so a change anywhere
+  // in the frame may change its output.
+  context->needs_full_repaint = true;
+}
+
 void BackdropFilterLayer::Paint(PaintContext& context) {
   TRACE_EVENT0("flutter", "BackdropFilterLayer::Paint");
   Layer::AutoSaveLayer(
@@ -14,6 +14,13 @@ class BackdropFilterLayer : public ContainerLayer {
   BackdropFilterLayer();
   ~BackdropFilterLayer() override;
 
+  // Not a plain container. See |Diff|.
+  Type type() const override { return Type::kUnknown; }
+
+  void Diff(DiffContext* context,
+            const Layer* old_layer,
+            const SkMatrix& matrix) const override;
+
   void set_filter(sk_sp<SkImageFilter> filter) { filter_ = std::move(filter); }
 
  protected:
@@ -42,4 +42,9 @@ void ClipPathLayer::Paint(PaintContext& context) {
   PaintChildren(context);
 }
 
+bool ClipPathLayer::IsEquivalent(const Layer& old_layer) const {
+  const auto& old = static_cast<const ClipPathLayer&>(old_layer);
+  return clip_path_ == old.clip_path_;
+}
+
 }  // namespace flow
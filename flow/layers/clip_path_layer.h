@@ -14,11 +14,14 @@ class ClipPathLayer : public ContainerLayer {
   ClipPathLayer();
   ~ClipPathLayer() override;
 
+  Type type() const override { return Type::kClipPath; }
+
   void set_clip_path(const SkPath& clip_path) { clip_path_ = clip_path; }
 
  protected:
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
   void Paint(PaintContext& context) override;
+  bool IsEquivalent(const Layer& old_layer) const override;
 
 #if defined(OS_FUCHSIA)
   void UpdateScene(SceneUpdateContext& context,
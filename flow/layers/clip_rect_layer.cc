@@ -42,4 +42,9 @@ void ClipRectLayer::Paint(PaintContext& context) {
   PaintChildren(context);
 }
 
+bool ClipRectLayer::IsEquivalent(const Layer& old_layer) const {
+  const auto& old = static_cast<const ClipRectLayer&>(old_layer);
+  return clip_rect_ == old.clip_rect_;
+}
+
 }  // namespace flow
@@ -14,11 +14,14 @@ class ClipRectLayer : public ContainerLayer {
   ClipRectLayer();
   ~ClipRectLayer() override;
 
+  Type type() const override { return Type::kClipRect; }
+
   void set_clip_rect(const SkRect& clip_rect) { clip_rect_ = clip_rect; }
 
  protected:
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
   void Paint(PaintContext& context) override;
+  bool IsEquivalent(const Layer& old_layer) const override;
 
 #if defined(OS_FUCHSIA)
   void UpdateScene(SceneUpdateContext& context,
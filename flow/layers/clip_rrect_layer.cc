@@ -42,4 +42,9 @@ void ClipRRectLayer::Paint(PaintContext& context) {
   PaintChildren(context);
 }
 
+bool ClipRRectLayer::IsEquivalent(const Layer& old_layer) const {
+  const auto& old = static_cast<const ClipRRectLayer&>(old_layer);
+  return clip_rrect_ == old.clip_rrect_;
+}
+
 }  // namespace flow
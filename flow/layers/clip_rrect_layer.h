@@ -14,11 +14,14 @@ class ClipRRectLayer : public ContainerLayer {
   ClipRRectLayer();
   ~ClipRRectLayer() override;
 
+  Type type() const override { return Type::kClipRRect; }
+
   void set_clip_rrect(const SkRRect& clip_rrect) { clip_rrect_ = clip_rrect; }
 
  protected:
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
   void Paint(PaintContext& context) override;
+  bool IsEquivalent(const Layer& old_layer) const override;
 
 #if defined(OS_FUCHSIA)
   void UpdateScene(SceneUpdateContext& context,
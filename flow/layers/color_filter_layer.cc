@@ -21,4 +21,9 @@ void ColorFilterLayer::Paint(PaintContext& context) {
   PaintChildren(context);
 }
 
+bool ColorFilterLayer::IsEquivalent(const Layer& old_layer) const {
+  const auto& old = static_cast<const ColorFilterLayer&>(old_layer);
+  return color_ == old.color_ && blend_mode_ == old.blend_mode_;
+}
+
 }  // namespace flow
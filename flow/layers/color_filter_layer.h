@@ -14,12 +14,15 @@ class ColorFilterLayer : public ContainerLayer {
   ColorFilterLayer();
   ~ColorFilterLayer() override;
 
+  Type type() const override { return Type::kColorFilter; }
+
   void set_color(SkColor color) { color_ = color; }
 
   void set_blend_mode(SkBlendMode blend_mode) { blend_mode_ = blend_mode; }
 
  protected:
   void Paint(PaintContext& context) override;
+  bool IsEquivalent(const Layer& old_layer) const override;
 
  private:
   SkColor color_;
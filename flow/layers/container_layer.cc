@@ -25,19 +25,61 @@ void ContainerLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
 
 void ContainerLayer::PrerollChildren(PrerollContext* context,
                                      const SkMatrix& matrix) {
-  SkRect child_paint_bounds = SkRect::MakeEmpty();
-  for (auto& layer : layers_) {
+  if (context->worker_pool && layers_.size() > 1) {
+    PrerollChildrenConcurrently(context, matrix);
+  } else {
+    SkRect child_paint_bounds = SkRect::MakeEmpty();
+    for (auto& layer : layers_) {
+      PrerollContext child_context = *context;
+      FTL_DCHECK(child_context.child_paint_bounds.isEmpty());
+      layer->Preroll(&child_context, matrix);
+      if (layer->needs_system_composite())
+        set_needs_system_composite(true);
+      child_paint_bounds.join(child_context.child_paint_bounds);
+    }
+    context->child_paint_bounds = child_paint_bounds;
+  }
+
+  if (needs_system_composite())
+    ctm_ = matrix;
+}
+
+void ContainerLayer::PrerollChildrenConcurrently(PrerollContext* context,
+                                                 const SkMatrix& matrix) {
+  TRACE_EVENT0("flutter", "ContainerLayer::PrerollChildrenConcurrently");
+
+  struct ChildResult {
+    SkRect child_paint_bounds;
+    std::vector<Layer*> deferred_raster_cache_layers;
+  };
+
+  std::vector<ChildResult> results(layers_.size());
+
+  // Each child subtree is only ever touched by one thread. Workers do not
+  // fan out any further, the pool is busy with this container already.
+  context->worker_pool->ParallelFor(layers_.size(), [&](size_t index) {
+    ChildResult& result = results[index];
     PrerollContext child_context = *context;
     FTL_DCHECK(child_context.child_paint_bounds.isEmpty());
-    layer->Preroll(&child_context, matrix);
-    if (layer->needs_system_composite())
+    child_context.worker_pool = nullptr;
+    child_context.deferred_raster_cache_layers =
+        &result.deferred_raster_cache_layers;
+    layers_[index]->Preroll(&child_context, matrix);
+    result.child_paint_bounds = child_context.child_paint_bounds;
+  });
+
+  // The raster cache is accessed in the same order as a serial preroll would
+  // have, so it makes the same decisions.
+  SkRect child_paint_bounds = SkRect::MakeEmpty();
+  for (size_t i = 0; i < layers_.size(); i++) {
+    for (Layer* layer : results[i].deferred_raster_cache_layers) {
+      layer->PrerollRasterCache(context);
+    }
+    if (layers_[i]->needs_system_composite())
       set_needs_system_composite(true);
-    child_paint_bounds.join(child_context.child_paint_bounds);
+    child_paint_bounds.join(results[i].child_paint_bounds);
   }
   context->child_paint_bounds = child_paint_bounds;
-
-  if (needs_system_composite())
-    ctm_ = matrix;
 }
 
 void ContainerLayer::PaintChildren(PaintContext& context) const {
@@ -48,6 +90,40 @@ void ContainerLayer::PaintChildren(PaintContext& context) const {
     layer->Paint(context);
 }
 
+void ContainerLayer::Diff(DiffContext* context,
+                          const Layer* old_layer,
+                          const SkMatrix& matrix) const {
+  if (old_layer == nullptr || old_layer->type() != type() ||
+      !IsEquivalent(*old_layer)) {
+    Layer::Diff(context, old_layer, matrix);
+    return;
+  }
+
+  DiffChildren(context, static_cast<const ContainerLayer&>(*old_layer),
+               matrix);
+}
+
+void ContainerLayer::DiffChildren(DiffContext* context,
+                                  const ContainerLayer& old_layer,
+                                  const SkMatrix& matrix) const {
+  const auto& old_layers = old_layer.layers();
+
+  for (size_t i = 0; i < layers_.size(); i++) {
+    const Layer* old_child = i < old_layers.size() ? old_layers[i].get()
+                                                   : nullptr;
+    layers_[i]->Diff(context, old_child, matrix);
+  }
+
+  for (size_t i = layers_.size(); i < old_layers.size(); i++) {
+    AddDamage(context, matrix, old_layers[i]->paint_bounds());
+  }
+}
+
+bool ContainerLayer::IsEquivalent(const Layer& old_layer) const {
+  // A plain container has no properties of its own.
+  return true;
+}
+
 #if defined(OS_FUCHSIA)
 
 void ContainerLayer::UpdateScene(SceneUpdateContext& context,
@@ -22,6 +22,18 @@ class ContainerLayer : public Layer {
 
   void PaintChildren(PaintContext& context) const;
 
+  Type type() const override { return Type::kContainer; }
+
+  void Diff(DiffContext* context,
+            const Layer* old_layer,
+            const SkMatrix& matrix) const override;
+
+  // Pairs up the children of this layer with those of |old_layer| by index.
+  // Children without a counterpart are damaged in their entirety.
+  void DiffChildren(DiffContext* context,
+                    const ContainerLayer& old_layer,
+                    const SkMatrix& matrix) const;
+
 #if defined(OS_FUCHSIA)
   void UpdateScene(SceneUpdateContext& context,
                    mozart::Node* container) override;
@@ -38,11 +50,18 @@ class ContainerLayer : public Layer {
   // Valid only after preroll when needs_system_composite() is true.
   const SkMatrix& ctm() const { return ctm_; }
 
+  bool IsEquivalent(const Layer& old_layer) const override;
+
  private:
   std::vector<std::unique_ptr<Layer>> layers_;
 
   SkMatrix ctm_;
 
+  // Prerolls each child on the worker pool of |context|. Only the first
+  // container with more than one child along any path does so.
+  void PrerollChildrenConcurrently(PrerollContext* context,
+                                   const SkMatrix& matrix);
+
   FTL_DISALLOW_COPY_AND_ASSIGN(ContainerLayer);
 };
 
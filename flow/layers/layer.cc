@@ -4,6 +4,8 @@
 
 #include "flutter/flow/layers/layer.h"
 
+#include <atomic>
+
 #include "flutter/flow/paint_utils.h"
 #include "third_party/skia/include/core/SkColorFilter.h"
 
@@ -17,12 +19,94 @@ Layer::Layer()
 
 Layer::~Layer() = default;
 
+namespace {
+
+// Precedes every layer in memory. Keeps the layer itself aligned.
+struct alignas(LayerArena::kAlignment) AllocationHeader {
+  LayerArena* arena;
+};
+
+static_assert(sizeof(AllocationHeader) == LayerArena::kAlignment,
+              "The allocation header must not misalign layers.");
+
+std::atomic<size_t> g_heap_allocation_count(0);
+
+}  // namespace
+
+void* Layer::operator new(size_t size) {
+  g_heap_allocation_count++;
+  auto header = static_cast<AllocationHeader*>(
+      ::operator new(sizeof(AllocationHeader) + size));
+  header->arena = nullptr;
+  return header + 1;
+}
+
+void* Layer::operator new(size_t size, LayerArena* arena) {
+  if (arena == nullptr) {
+    return Layer::operator new(size);
+  }
+  auto header = static_cast<AllocationHeader*>(
+      arena->Allocate(sizeof(AllocationHeader) + size));
+  header->arena = arena;
+  return header + 1;
+}
+
+void Layer::operator delete(void* pointer) {
+  if (pointer == nullptr) {
+    return;
+  }
+  AllocationHeader* header = static_cast<AllocationHeader*>(pointer) - 1;
+  if (header->arena == nullptr) {
+    ::operator delete(header);
+  }
+  // Memory in an arena is released along with the arena.
+}
+
+void Layer::operator delete(void* pointer, LayerArena* arena) {
+  Layer::operator delete(pointer);
+}
+
+size_t Layer::heap_allocation_count() {
+  return g_heap_allocation_count;
+}
+
 void Layer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   if (!has_paint_bounds()) {
     set_paint_bounds(SkRect::MakeEmpty());
   }
 }
 
+void Layer::Diff(DiffContext* context,
+                 const Layer* old_layer,
+                 const SkMatrix& matrix) const {
+  if (old_layer != nullptr && old_layer->type() == type() &&
+      IsEquivalent(*old_layer)) {
+    return;
+  }
+
+  if (old_layer != nullptr) {
+    AddDamage(context, matrix, old_layer->paint_bounds());
+  }
+  AddDamage(context, matrix, paint_bounds());
+}
+
+bool Layer::IsEquivalent(const Layer& old_layer) const {
+  return false;
+}
+
+void Layer::AddDamage(DiffContext* context,
+                      const SkMatrix& matrix,
+                      const SkRect& bounds) {
+  if (bounds.isEmpty()) {
+    return;
+  }
+  SkRect device_bounds;
+  matrix.mapRect(&device_bounds, bounds);
+  context->damage.join(device_bounds);
+}
+
+void Layer::PrerollRasterCache(PrerollContext* context) {}
+
 #if defined(OS_FUCHSIA)
 void Layer::UpdateScene(SceneUpdateContext& context, mozart::Node* container) {}
 #endif
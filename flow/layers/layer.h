@@ -9,6 +9,8 @@
 #include <vector>
 
 #include "flutter/flow/instrumentation.h"
+#include "flutter/flow/layers/layer_arena.h"
+#include "flutter/flow/preroll_worker_pool.h"
 #include "flutter/flow/raster_cache.h"
 #include "flutter/flow/scene_update_context.h"
 #include "flutter/glue/trace_event.h"
@@ -32,15 +34,57 @@ class Layer {
   Layer();
   virtual ~Layer();
 
+  // Layers may be placed in a LayerArena with `new (arena) SomeLayer()`. Each
+  // allocation records where it came from so that deleting the layer only
+  // frees the memory of layers allocated on the heap.
+  static void* operator new(size_t size);
+  static void* operator new(size_t size, LayerArena* arena);
+  static void operator delete(void* pointer);
+  static void operator delete(void* pointer, LayerArena* arena);
+
+  // The number of layers allocated on the heap rather than in an arena over
+  // the lifetime of the process.
+  static size_t heap_allocation_count();
+
+  // The concrete type of the layer. Used to compare layers across frames
+  // without relying on RTTI.
+  enum class Type {
+    kUnknown,
+    kClipPath,
+    kClipRect,
+    kClipRRect,
+    kColorFilter,
+    kContainer,
+    kOpacity,
+    kPhysicalModel,
+    kPicture,
+    kShaderMask,
+    kTransform,
+  };
+
+  virtual Type type() const { return Type::kUnknown; }
+
   struct PrerollContext {
     RasterCache* raster_cache;
     GrContext* gr_context;
     SkColorSpace* dst_color_space;
     SkRect child_paint_bounds;
+    // If set, containers may preroll their children concurrently.
+    PrerollWorkerPool* worker_pool;
+    // If set, the subtree is being prerolled on a worker thread. Layers must
+    // not access the raster cache and add themselves to this list instead.
+    // Their PrerollRasterCache method is called back on the thread that owns
+    // the raster cache once the preroll of the subtree is done.
+    std::vector<Layer*>* deferred_raster_cache_layers;
   };
 
   virtual void Preroll(PrerollContext* context, const SkMatrix& matrix);
 
+  // Performs the raster cache lookups skipped while prerolling on a worker
+  // thread. The context is that of the container which prerolled this layer
+  // concurrently.
+  virtual void PrerollRasterCache(PrerollContext* context);
+
   struct PaintContext {
     SkCanvas& canvas;
     const Stopwatch& frame_time;
@@ -69,6 +113,21 @@ class Layer {
 
   virtual void Paint(PaintContext& context) = 0;
 
+  struct DiffContext {
+    // In the coordinate space of the root layer.
+    SkRect damage;
+    bool needs_full_repaint;
+  };
+
+  // Adds the bounds of the pixels this layer paints differently than
+  // |old_layer| did in the previous frame to the damage in |context|.
+  // |old_layer| may be null. |matrix| maps the coordinate space of the parent
+  // of this layer to that of the root layer. Both layers must have been
+  // prerolled.
+  virtual void Diff(DiffContext* context,
+                    const Layer* old_layer,
+                    const SkMatrix& matrix) const;
+
 #if defined(OS_FUCHSIA)
   virtual void UpdateScene(SceneUpdateContext& context,
                            mozart::Node* container);
@@ -96,6 +155,17 @@ class Layer {
     paint_bounds_ = paint_bounds;
   }
 
+ protected:
+  // Returns true if |old_layer| has the same properties as this layer, which
+  // means that both paint the same pixels as long as their children, if any,
+  // do as well. Only called with layers of the same type(). Layers that cannot
+  // make that guarantee are always considered damaged.
+  virtual bool IsEquivalent(const Layer& old_layer) const;
+
+  static void AddDamage(DiffContext* context,
+                        const SkMatrix& matrix,
+                        const SkRect& bounds);
+
  private:
   ContainerLayer* parent_;
   bool needs_system_composite_;
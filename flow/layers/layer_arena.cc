@@ -0,0 +1,60 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/layer_arena.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+
+#include "lib/ftl/logging.h"
+
+namespace flow {
+
+constexpr size_t LayerArena::kAlignment;
+constexpr size_t LayerArena::kMinBlockSize;
+constexpr size_t LayerArena::kMaxBlockSize;
+
+static inline size_t AlignUp(size_t size) {
+  return (size + LayerArena::kAlignment - 1) & ~(LayerArena::kAlignment - 1);
+}
+
+LayerArena::LayerArena()
+    : cursor_(nullptr),
+      limit_(nullptr),
+      next_block_size_(kMinBlockSize),
+      allocation_count_(0),
+      bytes_allocated_(0),
+      bytes_reserved_(0) {}
+
+LayerArena::~LayerArena() = default;
+
+void* LayerArena::Allocate(size_t size) {
+  size = AlignUp(std::max<size_t>(size, 1));
+
+  if (static_cast<size_t>(limit_ - cursor_) < size) {
+    // Blocks double in size so that large trees need few of them. The slack
+    // at the end of the previous block is abandoned.
+    const size_t block_size = std::max(next_block_size_, size + kAlignment);
+    next_block_size_ = std::min(next_block_size_ * 2, kMaxBlockSize);
+
+    blocks_.emplace_back(new char[block_size]);
+    char* block = blocks_.back().get();
+    bytes_reserved_ += block_size;
+
+    // operator new[] only guarantees the alignment of fundamental types.
+    const uintptr_t address = reinterpret_cast<uintptr_t>(block);
+    cursor_ = block + (AlignUp(address) - address);
+    limit_ = block + block_size;
+    FTL_DCHECK(static_cast<size_t>(limit_ - cursor_) >= size);
+  }
+
+  void* allocation = cursor_;
+  cursor_ += size;
+  allocation_count_++;
+  bytes_allocated_ += size;
+  return allocation;
+}
+
+}  // namespace flow
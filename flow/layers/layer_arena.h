@@ -0,0 +1,70 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_LAYERS_LAYER_ARENA_H_
+#define FLUTTER_FLOW_LAYERS_LAYER_ARENA_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+#include "lib/ftl/macros.h"
+
+namespace flow {
+
+/// A bump allocator for the layers of a single layer tree. Layers are placed
+/// in the arena with `new (arena) SomeLayer()` and are still owned and
+/// destroyed through the usual std::unique_ptr<Layer>. Destroying such a layer
+/// runs its destructor but does not release its memory. All of it is released
+/// in one go when the arena is destroyed, which must happen after all layers
+/// in it have been destroyed.
+///
+/// Since scene builders add layers in preorder, the layers of a tree end up
+/// laid out in the order in which they are prerolled and painted.
+///
+/// An arena may be handed from one thread to another but must not be used by
+/// two threads at the same time.
+class LayerArena {
+ public:
+  // Allocations are aligned to this many bytes.
+  static constexpr size_t kAlignment = 16;
+
+  LayerArena();
+
+  ~LayerArena();
+
+  // Returns |size| bytes of memory owned by the arena.
+  void* Allocate(size_t size);
+
+  // The number of calls to Allocate.
+  size_t allocation_count() const { return allocation_count_; }
+
+  // The number of bytes handed out by Allocate, including alignment padding.
+  size_t bytes_allocated() const { return bytes_allocated_; }
+
+  // The number of bytes obtained from the system.
+  size_t bytes_reserved() const { return bytes_reserved_; }
+
+  // The number of blocks obtained from the system.
+  size_t block_count() const { return blocks_.size(); }
+
+ private:
+  static constexpr size_t kMinBlockSize = 4 * 1024;
+  static constexpr size_t kMaxBlockSize = 64 * 1024;
+
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  char* cursor_;
+  char* limit_;
+  size_t next_block_size_;
+  size_t allocation_count_;
+  size_t bytes_allocated_;
+  size_t bytes_reserved_;
+
+  FTL_DISALLOW_COPY_AND_ASSIGN(LayerArena);
+};
+
+}  // namespace flow
+
+#endif  // FLUTTER_FLOW_LAYERS_LAYER_ARENA_H_
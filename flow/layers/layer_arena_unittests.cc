@@ -0,0 +1,76 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/layer_arena.h"
+
+#include <stdint.h>
+
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/layer_tree.h"
+#include "flutter/flow/layers/opacity_layer.h"
+#include "third_party/gtest/include/gtest/gtest.h"
+
+namespace {
+
+class CountingLayer : public flow::ContainerLayer {
+ public:
+  explicit CountingLayer(size_t* destroyed) : destroyed_(destroyed) {}
+
+  ~CountingLayer() override { (*destroyed_)++; }
+
+ private:
+  size_t* destroyed_;
+};
+
+}  // namespace
+
+TEST(LayerArena, AllocationsAreAligned) {
+  flow::LayerArena arena;
+  for (size_t size : {1, 3, 17, 100, 4096, 100000}) {
+    auto address = reinterpret_cast<uintptr_t>(arena.Allocate(size));
+    ASSERT_EQ(address % flow::LayerArena::kAlignment, 0u);
+  }
+  ASSERT_EQ(arena.allocation_count(), 6u);
+  ASSERT_GE(arena.bytes_reserved(), arena.bytes_allocated());
+}
+
+TEST(LayerArena, AllocationsAreContiguous) {
+  flow::LayerArena arena;
+  char* first = static_cast<char*>(arena.Allocate(32));
+  char* second = static_cast<char*>(arena.Allocate(32));
+  ASSERT_EQ(second, first + 32);
+  ASSERT_EQ(arena.block_count(), 1u);
+}
+
+TEST(LayerArena, LayersInArenaAreDestroyed) {
+  size_t destroyed = 0;
+  const size_t heap_allocations = flow::Layer::heap_allocation_count();
+
+  std::unique_ptr<flow::LayerArena> arena(new flow::LayerArena());
+  std::unique_ptr<flow::ContainerLayer> root(
+      new (arena.get()) CountingLayer(&destroyed));
+  for (size_t i = 0; i < 100; i++) {
+    root->Add(std::unique_ptr<flow::Layer>(
+        new (arena.get()) CountingLayer(&destroyed)));
+  }
+
+  ASSERT_EQ(flow::Layer::heap_allocation_count(), heap_allocations);
+  ASSERT_EQ(arena->allocation_count(), 101u);
+
+  flow::LayerTree tree;
+  tree.set_root_layer(std::move(root), std::move(arena));
+  ASSERT_NE(tree.arena(), nullptr);
+
+  tree.set_root_layer(nullptr);
+  ASSERT_EQ(destroyed, 101u);
+  ASSERT_EQ(tree.arena(), nullptr);
+}
+
+TEST(LayerArena, HeapLayersAreCounted) {
+  const size_t heap_allocations = flow::Layer::heap_allocation_count();
+  std::unique_ptr<flow::Layer> layer(new flow::OpacityLayer());
+  std::unique_ptr<flow::Layer> fallback(
+      new (static_cast<flow::LayerArena*>(nullptr)) flow::OpacityLayer());
+  ASSERT_EQ(flow::Layer::heap_allocation_count(), heap_allocations + 2);
+}
@@ -6,6 +6,7 @@
 
 #include "flutter/flow/layers/layer.h"
 #include "flutter/glue/trace_event.h"
+#include "lib/ftl/time/time_point.h"
 
 namespace flow {
 
@@ -27,6 +28,7 @@ void LayerTree::Raster(CompositorContext::ScopedFrame& frame,
 void LayerTree::Preroll(CompositorContext::ScopedFrame& frame,
                         bool ignore_raster_cache) {
   TRACE_EVENT0("flutter", "LayerTree::Preroll");
+  const ftl::TimePoint start = ftl::TimePoint::Now();
   SkColorSpace* color_space =
       frame.canvas() ? frame.canvas()->imageInfo().colorSpace() : nullptr;
   frame.context().raster_cache().SetCheckboardCacheImages(
@@ -34,8 +36,11 @@ void LayerTree::Preroll(CompositorContext::ScopedFrame& frame,
   Layer::PrerollContext context = {
       ignore_raster_cache ? nullptr : &frame.context().raster_cache(),
       frame.gr_context(), color_space, SkRect::MakeEmpty(),
+      frame.context().preroll_worker_pool(), nullptr,
   };
   root_layer_->Preroll(&context, SkMatrix::I());
+  frame.timing().preroll_time =
+      frame.timing().preroll_time + (ftl::TimePoint::Now() - start);
 }
 
 #if defined(OS_FUCHSIA)
@@ -52,13 +57,47 @@ void LayerTree::UpdateScene(SceneUpdateContext& context,
 }
 #endif
 
+SkIRect LayerTree::ComputeDamage(const LayerTree& old_tree) const {
+  TRACE_EVENT0("flutter", "LayerTree::ComputeDamage");
+
+  const SkIRect frame_rect = SkIRect::MakeSize(frame_size_);
+
+  if (frame_size_ != old_tree.frame_size_ || !root_layer_ ||
+      !old_tree.root_layer_ ||
+      checkerboard_raster_cache_images_ !=
+          old_tree.checkerboard_raster_cache_images_ ||
+      checkerboard_offscreen_layers_ !=
+          old_tree.checkerboard_offscreen_layers_) {
+    return frame_rect;
+  }
+
+  Layer::DiffContext context = {SkRect::MakeEmpty(), false};
+  root_layer_->Diff(&context, old_tree.root_layer_.get(), SkMatrix::I());
+
+  if (context.needs_full_repaint) {
+    return frame_rect;
+  }
+
+  SkIRect damage;
+  context.damage.roundOut(&damage);
+  // Anti-aliased edges may touch the pixels just outside the bounds.
+  damage.outset(1, 1);
+  if (!damage.intersect(frame_rect)) {
+    return SkIRect::MakeEmpty();
+  }
+  return damage;
+}
+
 void LayerTree::Paint(CompositorContext::ScopedFrame& frame) {
   Layer::PaintContext context = {*frame.canvas(), frame.context().frame_time(),
                                  frame.context().engine_time(),
                                  frame.context().memory_usage(),
                                  checkerboard_offscreen_layers_};
   TRACE_EVENT0("flutter", "LayerTree::Paint");
+  const ftl::TimePoint start = ftl::TimePoint::Now();
   root_layer_->Paint(context);
+  frame.timing().paint_time =
+      frame.timing().paint_time + (ftl::TimePoint::Now() - start);
 }
 
 }  // namespace flow
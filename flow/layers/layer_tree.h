@@ -11,6 +11,7 @@
 
 #include "flutter/flow/compositor_context.h"
 #include "flutter/flow/layers/layer.h"
+#include "flutter/flow/layers/layer_arena.h"
 #include "lib/ftl/macros.h"
 #include "lib/ftl/time/time_delta.h"
 #include "third_party/skia/include/core/SkSize.h"
@@ -39,12 +40,30 @@ class LayerTree {
 
   void Paint(CompositorContext::ScopedFrame& frame);
 
+  // Returns the bounds, in the coordinate space of the root layer, of the
+  // pixels that differ between this tree and |old_tree|. Both trees must have
+  // been prerolled. Returns the entire frame if the difference cannot be
+  // bounded.
+  SkIRect ComputeDamage(const LayerTree& old_tree) const;
+
   Layer* root_layer() const { return root_layer_.get(); }
 
   void set_root_layer(std::unique_ptr<Layer> root_layer) {
     root_layer_ = std::move(root_layer);
+    arena_.reset();
   }
 
+  // Also takes ownership of the arena that |root_layer| and its descendants
+  // were allocated in. The arena is destroyed after the layers.
+  void set_root_layer(std::unique_ptr<Layer> root_layer,
+                      std::unique_ptr<LayerArena> arena) {
+    root_layer_ = std::move(root_layer);
+    arena_ = std::move(arena);
+  }
+
+  // May be null if the layers were allocated on the heap.
+  const LayerArena* arena() const { return arena_.get(); }
+
   const SkISize& frame_size() const { return frame_size_; }
 
   void set_frame_size(const SkISize& frame_size) { frame_size_ = frame_size; }
@@ -83,6 +102,8 @@ class LayerTree {
  private:
   SkISize frame_size_;  // Physical pixels.
   uint32_t scene_version_;
+  // Must outlive |root_layer_|.
+  std::unique_ptr<LayerArena> arena_;
   std::unique_ptr<Layer> root_layer_;
   ftl::TimeDelta construction_time_;
   uint32_t rasterizer_tracing_threshold_;
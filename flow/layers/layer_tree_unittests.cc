@@ -0,0 +1,160 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/layer_tree.h"
+
+#include <vector>
+
+#include "flutter/flow/layers/backdrop_filter_layer.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/physical_model_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "third_party/gtest/include/gtest/gtest.h"
+
+namespace {
+
+const SkISize kFrameSize = SkISize::Make(800, 600);
+
+std::unique_ptr<flow::Layer> MakeModel(const SkRect& rect, SkColor color) {
+  std::unique_ptr<flow::PhysicalModelLayer> layer(
+      new flow::PhysicalModelLayer());
+  layer->set_rrect(SkRRect::MakeRect(rect));
+  layer->set_elevation(0);
+  layer->set_color(color);
+  return std::move(layer);
+}
+
+// Builds a tree with a root container holding a transform layer which in
+// turn holds one physical model per color.
+std::unique_ptr<flow::LayerTree> MakeTree(const SkMatrix& transform,
+                                          const std::vector<SkColor>& colors) {
+  std::unique_ptr<flow::TransformLayer> transform_layer(
+      new flow::TransformLayer());
+  transform_layer->set_transform(transform);
+  for (size_t i = 0; i < colors.size(); i++) {
+    transform_layer->Add(
+        MakeModel(SkRect::MakeXYWH(100 * i, 0, 50, 50), colors[i]));
+  }
+
+  std::unique_ptr<flow::ContainerLayer> root(new flow::ContainerLayer());
+  root->Add(std::move(transform_layer));
+
+  std::unique_ptr<flow::LayerTree> tree(new flow::LayerTree());
+  tree->set_frame_size(kFrameSize);
+  tree->set_root_layer(std::move(root));
+  return tree;
+}
+
+void Preroll(flow::LayerTree* tree) {
+  flow::CompositorContext context(nullptr);
+  auto frame = context.AcquireFrame(nullptr, nullptr, false);
+  tree->Preroll(frame, true);
+}
+
+}  // namespace
+
+TEST(LayerTreeDamage, IdenticalTreesHaveNoDamage) {
+  auto old_tree = MakeTree(SkMatrix::I(), {SK_ColorRED, SK_ColorBLUE});
+  auto new_tree = MakeTree(SkMatrix::I(), {SK_ColorRED, SK_ColorBLUE});
+  Preroll(old_tree.get());
+  Preroll(new_tree.get());
+
+  ASSERT_TRUE(new_tree->ComputeDamage(*old_tree).isEmpty());
+}
+
+TEST(LayerTreeDamage, ChangedLayerIsDamaged) {
+  auto old_tree = MakeTree(SkMatrix::I(), {SK_ColorRED, SK_ColorBLUE});
+  auto new_tree = MakeTree(SkMatrix::I(), {SK_ColorRED, SK_ColorGREEN});
+  Preroll(old_tree.get());
+  Preroll(new_tree.get());
+
+  // The physical model bounds include a 20 pixel margin for the shadow and
+  // the damage includes one more pixel for anti-aliasing.
+  ASSERT_EQ(new_tree->ComputeDamage(*old_tree),
+            SkIRect::MakeLTRB(100 - 21, 0, 150 + 21, 50 + 21));
+}
+
+TEST(LayerTreeDamage, DamageIsTransformedToRootSpace) {
+  const SkMatrix scale = SkMatrix::MakeScale(2, 2);
+  auto old_tree = MakeTree(scale, {SK_ColorRED, SK_ColorBLUE});
+  auto new_tree = MakeTree(scale, {SK_ColorGREEN, SK_ColorBLUE});
+  Preroll(old_tree.get());
+  Preroll(new_tree.get());
+
+  ASSERT_EQ(new_tree->ComputeDamage(*old_tree),
+            SkIRect::MakeLTRB(0, 0, 140 + 1, 140 + 1));
+}
+
+TEST(LayerTreeDamage, RemovedLayerIsDamaged) {
+  auto old_tree = MakeTree(SkMatrix::I(), {SK_ColorRED, SK_ColorBLUE});
+  auto new_tree = MakeTree(SkMatrix::I(), {SK_ColorRED});
+  Preroll(old_tree.get());
+  Preroll(new_tree.get());
+
+  ASSERT_EQ(new_tree->ComputeDamage(*old_tree),
+            SkIRect::MakeLTRB(100 - 21, 0, 150 + 21, 50 + 21));
+}
+
+TEST(LayerTreeDamage, ChangedTransformDamagesOldAndNewBounds) {
+  auto old_tree = MakeTree(SkMatrix::I(), {SK_ColorRED});
+  auto new_tree = MakeTree(SkMatrix::MakeTrans(200, 200), {SK_ColorRED});
+  Preroll(old_tree.get());
+  Preroll(new_tree.get());
+
+  ASSERT_EQ(new_tree->ComputeDamage(*old_tree),
+            SkIRect::MakeLTRB(0, 0, 270 + 1, 270 + 1));
+}
+
+TEST(LayerTreeDamage, ResizedFrameIsFullyDamaged) {
+  auto old_tree = MakeTree(SkMatrix::I(), {SK_ColorRED});
+  auto new_tree = MakeTree(SkMatrix::I(), {SK_ColorRED});
+  new_tree->set_frame_size(SkISize::Make(400, 300));
+  Preroll(old_tree.get());
+  Preroll(new_tree.get());
+
+  ASSERT_EQ(new_tree->ComputeDamage(*old_tree), SkIRect::MakeWH(400, 300));
+}
+
+TEST(LayerTreeDamage, BackdropFilterDamagesFullFrame) {
+  auto old_tree = MakeTree(SkMatrix::I(), {SK_ColorRED});
+  auto new_tree = MakeTree(SkMatrix::I(), {SK_ColorRED});
+  for (auto tree : {old_tree.get(), new_tree.get()}) {
+    auto root = static_cast<flow::ContainerLayer*>(tree->root_layer());
+    root->Add(std::unique_ptr<flow::Layer>(new flow::BackdropFilterLayer()));
+  }
+  Preroll(old_tree.get());
+  Preroll(new_tree.get());
+
+  ASSERT_EQ(new_tree->ComputeDamage(*old_tree),
+            SkIRect::MakeSize(kFrameSize));
+}
+
+TEST(LayerTreePreroll, ConcurrentPrerollMatchesSerialPreroll) {
+  std::vector<SkColor> colors(16, SK_ColorRED);
+
+  auto serial_tree = MakeTree(SkMatrix::MakeScale(2, 2), colors);
+  auto concurrent_tree = MakeTree(SkMatrix::MakeScale(2, 2), colors);
+  for (auto tree : {serial_tree.get(), concurrent_tree.get()}) {
+    // Give the root more than one child so that it fans out.
+    auto root = static_cast<flow::ContainerLayer*>(tree->root_layer());
+    for (size_t i = 0; i < 8; i++) {
+      root->Add(
+          MakeModel(SkRect::MakeXYWH(0, 100 * i, 50, 50), SK_ColorBLUE));
+    }
+  }
+
+  Preroll(serial_tree.get());
+
+  flow::CompositorContext context(nullptr);
+  context.SetPrerollWorkerCount(3);
+  ASSERT_NE(context.preroll_worker_pool(), nullptr);
+  {
+    auto frame = context.AcquireFrame(nullptr, nullptr, false);
+    concurrent_tree->Preroll(frame, true);
+  }
+
+  ASSERT_EQ(concurrent_tree->root_layer()->paint_bounds(),
+            serial_tree->root_layer()->paint_bounds());
+  ASSERT_TRUE(concurrent_tree->ComputeDamage(*serial_tree).isEmpty());
+}
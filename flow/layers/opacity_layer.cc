@@ -41,4 +41,9 @@ void OpacityLayer::Paint(PaintContext& context) {
   PaintChildren(context);
 }
 
+bool OpacityLayer::IsEquivalent(const Layer& old_layer) const {
+  const auto& old = static_cast<const OpacityLayer&>(old_layer);
+  return alpha_ == old.alpha_;
+}
+
 }  // namespace flow
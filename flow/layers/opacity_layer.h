@@ -14,10 +14,13 @@ class OpacityLayer : public ContainerLayer {
   OpacityLayer();
   ~OpacityLayer() override;
 
+  Type type() const override { return Type::kOpacity; }
+
   void set_alpha(int alpha) { alpha_ = alpha; }
 
  protected:
   void Paint(PaintContext& context) override;
+  bool IsEquivalent(const Layer& old_layer) const override;
 
 #if defined(OS_FUCHSIA)
   void UpdateScene(SceneUpdateContext& context,
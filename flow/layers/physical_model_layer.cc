@@ -92,4 +92,10 @@ void PhysicalModelLayer::DrawShadow(SkCanvas* canvas, const SkPath& path,
                               flags);
 }
 
+bool PhysicalModelLayer::IsEquivalent(const Layer& old_layer) const {
+  const auto& old = static_cast<const PhysicalModelLayer&>(old_layer);
+  return rrect_ == old.rrect_ && elevation_ == old.elevation_ &&
+         color_ == old.color_;
+}
+
 }  // namespace flow
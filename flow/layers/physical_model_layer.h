@@ -14,6 +14,8 @@ class PhysicalModelLayer : public ContainerLayer {
   PhysicalModelLayer();
   ~PhysicalModelLayer() override;
 
+  Type type() const override { return Type::kPhysicalModel; }
+
   void set_rrect(const SkRRect& rrect) { rrect_ = rrect; }
   void set_elevation(double elevation) { elevation_ = elevation; }
   void set_color(SkColor color) { color_ = color; }
@@ -24,6 +26,7 @@ class PhysicalModelLayer : public ContainerLayer {
  protected:
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
   void Paint(PaintContext& context) override;
+  bool IsEquivalent(const Layer& old_layer) const override;
 
 #if defined(OS_FUCHSIA)
   void UpdateScene(SceneUpdateContext& context,
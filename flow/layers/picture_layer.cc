@@ -21,7 +21,11 @@ PictureLayer::~PictureLayer() {
 }
 
 void PictureLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
-  if (auto cache = context->raster_cache) {
+  if (context->deferred_raster_cache_layers) {
+    preroll_matrix_ = matrix;
+    raster_cache_result_ = RasterCacheResult();
+    context->deferred_raster_cache_layers->push_back(this);
+  } else if (auto cache = context->raster_cache) {
     raster_cache_result_ = cache->GetPrerolledImage(
         context->gr_context, picture_.get(), matrix, context->dst_color_space,
         is_complex_, will_change_);
@@ -32,6 +36,14 @@ void PictureLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   context->child_paint_bounds = bounds;
 }
 
+void PictureLayer::PrerollRasterCache(PrerollContext* context) {
+  if (auto cache = context->raster_cache) {
+    raster_cache_result_ = cache->GetPrerolledImage(
+        context->gr_context, picture_.get(), preroll_matrix_,
+        context->dst_color_space, is_complex_, will_change_);
+  }
+}
+
 void PictureLayer::Paint(PaintContext& context) {
   FTL_DCHECK(picture_);
 
@@ -53,4 +65,10 @@ void PictureLayer::Paint(PaintContext& context) {
   }
 }
 
+bool PictureLayer::IsEquivalent(const Layer& old_layer) const {
+  const auto& old = static_cast<const PictureLayer&>(old_layer);
+  return offset_ == old.offset_ &&
+         picture_->uniqueID() == old.picture_->uniqueID();
+}
+
 }  // namespace flow
@@ -15,6 +15,8 @@ class PictureLayer : public Layer {
   PictureLayer();
   ~PictureLayer() override;
 
+  Type type() const override { return Type::kPicture; }
+
   void set_offset(const SkPoint& offset) { offset_ = offset; }
   void set_picture(sk_sp<SkPicture> picture) { picture_ = std::move(picture); }
 
@@ -24,14 +26,20 @@ class PictureLayer : public Layer {
   SkPicture* picture() const { return picture_.get(); }
 
   void Preroll(PrerollContext* frame, const SkMatrix& matrix) override;
+  void PrerollRasterCache(PrerollContext* context) override;
   void Paint(PaintContext& context) override;
 
+ protected:
+  bool IsEquivalent(const Layer& old_layer) const override;
+
  private:
   SkPoint offset_;
   sk_sp<SkPicture> picture_;
   bool is_complex_ = false;
   bool will_change_ = false;
   RasterCacheResult raster_cache_result_;
+  // The matrix of the last preroll. Used for deferred raster cache lookups.
+  SkMatrix preroll_matrix_;
 
   FTL_DISALLOW_COPY_AND_ASSIGN(PictureLayer);
 };
@@ -23,4 +23,10 @@ void ShaderMaskLayer::Paint(PaintContext& context) {
       SkRect::MakeWH(mask_rect_.width(), mask_rect_.height()), paint);
 }
 
+bool ShaderMaskLayer::IsEquivalent(const Layer& old_layer) const {
+  const auto& old = static_cast<const ShaderMaskLayer&>(old_layer);
+  return shader_ == old.shader_ && mask_rect_ == old.mask_rect_ &&
+         blend_mode_ == old.blend_mode_;
+}
+
 }  // namespace flow
@@ -16,6 +16,8 @@ class ShaderMaskLayer : public ContainerLayer {
   ShaderMaskLayer();
   ~ShaderMaskLayer() override;
 
+  Type type() const override { return Type::kShaderMask; }
+
   void set_shader(sk_sp<SkShader> shader) { shader_ = shader; }
 
   void set_mask_rect(const SkRect& mask_rect) { mask_rect_ = mask_rect; }
@@ -26,6 +28,7 @@ class ShaderMaskLayer : public ContainerLayer {
 
  protected:
   void Paint(PaintContext& context) override;
+  bool IsEquivalent(const Layer& old_layer) const override;
 
  private:
   sk_sp<SkShader> shader_;
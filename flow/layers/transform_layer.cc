@@ -23,6 +23,21 @@ void TransformLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   set_paint_bounds(context->child_paint_bounds);
 }
 
+void TransformLayer::Diff(DiffContext* context,
+                          const Layer* old_layer,
+                          const SkMatrix& matrix) const {
+  if (old_layer == nullptr || old_layer->type() != type() ||
+      !IsEquivalent(*old_layer)) {
+    Layer::Diff(context, old_layer, matrix);
+    return;
+  }
+
+  SkMatrix child_matrix;
+  child_matrix.setConcat(matrix, transform_);
+  DiffChildren(context, static_cast<const ContainerLayer&>(*old_layer),
+               child_matrix);
+}
+
 #if defined(OS_FUCHSIA)
 
 void TransformLayer::UpdateScene(SceneUpdateContext& context,
@@ -43,4 +58,9 @@ void TransformLayer::Paint(PaintContext& context) {
   PaintChildren(context);
 }
 
+bool TransformLayer::IsEquivalent(const Layer& old_layer) const {
+  const auto& old = static_cast<const TransformLayer&>(old_layer);
+  return transform_ == old.transform_;
+}
+
 }  // namespace flow
@@ -14,11 +14,18 @@ class TransformLayer : public ContainerLayer {
   TransformLayer();
   ~TransformLayer() override;
 
+  Type type() const override { return Type::kTransform; }
+
+  void Diff(DiffContext* context,
+            const Layer* old_layer,
+            const SkMatrix& matrix) const override;
+
   void set_transform(const SkMatrix& transform) { transform_ = transform; }
 
  protected:
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
   void Paint(PaintContext& context) override;
+  bool IsEquivalent(const Layer& old_layer) const override;
 
 #if defined(OS_FUCHSIA)
   void UpdateScene(SceneUpdateContext& context,
@@ -0,0 +1,104 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures the preroll of synthetic layer trees with about ten thousand layers
+// for a varying number of preroll worker threads.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "flutter/flow/compositor_context.h"
+#include "flutter/flow/layers/clip_rect_layer.h"
+#include "flutter/flow/layers/layer_tree.h"
+#include "flutter/flow/layers/physical_model_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "lib/ftl/time/time_delta.h"
+#include "lib/ftl/time/time_point.h"
+
+namespace {
+
+constexpr size_t kFanOut = 10;
+constexpr size_t kDepth = 4;
+constexpr size_t kIterations = 100;
+
+// Builds a subtree whose interior nodes alternate between transforms and
+// clips and whose leaves are physical models. With the constants above, the
+// tree built for the root holds 11111 layers.
+std::unique_ptr<flow::Layer> MakeSubtree(size_t depth, size_t* layer_count) {
+  (*layer_count)++;
+
+  if (depth == 0) {
+    std::unique_ptr<flow::PhysicalModelLayer> leaf(
+        new flow::PhysicalModelLayer());
+    leaf->set_rrect(SkRRect::MakeRectXY(SkRect::MakeWH(40, 40), 4, 4));
+    leaf->set_elevation(2);
+    leaf->set_color(SK_ColorBLUE);
+    return std::move(leaf);
+  }
+
+  std::unique_ptr<flow::ContainerLayer> node;
+  if (depth % 2 == 0) {
+    std::unique_ptr<flow::TransformLayer> transform(new flow::TransformLayer());
+    SkMatrix matrix;
+    matrix.setRotate(5);
+    matrix.postTranslate(10, 10);
+    transform->set_transform(matrix);
+    node = std::move(transform);
+  } else {
+    std::unique_ptr<flow::ClipRectLayer> clip(new flow::ClipRectLayer());
+    clip->set_clip_rect(SkRect::MakeWH(400, 400));
+    node = std::move(clip);
+  }
+
+  for (size_t i = 0; i < kFanOut; i++) {
+    node->Add(MakeSubtree(depth - 1, layer_count));
+  }
+  return std::move(node);
+}
+
+ftl::TimeDelta MeasurePreroll(flow::LayerTree* tree, size_t worker_count) {
+  flow::CompositorContext context(nullptr);
+  context.SetPrerollWorkerCount(worker_count);
+
+  ftl::TimeDelta total = ftl::TimeDelta::Zero();
+  for (size_t i = 0; i < kIterations; i++) {
+    auto frame = context.AcquireFrame(nullptr, nullptr, false);
+    const auto start = ftl::TimePoint::Now();
+    tree->Preroll(frame, true);
+    total = total + (ftl::TimePoint::Now() - start);
+  }
+  return total;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t layer_count = 0;
+  flow::LayerTree tree;
+  tree.set_frame_size(SkISize::Make(1080, 1920));
+  tree.set_root_layer(MakeSubtree(kDepth, &layer_count));
+
+  const size_t max_workers =
+      std::max<size_t>(std::thread::hardware_concurrency(), 1) - 1;
+
+  printf("%zu layers, %zu iterations\n", layer_count, kIterations);
+  printf("%8s %18s %10s\n", "workers", "preroll (us)", "speedup");
+
+  double serial_us = 0;
+  for (size_t workers = 0; workers <= max_workers;
+       workers = workers == 0 ? 1 : workers * 2) {
+    const double us =
+        static_cast<double>(MeasurePreroll(&tree, workers).ToMicroseconds()) /
+        kIterations;
+    if (workers == 0) {
+      serial_us = us;
+    }
+    printf("%8zu %18.1f %9.2fx\n", workers, us, serial_us / us);
+  }
+
+  return 0;
+}
@@ -0,0 +1,100 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/preroll_worker_pool.h"
+
+#include "lib/ftl/logging.h"
+
+namespace flow {
+
+PrerollWorkerPool::PrerollWorkerPool(size_t worker_count)
+    : task_(nullptr),
+      task_count_(0),
+      generation_(0),
+      active_workers_(0),
+      terminated_(false),
+      next_index_(0) {
+  for (size_t i = 0; i < worker_count; i++) {
+    workers_.emplace_back([this]() { WorkerMain(); });
+  }
+}
+
+PrerollWorkerPool::~PrerollWorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    terminated_ = true;
+  }
+  work_available_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void PrerollWorkerPool::ParallelFor(size_t count,
+                                    const std::function<void(size_t)>& task) {
+  if (count == 0) {
+    return;
+  }
+
+  if (workers_.empty() || count == 1) {
+    for (size_t i = 0; i < count; i++) {
+      task(i);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FTL_DCHECK(task_ == nullptr) << "ParallelFor calls may not be nested.";
+    task_ = &task;
+    task_count_ = count;
+    next_index_ = 0;
+    generation_++;
+  }
+  work_available_.notify_all();
+
+  RunTasks(task, count);
+
+  // Workers that woke up for this batch may still be running their last
+  // index. |task| must outlive them.
+  std::unique_lock<std::mutex> lock(mutex_);
+  task_ = nullptr;
+  work_finished_.wait(lock, [this]() { return active_workers_ == 0; });
+}
+
+void PrerollWorkerPool::WorkerMain() {
+  size_t last_generation = 0;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    work_available_.wait(lock, [this, last_generation]() {
+      return terminated_ || (task_ != nullptr && generation_ != last_generation);
+    });
+
+    if (terminated_) {
+      return;
+    }
+
+    last_generation = generation_;
+    const std::function<void(size_t)>& task = *task_;
+    const size_t count = task_count_;
+    active_workers_++;
+
+    lock.unlock();
+    RunTasks(task, count);
+    lock.lock();
+
+    if (--active_workers_ == 0) {
+      work_finished_.notify_one();
+    }
+  }
+}
+
+void PrerollWorkerPool::RunTasks(const std::function<void(size_t)>& task,
+                                 size_t count) {
+  for (size_t index = next_index_++; index < count; index = next_index_++) {
+    task(index);
+  }
+}
+
+}  // namespace flow
@@ -0,0 +1,59 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_PREROLL_WORKER_POOL_H_
+#define FLUTTER_FLOW_PREROLL_WORKER_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "lib/ftl/macros.h"
+
+namespace flow {
+
+/// A small pool of threads that layers use to preroll independent subtrees
+/// concurrently. Only one batch of work is in flight at a time and the thread
+/// submitting it participates in running it, so a pool with no workers simply
+/// runs everything on the calling thread.
+class PrerollWorkerPool {
+ public:
+  explicit PrerollWorkerPool(size_t worker_count);
+
+  ~PrerollWorkerPool();
+
+  size_t worker_count() const { return workers_.size(); }
+
+  /// Invokes |task| once for every index in [0, |count|) and returns once all
+  /// invocations have finished. Indices are handed out in increasing order to
+  /// whichever thread is free next. Must not be called from within |task|.
+  void ParallelFor(size_t count, const std::function<void(size_t)>& task);
+
+ private:
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable work_available_;
+  std::condition_variable work_finished_;
+  // Guarded by |mutex_|.
+  const std::function<void(size_t)>* task_;
+  size_t task_count_;
+  size_t generation_;
+  size_t active_workers_;
+  bool terminated_;
+  // Claimed without holding |mutex_|.
+  std::atomic<size_t> next_index_;
+
+  void WorkerMain();
+
+  void RunTasks(const std::function<void(size_t)>& task, size_t count);
+
+  FTL_DISALLOW_COPY_AND_ASSIGN(PrerollWorkerPool);
+};
+
+}  // namespace flow
+
+#endif  // FLUTTER_FLOW_PREROLL_WORKER_POOL_H_
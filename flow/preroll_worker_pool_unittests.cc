@@ -0,0 +1,54 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/preroll_worker_pool.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "third_party/gtest/include/gtest/gtest.h"
+
+TEST(PrerollWorkerPool, RunsEveryIndexOnce) {
+  flow::PrerollWorkerPool pool(3);
+  ASSERT_EQ(pool.worker_count(), 3u);
+
+  std::vector<std::atomic<int>> runs(1000);
+  for (auto& count : runs) {
+    count = 0;
+  }
+
+  pool.ParallelFor(runs.size(), [&runs](size_t index) { runs[index]++; });
+
+  for (const auto& count : runs) {
+    ASSERT_EQ(count, 1);
+  }
+}
+
+TEST(PrerollWorkerPool, CanBeReusedForManyBatches) {
+  flow::PrerollWorkerPool pool(2);
+  std::atomic<size_t> total(0);
+  for (size_t batch = 0; batch < 100; batch++) {
+    pool.ParallelFor(batch, [&total](size_t index) { total += index; });
+  }
+
+  // Sum over the batches of 0 + 1 + ... + (batch - 1).
+  size_t expected = 0;
+  for (size_t batch = 1; batch < 100; batch++) {
+    expected += batch * (batch - 1) / 2;
+  }
+  ASSERT_EQ(total, expected);
+}
+
+TEST(PrerollWorkerPool, RunsOnCallingThreadWithoutWorkers) {
+  flow::PrerollWorkerPool pool(0);
+  const auto caller = std::this_thread::get_id();
+  bool ran_elsewhere = false;
+  pool.ParallelFor(10, [&](size_t index) {
+    if (std::this_thread::get_id() != caller) {
+      ran_elsewhere = true;
+    }
+  });
+  ASSERT_FALSE(ran_elsewhere);
+}
@@ -4,12 +4,14 @@
 
 #include "flutter/flow/raster_cache.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "flutter/common/threads.h"
 #include "flutter/flow/paint_utils.h"
 #include "flutter/glue/trace_event.h"
 #include "lib/ftl/logging.h"
+#include "lib/ftl/time/time_point.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkPicture.h"
@@ -17,10 +19,21 @@
 
 namespace flow {
 
-RasterCache::RasterCache(size_t threshold)
-    : threshold_(threshold), checkerboard_images_(false), weak_factory_(this) {}
-
-RasterCache::~RasterCache() = default;
+RasterCache::RasterCache(size_t threshold,
+                         size_t max_bytes,
+                         size_t max_unused_frames)
+    : threshold_(threshold),
+      max_bytes_(max_bytes),
+      max_unused_frames_(std::max<size_t>(max_unused_frames, 1)),
+      bytes_used_(0),
+      access_clock_(0),
+      checkerboard_images_(false),
+      deferred_rasterization_(false),
+      weak_factory_(this) {}
+
+RasterCache::~RasterCache() {
+  ClearPendingPictures();
+}
 
 static bool CanRasterizePicture(SkPicture* picture) {
   if (picture == nullptr) {
@@ -68,6 +81,24 @@ static bool IsPictureWorthRasterizing(SkPicture* picture,
   return picture->approximateOpCount() > 10;
 }
 
+static SkImageInfo ImageInfoForPicture(SkPicture* picture,
+                                       const MatrixDecomposition& matrix,
+                                       SkColorSpace* dst_color_space) {
+  const SkVector3& scale = matrix.scale();
+  const SkRect& logical_rect = picture->cullRect();
+
+  return SkImageInfo::MakeN32Premul(
+      std::ceil(logical_rect.width() * std::abs(scale.x())),  // physical width
+      std::ceil(logical_rect.height() *
+                std::abs(scale.y())),  // physical height
+      sk_ref_sp(dst_color_space)       // colorspace
+      );
+}
+
+static size_t BytesForImageInfo(const SkImageInfo& image_info) {
+  return image_info.minRowBytes() * image_info.height();
+}
+
 RasterCacheResult RasterizePicture(SkPicture* picture,
                                    GrContext* context,
                                    const MatrixDecomposition& matrix,
@@ -78,12 +109,8 @@ RasterCacheResult RasterizePicture(SkPicture* picture,
   const SkVector3& scale = matrix.scale();
   SkRect logical_rect = picture->cullRect();
 
-  const SkImageInfo image_info = SkImageInfo::MakeN32Premul(
-      std::ceil(logical_rect.width() * std::abs(scale.x())),  // physical width
-      std::ceil(logical_rect.height() *
-                std::abs(scale.y())),  // physical height
-      sk_ref_sp(dst_color_space)       // colorspace
-      );
+  const SkImageInfo image_info =
+      ImageInfoForPicture(picture, matrix, dst_color_space);
 
   sk_sp<SkSurface> surface =
       context
@@ -111,10 +138,20 @@ RasterCacheResult RasterizePicture(SkPicture* picture,
       SkRect::MakeWH(
           logical_rect.width() * std::abs(scale.x()),
           logical_rect.height() * std::abs(scale.y())),  // source rect
-      logical_rect                                       // destination rect
+      logical_rect,                                      // destination rect
+      BytesForImageInfo(image_info),                     // bytes
   };
 }
 
+// The picture may contain references to textures that are associated with the
+// IO thread's context.
+static void UnrefPictureOnIOThread(sk_sp<SkPicture> picture) {
+  SkPicture* raw_picture = picture.release();
+  if (raw_picture) {
+    blink::Threads::IO()->PostTask([raw_picture]() { raw_picture->unref(); });
+  }
+}
+
 static inline size_t ClampSize(size_t value, size_t min, size_t max) {
   if (value > max) {
     return max;
@@ -148,48 +185,213 @@ RasterCacheResult RasterCache::GetPrerolledImage(
     return {};
   }
 
-  RasterCacheKey cache_key(*picture, matrix);
+  RasterCacheKey cache_key(*picture, matrix, dst_color_space);
 
   Entry& entry = cache_[cache_key];
   entry.access_count = ClampSize(entry.access_count + 1, 0, threshold_);
   entry.used_this_frame = true;
+  entry.unused_frame_count = 0;
+  entry.last_access = ++access_clock_;
+
+  if (entry.image.is_valid()) {
+    hit_count_.Increment();
+    return entry.image;
+  }
+
+  miss_count_.Increment();
 
   if (entry.access_count < threshold_ || threshold_ == 0) {
     // Frame threshold has not yet been reached.
     return {};
   }
 
-  if (!entry.image.is_valid()) {
-    entry.image =
-        RasterizePicture(picture, context, matrix, dst_color_space,
-                         checkerboard_images_);
+  const size_t bytes =
+      BytesForImageInfo(ImageInfoForPicture(picture, matrix, dst_color_space));
+
+  if (deferred_rasterization_) {
+    // Room for the image is made once it is rasterized.
+    if (!entry.pending && bytes <= max_bytes_) {
+      entry.pending = true;
+      pending_.push_back(
+          {cache_key, sk_ref_sp(picture), transformation_matrix});
+    }
+    return {};
+  }
+
+  // Make room for the image before doing the work of rasterizing it. Only
+  // entries not used in this frame are candidates for eviction, so |entry| is
+  // never one of them.
+  if (!EvictToFit(bytes)) {
+    // Everything in the cache is in use this frame or the image is larger than
+    // the entire budget. Draw the picture directly instead.
+    return {};
   }
 
+  entry.image = RasterizePicture(picture, context, matrix, dst_color_space,
+                                 checkerboard_images_);
+
   // We are not considering unrasterizable images. So if we don't have an image
   // by now, we know that rasterization itself failed.
   FTL_DCHECK(entry.image.is_valid());
 
+  bytes_used_ += entry.image.bytes();
+
   return entry.image;
 }
 
+bool RasterCache::EvictToFit(size_t bytes) {
+  if (bytes > max_bytes_) {
+    return false;
+  }
+
+  if (bytes_used_ + bytes <= max_bytes_) {
+    return true;
+  }
+
+  std::vector<RasterCacheKey::Map<Entry>::iterator> candidates;
+  for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+    const Entry& entry = it->second;
+    if (!entry.used_this_frame && entry.image.is_valid()) {
+      candidates.push_back(it);
+    }
+  }
+
+  std::sort(candidates.begin(), candidates.end(),
+            [](const RasterCacheKey::Map<Entry>::iterator& lhs,
+               const RasterCacheKey::Map<Entry>::iterator& rhs) {
+              return lhs->second.last_access < rhs->second.last_access;
+            });
+
+  for (auto it : candidates) {
+    if (bytes_used_ + bytes <= max_bytes_) {
+      break;
+    }
+    EraseEntry(it);
+  }
+
+  return bytes_used_ + bytes <= max_bytes_;
+}
+
+void RasterCache::EraseEntry(RasterCacheKey::Map<Entry>::iterator it) {
+  const RasterCacheResult& image = it->second.image;
+  if (image.is_valid()) {
+    FTL_DCHECK(bytes_used_ >= image.bytes());
+    bytes_used_ -= image.bytes();
+    eviction_count_.Increment();
+  }
+  cache_.erase(it);
+}
+
+void RasterCache::EvictUnusedEntries() {
+  std::vector<RasterCacheKey::Map<Entry>::iterator> unused;
+  for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+    const Entry& entry = it->second;
+    if (!entry.used_this_frame && entry.unused_frame_count > 0) {
+      unused.push_back(it);
+    }
+  }
+
+  for (auto it : unused) {
+    EraseEntry(it);
+  }
+}
+
 void RasterCache::SweepAfterFrame() {
   std::vector<RasterCacheKey::Map<Entry>::iterator> dead;
 
   for (auto it = cache_.begin(); it != cache_.end(); ++it) {
     Entry& entry = it->second;
-    if (!entry.used_this_frame) {
+    if (!entry.used_this_frame &&
+        ++entry.unused_frame_count >= max_unused_frames_) {
       dead.push_back(it);
     }
     entry.used_this_frame = false;
   }
 
   for (auto it : dead) {
-    cache_.erase(it);
+    EraseEntry(it);
   }
+
+  // The budget may have been lowered since the images were added.
+  EvictToFit(0);
+}
+
+bool RasterCache::RasterizePendingPictures(GrContext* context,
+                                           ftl::TimeDelta budget) {
+  TRACE_EVENT0("flutter", "RasterCache::RasterizePendingPictures");
+
+  const ftl::TimePoint deadline = ftl::TimePoint::Now() + budget;
+
+  while (!pending_.empty()) {
+    PendingPicture pending = std::move(pending_.front());
+    pending_.pop_front();
+
+    auto found = cache_.find(pending.key);
+    // The entry may have aged out or been evicted since it was queued.
+    if (found != cache_.end() && !found->second.image.is_valid()) {
+      Entry& entry = found->second;
+      entry.pending = false;
+
+      const MatrixDecomposition matrix(pending.transformation_matrix);
+      SkColorSpace* color_space = pending.key.color_space();
+      const size_t bytes = BytesForImageInfo(
+          ImageInfoForPicture(pending.picture.get(), matrix, color_space));
+
+      // Eviction only ever leaves tombstones behind, so |entry| stays valid.
+      if (EvictToFit(bytes)) {
+        entry.image = RasterizePicture(pending.picture.get(), context, matrix,
+                                       color_space, checkerboard_images_);
+        FTL_DCHECK(entry.image.is_valid());
+        bytes_used_ += entry.image.bytes();
+      }
+    }
+
+    UnrefPictureOnIOThread(std::move(pending.picture));
+
+    if (ftl::TimePoint::Now() >= deadline) {
+      break;
+    }
+  }
+
+  return !pending_.empty();
+}
+
+void RasterCache::ClearPendingPictures() {
+  for (auto& pending : pending_) {
+    UnrefPictureOnIOThread(std::move(pending.picture));
+  }
+  pending_.clear();
 }
 
 void RasterCache::Clear() {
+  ClearPendingPictures();
   cache_.clear();
+  bytes_used_ = 0;
+}
+
+void RasterCache::SetDeferredRasterization(bool deferred) {
+  if (deferred_rasterization_ == deferred) {
+    return;
+  }
+
+  deferred_rasterization_ = deferred;
+
+  if (!deferred_rasterization_) {
+    // Pictures still pending will be rasterized synchronously on their next
+    // access.
+    ClearPendingPictures();
+    for (auto& item : cache_) {
+      item.second.pending = false;
+    }
+  }
+}
+
+void RasterCache::SetMaxBytes(size_t max_bytes) {
+  max_bytes_ = max_bytes;
+}
+
+void RasterCache::SetMaxUnusedFrames(size_t max_unused_frames) {
+  max_unused_frames_ = std::max<size_t>(max_unused_frames, 1);
 }
 
 void RasterCache::SetCheckboardCacheImages(bool checkerboard) {
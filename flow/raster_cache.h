@@ -5,6 +5,7 @@
 #ifndef FLUTTER_FLOW_RASTER_CACHE_H_
 #define FLUTTER_FLOW_RASTER_CACHE_H_
 
+#include <deque>
 #include <memory>
 #include <unordered_map>
 
@@ -12,6 +13,7 @@
 #include "flutter/flow/raster_cache_key.h"
 #include "lib/ftl/macros.h"
 #include "lib/ftl/memory/weak_ptr.h"
+#include "lib/ftl/time/time_delta.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkSize.h"
 
@@ -23,10 +25,14 @@ class RasterCacheResult {
       : source_rect_(SkRect::MakeEmpty()),
         destination_rect_(SkRect::MakeEmpty()) {}
 
-  RasterCacheResult(sk_sp<SkImage> image, SkRect source, SkRect destination)
+  RasterCacheResult(sk_sp<SkImage> image,
+                    SkRect source,
+                    SkRect destination,
+                    size_t bytes)
       : image_(std::move(image)),
         source_rect_(source),
-        destination_rect_(destination) {}
+        destination_rect_(destination),
+        bytes_(bytes) {}
 
   operator bool() const { return static_cast<bool>(image_); }
 
@@ -38,15 +44,29 @@ class RasterCacheResult {
 
   const SkRect& destination_rect() const { return destination_rect_; }
 
+  // The number of bytes of backing store held by the image.
+  size_t bytes() const { return bytes_; }
+
  private:
   sk_sp<SkImage> image_;
   SkRect source_rect_;
   SkRect destination_rect_;
+  size_t bytes_ = 0;
 };
 
 class RasterCache {
  public:
-  explicit RasterCache(size_t threshold = 3);
+  static constexpr size_t kDefaultMaxBytes = 64 * 1024 * 1024;
+  static constexpr size_t kDefaultMaxUnusedFrames = 3;
+
+  // |threshold| is the number of accesses after which a picture is
+  // rasterized. Rasterized images are kept around for |max_unused_frames|
+  // consecutive frames without an access before being swept. When the bytes
+  // held by the cache would exceed |max_bytes|, the least recently used
+  // entries not used in the current frame are evicted first.
+  explicit RasterCache(size_t threshold = 3,
+                       size_t max_bytes = kDefaultMaxBytes,
+                       size_t max_unused_frames = kDefaultMaxUnusedFrames);
 
   ~RasterCache();
 
@@ -61,20 +81,92 @@ class RasterCache {
 
   void Clear();
 
+  // Drops the images of pictures that were not drawn in the most recent
+  // frame, as when memory is running low.
+  void EvictUnusedEntries();
+
   void SetCheckboardCacheImages(bool checkerboard);
 
+  void SetMaxBytes(size_t max_bytes);
+
+  void SetMaxUnusedFrames(size_t max_unused_frames);
+
+  // When enabled, pictures that cross the access threshold are not rasterized
+  // while the frame is being prerolled. Instead, they are queued up for
+  // |RasterizePendingPictures| which is meant to be called once the frame has
+  // been submitted. Till their images are ready, frames draw the pictures
+  // directly.
+  void SetDeferredRasterization(bool deferred);
+
+  bool deferred_rasterization() const { return deferred_rasterization_; }
+
+  bool HasPendingPictures() const { return !pending_.empty(); }
+
+  // Rasterizes pictures queued up in the deferred mode till none remain or the
+  // |budget| has been exhausted. At least one picture is rasterized per call.
+  // Returns true if pictures are still pending.
+  bool RasterizePendingPictures(GrContext* context, ftl::TimeDelta budget);
+
+  size_t max_bytes() const { return max_bytes_; }
+
+  size_t max_unused_frames() const { return max_unused_frames_; }
+
+  // The number of bytes currently held by rasterized images in the cache.
+  size_t bytes_used() const { return bytes_used_; }
+
+  size_t entry_count() const { return cache_.size(); }
+
+  // Lookups of pictures worthy of rasterization that were served from an
+  // existing image.
+  const Counter& hit_count() const { return hit_count_; }
+
+  // Lookups of pictures worthy of rasterization that could not be served from
+  // an existing image.
+  const Counter& miss_count() const { return miss_count_; }
+
+  // Rasterized images dropped because they aged out or because the cache was
+  // over budget.
+  const Counter& eviction_count() const { return eviction_count_; }
+
  private:
   struct Entry {
     bool used_this_frame = false;
     size_t access_count = 0;
+    size_t unused_frame_count = 0;
+    uint64_t last_access = 0;
+    bool pending = false;
     RasterCacheResult image;
   };
 
+  struct PendingPicture {
+    RasterCacheKey key;
+    sk_sp<SkPicture> picture;
+    SkMatrix transformation_matrix;
+  };
+
   const size_t threshold_;
+  size_t max_bytes_;
+  size_t max_unused_frames_;
+  size_t bytes_used_;
+  uint64_t access_clock_;
   RasterCacheKey::Map<Entry> cache_;
   bool checkerboard_images_;
+  bool deferred_rasterization_;
+  std::deque<PendingPicture> pending_;
+  Counter hit_count_;
+  Counter miss_count_;
+  Counter eviction_count_;
   ftl::WeakPtrFactory<RasterCache> weak_factory_;
 
+  // Evicts least recently used entries that were not accessed this frame
+  // till |bytes| more can be added without exceeding the budget. Returns
+  // false if that is not possible.
+  bool EvictToFit(size_t bytes);
+
+  void EraseEntry(RasterCacheKey::Map<Entry>::iterator it);
+
+  void ClearPendingPictures();
+
   FTL_DISALLOW_COPY_AND_ASSIGN(RasterCache);
 };
 
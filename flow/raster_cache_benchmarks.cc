@@ -0,0 +1,132 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Compares the raster cache key map against the std::unordered_map keyed only
+// on the picture ID that it replaced. Keys are generated the way pinch-zoom
+// generates them: a handful of pictures, each seen at many scales.
+
+#include <stdio.h>
+
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/flow/matrix_decomposition.h"
+#include "flutter/flow/raster_cache_key.h"
+#include "lib/ftl/time/time_delta.h"
+#include "lib/ftl/time/time_point.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+
+namespace {
+
+constexpr size_t kScalesPerPicture = 10;
+constexpr size_t kIterations = 1000;
+
+struct Entry {
+  bool used_this_frame = false;
+  size_t access_count = 0;
+};
+
+struct LegacyHash {
+  std::size_t operator()(const flow::RasterCacheKey& key) const {
+    return key.picture_id();
+  }
+};
+
+using LegacyMap = std::unordered_map<flow::RasterCacheKey,
+                                     Entry,
+                                     LegacyHash,
+                                     flow::RasterCacheKey::Equal>;
+
+using FlatMap = flow::RasterCacheKey::Map<Entry>;
+
+sk_sp<SkPicture> MakePicture() {
+  SkPictureRecorder recorder;
+  recorder.beginRecording(SkRect::MakeWH(100, 100));
+  recorder.getRecordingCanvas()->drawColor(SK_ColorRED);
+  return recorder.finishRecordingAsPicture();
+}
+
+std::vector<flow::RasterCacheKey> MakeKeys(
+    size_t count,
+    std::vector<sk_sp<SkPicture>>* pictures,
+    SkColorSpace* color_space) {
+  std::vector<flow::RasterCacheKey> keys;
+  for (size_t i = 0; i < count; i++) {
+    if (i % kScalesPerPicture == 0) {
+      pictures->push_back(MakePicture());
+    }
+    const float scale = 1.0f + (i % kScalesPerPicture) * 0.125f;
+    flow::MatrixDecomposition matrix(SkMatrix::MakeScale(scale, scale));
+    keys.emplace_back(*pictures->back(), matrix, color_space);
+  }
+  return keys;
+}
+
+// Simulates the per-frame accesses made by RasterCache::GetPrerolledImage.
+template <class Map>
+ftl::TimeDelta MeasureLookup(const std::vector<flow::RasterCacheKey>& keys) {
+  Map map;
+  const auto start = ftl::TimePoint::Now();
+  for (size_t i = 0; i < kIterations; i++) {
+    for (const auto& key : keys) {
+      Entry& entry = map[key];
+      entry.access_count++;
+      entry.used_this_frame = true;
+    }
+  }
+  return ftl::TimePoint::Now() - start;
+}
+
+// Simulates RasterCache::SweepAfterFrame where half the entries went unused.
+template <class Map>
+ftl::TimeDelta MeasureSweep(const std::vector<flow::RasterCacheKey>& keys) {
+  Map map;
+  ftl::TimeDelta total = ftl::TimeDelta::Zero();
+  for (size_t i = 0; i < kIterations; i++) {
+    for (size_t k = 0; k < keys.size(); k++) {
+      map[keys[k]].used_this_frame = (k + i) % 2 == 0;
+    }
+
+    const auto start = ftl::TimePoint::Now();
+    std::vector<typename Map::iterator> dead;
+    for (auto it = map.begin(); it != map.end(); ++it) {
+      Entry& entry = it->second;
+      if (!entry.used_this_frame) {
+        dead.push_back(it);
+      }
+      entry.used_this_frame = false;
+    }
+    for (auto it : dead) {
+      map.erase(it);
+    }
+    total = total + (ftl::TimePoint::Now() - start);
+  }
+  return total;
+}
+
+double NanosecondsPerOperation(ftl::TimeDelta delta, size_t entries) {
+  return static_cast<double>(delta.ToNanoseconds()) / (kIterations * entries);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+
+  printf("%8s %18s %18s %18s %18s\n", "entries", "lookup legacy (ns)",
+         "lookup flat (ns)", "sweep legacy (ns)", "sweep flat (ns)");
+
+  for (size_t count : {10, 100, 1000}) {
+    std::vector<sk_sp<SkPicture>> pictures;
+    const auto keys = MakeKeys(count, &pictures, srgb.get());
+
+    printf("%8zu %18.1f %18.1f %18.1f %18.1f\n", count,
+           NanosecondsPerOperation(MeasureLookup<LegacyMap>(keys), count),
+           NanosecondsPerOperation(MeasureLookup<FlatMap>(keys), count),
+           NanosecondsPerOperation(MeasureSweep<LegacyMap>(keys), count),
+           NanosecondsPerOperation(MeasureSweep<FlatMap>(keys), count));
+  }
+
+  return 0;
+}
@@ -6,6 +6,33 @@
 
 namespace flow {
 
-//
+// The 64-bit finalizer from MurmurHash3. Every input bit affects every output
+// bit, which keeps linear probe sequences short even though picture IDs are
+// sequential and scale keys of a single picture differ in few bits.
+static inline uint64_t MixBits(uint64_t value) {
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccdULL;
+  value ^= value >> 33;
+  value *= 0xc4ceb9fe1a85ec53ULL;
+  value ^= value >> 33;
+  return value;
+}
+
+std::size_t RasterCacheKey::Hash::operator()(const RasterCacheKey& key) const {
+  // Color spaces are compared by value, so only properties that are equal for
+  // equal color spaces may contribute to the hash.
+  const SkColorSpace* color_space = key.color_space_.get();
+  const uint64_t color_space_bits =
+      color_space == nullptr ? 0 : (color_space->gammaCloseToSRGB() ? 1 : 2);
+
+  uint64_t hash = MixBits(
+      static_cast<uint64_t>(key.picture_id_) |
+      (static_cast<uint64_t>(static_cast<uint32_t>(key.scale_key_.width()))
+       << 32));
+  hash = MixBits(
+      hash ^ static_cast<uint32_t>(key.scale_key_.height()) ^
+      (color_space_bits << 32));
+  return static_cast<std::size_t>(hash);
+}
 
 }  // namespace flow
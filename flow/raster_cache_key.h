@@ -5,9 +5,10 @@
 #ifndef FLUTTER_FLOW_RASTER_CACHE_KEY_H_
 #define FLUTTER_FLOW_RASTER_CACHE_KEY_H_
 
-#include <unordered_map>
+#include "flutter/flow/flat_hash_map.h"
 #include "flutter/flow/matrix_decomposition.h"
 #include "lib/ftl/macros.h"
+#include "third_party/skia/include/core/SkColorSpace.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkPicture.h"
 
@@ -15,35 +16,43 @@ namespace flow {
 
 class RasterCacheKey {
  public:
-  RasterCacheKey(const SkPicture& picture, const MatrixDecomposition& matrix)
+  RasterCacheKey(const SkPicture& picture,
+                 const MatrixDecomposition& matrix,
+                 SkColorSpace* color_space)
       : picture_id_(picture.uniqueID()),
         scale_key_(SkISize::Make(matrix.scale().x() * 1e3,
-                                 matrix.scale().y() * 1e3)) {}
+                                 matrix.scale().y() * 1e3)),
+        color_space_(sk_ref_sp(color_space)) {}
 
   uint32_t picture_id() const { return picture_id_; }
 
   const SkISize& scale_key() const { return scale_key_; }
 
+  SkColorSpace* color_space() const { return color_space_.get(); }
+
+  // Mixes all components of the key so that the scale variants of a single
+  // picture are spread across the table.
   struct Hash {
-    std::size_t operator()(RasterCacheKey const& key) const {
-      return key.picture_id_;
-    }
+    std::size_t operator()(const RasterCacheKey& key) const;
   };
 
   struct Equal {
-    constexpr bool operator()(const RasterCacheKey& lhs,
-                              const RasterCacheKey& rhs) const {
+    bool operator()(const RasterCacheKey& lhs,
+                    const RasterCacheKey& rhs) const {
       return lhs.picture_id_ == rhs.picture_id_ &&
-             lhs.scale_key_ == rhs.scale_key_;
+             lhs.scale_key_ == rhs.scale_key_ &&
+             SkColorSpace::Equals(lhs.color_space_.get(),
+                                  rhs.color_space_.get());
     }
   };
 
   template <class Value>
-  using Map = std::unordered_map<RasterCacheKey, Value, Hash, Equal>;
+  using Map = FlatHashMap<RasterCacheKey, Value, Hash, Equal>;
 
  private:
   uint32_t picture_id_;
   SkISize scale_key_;
+  sk_sp<SkColorSpace> color_space_;
 };
 
 }  // namespace flow
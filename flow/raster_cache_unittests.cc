@@ -2,7 +2,9 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include "flutter/common/threads.h"
 #include "flutter/flow/raster_cache.h"
+#include "flutter/fml/thread.h"
 #include "third_party/gtest/include/gtest/gtest.h"
 #include "third_party/skia/include/core/SkPicture.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
@@ -17,6 +19,16 @@ sk_sp<SkPicture> GetSamplePicture() {
   return recorder.finishRecordingAsPicture();
 }
 
+// Pictures whose rasterization was deferred are released on the IO thread.
+static void EnsureIOThreadForTesting() {
+  static fml::Thread* io_thread = nullptr;
+  if (io_thread == nullptr) {
+    io_thread = new fml::Thread("io_thread");
+    blink::Threads::Set(
+        blink::Threads({}, {}, {}, io_thread->GetTaskRunner()));
+  }
+}
+
 TEST(RasterCache, SimpleInitialization) {
   flow::RasterCache cache;
   ASSERT_TRUE(true);
@@ -68,7 +80,9 @@ TEST(RasterCache, ThresholdIsRespectedWhenZero) {
 
 TEST(RasterCache, SweepsRemoveUnusedFrames) {
   size_t threshold = 3;
-  flow::RasterCache cache(threshold);
+  size_t max_unused_frames = 1;
+  flow::RasterCache cache(threshold, flow::RasterCache::kDefaultMaxBytes,
+                          max_unused_frames);
 
   SkMatrix matrix = SkMatrix::I();
 
@@ -93,3 +107,184 @@ TEST(RasterCache, SweepsRemoveUnusedFrames) {
   ASSERT_FALSE(
       cache.GetPrerolledImage(NULL, picture.get(), matrix, srgb.get(), true, false));  // 5
 }
+
+TEST(RasterCache, EntriesAgeOutAfterUnusedFrames) {
+  size_t threshold = 1;
+  size_t max_unused_frames = 3;
+  flow::RasterCache cache(threshold, flow::RasterCache::kDefaultMaxBytes,
+                          max_unused_frames);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_TRUE(
+      cache.GetPrerolledImage(NULL, picture.get(), matrix, srgb.get(), true, false));
+  cache.SweepAfterFrame();
+  cache.SweepAfterFrame();  // Unused for one frame.
+  cache.SweepAfterFrame();  // Unused for two frames.
+  ASSERT_EQ(cache.entry_count(), 1u);
+  ASSERT_TRUE(
+      cache.GetPrerolledImage(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_EQ(cache.hit_count().count(), 1u);
+  cache.SweepAfterFrame();
+  cache.SweepAfterFrame();
+  cache.SweepAfterFrame();
+  cache.SweepAfterFrame();  // Unused for three frames.
+  ASSERT_EQ(cache.entry_count(), 0u);
+  ASSERT_EQ(cache.bytes_used(), 0u);
+  ASSERT_EQ(cache.eviction_count().count(), 1u);
+}
+
+TEST(RasterCache, TracksBytesOfRasterizedImages) {
+  size_t threshold = 1;
+  flow::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  auto result =
+      cache.GetPrerolledImage(NULL, picture.get(), matrix, srgb.get(), true, false);
+  ASSERT_TRUE(result);
+  ASSERT_EQ(result.bytes(), 150u * 100u * 4u);
+  ASSERT_EQ(cache.bytes_used(), result.bytes());
+  ASSERT_EQ(cache.miss_count().count(), 1u);
+
+  cache.Clear();
+  ASSERT_EQ(cache.bytes_used(), 0u);
+}
+
+TEST(RasterCache, EvictsLeastRecentlyUsedWhenOverBudget) {
+  size_t threshold = 1;
+  // Room for exactly two of the sample pictures.
+  size_t max_bytes = 2 * 150 * 100 * 4;
+  flow::RasterCache cache(threshold, max_bytes);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture1 = GetSamplePicture();
+  auto picture2 = GetSamplePicture();
+  auto picture3 = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, picture1.get(), matrix, srgb.get(),
+                                      true, false));
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, picture2.get(), matrix, srgb.get(),
+                                      true, false));
+  cache.SweepAfterFrame();
+
+  // Picture 1 is the least recently used and must make room for picture 3.
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, picture3.get(), matrix, srgb.get(),
+                                      true, false));
+  ASSERT_EQ(cache.eviction_count().count(), 1u);
+  ASSERT_EQ(cache.bytes_used(), max_bytes);
+  cache.SweepAfterFrame();
+
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, picture2.get(), matrix, srgb.get(),
+                                      true, false));
+  ASSERT_EQ(cache.hit_count().count(), 1u);
+}
+
+TEST(RasterCache, DoesNotEvictImagesUsedThisFrame) {
+  size_t threshold = 1;
+  size_t max_bytes = 150 * 100 * 4;
+  flow::RasterCache cache(threshold, max_bytes);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture1 = GetSamplePicture();
+  auto picture2 = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, picture1.get(), matrix, srgb.get(),
+                                      true, false));
+  ASSERT_FALSE(cache.GetPrerolledImage(NULL, picture2.get(), matrix,
+                                       srgb.get(), true, false));
+  ASSERT_EQ(cache.eviction_count().count(), 0u);
+  ASSERT_EQ(cache.bytes_used(), max_bytes);
+}
+
+TEST(RasterCache, EvictsEntriesUnusedInTheLastFrame) {
+  size_t threshold = 1;
+  flow::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture1 = GetSamplePicture();
+  auto picture2 = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, picture1.get(), matrix, srgb.get(),
+                                      true, false));
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, picture2.get(), matrix, srgb.get(),
+                                      true, false));
+  cache.SweepAfterFrame();
+
+  // Only picture 2 was drawn in the last frame.
+  cache.EvictUnusedEntries();
+  ASSERT_EQ(cache.eviction_count().count(), 1u);
+  ASSERT_EQ(cache.bytes_used(), 150u * 100u * 4u);
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, picture2.get(), matrix, srgb.get(),
+                                      true, false));
+  ASSERT_EQ(cache.hit_count().count(), 1u);
+}
+
+TEST(RasterCache, DeferredRasterizationPopulatesAfterFrame) {
+  EnsureIOThreadForTesting();
+
+  size_t threshold = 1;
+  flow::RasterCache cache(threshold);
+  cache.SetDeferredRasterization(true);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(
+      cache.GetPrerolledImage(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(
+      cache.GetPrerolledImage(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.HasPendingPictures());
+  ASSERT_EQ(cache.bytes_used(), 0u);
+  cache.SweepAfterFrame();
+
+  ASSERT_FALSE(cache.RasterizePendingPictures(
+      NULL, ftl::TimeDelta::FromMilliseconds(100)));
+  ASSERT_FALSE(cache.HasPendingPictures());
+  ASSERT_EQ(cache.bytes_used(), 150u * 100u * 4u);
+
+  ASSERT_TRUE(
+      cache.GetPrerolledImage(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_EQ(cache.hit_count().count(), 1u);
+}
+
+TEST(RasterCache, DeferredPicturesAreDroppedWithTheirEntries) {
+  EnsureIOThreadForTesting();
+
+  size_t threshold = 1;
+  size_t max_unused_frames = 1;
+  flow::RasterCache cache(threshold, flow::RasterCache::kDefaultMaxBytes,
+                          max_unused_frames);
+  cache.SetDeferredRasterization(true);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(
+      cache.GetPrerolledImage(NULL, picture.get(), matrix, srgb.get(), true, false));
+  cache.SweepAfterFrame();
+  cache.SweepAfterFrame();  // The entry ages out before it is rasterized.
+  ASSERT_EQ(cache.entry_count(), 0u);
+
+  ASSERT_FALSE(cache.RasterizePendingPictures(
+      NULL, ftl::TimeDelta::FromMilliseconds(100)));
+  ASSERT_EQ(cache.bytes_used(), 0u);
+}
@@ -7,7 +7,7 @@
 #include <memory>
 #include <mutex>
 
-#include "flutter/fml/mapping.h"
+#include "flutter/fml/resource_mapping.h"
 #include "flutter/fml/paths.h"
 #include "lib/ftl/build_config.h"
 #include "lib/ftl/logging.h"
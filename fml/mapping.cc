@@ -9,36 +9,14 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
-#include <type_traits>
-
-#include "lib/ftl/build_config.h"
 #include "lib/ftl/files/eintr_wrapper.h"
 
-#if OS_MACOSX
-
-#include "flutter/fml/platform/darwin/resource_mapping_darwin.h"
-using PlatformResourceMapping = fml::ResourceMappingDarwin;
-
-#else
-
-using PlatformResourceMapping = fml::FileMapping;
-
-#endif
-
 namespace fml {
 
 Mapping::Mapping() = default;
 
 Mapping::~Mapping() = default;
 
-bool PlatformHasResourcesBundle() {
-  return !std::is_same<PlatformResourceMapping, FileMapping>::value;
-}
-
-std::unique_ptr<Mapping> GetResourceMapping(const std::string& resource_name) {
-  return std::make_unique<PlatformResourceMapping>(resource_name);
-}
-
 FileMapping::FileMapping(const std::string& path)
     : FileMapping(ftl::UniqueFD{HANDLE_EINTR(::open(path.c_str(), O_RDONLY))}) {
 }
@@ -5,6 +5,7 @@
 #ifndef FLUTTER_FML_MAPPING_H_
 #define FLUTTER_FML_MAPPING_H_
 
+#include <memory>
 #include <string>
 
 #include "lib/ftl/files/unique_fd.h"
@@ -26,10 +27,6 @@ class Mapping {
   FTL_DISALLOW_COPY_AND_ASSIGN(Mapping);
 };
 
-bool PlatformHasResourcesBundle();
-
-std::unique_ptr<Mapping> GetResourceMapping(const std::string& resource_name);
-
 class FileMapping : public Mapping {
  public:
   FileMapping(const std::string& path);
@@ -38,11 +38,13 @@ bool MessageLoop::IsInitializedForCurrentThread() {
   return tls_message_loop.Get() != 0;
 }
 
-MessageLoop::MessageLoop()
-    : loop_(MessageLoopImpl::Create()),
-      task_runner_(ftl::MakeRefCounted<fml::TaskRunner>(loop_)) {
+MessageLoop::MessageLoop() : loop_(MessageLoopImpl::Create()) {
   FTL_CHECK(loop_);
-  FTL_CHECK(task_runner_);
+  for (size_t i = 0; i < kTaskPriorityCount; i++) {
+    task_runners_[i] = ftl::MakeRefCounted<fml::TaskRunner>(
+        loop_, static_cast<TaskPriority>(i));
+    FTL_CHECK(task_runners_[i]);
+  }
 }
 
 MessageLoop::~MessageLoop() = default;
@@ -55,8 +57,9 @@ void MessageLoop::Terminate() {
   loop_->DoTerminate();
 }
 
-ftl::RefPtr<ftl::TaskRunner> MessageLoop::GetTaskRunner() const {
-  return task_runner_;
+ftl::RefPtr<ftl::TaskRunner> MessageLoop::GetTaskRunner(
+    TaskPriority priority) const {
+  return task_runners_[static_cast<size_t>(priority)];
 }
 
 ftl::RefPtr<MessageLoopImpl> MessageLoop::GetLoopImpl() const {
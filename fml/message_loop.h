@@ -6,6 +6,7 @@
 #define FLUTTER_FML_MESSAGE_LOOP_H_
 
 #include "flutter/fml/task_observer.h"
+#include "flutter/fml/task_priority.h"
 #include "lib/ftl/macros.h"
 #include "lib/ftl/tasks/task_runner.h"
 
@@ -28,7 +29,10 @@ class MessageLoop {
 
   void RemoveTaskObserver(TaskObserver* observer);
 
-  ftl::RefPtr<ftl::TaskRunner> GetTaskRunner() const;
+  /// Returns a task runner whose tasks are serviced with the given priority
+  /// relative to the other tasks of this loop.
+  ftl::RefPtr<ftl::TaskRunner> GetTaskRunner(
+      TaskPriority priority = TaskPriority::Normal) const;
 
   static void EnsureInitializedForCurrentThread();
 
@@ -41,7 +45,7 @@ class MessageLoop {
   friend class MessageLoopImpl;
 
   ftl::RefPtr<MessageLoopImpl> loop_;
-  ftl::RefPtr<fml::TaskRunner> task_runner_;
+  ftl::RefPtr<fml::TaskRunner> task_runners_[kTaskPriorityCount];
 
   MessageLoop();
 
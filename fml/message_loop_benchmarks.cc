@@ -0,0 +1,93 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures how quickly a message loop services storms of tasks posted from
+// several threads at once, and how long a high priority task posted in the
+// middle of such a storm waits before it runs.
+
+#include <stdio.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "flutter/fml/thread.h"
+#include "lib/ftl/synchronization/waitable_event.h"
+#include "lib/ftl/time/time_delta.h"
+#include "lib/ftl/time/time_point.h"
+
+namespace {
+
+constexpr size_t kTasksPerThread = 100000;
+
+struct StormResult {
+  ftl::TimeDelta total;
+  ftl::TimeDelta high_priority_latency;
+};
+
+StormResult MeasureStorm(size_t thread_count) {
+  fml::Thread loop_thread("storm");
+  auto normal = loop_thread.GetTaskRunner();
+  auto high = loop_thread.GetTaskRunner(fml::TaskPriority::High);
+
+  const size_t task_count = thread_count * kTasksPerThread;
+  size_t run_count = 0;
+  ftl::AutoResetWaitableEvent all_run;
+  ftl::AutoResetWaitableEvent high_priority_run;
+  ftl::TimeDelta high_priority_latency;
+  std::atomic_bool post_high_priority(false);
+
+  const auto start = ftl::TimePoint::Now();
+
+  std::vector<std::thread> posters;
+  for (size_t i = 0; i < thread_count; i++) {
+    posters.emplace_back([&, i]() {
+      for (size_t j = 0; j < kTasksPerThread; j++) {
+        normal->PostTask([&]() {
+          if (++run_count == task_count) {
+            all_run.Signal();
+          }
+        });
+        if (i == 0 && j == kTasksPerThread / 2) {
+          post_high_priority = true;
+        }
+      }
+    });
+  }
+
+  while (!post_high_priority) {
+    std::this_thread::yield();
+  }
+  const auto high_priority_posted = ftl::TimePoint::Now();
+  high->PostTask([&]() {
+    high_priority_latency = ftl::TimePoint::Now() - high_priority_posted;
+    high_priority_run.Signal();
+  });
+
+  for (auto& poster : posters) {
+    poster.join();
+  }
+  all_run.Wait();
+  high_priority_run.Wait();
+
+  return {ftl::TimePoint::Now() - start, high_priority_latency};
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  printf("%8s %14s %22s\n", "threads", "per task (ns)",
+         "high priority wait (us)");
+
+  for (size_t thread_count : {1, 2, 4, 8}) {
+    const StormResult result = MeasureStorm(thread_count);
+    printf("%8zu %14.1f %22.1f\n", thread_count,
+           static_cast<double>(result.total.ToNanoseconds()) /
+               (thread_count * kTasksPerThread),
+           static_cast<double>(result.high_priority_latency.ToNanoseconds()) /
+               1000);
+  }
+
+  return 0;
+}
@@ -42,13 +42,20 @@ ftl::RefPtr<MessageLoopImpl> MessageLoopImpl::Create() {
   return ftl::MakeRefCounted<::PlatformMessageLoopImpl>();
 }
 
-MessageLoopImpl::MessageLoopImpl() : order_(0), terminated_(false) {}
+MessageLoopImpl::MessageLoopImpl()
+    : order_(0),
+      wake_up_time_(ftl::TimePoint::Max()),
+      immediate_wake_up_pending_(false),
+      terminated_(false),
+      running_tasks_(false) {}
 
 MessageLoopImpl::~MessageLoopImpl() = default;
 
-void MessageLoopImpl::PostTask(ftl::Closure task, ftl::TimePoint target_time) {
+void MessageLoopImpl::PostTask(ftl::Closure task,
+                               ftl::TimePoint target_time,
+                               TaskPriority priority) {
   FTL_DCHECK(task != nullptr);
-  RegisterTask(task, target_time);
+  RegisterTask(task, target_time, priority);
 }
 
 void MessageLoopImpl::RunExpiredTasksNow() {
@@ -94,8 +101,7 @@ void MessageLoopImpl::DoRun() {
   // should be destructed on the message loop's thread. We have just returned
   // from the implementations |Run| method which we know is on the correct
   // thread. Drop all pending tasks on the floor.
-  ftl::MutexLocker lock(&delayed_tasks_mutex_);
-  delayed_tasks_ = {};
+  DropPendingTasks();
 }
 
 void MessageLoopImpl::DoTerminate() {
@@ -104,49 +110,133 @@ void MessageLoopImpl::DoTerminate() {
 }
 
 void MessageLoopImpl::RegisterTask(ftl::Closure task,
-                                   ftl::TimePoint target_time) {
+                                   ftl::TimePoint target_time,
+                                   TaskPriority priority) {
   FTL_DCHECK(task != nullptr);
   if (terminated_) {
     // If the message loop has already been terminated, PostTask should destruct
     // |task| synchronously within this function.
     return;
   }
+
+  if (target_time <= ftl::TimePoint::Now()) {
+    immediate_tasks_[static_cast<size_t>(priority)].Push(std::move(task));
+    // The wake up must be requested after the push is complete. Otherwise
+    // the loop could wake up, miss the task and go back to sleep.
+    if (!immediate_wake_up_pending_.exchange(true)) {
+      ftl::MutexLocker lock(&delayed_tasks_mutex_);
+      wake_up_time_ = ftl::TimePoint::Now();
+      WakeUp(wake_up_time_);
+    }
+    return;
+  }
+
   ftl::MutexLocker lock(&delayed_tasks_mutex_);
-  delayed_tasks_.push({++order_, std::move(task), target_time});
-  WakeUp(delayed_tasks_.top().target_time);
+  delayed_tasks_.push({++order_, priority, std::move(task), target_time});
+  // Only the earliest deadline matters to the implementation.
+  if (target_time < wake_up_time_) {
+    wake_up_time_ = target_time;
+    WakeUp(wake_up_time_);
+  }
+}
+
+bool MessageLoopImpl::CollectImmediateTasks(TaskPriority priority,
+                                            ReadyTaskLists& lists) {
+  const size_t index = static_cast<size_t>(priority);
+  std::vector<ftl::Closure>& tasks = lists[index].tasks;
+  const size_t count = tasks.size();
+  ftl::Closure task;
+  while (immediate_tasks_[index].Pop(&task)) {
+    tasks.emplace_back(std::move(task));
+  }
+  return tasks.size() != count;
 }
 
 void MessageLoopImpl::RunExpiredTasks() {
   TRACE_EVENT0("fml", "MessageLoop::RunExpiredTasks");
-  std::vector<ftl::Closure> invocations;
+
+  // A task may spin a nested run loop, which services tasks too. The nested
+  // call must not disturb the lists the outer one is working through.
+  ReadyTaskLists nested_lists;
+  ReadyTaskLists& lists = running_tasks_ ? nested_lists : ready_tasks_;
+  const bool outermost = !running_tasks_;
+  running_tasks_ = true;
+
+  // Tasks posted from here on need to wake up the loop again.
+  immediate_wake_up_pending_.store(false);
 
   {
     ftl::MutexLocker lock(&delayed_tasks_mutex_);
 
-    if (delayed_tasks_.empty()) {
-      return;
-    }
-
     auto now = ftl::TimePoint::Now();
     while (!delayed_tasks_.empty()) {
       const auto& top = delayed_tasks_.top();
       if (top.target_time > now) {
         break;
       }
-      invocations.emplace_back(std::move(top.task));
+      lists[static_cast<size_t>(top.priority)].tasks.emplace_back(
+          std::move(top.task));
       delayed_tasks_.pop();
     }
 
-    WakeUp(delayed_tasks_.empty() ? ftl::TimePoint::Max()
-                                  : delayed_tasks_.top().target_time);
+    // The wake up that got us here has been used up. Always ask for the next
+    // one, which is right away if immediate tasks were posted in the
+    // meantime.
+    wake_up_time_ = delayed_tasks_.empty() ? ftl::TimePoint::Max()
+                                           : delayed_tasks_.top().target_time;
+    if (immediate_wake_up_pending_.load()) {
+      wake_up_time_ = now;
+    }
+    WakeUp(wake_up_time_);
+  }
+
+  for (size_t i = 0; i < kTaskPriorityCount; i++) {
+    CollectImmediateTasks(static_cast<TaskPriority>(i), lists);
   }
 
-  for (const auto& invocation : invocations) {
-    invocation();
+  while (true) {
+    size_t index = 0;
+    while (index < kTaskPriorityCount && lists[index].empty()) {
+      index++;
+    }
+    if (index == kTaskPriorityCount) {
+      break;
+    }
+
+    // High priority tasks posted while this batch runs jump ahead of the
+    // rest of it.
+    if (static_cast<TaskPriority>(index) != TaskPriority::High &&
+        CollectImmediateTasks(TaskPriority::High, lists)) {
+      continue;
+    }
+
+    ReadyTasks& ready = lists[index];
+    ftl::Closure task = std::move(ready.tasks[ready.next++]);
+    task();
     for (const auto& observer : task_observers_) {
       observer->DidProcessTask();
     }
   }
+
+  for (auto& ready : lists) {
+    ready.tasks.clear();
+    ready.next = 0;
+  }
+  running_tasks_ = !outermost;
+}
+
+void MessageLoopImpl::DropPendingTasks() {
+  {
+    ftl::MutexLocker lock(&delayed_tasks_mutex_);
+    delayed_tasks_ = {};
+  }
+
+  ftl::Closure task;
+  for (auto& queue : immediate_tasks_) {
+    while (queue.Pop(&task)) {
+      task = nullptr;
+    }
+  }
 }
 
 }  // namespace fml
@@ -10,8 +10,11 @@
 #include <queue>
 #include <set>
 #include <utility>
+#include <vector>
 
 #include "flutter/fml/message_loop.h"
+#include "flutter/fml/mpsc_queue.h"
+#include "flutter/fml/task_priority.h"
 #include "lib/ftl/functional/closure.h"
 #include "lib/ftl/macros.h"
 #include "lib/ftl/memory/ref_counted.h"
@@ -33,7 +36,9 @@ class MessageLoopImpl : public ftl::RefCountedThreadSafe<MessageLoopImpl> {
 
   virtual void WakeUp(ftl::TimePoint time_point) = 0;
 
-  void PostTask(ftl::Closure task, ftl::TimePoint target_time);
+  void PostTask(ftl::Closure task,
+                ftl::TimePoint target_time,
+                TaskPriority priority = TaskPriority::Normal);
 
   void AddTaskObserver(TaskObserver* observer);
 
@@ -51,13 +56,18 @@ class MessageLoopImpl : public ftl::RefCountedThreadSafe<MessageLoopImpl> {
  private:
   struct DelayedTask {
     size_t order;
+    TaskPriority priority;
     ftl::Closure task;
     ftl::TimePoint target_time;
 
     DelayedTask(size_t p_order,
+                TaskPriority p_priority,
                 ftl::Closure p_task,
                 ftl::TimePoint p_target_time)
-        : order(p_order), task(std::move(p_task)), target_time(p_target_time) {}
+        : order(p_order),
+          priority(p_priority),
+          task(std::move(p_task)),
+          target_time(p_target_time) {}
   };
 
   struct DelayedTaskCompare {
@@ -70,16 +80,47 @@ class MessageLoopImpl : public ftl::RefCountedThreadSafe<MessageLoopImpl> {
   using DelayedTaskQueue = std::
       priority_queue<DelayedTask, std::deque<DelayedTask>, DelayedTaskCompare>;
 
+  // The tasks of one priority collected by a call to |RunExpiredTasks|.
+  struct ReadyTasks {
+    std::vector<ftl::Closure> tasks;
+    size_t next = 0;
+
+    bool empty() const { return next == tasks.size(); }
+  };
+
+  using ReadyTaskLists = ReadyTasks[kTaskPriorityCount];
+
   std::set<TaskObserver*> task_observers_;
   ftl::Mutex delayed_tasks_mutex_;
   DelayedTaskQueue delayed_tasks_ FTL_GUARDED_BY(delayed_tasks_mutex_);
   size_t order_ FTL_GUARDED_BY(delayed_tasks_mutex_);
+  // The time the implementation was last asked to wake up at. All calls to
+  // |WakeUp| are made with the mutex held so that they are not reordered.
+  ftl::TimePoint wake_up_time_ FTL_GUARDED_BY(delayed_tasks_mutex_);
+  // Tasks that are ready to run as soon as they are posted are not sorted by
+  // time and bypass the mutex.
+  MPSCQueue<ftl::Closure> immediate_tasks_[kTaskPriorityCount];
+  // Set by the first immediate task posted since |RunExpiredTasks| last
+  // looked at the immediate task queues. Only that task wakes up the loop.
+  std::atomic_bool immediate_wake_up_pending_;
   std::atomic_bool terminated_;
+  // Only accessed on the thread of the loop. Reused across calls to
+  // |RunExpiredTasks| to avoid allocations.
+  ReadyTaskLists ready_tasks_;
+  bool running_tasks_;
 
-  void RegisterTask(ftl::Closure task, ftl::TimePoint target_time);
+  void RegisterTask(ftl::Closure task,
+                    ftl::TimePoint target_time,
+                    TaskPriority priority);
 
   void RunExpiredTasks();
 
+  // Moves all available immediate tasks of the given priority to |lists|.
+  // Returns whether there were any.
+  bool CollectImmediateTasks(TaskPriority priority, ReadyTaskLists& lists);
+
+  void DropPendingTasks();
+
   FTL_DISALLOW_COPY_AND_ASSIGN(MessageLoopImpl);
 };
 
@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/message_loop.h"
 #include "gtest/gtest.h"
@@ -284,3 +285,82 @@ TEST(MessageLoop, TaskObserverFire) {
   ASSERT_TRUE(started);
   ASSERT_TRUE(terminated);
 }
+
+TEST(MessageLoop, TasksRunInPriorityOrder) {
+  std::vector<int> order;
+  std::thread thread([&order]() {
+    fml::MessageLoop::EnsureInitializedForCurrentThread();
+    auto& loop = fml::MessageLoop::GetCurrent();
+    loop.GetTaskRunner(fml::TaskPriority::Low)->PostTask([&order]() {
+      order.push_back(3);
+      fml::MessageLoop::GetCurrent().Terminate();
+    });
+    loop.GetTaskRunner()->PostTask([&order]() { order.push_back(2); });
+    loop.GetTaskRunner(fml::TaskPriority::High)->PostTask([&order]() {
+      order.push_back(1);
+    });
+    loop.Run();
+  });
+  thread.join();
+  ASSERT_EQ(order, std::vector<int>({1, 2, 3}));
+}
+
+TEST(MessageLoop, HighPriorityTasksPreemptOtherReadyTasks) {
+  std::vector<int> order;
+  std::thread thread([&order]() {
+    fml::MessageLoop::EnsureInitializedForCurrentThread();
+    auto& loop = fml::MessageLoop::GetCurrent();
+    auto high = loop.GetTaskRunner(fml::TaskPriority::High);
+    loop.GetTaskRunner()->PostTask([&order, high]() {
+      order.push_back(1);
+      high->PostTask([&order]() { order.push_back(2); });
+    });
+    loop.GetTaskRunner()->PostTask([&order]() { order.push_back(3); });
+    loop.GetTaskRunner(fml::TaskPriority::Low)->PostTask([&order]() {
+      order.push_back(4);
+      fml::MessageLoop::GetCurrent().Terminate();
+    });
+    loop.Run();
+  });
+  thread.join();
+  ASSERT_EQ(order, std::vector<int>({1, 2, 3, 4}));
+}
+
+TEST(MessageLoop, TasksPostedFromManyThreadsAllRun) {
+  const size_t thread_count = 4;
+  const size_t tasks_per_thread = 1000;
+  fml::MessageLoop* loop = nullptr;
+  ftl::AutoResetWaitableEvent loop_ready;
+  ftl::AutoResetWaitableEvent all_run;
+  size_t run_count = 0;
+  std::thread loop_thread([&loop, &loop_ready]() {
+    fml::MessageLoop::EnsureInitializedForCurrentThread();
+    loop = &fml::MessageLoop::GetCurrent();
+    loop_ready.Signal();
+    loop->Run();
+  });
+  loop_ready.Wait();
+
+  std::vector<std::thread> posters;
+  for (size_t i = 0; i < thread_count; i++) {
+    posters.emplace_back([&]() {
+      auto runner = loop->GetTaskRunner();
+      for (size_t j = 0; j < tasks_per_thread; j++) {
+        runner->PostTask([&]() {
+          if (++run_count == thread_count * tasks_per_thread) {
+            all_run.Signal();
+          }
+        });
+      }
+    });
+  }
+  for (auto& poster : posters) {
+    poster.join();
+  }
+
+  all_run.Wait();
+  loop->GetTaskRunner()->PostTask(
+      []() { fml::MessageLoop::GetCurrent().Terminate(); });
+  loop_thread.join();
+  ASSERT_EQ(run_count, thread_count * tasks_per_thread);
+}
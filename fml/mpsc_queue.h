@@ -0,0 +1,107 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_MPSC_QUEUE_H_
+#define FLUTTER_FML_MPSC_QUEUE_H_
+
+#include <atomic>
+#include <utility>
+
+#include "lib/ftl/macros.h"
+
+namespace fml {
+
+/// An unbounded first-in first-out queue that any number of threads may push
+/// onto without taking a lock, while a single thread pops from it. Each push
+/// allocates one node, which is freed by the pop that returns it.
+///
+/// This is the intrusive node based queue by Dmitry Vyukov. A push is a
+/// single atomic exchange. A push that has only been partially performed may
+/// briefly hide the values pushed after it from the consumer. Pops report the
+/// queue as empty in that case. Callers must arrange for the consumer to try
+/// again once the push is complete.
+template <class T>
+class MPSCQueue {
+ public:
+  MPSCQueue() : head_(&stub_), tail_(&stub_) {}
+
+  ~MPSCQueue() {
+    T value;
+    while (Pop(&value)) {
+    }
+  }
+
+  /// May be called on any thread.
+  void Push(T value) { PushNode(new Node(std::move(value))); }
+
+  /// May only be called on the consumer thread. Returns false if no value is
+  /// available.
+  bool Pop(T* value) {
+    Node* tail = tail_;
+    Node* next = tail->next.load(std::memory_order_acquire);
+
+    if (tail == &stub_) {
+      if (next == nullptr) {
+        return false;
+      }
+      tail_ = next;
+      tail = next;
+      next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next != nullptr) {
+      tail_ = next;
+      *value = std::move(tail->value);
+      delete tail;
+      return true;
+    }
+
+    if (tail != head_.load(std::memory_order_acquire)) {
+      // A producer is in the middle of pushing after |tail|.
+      return false;
+    }
+
+    // |tail| is the last node. Push the stub behind it so that |tail| can be
+    // unlinked.
+    PushNode(&stub_);
+
+    next = tail->next.load(std::memory_order_acquire);
+    if (next != nullptr) {
+      tail_ = next;
+      *value = std::move(tail->value);
+      delete tail;
+      return true;
+    }
+
+    return false;
+  }
+
+ private:
+  struct Node {
+    std::atomic<Node*> next;
+    T value;
+
+    Node() : next(nullptr) {}
+
+    explicit Node(T p_value) : next(nullptr), value(std::move(p_value)) {}
+  };
+
+  Node stub_;
+  // Written by producers. The most recently pushed node.
+  std::atomic<Node*> head_;
+  // Only accessed by the consumer. The next node to pop, or the stub.
+  Node* tail_;
+
+  void PushNode(Node* node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node* previous = head_.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+  }
+
+  FTL_DISALLOW_COPY_AND_ASSIGN(MPSCQueue);
+};
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_MPSC_QUEUE_H_
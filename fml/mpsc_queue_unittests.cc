@@ -0,0 +1,81 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/mpsc_queue.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(MPSCQueue, EmptyQueuePopsNothing) {
+  fml::MPSCQueue<int> queue;
+  int value = 0;
+  ASSERT_FALSE(queue.Pop(&value));
+}
+
+TEST(MPSCQueue, ValuesArePoppedInOrder) {
+  fml::MPSCQueue<int> queue;
+  for (int i = 0; i < 10; i++) {
+    queue.Push(i);
+  }
+  int value = -1;
+  for (int i = 0; i < 10; i++) {
+    ASSERT_TRUE(queue.Pop(&value));
+    ASSERT_EQ(value, i);
+  }
+  ASSERT_FALSE(queue.Pop(&value));
+
+  // The queue remains usable once drained.
+  queue.Push(42);
+  ASSERT_TRUE(queue.Pop(&value));
+  ASSERT_EQ(value, 42);
+}
+
+TEST(MPSCQueue, RemainingValuesAreDestroyed) {
+  auto value = std::make_shared<int>(0);
+  {
+    fml::MPSCQueue<std::shared_ptr<int>> queue;
+    queue.Push(value);
+    queue.Push(value);
+    ASSERT_EQ(value.use_count(), 3);
+  }
+  ASSERT_EQ(value.use_count(), 1);
+}
+
+TEST(MPSCQueue, ConcurrentProducersKeepTheirOrder) {
+  const size_t producer_count = 4;
+  const size_t values_per_producer = 10000;
+  fml::MPSCQueue<size_t> queue;
+
+  std::vector<std::thread> producers;
+  for (size_t p = 0; p < producer_count; p++) {
+    producers.emplace_back([&queue, p]() {
+      for (size_t i = 0; i < values_per_producer; i++) {
+        queue.Push(p * values_per_producer + i);
+      }
+    });
+  }
+
+  std::vector<size_t> next(producer_count, 0);
+  size_t popped = 0;
+  while (popped < producer_count * values_per_producer) {
+    size_t value = 0;
+    if (!queue.Pop(&value)) {
+      std::this_thread::yield();
+      continue;
+    }
+    const size_t producer = value / values_per_producer;
+    ASSERT_EQ(value % values_per_producer, next[producer]);
+    next[producer]++;
+    popped++;
+  }
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  size_t value = 0;
+  ASSERT_FALSE(queue.Pop(&value));
+}
@@ -0,0 +1,32 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/resource_mapping.h"
+
+#include <type_traits>
+
+#include "lib/ftl/build_config.h"
+
+#if OS_MACOSX
+
+#include "flutter/fml/platform/darwin/resource_mapping_darwin.h"
+using PlatformResourceMapping = fml::ResourceMappingDarwin;
+
+#else
+
+using PlatformResourceMapping = fml::FileMapping;
+
+#endif
+
+namespace fml {
+
+bool PlatformHasResourcesBundle() {
+  return !std::is_same<PlatformResourceMapping, FileMapping>::value;
+}
+
+std::unique_ptr<Mapping> GetResourceMapping(const std::string& resource_name) {
+  return std::make_unique<PlatformResourceMapping>(resource_name);
+}
+
+}  // namespace fml
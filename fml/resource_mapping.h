@@ -0,0 +1,21 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_RESOURCE_MAPPING_H_
+#define FLUTTER_FML_RESOURCE_MAPPING_H_
+
+#include <memory>
+#include <string>
+
+#include "flutter/fml/mapping.h"
+
+namespace fml {
+
+bool PlatformHasResourcesBundle();
+
+std::unique_ptr<Mapping> GetResourceMapping(const std::string& resource_name);
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_RESOURCE_MAPPING_H_
@@ -0,0 +1,27 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_TASK_PRIORITY_H_
+#define FLUTTER_FML_TASK_PRIORITY_H_
+
+#include <stddef.h>
+
+namespace fml {
+
+/// The order in which a message loop services tasks that are ready to run.
+/// Tasks of the same priority run in the order they were posted in.
+enum class TaskPriority {
+  /// Work on the critical path of a frame, such as vsync callbacks.
+  High,
+  Normal,
+  /// Work that may wait for a frame to be produced, such as notifications of
+  /// finished image decodes.
+  Low,
+};
+
+constexpr size_t kTaskPriorityCount = 3;
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_TASK_PRIORITY_H_
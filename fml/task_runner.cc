@@ -11,24 +11,26 @@
 
 namespace fml {
 
-TaskRunner::TaskRunner(ftl::RefPtr<MessageLoopImpl> loop)
-    : loop_(std::move(loop)) {
+TaskRunner::TaskRunner(ftl::RefPtr<MessageLoopImpl> loop,
+                       TaskPriority priority)
+    : loop_(std::move(loop)), priority_(priority) {
   FTL_CHECK(loop_);
 }
 
 TaskRunner::~TaskRunner() = default;
 
 void TaskRunner::PostTask(ftl::Closure task) {
-  loop_->PostTask(std::move(task), ftl::TimePoint::Now());
+  loop_->PostTask(std::move(task), ftl::TimePoint::Now(), priority_);
 }
 
 void TaskRunner::PostTaskForTime(ftl::Closure task,
                                  ftl::TimePoint target_time) {
-  loop_->PostTask(std::move(task), target_time);
+  loop_->PostTask(std::move(task), target_time, priority_);
 }
 
 void TaskRunner::PostDelayedTask(ftl::Closure task, ftl::TimeDelta delay) {
-  loop_->PostTask(std::move(task), ftl::TimePoint::Now() + delay);
+  loop_->PostTask(std::move(task), ftl::TimePoint::Now() + delay,
+                  priority_);
 }
 
 bool TaskRunner::RunsTasksOnCurrentThread() {
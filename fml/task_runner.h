@@ -5,6 +5,7 @@
 #ifndef FLUTTER_FML_TASK_RUNNER_H_
 #define FLUTTER_FML_TASK_RUNNER_H_
 
+#include "flutter/fml/task_priority.h"
 #include "lib/ftl/macros.h"
 #include "lib/ftl/memory/ref_counted.h"
 #include "lib/ftl/tasks/task_runner.h"
@@ -25,8 +26,9 @@ class TaskRunner : public ftl::TaskRunner {
 
  private:
   ftl::RefPtr<MessageLoopImpl> loop_;
+  const TaskPriority priority_;
 
-  TaskRunner(ftl::RefPtr<MessageLoopImpl> loop);
+  TaskRunner(ftl::RefPtr<MessageLoopImpl> loop, TaskPriority priority);
 
   ~TaskRunner();
 
@@ -22,25 +22,30 @@ namespace fml {
 
 Thread::Thread(const std::string& name) : joined_(false) {
   ftl::AutoResetWaitableEvent latch;
-  ftl::RefPtr<ftl::TaskRunner> runner;
-  thread_ = std::make_unique<std::thread>([&latch, &runner, name]() -> void {
+  ftl::RefPtr<ftl::TaskRunner> runners[kTaskPriorityCount];
+  thread_ = std::make_unique<std::thread>([&latch, &runners, name]() -> void {
     SetCurrentThreadName(name);
     fml::MessageLoop::EnsureInitializedForCurrentThread();
     auto& loop = MessageLoop::GetCurrent();
-    runner = loop.GetTaskRunner();
+    for (size_t i = 0; i < kTaskPriorityCount; i++) {
+      runners[i] = loop.GetTaskRunner(static_cast<TaskPriority>(i));
+    }
     latch.Signal();
     loop.Run();
   });
   latch.Wait();
-  task_runner_ = runner;
+  for (size_t i = 0; i < kTaskPriorityCount; i++) {
+    task_runners_[i] = runners[i];
+  }
 }
 
 Thread::~Thread() {
   Join();
 }
 
-ftl::RefPtr<ftl::TaskRunner> Thread::GetTaskRunner() const {
-  return task_runner_;
+ftl::RefPtr<ftl::TaskRunner> Thread::GetTaskRunner(
+    TaskPriority priority) const {
+  return task_runners_[static_cast<size_t>(priority)];
 }
 
 void Thread::Join() {
@@ -48,7 +53,7 @@ void Thread::Join() {
     return;
   }
   joined_ = true;
-  task_runner_->PostTask([]() { MessageLoop::GetCurrent().Terminate(); });
+  GetTaskRunner()->PostTask([]() { MessageLoop::GetCurrent().Terminate(); });
   thread_->join();
 }
 
@@ -9,6 +9,7 @@
 #include <memory>
 #include <thread>
 
+#include "flutter/fml/task_priority.h"
 #include "lib/ftl/macros.h"
 #include "lib/ftl/tasks/task_runner.h"
 
@@ -20,13 +21,14 @@ class Thread {
 
   ~Thread();
 
-  ftl::RefPtr<ftl::TaskRunner> GetTaskRunner() const;
+  ftl::RefPtr<ftl::TaskRunner> GetTaskRunner(
+      TaskPriority priority = TaskPriority::Normal) const;
 
   void Join();
 
  private:
   std::unique_ptr<std::thread> thread_;
-  ftl::RefPtr<ftl::TaskRunner> task_runner_;
+  ftl::RefPtr<ftl::TaskRunner> task_runners_[kTaskPriorityCount];
   std::atomic_bool joined_;
 
   static void SetCurrentThreadName(const std::string& name);
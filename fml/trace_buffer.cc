@@ -0,0 +1,97 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/trace_buffer.h"
+
+#include <utility>
+
+#include "lib/ftl/logging.h"
+
+namespace fml {
+namespace tracing {
+
+constexpr size_t TraceBuffer::kDefaultCapacity;
+
+TraceBuffer::TraceBuffer(size_t capacity, Sink sink)
+    : capacity_(capacity),
+      sink_(std::move(sink)),
+      records_(new TraceRecord[capacity]),
+      size_(0),
+      depth_(0) {
+  FTL_DCHECK(capacity_ > 0);
+  open_begins_.reserve(capacity_);
+  folded_.resize(capacity_);
+}
+
+TraceBuffer::~TraceBuffer() {
+  Flush();
+}
+
+void TraceBuffer::Add(const TraceRecord& record) {
+  if (size_ == capacity_) {
+    Flush();
+  }
+
+  records_[size_++] = record;
+
+  switch (record.type) {
+    case TraceEventType::kBegin:
+      depth_++;
+      break;
+    case TraceEventType::kEnd:
+      // Ends of events that began before tracing was set up are unbalanced.
+      if (depth_ > 0) {
+        depth_--;
+      }
+      break;
+    default:
+      break;
+  }
+
+  if (depth_ == 0) {
+    Flush();
+  }
+}
+
+void TraceBuffer::Flush() {
+  if (size_ == 0) {
+    return;
+  }
+
+  // Fold the ends into their begins. What is left unmatched belongs to events
+  // that span more than one batch.
+  open_begins_.clear();
+  for (size_t i = 0; i < size_; i++) {
+    folded_[i] = false;
+    TraceRecord& record = records_[i];
+    if (record.type == TraceEventType::kBegin) {
+      open_begins_.push_back(i);
+    } else if (record.type == TraceEventType::kEnd && !open_begins_.empty()) {
+      TraceRecord& begin = records_[open_begins_.back()];
+      open_begins_.pop_back();
+      begin.type = TraceEventType::kComplete;
+      begin.end_timestamp = record.timestamp;
+      folded_[i] = true;
+    }
+  }
+
+  size_t count = 0;
+  for (size_t i = 0; i < size_; i++) {
+    if (folded_[i]) {
+      continue;
+    }
+    if (count != i) {
+      records_[count] = records_[i];
+    }
+    count++;
+  }
+
+  size_ = 0;
+  if (sink_) {
+    sink_(records_.get(), count);
+  }
+}
+
+}  // namespace tracing
+}  // namespace fml
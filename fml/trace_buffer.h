@@ -0,0 +1,94 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_TRACE_BUFFER_H_
+#define FLUTTER_FML_TRACE_BUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "lib/ftl/macros.h"
+
+namespace fml {
+namespace tracing {
+
+constexpr size_t kMaxTraceArgs = 2;
+// Argument values are copied and truncated to fit.
+constexpr size_t kTraceArgValueCapacity = 32;
+
+enum class TraceEventType : uint8_t {
+  kBegin,
+  kEnd,
+  // A begin and end on the same thread that were matched up when the buffer
+  // was flushed. Spans from |timestamp| to |end_timestamp|.
+  kComplete,
+  kAsyncBegin,
+  kAsyncEnd,
+  kInstant,
+};
+
+// A trace event as it is buffered. Categories, names and argument names are
+// not copied and must be string literals.
+struct TraceRecord {
+  TraceEventType type;
+  uint8_t arg_count;
+  // In microseconds, on the clock of the Dart timeline.
+  int64_t timestamp;
+  int64_t end_timestamp;
+  int64_t id;
+  const char* category;
+  const char* name;
+  const char* arg_names[kMaxTraceArgs];
+  char arg_values[kMaxTraceArgs][kTraceArgValueCapacity];
+};
+
+// Collects the trace events of a single thread and hands them to a sink in
+// batches, so that the work of recording them somewhere shared happens
+// outside of the traced code. A batch is handed over whenever the outermost
+// scoped event on the thread ends, or when the buffer fills up. Not thread
+// safe.
+class TraceBuffer {
+ public:
+  static constexpr size_t kDefaultCapacity = 1024;
+
+  // Called with the batches of events, oldest first. Matched begin and end
+  // events are replaced by complete events in the position of the begin.
+  using Sink = std::function<void(const TraceRecord* records, size_t count)>;
+
+  TraceBuffer(size_t capacity, Sink sink);
+
+  ~TraceBuffer();
+
+  void Add(const TraceRecord& record);
+
+  void Flush();
+
+  // The number of events waiting to be flushed.
+  size_t size() const { return size_; }
+
+  // The number of scoped events that have begun but not ended.
+  size_t depth() const { return depth_; }
+
+ private:
+  const size_t capacity_;
+  Sink sink_;
+  std::unique_ptr<TraceRecord[]> records_;
+  size_t size_;
+  size_t depth_;
+  // Indices of the begin events without a matching end yet. Kept around to
+  // avoid allocating on every flush.
+  std::vector<size_t> open_begins_;
+  // Whether the record at an index was folded into an earlier complete event.
+  std::vector<bool> folded_;
+
+  FTL_DISALLOW_COPY_AND_ASSIGN(TraceBuffer);
+};
+
+}  // namespace tracing
+}  // namespace fml
+
+#endif  // FLUTTER_FML_TRACE_BUFFER_H_
@@ -0,0 +1,117 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/trace_buffer.h"
+
+#include <vector>
+
+#include "flutter/fml/trace_event.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using fml::tracing::TraceBuffer;
+using fml::tracing::TraceEventType;
+using fml::tracing::TraceRecord;
+
+TraceRecord MakeRecord(TraceEventType type, const char* name, int64_t time) {
+  TraceRecord record = {};
+  record.type = type;
+  record.timestamp = time;
+  record.name = name;
+  return record;
+}
+
+class RecordingSink {
+ public:
+  TraceBuffer::Sink sink() {
+    return [this](const TraceRecord* records, size_t count) {
+      batches_++;
+      records_.insert(records_.end(), records, records + count);
+    };
+  }
+
+  size_t batches() const { return batches_; }
+
+  const std::vector<TraceRecord>& records() const { return records_; }
+
+ private:
+  size_t batches_ = 0;
+  std::vector<TraceRecord> records_;
+};
+
+}  // namespace
+
+TEST(TraceBuffer, FlushesWhenTheOutermostEventEnds) {
+  RecordingSink sink;
+  TraceBuffer buffer(16, sink.sink());
+
+  buffer.Add(MakeRecord(TraceEventType::kBegin, "outer", 1));
+  buffer.Add(MakeRecord(TraceEventType::kBegin, "inner", 2));
+  buffer.Add(MakeRecord(TraceEventType::kEnd, "inner", 3));
+  ASSERT_EQ(sink.batches(), 0u);
+  ASSERT_EQ(buffer.depth(), 1u);
+
+  buffer.Add(MakeRecord(TraceEventType::kEnd, "outer", 4));
+  ASSERT_EQ(sink.batches(), 1u);
+  ASSERT_EQ(buffer.size(), 0u);
+  ASSERT_EQ(buffer.depth(), 0u);
+}
+
+TEST(TraceBuffer, FoldsMatchedEventsIntoCompleteEvents) {
+  RecordingSink sink;
+  TraceBuffer buffer(16, sink.sink());
+
+  buffer.Add(MakeRecord(TraceEventType::kBegin, "outer", 1));
+  buffer.Add(MakeRecord(TraceEventType::kBegin, "inner", 2));
+  buffer.Add(MakeRecord(TraceEventType::kInstant, "instant", 3));
+  buffer.Add(MakeRecord(TraceEventType::kEnd, "inner", 4));
+  buffer.Add(MakeRecord(TraceEventType::kEnd, "outer", 5));
+
+  const std::vector<TraceRecord>& records = sink.records();
+  ASSERT_EQ(records.size(), 3u);
+  ASSERT_EQ(records[0].type, TraceEventType::kComplete);
+  ASSERT_STREQ(records[0].name, "outer");
+  ASSERT_EQ(records[0].timestamp, 1);
+  ASSERT_EQ(records[0].end_timestamp, 5);
+  ASSERT_EQ(records[1].type, TraceEventType::kComplete);
+  ASSERT_STREQ(records[1].name, "inner");
+  ASSERT_EQ(records[1].timestamp, 2);
+  ASSERT_EQ(records[1].end_timestamp, 4);
+  ASSERT_EQ(records[2].type, TraceEventType::kInstant);
+}
+
+TEST(TraceBuffer, KeepsEventsSpanningBatchesUnmatched) {
+  RecordingSink sink;
+  TraceBuffer buffer(2, sink.sink());
+
+  buffer.Add(MakeRecord(TraceEventType::kBegin, "outer", 1));
+  buffer.Add(MakeRecord(TraceEventType::kBegin, "inner", 2));
+  // The buffer is full, so adding flushes the open events first.
+  buffer.Add(MakeRecord(TraceEventType::kEnd, "inner", 3));
+  buffer.Add(MakeRecord(TraceEventType::kEnd, "outer", 4));
+
+  const std::vector<TraceRecord>& records = sink.records();
+  ASSERT_EQ(sink.batches(), 2u);
+  ASSERT_EQ(records.size(), 4u);
+  ASSERT_EQ(records[0].type, TraceEventType::kBegin);
+  ASSERT_EQ(records[1].type, TraceEventType::kBegin);
+  ASSERT_EQ(records[2].type, TraceEventType::kEnd);
+  ASSERT_EQ(records[3].type, TraceEventType::kEnd);
+}
+
+TEST(TraceBuffer, IgnoresUnbalancedEnds) {
+  RecordingSink sink;
+  TraceBuffer buffer(16, sink.sink());
+
+  buffer.Add(MakeRecord(TraceEventType::kEnd, "stray", 1));
+  ASSERT_EQ(buffer.depth(), 0u);
+  ASSERT_EQ(sink.records().size(), 1u);
+  ASSERT_EQ(sink.records()[0].type, TraceEventType::kEnd);
+}
+
+TEST(TraceBuffer, CategoriesAreEnabledByDefault) {
+  static_assert(fml::tracing::internal::IsCategoryEnabled("flutter"),
+                "Categories not listed as disabled must be enabled.");
+}
@@ -4,20 +4,231 @@
 
 #include "flutter/fml/trace_event.h"
 
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <atomic>
+
 #include "dart/runtime/include/dart_tools_api.h"
+#include "flutter/fml/thread_local.h"
+#include "flutter/fml/trace_buffer.h"
+#include "lib/ftl/logging.h"
+#include "lib/ftl/synchronization/mutex.h"
+#include "lib/ftl/synchronization/thread_annotations.h"
 
 namespace fml {
 namespace tracing {
+namespace {
+
+struct TraceFile {
+  ftl::Mutex mutex;
+  FILE* file FTL_GUARDED_BY(mutex) = nullptr;
+  bool has_events FTL_GUARDED_BY(mutex) = false;
+};
+
+// Leaked so that threads exiting late can still flush their events.
+TraceFile& GetTraceFile() {
+  static TraceFile* trace_file = new TraceFile();
+  return *trace_file;
+}
+
+std::atomic<bool> g_tracing_to_file(false);
+
+std::atomic<int64_t> g_next_thread_id(1);
+
+void WriteJSONString(FILE* file, const char* string) {
+  fputc('"', file);
+  for (const char* c = string; *c != '\0'; c++) {
+    if (*c == '"' || *c == '\\') {
+      fputc('\\', file);
+      fputc(*c, file);
+    } else if (static_cast<unsigned char>(*c) < 0x20) {
+      fprintf(file, "\\u%04x", *c);
+    } else {
+      fputc(*c, file);
+    }
+  }
+  fputc('"', file);
+}
+
+void WriteChromeTraceEvent(FILE* file,
+                           int64_t thread_id,
+                           const TraceRecord& record) {
+  static const int kProcessId = getpid();
+
+  const char* phase = "i";
+  switch (record.type) {
+    case TraceEventType::kBegin:
+      phase = "B";
+      break;
+    case TraceEventType::kEnd:
+      phase = "E";
+      break;
+    case TraceEventType::kComplete:
+      phase = "X";
+      break;
+    case TraceEventType::kAsyncBegin:
+      phase = "b";
+      break;
+    case TraceEventType::kAsyncEnd:
+      phase = "e";
+      break;
+    case TraceEventType::kInstant:
+      phase = "i";
+      break;
+  }
+
+  fprintf(file, "{\"ph\":\"%s\",\"pid\":%d,\"tid\":%lld,\"ts\":%lld", phase,
+          kProcessId, static_cast<long long>(thread_id),
+          static_cast<long long>(record.timestamp));
+  fputs(",\"name\":", file);
+  WriteJSONString(file, record.name);
+  if (record.category != nullptr) {
+    fputs(",\"cat\":", file);
+    WriteJSONString(file, record.category);
+  }
+  if (record.type == TraceEventType::kComplete) {
+    fprintf(file, ",\"dur\":%lld",
+            static_cast<long long>(record.end_timestamp - record.timestamp));
+  }
+  if (record.type == TraceEventType::kAsyncBegin ||
+      record.type == TraceEventType::kAsyncEnd) {
+    fprintf(file, ",\"id\":%lld", static_cast<long long>(record.id));
+  }
+  if (record.type == TraceEventType::kInstant) {
+    fputs(",\"s\":\"t\"", file);
+  }
+  if (record.arg_count > 0) {
+    fputs(",\"args\":{", file);
+    for (size_t i = 0; i < record.arg_count; i++) {
+      if (i > 0) {
+        fputc(',', file);
+      }
+      WriteJSONString(file, record.arg_names[i]);
+      fputc(':', file);
+      WriteJSONString(file, record.arg_values[i]);
+    }
+    fputc('}', file);
+  }
+  fputc('}', file);
+}
+
+void WriteToTraceFile(int64_t thread_id,
+                      const TraceRecord* records,
+                      size_t count) {
+  TraceFile& trace_file = GetTraceFile();
+  ftl::MutexLocker lock(&trace_file.mutex);
+  if (trace_file.file == nullptr) {
+    return;
+  }
+  for (size_t i = 0; i < count; i++) {
+    // The trailing bracket of the array is optional in this format, so the
+    // file is valid however abruptly tracing ends.
+    fputs(trace_file.has_events ? ",\n" : "[\n", trace_file.file);
+    trace_file.has_events = true;
+    WriteChromeTraceEvent(trace_file.file, thread_id, records[i]);
+  }
+  fflush(trace_file.file);
+}
+
+void WriteToDartTimeline(const TraceRecord* records, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    const TraceRecord& record = records[i];
+
+    Dart_Timeline_Event_Type type = Dart_Timeline_Event_Instant;
+    int64_t timestamp1_or_async_id = 0;
+    switch (record.type) {
+      case TraceEventType::kBegin:
+        type = Dart_Timeline_Event_Begin;
+        break;
+      case TraceEventType::kEnd:
+        type = Dart_Timeline_Event_End;
+        break;
+      case TraceEventType::kComplete:
+        type = Dart_Timeline_Event_Duration;
+        timestamp1_or_async_id = record.end_timestamp;
+        break;
+      case TraceEventType::kAsyncBegin:
+        type = Dart_Timeline_Event_Async_Begin;
+        timestamp1_or_async_id = record.id;
+        break;
+      case TraceEventType::kAsyncEnd:
+        type = Dart_Timeline_Event_Async_End;
+        timestamp1_or_async_id = record.id;
+        break;
+      case TraceEventType::kInstant:
+        type = Dart_Timeline_Event_Instant;
+        break;
+    }
+
+    const char* arg_values[kMaxTraceArgs];
+    for (size_t j = 0; j < record.arg_count; j++) {
+      arg_values[j] = record.arg_values[j];
+    }
+    Dart_TimelineEvent(record.name,             // label
+                       record.timestamp,        // timestamp0
+                       timestamp1_or_async_id,  // timestamp1_or_async_id
+                       type,                    // event type
+                       record.arg_count,        // argument_count
+                       const_cast<const char**>(record.arg_names),
+                       arg_values);
+  }
+}
+
+TraceBuffer* CreateCurrentThreadTraceBuffer() {
+  const int64_t thread_id = g_next_thread_id.fetch_add(1);
+  return new TraceBuffer(TraceBuffer::kDefaultCapacity,
+                         [thread_id](const TraceRecord* records, size_t count) {
+                           WriteToDartTimeline(records, count);
+                           if (g_tracing_to_file.load()) {
+                             WriteToTraceFile(thread_id, records, count);
+                           }
+                         });
+}
+
+FML_THREAD_LOCAL ThreadLocal tls_trace_buffer([](intptr_t value) {
+  delete reinterpret_cast<TraceBuffer*>(value);
+});
+
+TraceBuffer& GetCurrentThreadTraceBuffer() {
+  TraceBuffer* buffer = reinterpret_cast<TraceBuffer*>(tls_trace_buffer.Get());
+  if (buffer == nullptr) {
+    buffer = CreateCurrentThreadTraceBuffer();
+    tls_trace_buffer.Set(reinterpret_cast<intptr_t>(buffer));
+  }
+  return *buffer;
+}
+
+void AddTraceEvent(TraceEventType type,
+                   TraceArg category_group,
+                   TraceArg name,
+                   TraceIDArg id,
+                   size_t arg_count,
+                   const TraceArg* arg_names,
+                   const TraceArg* arg_values) {
+  TraceRecord record;
+  record.type = type;
+  record.arg_count = static_cast<uint8_t>(arg_count);
+  record.timestamp = Dart_TimelineGetMicros();
+  record.end_timestamp = 0;
+  record.id = id;
+  record.category = category_group;
+  record.name = name;
+  for (size_t i = 0; i < arg_count; i++) {
+    record.arg_names[i] = arg_names[i];
+    strncpy(record.arg_values[i], arg_values[i] ? arg_values[i] : "",
+            kTraceArgValueCapacity - 1);
+    record.arg_values[i][kTraceArgValueCapacity - 1] = '\0';
+  }
+  GetCurrentThreadTraceBuffer().Add(record);
+}
+
+}  // namespace
 
 void TraceEvent0(TraceArg category_group, TraceArg name) {
-  Dart_TimelineEvent(name,                       // label
-                     Dart_TimelineGetMicros(),   // timestamp0
-                     0,                          // timestamp1_or_async_id
-                     Dart_Timeline_Event_Begin,  // event type
-                     0,                          // argument_count
-                     nullptr,                    // argument_names
-                     nullptr                     // argument_values
-                     );
+  AddTraceEvent(TraceEventType::kBegin, category_group, name, 0, 0, nullptr,
+                nullptr);
 }
 
 void TraceEvent1(TraceArg category_group,
@@ -26,14 +237,8 @@ void TraceEvent1(TraceArg category_group,
                  TraceArg arg1_val) {
   const char* arg_names[] = {arg1_name};
   const char* arg_values[] = {arg1_val};
-  Dart_TimelineEvent(name,                       // label
-                     Dart_TimelineGetMicros(),   // timestamp0
-                     0,                          // timestamp1_or_async_id
-                     Dart_Timeline_Event_Begin,  // event type
-                     1,                          // argument_count
-                     arg_names,                  // argument_names
-                     arg_values                  // argument_values
-                     );
+  AddTraceEvent(TraceEventType::kBegin, category_group, name, 0, 1, arg_names,
+                arg_values);
 }
 
 void TraceEvent2(TraceArg category_group,
@@ -44,51 +249,26 @@ void TraceEvent2(TraceArg category_group,
                  TraceArg arg2_val) {
   const char* arg_names[] = {arg1_name, arg2_name};
   const char* arg_values[] = {arg1_val, arg2_val};
-  Dart_TimelineEvent(name,                       // label
-                     Dart_TimelineGetMicros(),   // timestamp0
-                     0,                          // timestamp1_or_async_id
-                     Dart_Timeline_Event_Begin,  // event type
-                     2,                          // argument_count
-                     arg_names,                  // argument_names
-                     arg_values                  // argument_values
-                     );
+  AddTraceEvent(TraceEventType::kBegin, category_group, name, 0, 2, arg_names,
+                arg_values);
 }
 
 void TraceEventEnd(TraceArg name) {
-  Dart_TimelineEvent(name,                      // label
-                     Dart_TimelineGetMicros(),  // timestamp0
-                     0,                         // timestamp1_or_async_id
-                     Dart_Timeline_Event_End,   // event type
-                     0,                         // argument_count
-                     nullptr,                   // argument_names
-                     nullptr                    // argument_values
-                     );
+  AddTraceEvent(TraceEventType::kEnd, nullptr, name, 0, 0, nullptr, nullptr);
 }
 
 void TraceEventAsyncBegin0(TraceArg category_group,
                            TraceArg name,
                            TraceIDArg id) {
-  Dart_TimelineEvent(name,                             // label
-                     Dart_TimelineGetMicros(),         // timestamp0
-                     id,                               // timestamp1_or_async_id
-                     Dart_Timeline_Event_Async_Begin,  // event type
-                     0,                                // argument_count
-                     nullptr,                          // argument_names
-                     nullptr                           // argument_values
-                     );
+  AddTraceEvent(TraceEventType::kAsyncBegin, category_group, name, id, 0,
+                nullptr, nullptr);
 }
 
 void TraceEventAsyncEnd0(TraceArg category_group,
                          TraceArg name,
                          TraceIDArg id) {
-  Dart_TimelineEvent(name,                           // label
-                     Dart_TimelineGetMicros(),       // timestamp0
-                     id,                             // timestamp1_or_async_id
-                     Dart_Timeline_Event_Async_End,  // event type
-                     0,                              // argument_count
-                     nullptr,                        // argument_names
-                     nullptr                         // argument_values
-                     );
+  AddTraceEvent(TraceEventType::kAsyncEnd, category_group, name, id, 0,
+                nullptr, nullptr);
 }
 
 void TraceEventAsyncBegin1(TraceArg category_group,
@@ -98,14 +278,8 @@ void TraceEventAsyncBegin1(TraceArg category_group,
                            TraceArg arg1_val) {
   const char* arg_names[] = {arg1_name};
   const char* arg_values[] = {arg1_val};
-  Dart_TimelineEvent(name,                             // label
-                     Dart_TimelineGetMicros(),         // timestamp0
-                     id,                               // timestamp1_or_async_id
-                     Dart_Timeline_Event_Async_Begin,  // event type
-                     1,                                // argument_count
-                     arg_names,                        // argument_names
-                     arg_values                        // argument_values
-                     );
+  AddTraceEvent(TraceEventType::kAsyncBegin, category_group, name, id, 1,
+                arg_names, arg_values);
 }
 
 void TraceEventAsyncEnd1(TraceArg category_group,
@@ -115,25 +289,48 @@ void TraceEventAsyncEnd1(TraceArg category_group,
                          TraceArg arg1_val) {
   const char* arg_names[] = {arg1_name};
   const char* arg_values[] = {arg1_val};
-  Dart_TimelineEvent(name,                           // label
-                     Dart_TimelineGetMicros(),       // timestamp0
-                     id,                             // timestamp1_or_async_id
-                     Dart_Timeline_Event_Async_End,  // event type
-                     1,                              // argument_count
-                     arg_names,                      // argument_names
-                     arg_values                      // argument_values
-                     );
+  AddTraceEvent(TraceEventType::kAsyncEnd, category_group, name, id, 1,
+                arg_names, arg_values);
 }
 
 void TraceEventInstant0(TraceArg category_group, TraceArg name) {
-  Dart_TimelineEvent(name,                         // label
-                     Dart_TimelineGetMicros(),     // timestamp0
-                     0,                            // timestamp1_or_async_id
-                     Dart_Timeline_Event_Instant,  // event type
-                     0,                            // argument_count
-                     nullptr,                      // argument_names
-                     nullptr                       // argument_values
-                     );
+  AddTraceEvent(TraceEventType::kInstant, category_group, name, 0, 0, nullptr,
+                nullptr);
+}
+
+bool StartTracingToFile(const std::string& path) {
+  TraceFile& trace_file = GetTraceFile();
+  ftl::MutexLocker lock(&trace_file.mutex);
+  if (trace_file.file != nullptr) {
+    fclose(trace_file.file);
+  }
+  trace_file.file = fopen(path.c_str(), "w");
+  trace_file.has_events = false;
+  if (trace_file.file == nullptr) {
+    FTL_LOG(ERROR) << "Could not open the trace file at " << path;
+    g_tracing_to_file.store(false);
+    return false;
+  }
+  g_tracing_to_file.store(true);
+  return true;
+}
+
+void StopTracingToFile() {
+  FlushCurrentThreadTraceEvents();
+  g_tracing_to_file.store(false);
+
+  TraceFile& trace_file = GetTraceFile();
+  ftl::MutexLocker lock(&trace_file.mutex);
+  if (trace_file.file == nullptr) {
+    return;
+  }
+  fputs(trace_file.has_events ? "\n]\n" : "[]\n", trace_file.file);
+  fclose(trace_file.file);
+  trace_file.file = nullptr;
+}
+
+void FlushCurrentThreadTraceEvents() {
+  GetCurrentThreadTraceBuffer().Flush();
 }
 
 }  // namespace tracing
@@ -11,39 +11,71 @@
 
 #include "lib/ftl/macros.h"
 
+// Trace events in the categories listed in FML_TRACE_DISABLED_CATEGORIES, a
+// comma separated list of string literals, are compiled out. For example,
+// -DFML_TRACE_DISABLED_CATEGORIES='"skia","fml"'.
+#ifndef FML_TRACE_DISABLED_CATEGORIES
+#define FML_TRACE_DISABLED_CATEGORIES nullptr
+#endif
+
 #ifndef TRACE_EVENT_HIDE_MACROS
 
-#define TRACE_EVENT0(category_group, name)           \
-  ::fml::tracing::TraceEvent0(category_group, name); \
-  ::fml::tracing::ScopedInstantEnd __trace_end0_##__LINE__(name);
+#define FML_TRACE_CONCAT_INNER(a, b) a##b
+#define FML_TRACE_CONCAT(a, b) FML_TRACE_CONCAT_INNER(a, b)
+#define FML_TRACE_SCOPE_NAME FML_TRACE_CONCAT(__trace_scope_, __LINE__)
 
-#define TRACE_EVENT1(category_group, name, arg1_name, arg1_val)           \
-  ::fml::tracing::TraceEvent1(category_group, name, arg1_name, arg1_val); \
-  ::fml::tracing::ScopedInstantEnd __trace_end1_##__LINE__(name);
+#define FML_TRACE_CATEGORY_ENABLED(category_group) \
+  ::fml::tracing::internal::IsCategoryEnabled(category_group)
 
-#define TRACE_EVENT2(category_group, name, arg1_name, arg1_val, arg2_name, \
-                     arg2_val)                                             \
-  ::fml::tracing::TraceEvent2(category_group, name, arg1_name, arg1_val,   \
-                              arg2_name, arg2_val);                        \
-  ::fml::tracing::ScopedInstantEnd __trace_end2_##__LINE__(name);
+#define TRACE_EVENT0(category_group, name)                                  \
+  ::fml::tracing::ScopedTraceEvent<FML_TRACE_CATEGORY_ENABLED(             \
+      category_group)>                                                       \
+      FML_TRACE_SCOPE_NAME(category_group, name);
 
-#define TRACE_EVENT_ASYNC_BEGIN0(category_group, name, id) \
-  ::fml::tracing::TraceEventAsyncBegin0(category_group, name, id);
+#define TRACE_EVENT1(category_group, name, arg1_name, arg1_val)             \
+  ::fml::tracing::ScopedTraceEvent<FML_TRACE_CATEGORY_ENABLED(             \
+      category_group)>                                                       \
+      FML_TRACE_SCOPE_NAME(category_group, name, arg1_name, arg1_val);
 
-#define TRACE_EVENT_ASYNC_END0(category_group, name, id) \
-  ::fml::tracing::TraceEventAsyncEnd0(category_group, name, id);
+#define TRACE_EVENT2(category_group, name, arg1_name, arg1_val, arg2_name, \
+                     arg2_val)                                             \
+  ::fml::tracing::ScopedTraceEvent<FML_TRACE_CATEGORY_ENABLED(             \
+      category_group)>                                                     \
+      FML_TRACE_SCOPE_NAME(category_group, name, arg1_name, arg1_val,      \
+                           arg2_name, arg2_val);
+
+#define TRACE_EVENT_ASYNC_BEGIN0(category_group, name, id)             \
+  do {                                                                 \
+    if (FML_TRACE_CATEGORY_ENABLED(category_group))                    \
+      ::fml::tracing::TraceEventAsyncBegin0(category_group, name, id); \
+  } while (0)
+
+#define TRACE_EVENT_ASYNC_END0(category_group, name, id)             \
+  do {                                                               \
+    if (FML_TRACE_CATEGORY_ENABLED(category_group))                  \
+      ::fml::tracing::TraceEventAsyncEnd0(category_group, name, id); \
+  } while (0)
 
 #define TRACE_EVENT_ASYNC_BEGIN1(category_group, name, id, arg1_name,        \
                                  arg1_val)                                   \
-  ::fml::tracing::TraceEventAsyncBegin1(category_group, name, id, arg1_name, \
-                                        arg1_val);
+  do {                                                                       \
+    if (FML_TRACE_CATEGORY_ENABLED(category_group))                          \
+      ::fml::tracing::TraceEventAsyncBegin1(category_group, name, id,        \
+                                            arg1_name, arg1_val);            \
+  } while (0)
 
 #define TRACE_EVENT_ASYNC_END1(category_group, name, id, arg1_name, arg1_val) \
-  ::fml::tracing::TraceEventAsyncEnd1(category_group, name, id, arg1_name,    \
-                                      arg1_val);
-
-#define TRACE_EVENT_INSTANT0(category_group, name) \
-  ::fml::tracing::TraceEventInstant0(category_group, name);
+  do {                                                                        \
+    if (FML_TRACE_CATEGORY_ENABLED(category_group))                           \
+      ::fml::tracing::TraceEventAsyncEnd1(category_group, name, id,           \
+                                          arg1_name, arg1_val);               \
+  } while (0)
+
+#define TRACE_EVENT_INSTANT0(category_group, name)                \
+  do {                                                            \
+    if (FML_TRACE_CATEGORY_ENABLED(category_group))               \
+      ::fml::tracing::TraceEventInstant0(category_group, name);   \
+  } while (0)
 
 #endif  // TRACE_EVENT_HIDE_MACROS
 
@@ -53,6 +85,10 @@ namespace tracing {
 using TraceArg = const char*;
 using TraceIDArg = int64_t;
 
+// Events are recorded in a buffer private to the calling thread and handed to
+// the Dart timeline, and to the trace file if one is open, when the outermost
+// scoped event on the thread ends. Categories, names and argument names must
+// be string literals. Argument values are copied.
 void TraceEvent0(TraceArg category_group, TraceArg name);
 
 void TraceEvent1(TraceArg category_group,
@@ -89,16 +125,76 @@ void TraceEventAsyncEnd1(TraceArg category_group,
 
 void TraceEventInstant0(TraceArg category_group, TraceArg name);
 
-class ScopedInstantEnd {
- public:
-  ScopedInstantEnd(std::string str) : label_(std::move(str)) {}
+// Additionally writes every trace event recorded from now on to a file in the
+// Chrome trace event format, which about:tracing can open. Events still
+// buffered by a thread when tracing to the file stops may be missing.
+bool StartTracingToFile(const std::string& path);
+
+void StopTracingToFile();
 
-  ~ScopedInstantEnd() { TraceEventEnd(label_.c_str()); }
+// Hands the events buffered by the calling thread over right away.
+void FlushCurrentThreadTraceEvents();
+
+namespace internal {
+
+constexpr const char* kDisabledCategories[] = {FML_TRACE_DISABLED_CATEGORIES,
+                                               nullptr};
+
+constexpr bool StringEquals(const char* a, const char* b) {
+  return *a == *b && (*a == '\0' || StringEquals(a + 1, b + 1));
+}
+
+constexpr bool IsCategoryEnabled(const char* category, size_t index = 0) {
+  return kDisabledCategories[index] == nullptr ||
+         (!StringEquals(category, kDisabledCategories[index]) &&
+          IsCategoryEnabled(category, index + 1));
+}
+
+}  // namespace internal
+
+// Traces the enclosing scope. Compiles to nothing for disabled categories.
+template <bool kEnabled>
+class ScopedTraceEvent {
+ public:
+  ScopedTraceEvent(TraceArg category_group, TraceArg name) : name_(name) {
+    if (kEnabled) {
+      TraceEvent0(category_group, name);
+    }
+  }
+
+  ScopedTraceEvent(TraceArg category_group,
+                   TraceArg name,
+                   TraceArg arg1_name,
+                   TraceArg arg1_val)
+      : name_(name) {
+    if (kEnabled) {
+      TraceEvent1(category_group, name, arg1_name, arg1_val);
+    }
+  }
+
+  ScopedTraceEvent(TraceArg category_group,
+                   TraceArg name,
+                   TraceArg arg1_name,
+                   TraceArg arg1_val,
+                   TraceArg arg2_name,
+                   TraceArg arg2_val)
+      : name_(name) {
+    if (kEnabled) {
+      TraceEvent2(category_group, name, arg1_name, arg1_val, arg2_name,
+                  arg2_val);
+    }
+  }
+
+  ~ScopedTraceEvent() {
+    if (kEnabled) {
+      TraceEventEnd(name_);
+    }
+  }
 
  private:
-  const std::string label_;
+  TraceArg name_;
 
-  FTL_DISALLOW_COPY_AND_ASSIGN(ScopedInstantEnd);
+  FTL_DISALLOW_COPY_AND_ASSIGN(ScopedTraceEvent);
 };
 
 }  // namespace tracing
@@ -26,6 +26,7 @@ class Scene : public ftl::RefCountedThreadSafe<Scene>,
  public:
   ~Scene() override;
   static ftl::RefPtr<Scene> create(std::unique_ptr<flow::Layer> rootLayer,
+                                   std::unique_ptr<flow::LayerArena> layerArena,
                                    uint32_t rasterizerTracingThreshold,
                                    bool checkerboardRasterCacheImages,
                                    bool checkerboardOffscreenLayers);
@@ -38,6 +39,7 @@ class Scene : public ftl::RefCountedThreadSafe<Scene>,
 
  private:
   explicit Scene(std::unique_ptr<flow::Layer> rootLayer,
+                 std::unique_ptr<flow::LayerArena> layerArena,
                  uint32_t rasterizerTracingThreshold,
                  bool checkerboardRasterCacheImages,
                  bool checkerboardOffscreenLayers);
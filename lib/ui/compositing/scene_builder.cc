@@ -65,7 +65,8 @@ void SceneBuilder::RegisterNatives(tonic::DartLibraryNatives* natives) {
 }
 
 SceneBuilder::SceneBuilder()
-    : m_currentLayer(nullptr),
+    : m_layerArena(new flow::LayerArena()),
+      m_currentLayer(nullptr),
       m_currentRasterizerTracingThreshold(0),
       m_checkerboardRasterCacheImages(false),
       m_checkerboardOffscreenLayers(false) {
@@ -83,7 +84,8 @@ void SceneBuilder::pushTransform(const tonic::Float64List& matrix4) {
   else
     cullRect = SkRect::MakeLargest();
 
-  std::unique_ptr<flow::TransformLayer> layer(new flow::TransformLayer());
+  std::unique_ptr<flow::TransformLayer> layer(
+      new (m_layerArena.get()) flow::TransformLayer());
   layer->set_transform(sk_matrix);
   addLayer(std::move(layer), cullRect);
 }
@@ -97,7 +99,8 @@ void SceneBuilder::pushClipRect(double left,
   if (!cullRect.intersect(clipRect, m_cullRects.top()))
     cullRect = SkRect::MakeEmpty();
 
-  std::unique_ptr<flow::ClipRectLayer> layer(new flow::ClipRectLayer());
+  std::unique_ptr<flow::ClipRectLayer> layer(
+      new (m_layerArena.get()) flow::ClipRectLayer());
   layer->set_clip_rect(clipRect);
   addLayer(std::move(layer), cullRect);
 }
@@ -107,7 +110,8 @@ void SceneBuilder::pushClipRRect(const RRect& rrect) {
   if (!cullRect.intersect(rrect.sk_rrect.rect(), m_cullRects.top()))
     cullRect = SkRect::MakeEmpty();
 
-  std::unique_ptr<flow::ClipRRectLayer> layer(new flow::ClipRRectLayer());
+  std::unique_ptr<flow::ClipRRectLayer> layer(
+      new (m_layerArena.get()) flow::ClipRRectLayer());
   layer->set_clip_rrect(rrect.sk_rrect);
   addLayer(std::move(layer), cullRect);
 }
@@ -117,19 +121,22 @@ void SceneBuilder::pushClipPath(const CanvasPath* path) {
   if (!cullRect.intersect(path->path().getBounds(), m_cullRects.top()))
     cullRect = SkRect::MakeEmpty();
 
-  std::unique_ptr<flow::ClipPathLayer> layer(new flow::ClipPathLayer());
+  std::unique_ptr<flow::ClipPathLayer> layer(
+      new (m_layerArena.get()) flow::ClipPathLayer());
   layer->set_clip_path(path->path());
   addLayer(std::move(layer), cullRect);
 }
 
 void SceneBuilder::pushOpacity(int alpha) {
-  std::unique_ptr<flow::OpacityLayer> layer(new flow::OpacityLayer());
+  std::unique_ptr<flow::OpacityLayer> layer(
+      new (m_layerArena.get()) flow::OpacityLayer());
   layer->set_alpha(alpha);
   addLayer(std::move(layer), m_cullRects.top());
 }
 
 void SceneBuilder::pushColorFilter(int color, int blendMode) {
-  std::unique_ptr<flow::ColorFilterLayer> layer(new flow::ColorFilterLayer());
+  std::unique_ptr<flow::ColorFilterLayer> layer(
+      new (m_layerArena.get()) flow::ColorFilterLayer());
   layer->set_color(static_cast<SkColor>(color));
   layer->set_blend_mode(static_cast<SkBlendMode>(blendMode));
   addLayer(std::move(layer), m_cullRects.top());
@@ -137,7 +144,7 @@ void SceneBuilder::pushColorFilter(int color, int blendMode) {
 
 void SceneBuilder::pushBackdropFilter(ImageFilter* filter) {
   std::unique_ptr<flow::BackdropFilterLayer> layer(
-      new flow::BackdropFilterLayer());
+      new (m_layerArena.get()) flow::BackdropFilterLayer());
   layer->set_filter(filter->filter());
   addLayer(std::move(layer), m_cullRects.top());
 }
@@ -148,7 +155,8 @@ void SceneBuilder::pushShaderMask(Shader* shader,
                                   double maskRectTop,
                                   double maskRectBottom,
                                   int blendMode) {
-  std::unique_ptr<flow::ShaderMaskLayer> layer(new flow::ShaderMaskLayer());
+  std::unique_ptr<flow::ShaderMaskLayer> layer(
+      new (m_layerArena.get()) flow::ShaderMaskLayer());
   layer->set_shader(shader->shader());
   layer->set_mask_rect(SkRect::MakeLTRB(maskRectLeft, maskRectTop,
                                         maskRectRight, maskRectBottom));
@@ -163,7 +171,8 @@ void SceneBuilder::pushPhysicalModel(const RRect& rrect,
   if (!cullRect.intersect(rrect.sk_rrect.rect(), m_cullRects.top()))
     cullRect = SkRect::MakeEmpty();
 
-  std::unique_ptr<flow::PhysicalModelLayer> layer(new flow::PhysicalModelLayer());
+  std::unique_ptr<flow::PhysicalModelLayer> layer(
+      new (m_layerArena.get()) flow::PhysicalModelLayer());
   layer->set_rrect(rrect.sk_rrect);
   layer->set_elevation(elevation);
   layer->set_color(color);
@@ -208,7 +217,8 @@ void SceneBuilder::addPicture(double dx,
   if (!SkRect::Intersects(pictureRect, m_cullRects.top()))
     return;
 
-  std::unique_ptr<flow::PictureLayer> layer(new flow::PictureLayer());
+  std::unique_ptr<flow::PictureLayer> layer(
+      new (m_layerArena.get()) flow::PictureLayer());
   layer->set_offset(SkPoint::Make(dx, dy));
   layer->set_picture(picture->picture());
   layer->set_is_complex(!!(hints & 1));
@@ -232,7 +242,8 @@ void SceneBuilder::addChildScene(double dx,
   if (!SkRect::Intersects(sceneRect, m_cullRects.top()))
     return;
 
-  std::unique_ptr<flow::ChildSceneLayer> layer(new flow::ChildSceneLayer());
+  std::unique_ptr<flow::ChildSceneLayer> layer(
+      new (m_layerArena.get()) flow::ChildSceneLayer());
   layer->set_offset(SkPoint::Make(dx, dy));
   layer->set_device_pixel_ratio(devicePixelRatio);
   layer->set_physical_size(SkISize::Make(physicalWidth, physicalHeight));
@@ -250,7 +261,8 @@ void SceneBuilder::addPerformanceOverlay(uint64_t enabledOptions,
   if (!m_currentLayer)
     return;
   std::unique_ptr<flow::PerformanceOverlayLayer> layer(
-      new flow::PerformanceOverlayLayer(enabledOptions));
+      new (m_layerArena.get()) flow::PerformanceOverlayLayer(
+          enabledOptions));
   layer->set_paint_bounds(SkRect::MakeLTRB(left, top, right, bottom));
   m_currentLayer->Add(std::move(layer));
 }
@@ -271,9 +283,9 @@ ftl::RefPtr<Scene> SceneBuilder::build() {
   m_currentLayer = nullptr;
   int32_t threshold = m_currentRasterizerTracingThreshold;
   m_currentRasterizerTracingThreshold = 0;
-  ftl::RefPtr<Scene> scene = Scene::create(std::move(m_rootLayer), threshold,
-                                           m_checkerboardRasterCacheImages,
-                                           m_checkerboardOffscreenLayers);
+  ftl::RefPtr<Scene> scene = Scene::create(
+      std::move(m_rootLayer), std::move(m_layerArena), threshold,
+      m_checkerboardRasterCacheImages, m_checkerboardOffscreenLayers);
   ClearDartWrapper();
   return scene;
 }
@@ -10,6 +10,7 @@
 #include <stack>
 
 #include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/layer_arena.h"
 #include "flutter/lib/ui/compositing/scene.h"
 #include "flutter/lib/ui/painting/image_filter.h"
 #include "flutter/lib/ui/painting/path.h"
@@ -79,6 +80,8 @@ class SceneBuilder : public ftl::RefCountedThreadSafe<SceneBuilder>,
   void addLayer(std::unique_ptr<flow::ContainerLayer> layer,
                 const SkRect& cullRect);
 
+  // Holds all layers added by this builder. Must outlive |m_rootLayer|.
+  std::unique_ptr<flow::LayerArena> m_layerArena;
   std::unique_ptr<flow::ContainerLayer> m_rootLayer;
   flow::ContainerLayer* m_currentLayer;
   int32_t m_currentRasterizerTracingThreshold;
@@ -0,0 +1,49 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/external_allocation.h"
+
+#include <atomic>
+
+namespace blink {
+namespace {
+
+constexpr size_t kKindCount =
+    static_cast<size_t>(ExternalAllocationKind::kCount);
+
+// Wrappers are released on whichever thread drops their last reference.
+std::atomic<size_t> g_total_bytes[kKindCount];
+
+std::atomic<size_t>& TotalBytes(ExternalAllocationKind kind) {
+  return g_total_bytes[static_cast<size_t>(kind)];
+}
+
+}  // namespace
+
+ExternalAllocation::ExternalAllocation(ExternalAllocationKind kind)
+    : kind_(kind), bytes_(0) {}
+
+ExternalAllocation::~ExternalAllocation() {
+  TotalBytes(kind_).fetch_sub(bytes_);
+}
+
+size_t ExternalAllocation::Update(size_t bytes) {
+  TotalBytes(kind_).fetch_add(bytes);
+  TotalBytes(kind_).fetch_sub(bytes_);
+  bytes_ = bytes;
+  return bytes;
+}
+
+size_t ExternalAllocation::GetTotalBytes(ExternalAllocationKind kind) {
+  return TotalBytes(kind).load();
+}
+
+size_t ExternalAllocation::GetTotalBytes() {
+  size_t total = 0;
+  for (size_t i = 0; i < kKindCount; i++)
+    total += g_total_bytes[i].load();
+  return total;
+}
+
+}  // namespace blink
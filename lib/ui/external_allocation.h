@@ -0,0 +1,48 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_EXTERNAL_ALLOCATION_H_
+#define FLUTTER_LIB_UI_EXTERNAL_ALLOCATION_H_
+
+#include <stddef.h>
+
+#include "lib/ftl/macros.h"
+
+namespace blink {
+
+enum class ExternalAllocationKind {
+  kImage,
+  kParagraph,
+  kPicture,
+  kCount,
+};
+
+// The native memory held by a Dart wrapper. The bytes held by all live
+// wrappers are tallied for the whole engine, so that they can be compared
+// against the size of the Dart heap.
+class ExternalAllocation {
+ public:
+  explicit ExternalAllocation(ExternalAllocationKind kind);
+
+  ~ExternalAllocation();
+
+  // Replaces the bytes held by the wrapper with |bytes| and returns them.
+  size_t Update(size_t bytes);
+
+  size_t bytes() const { return bytes_; }
+
+  static size_t GetTotalBytes(ExternalAllocationKind kind);
+
+  static size_t GetTotalBytes();
+
+ private:
+  const ExternalAllocationKind kind_;
+  size_t bytes_;
+
+  FTL_DISALLOW_COPY_AND_ASSIGN(ExternalAllocation);
+};
+
+}  // namespace blink
+
+#endif  // FLUTTER_LIB_UI_EXTERNAL_ALLOCATION_H_
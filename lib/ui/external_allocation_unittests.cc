@@ -0,0 +1,156 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/external_allocation.h"
+
+#include "flutter/common/threads.h"
+#include "flutter/lib/ui/painting/image.h"
+#include "flutter/lib/ui/painting/picture.h"
+#include "lib/ftl/memory/ref_counted.h"
+#include "third_party/gtest/include/gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+#include "third_party/skia/include/gpu/gl/GrGLInterface.h"
+
+namespace blink {
+namespace {
+
+// Runs tasks as they are posted, so that wrappers release their Skia objects
+// right away.
+class ImmediateTaskRunner : public ftl::TaskRunner {
+ public:
+  void PostTask(ftl::Closure task) override { task(); }
+
+  void PostTaskForTime(ftl::Closure task,
+                       ftl::TimePoint target_time) override {
+    task();
+  }
+
+  void PostDelayedTask(ftl::Closure task, ftl::TimeDelta delay) override {
+    task();
+  }
+
+  bool RunsTasksOnCurrentThread() override { return true; }
+
+ private:
+  ImmediateTaskRunner() = default;
+  ~ImmediateTaskRunner() override = default;
+
+  FRIEND_MAKE_REF_COUNTED(ImmediateTaskRunner);
+  FRIEND_REF_COUNTED_THREAD_SAFE(ImmediateTaskRunner);
+  FTL_DISALLOW_COPY_AND_ASSIGN(ImmediateTaskRunner);
+};
+
+void EnsureThreads() {
+  static bool threads_set = false;
+  if (threads_set)
+    return;
+  auto runner = ftl::MakeRefCounted<ImmediateTaskRunner>();
+  Threads::Set(Threads(runner, runner, runner, runner));
+  threads_set = true;
+}
+
+size_t ImageTotal() {
+  return ExternalAllocation::GetTotalBytes(ExternalAllocationKind::kImage);
+}
+
+size_t PictureTotal() {
+  return ExternalAllocation::GetTotalBytes(ExternalAllocationKind::kPicture);
+}
+
+sk_sp<SkImage> MakeRasterImage(int width, int height) {
+  return SkSurface::MakeRasterN32Premul(width, height)->makeImageSnapshot();
+}
+
+}  // namespace
+
+TEST(ExternalAllocation, TalliesGoUpAndDown) {
+  const size_t images = ImageTotal();
+  const size_t pictures = PictureTotal();
+  const size_t total = ExternalAllocation::GetTotalBytes();
+  {
+    ExternalAllocation allocation(ExternalAllocationKind::kImage);
+    ASSERT_EQ(allocation.Update(100), 100u);
+    ASSERT_EQ(ImageTotal(), images + 100);
+    ASSERT_EQ(ExternalAllocation::GetTotalBytes(), total + 100);
+
+    // Updates replace the bytes reported before.
+    allocation.Update(40);
+    ASSERT_EQ(allocation.bytes(), 40u);
+    ASSERT_EQ(ImageTotal(), images + 40);
+    ASSERT_EQ(PictureTotal(), pictures);
+  }
+  ASSERT_EQ(ImageTotal(), images);
+  ASSERT_EQ(ExternalAllocation::GetTotalBytes(), total);
+}
+
+TEST(ExternalAllocation, ImageReleasesItsBytes) {
+  EnsureThreads();
+  const size_t images = ImageTotal();
+
+  ftl::RefPtr<CanvasImage> image = CanvasImage::Create();
+  image->set_image(MakeRasterImage(10, 20));
+  ASSERT_EQ(image->GetImageBytes(), 10u * 20 * 4);
+  ASSERT_EQ(image->GetAllocationSize(), sizeof(CanvasImage) + 10 * 20 * 4);
+  ASSERT_EQ(ImageTotal(), images + sizeof(CanvasImage) + 10 * 20 * 4);
+
+  image = nullptr;
+  ASSERT_EQ(ImageTotal(), images);
+}
+
+TEST(ExternalAllocation, PictureTalliesOnlyItsOwnBytes) {
+  EnsureThreads();
+  const size_t images = ImageTotal();
+  const size_t pictures = PictureTotal();
+
+  ftl::RefPtr<CanvasImage> image = CanvasImage::Create();
+  image->set_image(MakeRasterImage(100, 100));
+  image->GetAllocationSize();
+
+  SkPictureRecorder recorder;
+  recorder.beginRecording(SkRect::MakeWH(100, 100))
+      ->drawImage(image->image(), 0, 0);
+  ftl::RefPtr<Picture> picture = Picture::Create(
+      recorder.finishRecordingAsPicture(), image->GetImageBytes());
+  const size_t own_bytes = sizeof(Picture) + picture->GetRecordingBytes();
+
+  // The Dart heap learns about the image the picture keeps alive, but the
+  // tallies count the image once, for its own wrapper.
+  ASSERT_EQ(picture->GetAllocationSize(), own_bytes + image->GetImageBytes());
+  ASSERT_EQ(PictureTotal(), pictures + own_bytes);
+  ASSERT_EQ(ImageTotal(),
+            images + sizeof(CanvasImage) + image->GetImageBytes());
+
+  picture = nullptr;
+  ASSERT_EQ(PictureTotal(), pictures);
+  image = nullptr;
+  ASSERT_EQ(ImageTotal(), images);
+}
+
+TEST(ExternalAllocation, TextureBackedImageReportsTextureSize) {
+  EnsureThreads();
+  sk_sp<const GrGLInterface> interface(GrGLCreateNullInterface());
+  sk_sp<GrContext> context(GrContext::Create(
+      kOpenGL_GrBackend, reinterpret_cast<GrBackendContext>(interface.get())));
+  ASSERT_TRUE(context);
+
+  SkBitmap bitmap;
+  ASSERT_TRUE(bitmap.tryAllocN32Pixels(64, 32));
+  bitmap.eraseColor(SK_ColorRED);
+  SkPixmap pixmap;
+  ASSERT_TRUE(bitmap.peekPixels(&pixmap));
+
+  ftl::RefPtr<CanvasImage> image = CanvasImage::Create();
+  image->set_image(
+      SkImage::MakeTextureFromPixmap(context.get(), pixmap, SkBudgeted::kNo));
+  ASSERT_TRUE(image->image());
+  ASSERT_TRUE(image->image()->isTextureBacked());
+  // Measured from the texture, as there are no pixels in memory to measure.
+  ASSERT_FALSE(image->image()->peekPixels(&pixmap));
+  ASSERT_EQ(image->GetImageBytes(), 64u * 32 * 4);
+}
+
+}  // namespace blink
@@ -691,9 +691,78 @@ abstract class Image extends NativeFieldWrapperClass2 {
 typedef void ImageDecoderCallback(Image result);
 
 /// Convert an image file from a byte array into an [Image] object.
-void decodeImageFromList(Uint8List list, ImageDecoderCallback callback)
+///
+/// The image is decoded off the UI thread. If [targetWidth] or [targetHeight]
+/// are given, images larger than that are decoded at a smaller size that still
+/// covers the given dimensions, which saves both decoding time and memory. The
+/// aspect ratio is kept, and images are never scaled up.
+void decodeImageFromList(Uint8List list, ImageDecoderCallback callback, {
+  int targetWidth,
+  int targetHeight
+}) {
+  _decodeImageFromList(list, callback, targetWidth ?? 0, targetHeight ?? 0);
+}
+void _decodeImageFromList(Uint8List list, ImageDecoderCallback callback, int targetWidth, int targetHeight)
     native "decodeImageFromList";
 
+/// Decodes an image whose encoded bytes arrive in chunks, such as over the
+/// network, without waiting for all of them.
+///
+/// Add the chunks with [addData] as they arrive and call [close] after the
+/// last one. Each call to [decode] produces an image of everything received
+/// so far, so that something can be shown long before the whole image has
+/// arrived. For images too large to decode whole, [decodeRegion] decodes just
+/// the part of the image that is visible.
+class ProgressiveImageDecoder extends NativeFieldWrapperClass2 {
+  /// Creates a decoder for a single image.
+  ///
+  /// If [targetWidth] or [targetHeight] are given, [decode] produces images
+  /// scaled down as by [decodeImageFromList].
+  ProgressiveImageDecoder({ int targetWidth, int targetHeight }) {
+    _constructor(targetWidth ?? 0, targetHeight ?? 0);
+  }
+  void _constructor(int targetWidth, int targetHeight) native "ProgressiveImageDecoder_constructor";
+
+  /// Appends the next chunk of the encoded image.
+  void addData(Uint8List data) native "ProgressiveImageDecoder_addData";
+
+  /// Signals that all of the encoded image has been added.
+  void close() native "ProgressiveImageDecoder_close";
+
+  /// The number of pixels along the horizontal axis of the full size image.
+  ///
+  /// Zero until a call to [decode] or [decodeRegion] has read enough of the
+  /// image to know its size.
+  int get width native "ProgressiveImageDecoder_width";
+
+  /// The number of pixels along the vertical axis of the full size image.
+  ///
+  /// Zero until a call to [decode] or [decodeRegion] has read enough of the
+  /// image to know its size.
+  int get height native "ProgressiveImageDecoder_height";
+
+  /// Decodes as much of the image as has been added so far. The part of the
+  /// image that has not arrived yet is transparent.
+  ///
+  /// The callback receives null if too little of the image has arrived to
+  /// decode any of it, or if it is not a valid image.
+  void decode(ImageDecoderCallback callback) native "ProgressiveImageDecoder_decode";
+
+  /// Decodes the part of the image within [region], given in pixels of the
+  /// full size image, at full resolution.
+  ///
+  /// Only the region, rather than the whole image, is held in memory, which
+  /// lets tiled viewers show parts of images far too large to decode whole.
+  void decodeRegion(Rect region, ImageDecoderCallback callback) {
+    _decodeRegion(region.left.floor(), region.top.floor(), region.right.ceil(), region.bottom.ceil(), callback);
+  }
+  void _decodeRegion(int left, int top, int right, int bottom, ImageDecoderCallback callback) native "ProgressiveImageDecoder_decodeRegion";
+
+  /// Release the resources used by this object. The object is no longer usable
+  /// after this method is called.
+  void dispose() native "ProgressiveImageDecoder_dispose";
+}
+
 /// Determines the winding rule that decides how the interior of a [Path] is
 /// calculated.
 ///
@@ -1950,6 +2019,274 @@ class Canvas extends NativeFieldWrapperClass2 {
                    int color,
                    double elevation,
                    bool transparentOccluder) native "Canvas_drawShadow";
+
+  /// Draws the commands recorded in the given [CanvasCommandBuffer].
+  ///
+  /// This has the same effect as making the calls recorded in the buffer on
+  /// this canvas, but crosses into the engine once rather than once per call.
+  ///
+  /// The saves and restores in the buffer must balance within it: a restore
+  /// without a matching save in the buffer makes it malformed, and saves left
+  /// unrestored are restored once the buffer has been drawn.
+  void drawCommandBuffer(CanvasCommandBuffer buffer) {
+    assert(buffer != null);
+    final bool succeeded = _drawCommands(
+      buffer._paths, buffer._images, buffer._pictures,
+      buffer._maskFilters, buffer._shaders,
+      new Int32List.fromList(buffer._commands),
+      new Float32List.fromList(buffer._values)
+    );
+    if (!succeeded)
+      throw new ArgumentError('The command buffer is malformed.');
+  }
+  bool _drawCommands(List<Path> paths,
+                     List<Image> images,
+                     List<Picture> pictures,
+                     List<MaskFilter> maskFilters,
+                     List<Shader> shaders,
+                     Int32List commands,
+                     Float32List values) native "Canvas_drawCommands";
+}
+
+/// Records a sequence of canvas calls so that they can be drawn into a
+/// [Canvas] with a single call to [Canvas.drawCommandBuffer].
+///
+/// Each call on a [Canvas] crosses from Dart into the engine. When a picture
+/// is made of many small primitives, such as the points and lines of a chart,
+/// recording them into a [CanvasCommandBuffer] first is considerably cheaper.
+///
+/// The buffer captures the values of the [Paint] objects passed to it, so
+/// they may be changed afterwards. Paths, images and pictures are referenced
+/// and must not be changed until the buffer has been drawn.
+class CanvasCommandBuffer {
+  // Must be kept in sync with CanvasCommand in canvas_commands.h.
+  static const int _kSave = 0;
+  static const int _kSaveLayer = 1;
+  static const int _kSaveLayerWithoutBounds = 2;
+  static const int _kRestore = 3;
+  static const int _kTranslate = 4;
+  static const int _kScale = 5;
+  static const int _kRotate = 6;
+  static const int _kSkew = 7;
+  static const int _kClipRect = 8;
+  static const int _kClipRRect = 9;
+  static const int _kClipPath = 10;
+  static const int _kSetPaint = 11;
+  static const int _kDrawColor = 12;
+  static const int _kDrawLine = 13;
+  static const int _kDrawPaint = 14;
+  static const int _kDrawRect = 15;
+  static const int _kDrawRRect = 16;
+  static const int _kDrawOval = 17;
+  static const int _kDrawCircle = 18;
+  static const int _kDrawArc = 19;
+  static const int _kDrawPath = 20;
+  static const int _kDrawImage = 21;
+  static const int _kDrawPicture = 22;
+
+  final List<int> _commands = <int>[];
+  final List<double> _values = <double>[];
+  final List<Path> _paths = <Path>[];
+  final List<Image> _images = <Image>[];
+  final List<Picture> _pictures = <Picture>[];
+  final List<MaskFilter> _maskFilters = <MaskFilter>[];
+  final List<Shader> _shaders = <Shader>[];
+
+  /// Whether no calls have been recorded since the buffer was created or
+  /// last cleared.
+  bool get isEmpty => _commands.isEmpty;
+
+  /// Discards the recorded calls.
+  void clear() {
+    _commands.clear();
+    _values.clear();
+    _paths.clear();
+    _images.clear();
+    _pictures.clear();
+    _maskFilters.clear();
+    _shaders.clear();
+  }
+
+  void _addPaint(Paint paint) {
+    _commands.add(_kSetPaint);
+    for (int i = 0; i < Paint._kDataByteCount; i += 4)
+      _commands.add(paint._data.getInt32(i, _kFakeHostEndian));
+    if (paint._objects == null) {
+      _commands.add(-1);
+    } else {
+      _commands.add(_shaders.length);
+      _maskFilters.add(paint._objects[Paint._kMaskFilterIndex]);
+      _shaders.add(paint._objects[Paint._kShaderIndex]);
+    }
+  }
+
+  void _addRect(Rect rect) {
+    _values..add(rect.left)..add(rect.top)..add(rect.right)..add(rect.bottom);
+  }
+
+  /// Records a call to [Canvas.save].
+  void save() {
+    _commands.add(_kSave);
+  }
+
+  /// Records a call to [Canvas.saveLayer].
+  void saveLayer(Rect bounds, Paint paint) {
+    assert(paint != null);
+    _addPaint(paint);
+    if (bounds == null) {
+      _commands.add(_kSaveLayerWithoutBounds);
+    } else {
+      _commands.add(_kSaveLayer);
+      _addRect(bounds);
+    }
+  }
+
+  /// Records a call to [Canvas.restore].
+  void restore() {
+    _commands.add(_kRestore);
+  }
+
+  /// Records a call to [Canvas.translate].
+  void translate(double dx, double dy) {
+    _commands.add(_kTranslate);
+    _values..add(dx)..add(dy);
+  }
+
+  /// Records a call to [Canvas.scale].
+  void scale(double sx, double sy) {
+    _commands.add(_kScale);
+    _values..add(sx)..add(sy);
+  }
+
+  /// Records a call to [Canvas.rotate].
+  void rotate(double radians) {
+    _commands.add(_kRotate);
+    _values.add(radians);
+  }
+
+  /// Records a call to [Canvas.skew].
+  void skew(double sx, double sy) {
+    _commands.add(_kSkew);
+    _values..add(sx)..add(sy);
+  }
+
+  /// Records a call to [Canvas.clipRect].
+  void clipRect(Rect rect) {
+    assert(rect != null);
+    _commands.add(_kClipRect);
+    _addRect(rect);
+  }
+
+  /// Records a call to [Canvas.clipRRect].
+  void clipRRect(RRect rrect) {
+    assert(rrect != null);
+    _commands.add(_kClipRRect);
+    _values.addAll(rrect._value);
+  }
+
+  /// Records a call to [Canvas.clipPath].
+  void clipPath(Path path) {
+    assert(path != null);
+    _commands..add(_kClipPath)..add(_paths.length);
+    _paths.add(path);
+  }
+
+  /// Records a call to [Canvas.drawColor].
+  void drawColor(Color color, BlendMode blendMode) {
+    assert(color != null);
+    assert(blendMode != null);
+    _commands..add(_kDrawColor)..add(color.value)..add(blendMode.index);
+  }
+
+  /// Records a call to [Canvas.drawLine].
+  void drawLine(Offset p1, Offset p2, Paint paint) {
+    assert(p1 != null);
+    assert(p2 != null);
+    assert(paint != null);
+    _addPaint(paint);
+    _commands.add(_kDrawLine);
+    _values..add(p1.dx)..add(p1.dy)..add(p2.dx)..add(p2.dy);
+  }
+
+  /// Records a call to [Canvas.drawPaint].
+  void drawPaint(Paint paint) {
+    assert(paint != null);
+    _addPaint(paint);
+    _commands.add(_kDrawPaint);
+  }
+
+  /// Records a call to [Canvas.drawRect].
+  void drawRect(Rect rect, Paint paint) {
+    assert(rect != null);
+    assert(paint != null);
+    _addPaint(paint);
+    _commands.add(_kDrawRect);
+    _addRect(rect);
+  }
+
+  /// Records a call to [Canvas.drawRRect].
+  void drawRRect(RRect rrect, Paint paint) {
+    assert(rrect != null);
+    assert(paint != null);
+    _addPaint(paint);
+    _commands.add(_kDrawRRect);
+    _values.addAll(rrect._value);
+  }
+
+  /// Records a call to [Canvas.drawOval].
+  void drawOval(Rect rect, Paint paint) {
+    assert(rect != null);
+    assert(paint != null);
+    _addPaint(paint);
+    _commands.add(_kDrawOval);
+    _addRect(rect);
+  }
+
+  /// Records a call to [Canvas.drawCircle].
+  void drawCircle(Offset c, double radius, Paint paint) {
+    assert(c != null);
+    assert(paint != null);
+    _addPaint(paint);
+    _commands.add(_kDrawCircle);
+    _values..add(c.dx)..add(c.dy)..add(radius);
+  }
+
+  /// Records a call to [Canvas.drawArc].
+  void drawArc(Rect rect, double startAngle, double sweepAngle, bool useCenter, Paint paint) {
+    assert(rect != null);
+    assert(paint != null);
+    _addPaint(paint);
+    _commands..add(_kDrawArc)..add(useCenter ? 1 : 0);
+    _addRect(rect);
+    _values..add(startAngle)..add(sweepAngle);
+  }
+
+  /// Records a call to [Canvas.drawPath].
+  void drawPath(Path path, Paint paint) {
+    assert(path != null);
+    assert(paint != null);
+    _addPaint(paint);
+    _commands..add(_kDrawPath)..add(_paths.length);
+    _paths.add(path);
+  }
+
+  /// Records a call to [Canvas.drawImage].
+  void drawImage(Image image, Offset p, Paint paint) {
+    assert(image != null);
+    assert(p != null);
+    assert(paint != null);
+    _addPaint(paint);
+    _commands..add(_kDrawImage)..add(_images.length);
+    _images.add(image);
+    _values..add(p.dx)..add(p.dy);
+  }
+
+  /// Records a call to [Canvas.drawPicture].
+  void drawPicture(Picture picture) {
+    assert(picture != null);
+    _commands..add(_kDrawPicture)..add(_pictures.length);
+    _pictures.add(picture);
+  }
 }
 
 /// An object representing a sequence of recorded graphical operations.
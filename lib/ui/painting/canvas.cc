@@ -7,6 +7,7 @@
 #include <math.h>
 
 #include "flutter/flow/layers/physical_model_layer.h"
+#include "flutter/lib/ui/painting/canvas_commands.h"
 #include "flutter/lib/ui/painting/image.h"
 #include "flutter/lib/ui/painting/matrix.h"
 #include "lib/tonic/converter/dart_converter.h"
@@ -58,7 +59,8 @@ IMPLEMENT_WRAPPERTYPEINFO(ui, Canvas);
   V(Canvas, drawPoints)             \
   V(Canvas, drawVertices)           \
   V(Canvas, drawAtlas)              \
-  V(Canvas, drawShadow)
+  V(Canvas, drawShadow)             \
+  V(Canvas, drawCommands)
 
 FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
 
@@ -81,7 +83,7 @@ ftl::RefPtr<Canvas> Canvas::Create(PictureRecorder* recorder,
   return canvas;
 }
 
-Canvas::Canvas(SkCanvas* canvas) : canvas_(canvas) {}
+Canvas::Canvas(SkCanvas* canvas) : canvas_(canvas), referenced_bytes_(0) {}
 
 Canvas::~Canvas() {}
 
@@ -279,6 +281,7 @@ void Canvas::drawImage(const CanvasImage* image,
     return;
   if (!image)
     Dart_ThrowException(ToDart("Canvas.drawImage called with non-genuine Image."));
+  AddReference(image);
   canvas_->drawImage(image->image(), x, y, paint.paint());
 }
 
@@ -299,6 +302,7 @@ void Canvas::drawImageRect(const CanvasImage* image,
     Dart_ThrowException(ToDart("Canvas.drawImageRect called with non-genuine Image."));
   SkRect src = SkRect::MakeLTRB(src_left, src_top, src_right, src_bottom);
   SkRect dst = SkRect::MakeLTRB(dst_left, dst_top, dst_right, dst_bottom);
+  AddReference(image);
   canvas_->drawImageRect(image->image(), src, dst, paint.paint(),
                          SkCanvas::kFast_SrcRectConstraint);
 }
@@ -323,6 +327,7 @@ void Canvas::drawImageNine(const CanvasImage* image,
   SkIRect icenter;
   center.round(&icenter);
   SkRect dst = SkRect::MakeLTRB(dst_left, dst_top, dst_right, dst_bottom);
+  AddReference(image);
   canvas_->drawImageNine(image->image(), icenter, dst, paint.paint());
 }
 
@@ -331,6 +336,7 @@ void Canvas::drawPicture(Picture* picture) {
     return;
   if (!picture)
     Dart_ThrowException(ToDart("Canvas.drawPicture called with non-genuine Picture."));
+  AddReference(picture);
   canvas_->drawPicture(picture->picture().get());
 }
 
@@ -377,6 +383,7 @@ void Canvas::drawAtlas(const Paint& paint,
   if (!atlas)
     Dart_ThrowException(ToDart("Canvas.drawAtlas or Canvas.drawRawAtlas called with non-genuine Image."));
 
+  AddReference(atlas);
   sk_sp<SkImage> skImage = atlas->image();
 
   static_assert(sizeof(SkRSXform) == sizeof(float) * 4,
@@ -406,6 +413,42 @@ void Canvas::drawShadow(const CanvasPath* path,
                                        transparentOccluder);
 }
 
+bool Canvas::drawCommands(const std::vector<CanvasPath*>& paths,
+                          const std::vector<CanvasImage*>& images,
+                          const std::vector<Picture*>& pictures,
+                          const std::vector<MaskFilter*>& mask_filters,
+                          const std::vector<Shader*>& shaders,
+                          const tonic::Int32List& commands,
+                          const tonic::Float32List& values) {
+  if (!canvas_)
+    return true;
+
+  CanvasCommandObjects objects;
+  objects.paths.reserve(paths.size());
+  for (CanvasPath* path : paths)
+    objects.paths.push_back(path ? &path->path() : nullptr);
+  objects.images.reserve(images.size());
+  for (CanvasImage* image : images) {
+    objects.images.push_back(image ? image->image() : nullptr);
+    AddReference(image);
+  }
+  objects.pictures.reserve(pictures.size());
+  for (Picture* picture : pictures) {
+    objects.pictures.push_back(picture ? picture->picture() : nullptr);
+    AddReference(picture);
+  }
+  objects.mask_filters.reserve(mask_filters.size());
+  for (MaskFilter* mask_filter : mask_filters)
+    objects.mask_filters.push_back(mask_filter ? mask_filter->filter()
+                                               : nullptr);
+  objects.shaders.reserve(shaders.size());
+  for (Shader* shader : shaders)
+    objects.shaders.push_back(shader ? shader->shader() : nullptr);
+
+  return ReplayCanvasCommands(canvas_, commands.data(), commands.num_elements(),
+                              values.data(), values.num_elements(), objects);
+}
+
 void Canvas::Clear() {
   canvas_ = nullptr;
 }
@@ -414,4 +457,18 @@ bool Canvas::IsRecording() const {
   return !!canvas_;
 }
 
+void Canvas::AddReference(const CanvasImage* image) {
+  if (image && image->image() &&
+      referenced_objects_.insert(image->image().get()).second) {
+    referenced_bytes_ += image->GetImageBytes();
+  }
+}
+
+void Canvas::AddReference(const Picture* picture) {
+  if (picture && picture->picture() &&
+      referenced_objects_.insert(picture->picture().get()).second) {
+    referenced_bytes_ += picture->GetPictureBytes();
+  }
+}
+
 }  // namespace blink
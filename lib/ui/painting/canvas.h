@@ -5,11 +5,15 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_CANVAS_H_
 #define FLUTTER_LIB_UI_PAINTING_CANVAS_H_
 
+#include <unordered_set>
+
+#include "flutter/lib/ui/painting/mask_filter.h"
 #include "flutter/lib/ui/painting/paint.h"
 #include "flutter/lib/ui/painting/path.h"
 #include "flutter/lib/ui/painting/picture.h"
 #include "flutter/lib/ui/painting/picture_recorder.h"
 #include "flutter/lib/ui/painting/rrect.h"
+#include "flutter/lib/ui/painting/shader.h"
 #include "flutter/lib/ui/painting/vertices.h"
 #include "lib/tonic/dart_wrappable.h"
 #include "lib/tonic/typed_data/float32_list.h"
@@ -162,19 +166,39 @@ class Canvas : public ftl::RefCountedThreadSafe<Canvas>,
                   double elevation,
                   bool transparentOccluder);
 
+  // Plays back the commands of a CanvasCommandBuffer, which are described in
+  // canvas_commands.h. As with the functions above, the objects come first.
+  // Returns false if the commands are malformed.
+  bool drawCommands(const std::vector<CanvasPath*>& paths,
+                    const std::vector<CanvasImage*>& images,
+                    const std::vector<Picture*>& pictures,
+                    const std::vector<MaskFilter*>& mask_filters,
+                    const std::vector<Shader*>& shaders,
+                    const tonic::Int32List& commands,
+                    const tonic::Float32List& values);
+
   SkCanvas* canvas() const { return canvas_; }
   void Clear();
   bool IsRecording() const;
 
+  // The bytes of the images and pictures drawn into the recording, each
+  // counted once.
+  size_t referenced_bytes() const { return referenced_bytes_; }
+
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
 
  private:
   explicit Canvas(SkCanvas* canvas);
 
+  void AddReference(const CanvasImage* image);
+  void AddReference(const Picture* picture);
+
   // The SkCanvas is supplied by a call to SkPictureRecorder::beginRecording,
   // which does not transfer ownership.  For this reason, we hold a raw
   // pointer and manually set to null in Clear.
   SkCanvas* canvas_;
+  std::unordered_set<const void*> referenced_objects_;
+  size_t referenced_bytes_;
 };
 
 }  // namespace blink
@@ -0,0 +1,264 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/canvas_commands.h"
+
+#include <math.h>
+
+#include "flutter/lib/ui/painting/paint_decoding.h"
+#include "third_party/skia/include/core/SkRRect.h"
+
+namespace blink {
+namespace {
+
+class CommandReader {
+ public:
+  CommandReader(const int32_t* commands,
+                size_t command_count,
+                const float* values,
+                size_t value_count)
+      : commands_(commands),
+        command_count_(command_count),
+        command_index_(0),
+        values_(values),
+        value_count_(value_count),
+        value_index_(0) {}
+
+  bool done() const { return command_index_ == command_count_; }
+
+  // Returns null if fewer than |count| operands are left.
+  const int32_t* TakeInts(size_t count) {
+    if (command_count_ - command_index_ < count)
+      return nullptr;
+    const int32_t* result = commands_ + command_index_;
+    command_index_ += count;
+    return result;
+  }
+
+  const float* TakeFloats(size_t count) {
+    if (value_count_ - value_index_ < count)
+      return nullptr;
+    const float* result = values_ + value_index_;
+    value_index_ += count;
+    return result;
+  }
+
+ private:
+  const int32_t* commands_;
+  const size_t command_count_;
+  size_t command_index_;
+  const float* values_;
+  const size_t value_count_;
+  size_t value_index_;
+};
+
+template <typename T>
+const T* GetObject(const std::vector<T>& objects, int32_t index) {
+  if (index < 0 || static_cast<size_t>(index) >= objects.size())
+    return nullptr;
+  return &objects[index];
+}
+
+SkRect ReadRect(const float* values) {
+  return SkRect::MakeLTRB(values[0], values[1], values[2], values[3]);
+}
+
+SkRRect ReadRRect(const float* values) {
+  SkVector radii[4] = {{values[4], values[5]},
+                       {values[6], values[7]},
+                       {values[8], values[9]},
+                       {values[10], values[11]}};
+  SkRRect rrect;
+  rrect.setRectRadii(ReadRect(values), radii);
+  return rrect;
+}
+
+bool SetPaint(const int32_t* operands,
+              const CanvasCommandObjects& objects,
+              SkPaint* paint) {
+  *paint = SkPaint();
+  DecodePaintData(reinterpret_cast<const uint32_t*>(operands), paint);
+
+  const int32_t paint_objects = operands[kPaintDataWordCount];
+  if (paint_objects < 0)
+    return true;
+  const sk_sp<SkMaskFilter>* mask_filter =
+      GetObject(objects.mask_filters, paint_objects);
+  const sk_sp<SkShader>* shader = GetObject(objects.shaders, paint_objects);
+  if (!mask_filter || !shader)
+    return false;
+  paint->setMaskFilter(*mask_filter);
+  paint->setShader(*shader);
+  return true;
+}
+
+// Restores never go below |save_count|, the save count of the canvas before
+// the commands were played back.
+bool PlayBack(SkCanvas* canvas,
+              int save_count,
+              CommandReader* reader,
+              const CanvasCommandObjects& objects) {
+  SkPaint paint;
+
+  while (!reader->done()) {
+    const int32_t opcode = *reader->TakeInts(1);
+    if (opcode < 0 || opcode >= static_cast<int32_t>(CanvasCommand::kCount))
+      return false;
+
+    const int32_t* ints = nullptr;
+    const float* floats = nullptr;
+    switch (static_cast<CanvasCommand>(opcode)) {
+      case CanvasCommand::kSave:
+        canvas->save();
+        break;
+      case CanvasCommand::kSaveLayer: {
+        if (!(floats = reader->TakeFloats(4)))
+          return false;
+        SkRect bounds = ReadRect(floats);
+        canvas->saveLayer(&bounds, &paint);
+        break;
+      }
+      case CanvasCommand::kSaveLayerWithoutBounds:
+        canvas->saveLayer(nullptr, &paint);
+        break;
+      case CanvasCommand::kRestore:
+        if (canvas->getSaveCount() <= save_count)
+          return false;
+        canvas->restore();
+        break;
+      case CanvasCommand::kTranslate:
+        if (!(floats = reader->TakeFloats(2)))
+          return false;
+        canvas->translate(floats[0], floats[1]);
+        break;
+      case CanvasCommand::kScale:
+        if (!(floats = reader->TakeFloats(2)))
+          return false;
+        canvas->scale(floats[0], floats[1]);
+        break;
+      case CanvasCommand::kRotate:
+        if (!(floats = reader->TakeFloats(1)))
+          return false;
+        canvas->rotate(floats[0] * 180.0 / M_PI);
+        break;
+      case CanvasCommand::kSkew:
+        if (!(floats = reader->TakeFloats(2)))
+          return false;
+        canvas->skew(floats[0], floats[1]);
+        break;
+      case CanvasCommand::kClipRect:
+        if (!(floats = reader->TakeFloats(4)))
+          return false;
+        canvas->clipRect(ReadRect(floats));
+        break;
+      case CanvasCommand::kClipRRect:
+        if (!(floats = reader->TakeFloats(12)))
+          return false;
+        canvas->clipRRect(ReadRRect(floats), true);
+        break;
+      case CanvasCommand::kClipPath: {
+        if (!(ints = reader->TakeInts(1)))
+          return false;
+        const SkPath* const* path = GetObject(objects.paths, ints[0]);
+        if (!path || !*path)
+          return false;
+        canvas->clipPath(**path, true);
+        break;
+      }
+      case CanvasCommand::kSetPaint:
+        if (!(ints = reader->TakeInts(kPaintDataWordCount + 1)))
+          return false;
+        if (!SetPaint(ints, objects, &paint))
+          return false;
+        break;
+      case CanvasCommand::kDrawColor:
+        if (!(ints = reader->TakeInts(2)))
+          return false;
+        canvas->drawColor(static_cast<SkColor>(ints[0]),
+                          static_cast<SkBlendMode>(ints[1]));
+        break;
+      case CanvasCommand::kDrawLine:
+        if (!(floats = reader->TakeFloats(4)))
+          return false;
+        canvas->drawLine(floats[0], floats[1], floats[2], floats[3], paint);
+        break;
+      case CanvasCommand::kDrawPaint:
+        canvas->drawPaint(paint);
+        break;
+      case CanvasCommand::kDrawRect:
+        if (!(floats = reader->TakeFloats(4)))
+          return false;
+        canvas->drawRect(ReadRect(floats), paint);
+        break;
+      case CanvasCommand::kDrawRRect:
+        if (!(floats = reader->TakeFloats(12)))
+          return false;
+        canvas->drawRRect(ReadRRect(floats), paint);
+        break;
+      case CanvasCommand::kDrawOval:
+        if (!(floats = reader->TakeFloats(4)))
+          return false;
+        canvas->drawOval(ReadRect(floats), paint);
+        break;
+      case CanvasCommand::kDrawCircle:
+        if (!(floats = reader->TakeFloats(3)))
+          return false;
+        canvas->drawCircle(floats[0], floats[1], floats[2], paint);
+        break;
+      case CanvasCommand::kDrawArc:
+        if (!(ints = reader->TakeInts(1)) || !(floats = reader->TakeFloats(6)))
+          return false;
+        canvas->drawArc(ReadRect(floats), floats[4] * 180.0 / M_PI,
+                        floats[5] * 180.0 / M_PI, ints[0] != 0, paint);
+        break;
+      case CanvasCommand::kDrawPath: {
+        if (!(ints = reader->TakeInts(1)))
+          return false;
+        const SkPath* const* path = GetObject(objects.paths, ints[0]);
+        if (!path || !*path)
+          return false;
+        canvas->drawPath(**path, paint);
+        break;
+      }
+      case CanvasCommand::kDrawImage: {
+        if (!(ints = reader->TakeInts(1)) || !(floats = reader->TakeFloats(2)))
+          return false;
+        const sk_sp<SkImage>* image = GetObject(objects.images, ints[0]);
+        if (!image || !*image)
+          return false;
+        canvas->drawImage(image->get(), floats[0], floats[1], &paint);
+        break;
+      }
+      case CanvasCommand::kDrawPicture: {
+        if (!(ints = reader->TakeInts(1)))
+          return false;
+        const sk_sp<SkPicture>* picture = GetObject(objects.pictures, ints[0]);
+        if (!picture || !*picture)
+          return false;
+        canvas->drawPicture(picture->get());
+        break;
+      }
+      case CanvasCommand::kCount:
+        return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+bool ReplayCanvasCommands(SkCanvas* canvas,
+                          const int32_t* commands,
+                          size_t command_count,
+                          const float* values,
+                          size_t value_count,
+                          const CanvasCommandObjects& objects) {
+  CommandReader reader(commands, command_count, values, value_count);
+  const int save_count = canvas->getSaveCount();
+  const bool result = PlayBack(canvas, save_count, &reader, objects);
+  canvas->restoreToCount(save_count);
+  return result;
+}
+
+}  // namespace blink
@@ -0,0 +1,81 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_CANVAS_COMMANDS_H_
+#define FLUTTER_LIB_UI_PAINTING_CANVAS_COMMANDS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkMaskFilter.h"
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkShader.h"
+
+namespace blink {
+
+// The commands of a CanvasCommandBuffer in painting.dart. Each is an opcode in
+// the integer stream, followed by the integer operands listed here, and takes
+// its float operands from the float stream in the order listed.
+//
+// Drawing commands use the paint set by the last kSetPaint.
+//
+// Must be kept in sync with painting.dart.
+enum class CanvasCommand : int32_t {
+  kSave,                    //
+  kSaveLayer,               // floats: left, top, right, bottom
+  kSaveLayerWithoutBounds,  //
+  kRestore,                 //
+  kTranslate,               // floats: dx, dy
+  kScale,                   // floats: sx, sy
+  kRotate,                  // floats: radians
+  kSkew,                    // floats: sx, sy
+  kClipRect,                // floats: left, top, right, bottom
+  kClipRRect,               // floats: left, top, right, bottom, 8 radii
+  kClipPath,                // ints: path
+  kSetPaint,                // ints: 12 words of paint data, paint objects
+  kDrawColor,               // ints: color, blend mode
+  kDrawLine,                // floats: x1, y1, x2, y2
+  kDrawPaint,               //
+  kDrawRect,                // floats: left, top, right, bottom
+  kDrawRRect,               // floats: left, top, right, bottom, 8 radii
+  kDrawOval,                // floats: left, top, right, bottom
+  kDrawCircle,              // floats: x, y, radius
+  kDrawArc,                 // ints: use center
+                            // floats: left, top, right, bottom, start, sweep
+  kDrawPath,                // ints: path
+  kDrawImage,               // ints: image; floats: x, y
+  kDrawPicture,             // ints: picture
+  kCount,
+};
+
+// The objects commands refer to by index. The paint objects of a kSetPaint
+// index into both |mask_filters| and |shaders|, or are -1 for none.
+struct CanvasCommandObjects {
+  std::vector<const SkPath*> paths;
+  std::vector<sk_sp<SkImage>> images;
+  std::vector<sk_sp<SkPicture>> pictures;
+  std::vector<sk_sp<SkMaskFilter>> mask_filters;
+  std::vector<sk_sp<SkShader>> shaders;
+};
+
+// Plays the commands back into |canvas|. Returns false if they are malformed,
+// in which case the commands before the malformed one have been played back.
+// A restore without a matching save in the commands is malformed, and saves
+// left unrestored are restored at the end, so the save count of |canvas| is
+// the same afterwards.
+bool ReplayCanvasCommands(SkCanvas* canvas,
+                          const int32_t* commands,
+                          size_t command_count,
+                          const float* values,
+                          size_t value_count,
+                          const CanvasCommandObjects& objects);
+
+}  // namespace blink
+
+#endif  // FLUTTER_LIB_UI_PAINTING_CANVAS_COMMANDS_H_
@@ -0,0 +1,149 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Compares recording a chart of many small primitives into a picture one
+// canvas call at a time, decoding the paint of every call the way the Canvas
+// bindings do, with playing the same primitives back from a command buffer.
+// The per-call numbers exclude the transitions from Dart into the engine,
+// which the command buffer saves on top of what is measured here.
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "flutter/lib/ui/painting/canvas_commands.h"
+#include "flutter/lib/ui/painting/paint_decoding.h"
+#include "lib/ftl/time/time_delta.h"
+#include "lib/ftl/time/time_point.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+
+namespace {
+
+using blink::CanvasCommand;
+
+constexpr size_t kPrimitiveCount = 20000;
+constexpr size_t kIterations = 50;
+
+const SkRect kChartBounds = SkRect::MakeWH(1080, 1920);
+
+// A point of the chart, drawn as a circle, and the line to the next point.
+struct Point {
+  float x;
+  float y;
+};
+
+// The data of a Paint in painting.dart: a stroked, colored paint.
+struct EncodedPaint {
+  uint32_t words[blink::kPaintDataWordCount];
+};
+
+EncodedPaint MakePaint(SkColor color, float stroke_width) {
+  EncodedPaint paint;
+  memset(&paint, 0, sizeof(paint));
+  paint.words[1] = color ^ 0xFF000000;  // kColorIndex
+  paint.words[3] = SkPaint::kStroke_Style;
+  memcpy(&paint.words[4], &stroke_width, sizeof(float));
+  return paint;
+}
+
+std::vector<Point> MakePoints() {
+  std::vector<Point> points(kPrimitiveCount / 2);
+  for (size_t i = 0; i < points.size(); i++) {
+    points[i].x = kChartBounds.width() * i / points.size();
+    points[i].y = kChartBounds.height() * (0.5f + 0.4f * ((i * 37) % 100) / 100);
+  }
+  return points;
+}
+
+void RecordPerCall(SkCanvas* canvas,
+                   const std::vector<Point>& points,
+                   const EncodedPaint& line_paint,
+                   const EncodedPaint& dot_paint) {
+  for (size_t i = 0; i + 1 < points.size(); i++) {
+    SkPaint paint;
+    blink::DecodePaintData(line_paint.words, &paint);
+    canvas->drawLine(points[i].x, points[i].y, points[i + 1].x,
+                     points[i + 1].y, paint);
+
+    SkPaint dot;
+    blink::DecodePaintData(dot_paint.words, &dot);
+    canvas->drawCircle(points[i].x, points[i].y, 2, dot);
+  }
+}
+
+void AddPaint(std::vector<int32_t>* commands, const EncodedPaint& paint) {
+  commands->push_back(static_cast<int32_t>(CanvasCommand::kSetPaint));
+  for (uint32_t word : paint.words)
+    commands->push_back(static_cast<int32_t>(word));
+  commands->push_back(-1);
+}
+
+// Encodes the chart the way CanvasCommandBuffer in painting.dart does, which
+// sets the paint before every drawing command.
+void EncodeCommands(const std::vector<Point>& points,
+                    const EncodedPaint& line_paint,
+                    const EncodedPaint& dot_paint,
+                    std::vector<int32_t>* commands,
+                    std::vector<float>* values) {
+  for (size_t i = 0; i + 1 < points.size(); i++) {
+    AddPaint(commands, line_paint);
+    commands->push_back(static_cast<int32_t>(CanvasCommand::kDrawLine));
+    values->insert(values->end(), {points[i].x, points[i].y, points[i + 1].x,
+                                   points[i + 1].y});
+
+    AddPaint(commands, dot_paint);
+    commands->push_back(static_cast<int32_t>(CanvasCommand::kDrawCircle));
+    values->insert(values->end(), {points[i].x, points[i].y, 2});
+  }
+}
+
+template <typename Record>
+void Run(const char* name, Record record) {
+  ftl::TimeDelta total;
+  int op_count = 0;
+  for (size_t i = 0; i < kIterations; i++) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(kChartBounds);
+    const ftl::TimePoint start = ftl::TimePoint::Now();
+    if (!record(canvas)) {
+      fprintf(stderr, "%s: the commands are malformed.\n", name);
+      return;
+    }
+    total = total + (ftl::TimePoint::Now() - start);
+    op_count = recorder.finishRecordingAsPicture()->approximateOpCount();
+  }
+  printf("%-16s %12.1f %12.1f %12d\n", name,
+         total.ToNanoseconds() / (1000.0 * kIterations),
+         total.ToNanoseconds() / static_cast<double>(kIterations * op_count),
+         op_count);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const std::vector<Point> points = MakePoints();
+  const EncodedPaint line_paint = MakePaint(SK_ColorBLUE, 1);
+  const EncodedPaint dot_paint = MakePaint(SK_ColorRED, 2);
+
+  std::vector<int32_t> commands;
+  std::vector<float> values;
+  EncodeCommands(points, line_paint, dot_paint, &commands, &values);
+  const blink::CanvasCommandObjects objects;
+
+  printf("%zu primitives, %zu iterations\n", kPrimitiveCount, kIterations);
+  printf("%-16s %12s %12s %12s\n", "strategy", "record (us)", "per op (ns)",
+         "ops");
+  Run("per call", [&](SkCanvas* canvas) {
+    RecordPerCall(canvas, points, line_paint, dot_paint);
+    return true;
+  });
+  Run("command buffer", [&](SkCanvas* canvas) {
+    return blink::ReplayCanvasCommands(canvas, commands.data(),
+                                       commands.size(), values.data(),
+                                       values.size(), objects);
+  });
+
+  return 0;
+}
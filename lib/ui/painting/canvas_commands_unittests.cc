@@ -0,0 +1,78 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/canvas_commands.h"
+
+#include <vector>
+
+#include "third_party/gtest/include/gtest/gtest.h"
+
+namespace blink {
+namespace {
+
+constexpr int32_t Op(CanvasCommand command) {
+  return static_cast<int32_t>(command);
+}
+
+bool Replay(SkCanvas* canvas,
+            const std::vector<int32_t>& commands,
+            const std::vector<float>& values) {
+  CanvasCommandObjects objects;
+  return ReplayCanvasCommands(canvas, commands.data(), commands.size(),
+                              values.data(), values.size(), objects);
+}
+
+}  // namespace
+
+TEST(CanvasCommands, ReplaysBalancedSaves) {
+  SkCanvas canvas(100, 100);
+  ASSERT_TRUE(Replay(&canvas,
+                     {Op(CanvasCommand::kSave), Op(CanvasCommand::kTranslate),
+                      Op(CanvasCommand::kSave), Op(CanvasCommand::kRestore),
+                      Op(CanvasCommand::kRestore)},
+                     {10, 20}));
+  ASSERT_EQ(canvas.getSaveCount(), 1);
+  ASSERT_TRUE(canvas.getTotalMatrix().isIdentity());
+}
+
+TEST(CanvasCommands, RejectsRestoreWithoutSave) {
+  SkCanvas canvas(100, 100);
+  canvas.save();
+  canvas.translate(10, 20);
+
+  // The restore would pop the save made before the commands.
+  ASSERT_FALSE(Replay(&canvas,
+                      {Op(CanvasCommand::kSave), Op(CanvasCommand::kRestore),
+                       Op(CanvasCommand::kRestore)},
+                      {}));
+  ASSERT_EQ(canvas.getSaveCount(), 2);
+  ASSERT_EQ(canvas.getTotalMatrix().getTranslateX(), 10);
+  ASSERT_EQ(canvas.getTotalMatrix().getTranslateY(), 20);
+}
+
+TEST(CanvasCommands, RestoresSavesLeftOpen) {
+  SkCanvas canvas(100, 100);
+  ASSERT_TRUE(Replay(&canvas,
+                     {Op(CanvasCommand::kSave), Op(CanvasCommand::kTranslate),
+                      Op(CanvasCommand::kSaveLayerWithoutBounds),
+                      Op(CanvasCommand::kClipRect)},
+                     {10, 20, 0, 0, 50, 50}));
+  ASSERT_EQ(canvas.getSaveCount(), 1);
+  ASSERT_TRUE(canvas.getTotalMatrix().isIdentity());
+  SkIRect clip;
+  ASSERT_TRUE(canvas.getDeviceClipBounds(&clip));
+  ASSERT_EQ(clip, SkIRect::MakeWH(100, 100));
+}
+
+TEST(CanvasCommands, RestoresSavesLeftOpenByMalformedCommands) {
+  SkCanvas canvas(100, 100);
+  // The translate is missing its operands.
+  ASSERT_FALSE(Replay(&canvas,
+                      {Op(CanvasCommand::kSave), Op(CanvasCommand::kSave),
+                       Op(CanvasCommand::kTranslate)},
+                      {}));
+  ASSERT_EQ(canvas.getSaveCount(), 1);
+}
+
+}  // namespace blink
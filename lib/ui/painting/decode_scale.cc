@@ -0,0 +1,25 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/decode_scale.h"
+
+#include <algorithm>
+
+namespace blink {
+
+float ComputeDecodeScale(const SkISize& size,
+                         int target_width,
+                         int target_height) {
+  float scale = 1;
+  if (target_width > 0 && target_width < size.width())
+    scale = static_cast<float>(target_width) / size.width();
+  if (target_height > 0 && target_height < size.height()) {
+    const float height_scale =
+        static_cast<float>(target_height) / size.height();
+    scale = target_width > 0 ? std::max(scale, height_scale) : height_scale;
+  }
+  return scale;
+}
+
+}  // namespace blink
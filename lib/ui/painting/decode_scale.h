@@ -0,0 +1,20 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_DECODE_SCALE_H_
+#define FLUTTER_LIB_UI_PAINTING_DECODE_SCALE_H_
+
+#include "third_party/skia/include/core/SkSize.h"
+
+namespace blink {
+
+// The scale at which an image of |size| still covers the target size in the
+// dimensions given. Zero target dimensions are ignored. Never more than one.
+float ComputeDecodeScale(const SkISize& size,
+                         int target_width,
+                         int target_height);
+
+}  // namespace blink
+
+#endif  // FLUTTER_LIB_UI_PAINTING_DECODE_SCALE_H_
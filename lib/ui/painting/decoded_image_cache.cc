@@ -0,0 +1,168 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
+
+#include <string.h>
+
+#include <iterator>
+#include <utility>
+
+namespace blink {
+namespace {
+
+constexpr uint64_t kHashMultiplier = 0x9E3779B97F4A7C15ull;
+
+uint64_t Mix(uint64_t hash, uint64_t value) {
+  hash ^= value;
+  hash *= kHashMultiplier;
+  return hash ^ (hash >> 29);
+}
+
+size_t EstimateBytes(const SkImage& image) {
+  return static_cast<size_t>(image.width()) * image.height() * 4;
+}
+
+}  // namespace
+
+constexpr size_t DecodedImageCache::kDefaultMaxBytes;
+
+uint64_t DecodedImageKey::HashContent(const void* data, size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  uint64_t hash = Mix(0, size);
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, bytes + i, sizeof(word));
+    hash = Mix(hash, word);
+  }
+  uint64_t tail = 0;
+  memcpy(&tail, bytes + i, size - i);
+  return Mix(hash, tail);
+}
+
+DecodedImageKey DecodedImageKey::Create(sk_sp<SkData> content,
+                                        int target_width,
+                                        int target_height) {
+  DecodedImageKey key;
+  key.content_hash = HashContent(content->data(), content->size());
+  key.content = std::move(content);
+  key.target_width = target_width;
+  key.target_height = target_height;
+  return key;
+}
+
+bool DecodedImageKey::operator==(const DecodedImageKey& other) const {
+  if (content_hash != other.content_hash ||
+      target_width != other.target_width ||
+      target_height != other.target_height) {
+    return false;
+  }
+  if (content == other.content)
+    return true;
+  return content && other.content && content->equals(other.content.get());
+}
+
+size_t DecodedImageCache::KeyHash::operator()(
+    const DecodedImageKey& key) const {
+  uint64_t hash = key.content_hash;
+  hash = Mix(hash, static_cast<uint64_t>(key.target_width));
+  hash = Mix(hash, static_cast<uint64_t>(key.target_height));
+  return static_cast<size_t>(hash);
+}
+
+DecodedImageCache::DecodedImageCache(size_t max_bytes)
+    : max_bytes_(max_bytes), bytes_(0), hit_count_(0), miss_count_(0) {}
+
+DecodedImageCache::~DecodedImageCache() = default;
+
+sk_sp<SkImage> DecodedImageCache::Get(const DecodedImageKey& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = index_.find(key);
+  if (found == index_.end()) {
+    miss_count_++;
+    return nullptr;
+  }
+  hit_count_++;
+  entries_.splice(entries_.begin(), entries_, found->second);
+  return found->second->image;
+}
+
+void DecodedImageCache::Put(const DecodedImageKey& key, sk_sp<SkImage> image) {
+  if (!image)
+    return;
+  const size_t bytes =
+      EstimateBytes(*image) + (key.content ? key.content->size() : 0);
+  if (bytes > max_bytes_)
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(key);
+    if (found != index_.end())
+      Erase(found->second);
+
+    entries_.push_front(Entry{key, std::move(image), bytes});
+    index_.emplace(key, entries_.begin());
+    bytes_ += bytes;
+
+    while (bytes_ > max_bytes_)
+      Erase(std::prev(entries_.end()));
+  }
+  NotifyObserver();
+}
+
+void DecodedImageCache::Trim(size_t max_bytes) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (bytes_ > max_bytes)
+      Erase(std::prev(entries_.end()));
+  }
+  NotifyObserver();
+}
+
+void DecodedImageCache::SetBytesObserver(
+    std::function<void(size_t bytes)> observer) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    observer_ = std::move(observer);
+  }
+  NotifyObserver();
+}
+
+size_t DecodedImageCache::bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return bytes_;
+}
+
+uint64_t DecodedImageCache::hit_count() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return hit_count_;
+}
+
+uint64_t DecodedImageCache::miss_count() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return miss_count_;
+}
+
+void DecodedImageCache::Erase(EntryList::iterator entry) {
+  bytes_ -= entry->bytes;
+  index_.erase(entry->key);
+  entries_.erase(entry);
+}
+
+void DecodedImageCache::NotifyObserver() {
+  std::function<void(size_t bytes)> observer;
+  size_t bytes;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!observer_)
+      return;
+    observer = observer_;
+    bytes = bytes_;
+  }
+  observer(bytes);
+}
+
+}  // namespace blink
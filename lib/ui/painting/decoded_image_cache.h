@@ -0,0 +1,109 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
+#define FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "lib/ftl/macros.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkImage.h"
+
+namespace blink {
+
+// Identifies the result of decoding some encoded image at a target size.
+struct DecodedImageKey {
+  // The encoded bytes. Keys whose hashes match also compare these, so that
+  // different images never share a decoded image.
+  sk_sp<SkData> content;
+  uint64_t content_hash = 0;
+  // Zero for the size of the encoded image.
+  int target_width = 0;
+  int target_height = 0;
+
+  static DecodedImageKey Create(sk_sp<SkData> content,
+                                int target_width,
+                                int target_height);
+
+  static uint64_t HashContent(const void* data, size_t size);
+
+  bool operator==(const DecodedImageKey& other) const;
+};
+
+// Decoded images by the encoded bytes they were decoded from and their target
+// size, so that decoding the same bytes again, as happens when an asset is
+// shown by several widgets, is a lookup. An entry accounts for the pixels of
+// its image and the encoded bytes its key keeps. Once the entries exceed the
+// byte budget, the least recently used ones are evicted.
+//
+// May be used from any thread.
+class DecodedImageCache {
+ public:
+  static constexpr size_t kDefaultMaxBytes = 16 * 1024 * 1024;
+
+  explicit DecodedImageCache(size_t max_bytes);
+
+  ~DecodedImageCache();
+
+  // Returns null if the image is not cached.
+  sk_sp<SkImage> Get(const DecodedImageKey& key);
+
+  void Put(const DecodedImageKey& key, sk_sp<SkImage> image);
+
+  // Evicts the least recently used images till at most |max_bytes| remain.
+  void Trim(size_t max_bytes);
+
+  // Called with the bytes held whenever they change, on the thread that
+  // changed them and without the cache locked.
+  void SetBytesObserver(std::function<void(size_t bytes)> observer);
+
+  size_t max_bytes() const { return max_bytes_; }
+
+  size_t bytes() const;
+
+  uint64_t hit_count() const;
+
+  uint64_t miss_count() const;
+
+ private:
+  struct KeyHash {
+    size_t operator()(const DecodedImageKey& key) const;
+  };
+
+  struct Entry {
+    DecodedImageKey key;
+    sk_sp<SkImage> image;
+    size_t bytes;
+  };
+
+  // Most recently used first.
+  using EntryList = std::list<Entry>;
+
+  const size_t max_bytes_;
+  mutable std::mutex mutex_;
+  // Guarded by |mutex_|.
+  size_t bytes_;
+  uint64_t hit_count_;
+  uint64_t miss_count_;
+  EntryList entries_;
+  std::unordered_map<DecodedImageKey, EntryList::iterator, KeyHash> index_;
+  std::function<void(size_t bytes)> observer_;
+
+  void Erase(EntryList::iterator entry);
+
+  void NotifyObserver();
+
+  FTL_DISALLOW_COPY_AND_ASSIGN(DecodedImageCache);
+};
+
+}  // namespace blink
+
+#endif  // FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
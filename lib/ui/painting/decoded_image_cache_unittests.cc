@@ -0,0 +1,122 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
+
+#include <string>
+
+#include "third_party/gtest/include/gtest/gtest.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace blink {
+namespace {
+
+sk_sp<SkImage> MakeImage(int width, int height) {
+  return SkSurface::MakeRasterN32Premul(width, height)->makeImageSnapshot();
+}
+
+// Each call returns new data, as a decode request does.
+sk_sp<SkData> MakeContent(const std::string& content) {
+  return SkData::MakeWithCopy(content.data(), content.size());
+}
+
+DecodedImageKey MakeKey(const std::string& content,
+                        int target_width = 0,
+                        int target_height = 0) {
+  return DecodedImageKey::Create(MakeContent(content), target_width,
+                                 target_height);
+}
+
+// The bytes of a cached 10x10 image decoded from one byte of content.
+constexpr size_t kEntryBytes = 10 * 10 * 4 + 1;
+
+}  // namespace
+
+TEST(DecodedImageCache, ReturnsImageForSameContent) {
+  DecodedImageCache cache(DecodedImageCache::kDefaultMaxBytes);
+  sk_sp<SkImage> image = MakeImage(10, 10);
+  cache.Put(MakeKey("a"), image);
+
+  ASSERT_EQ(cache.Get(MakeKey("a")), image);
+  ASSERT_EQ(cache.hit_count(), 1u);
+  ASSERT_EQ(cache.miss_count(), 0u);
+  ASSERT_EQ(cache.bytes(), kEntryBytes);
+}
+
+TEST(DecodedImageCache, MissesOnDifferentContent) {
+  DecodedImageCache cache(DecodedImageCache::kDefaultMaxBytes);
+  cache.Put(MakeKey("a"), MakeImage(10, 10));
+
+  ASSERT_EQ(cache.Get(MakeKey("b")), nullptr);
+  ASSERT_EQ(cache.Get(MakeKey("aa")), nullptr);
+  ASSERT_EQ(cache.miss_count(), 2u);
+}
+
+TEST(DecodedImageCache, MissesOnDifferentContentWithSameHash) {
+  DecodedImageCache cache(DecodedImageCache::kDefaultMaxBytes);
+  DecodedImageKey key = MakeKey("a");
+  cache.Put(key, MakeImage(10, 10));
+
+  DecodedImageKey colliding = MakeKey("b");
+  colliding.content_hash = key.content_hash;
+  ASSERT_EQ(cache.Get(colliding), nullptr);
+  ASSERT_NE(cache.Get(key), nullptr);
+}
+
+TEST(DecodedImageCache, KeysImagesOnTheirTargetSize) {
+  DecodedImageCache cache(DecodedImageCache::kDefaultMaxBytes);
+  sk_sp<SkImage> full = MakeImage(10, 10);
+  sk_sp<SkImage> scaled = MakeImage(5, 4);
+  cache.Put(MakeKey("a"), full);
+  cache.Put(MakeKey("a", 5, 4), scaled);
+
+  ASSERT_EQ(cache.Get(MakeKey("a")), full);
+  ASSERT_EQ(cache.Get(MakeKey("a", 5, 4)), scaled);
+  ASSERT_EQ(cache.Get(MakeKey("a", 4, 5)), nullptr);
+  ASSERT_EQ(cache.Get(MakeKey("a", 5, 0)), nullptr);
+  ASSERT_EQ(cache.bytes(), kEntryBytes + 5 * 4 * 4 + 1);
+}
+
+TEST(DecodedImageCache, EvictsLeastRecentlyUsedOverBudget) {
+  DecodedImageCache cache(2 * kEntryBytes);
+  cache.Put(MakeKey("a"), MakeImage(10, 10));
+  cache.Put(MakeKey("b"), MakeImage(10, 10));
+  // Makes "b" the least recently used.
+  ASSERT_NE(cache.Get(MakeKey("a")), nullptr);
+  cache.Put(MakeKey("c"), MakeImage(10, 10));
+
+  ASSERT_EQ(cache.bytes(), 2 * kEntryBytes);
+  ASSERT_NE(cache.Get(MakeKey("a")), nullptr);
+  ASSERT_EQ(cache.Get(MakeKey("b")), nullptr);
+  ASSERT_NE(cache.Get(MakeKey("c")), nullptr);
+}
+
+TEST(DecodedImageCache, DoesNotCacheImagesOverBudget) {
+  DecodedImageCache cache(kEntryBytes - 1);
+  cache.Put(MakeKey("a"), MakeImage(10, 10));
+
+  ASSERT_EQ(cache.bytes(), 0u);
+  ASSERT_EQ(cache.Get(MakeKey("a")), nullptr);
+}
+
+TEST(DecodedImageCache, TrimEvictsLeastRecentlyUsed) {
+  DecodedImageCache cache(DecodedImageCache::kDefaultMaxBytes);
+  size_t observed_bytes = 0;
+  cache.SetBytesObserver([&observed_bytes](size_t bytes) {
+    observed_bytes = bytes;
+  });
+  cache.Put(MakeKey("a"), MakeImage(10, 10));
+  cache.Put(MakeKey("b"), MakeImage(10, 10));
+  ASSERT_EQ(observed_bytes, 2 * kEntryBytes);
+
+  cache.Trim(kEntryBytes);
+  ASSERT_EQ(observed_bytes, kEntryBytes);
+  ASSERT_EQ(cache.Get(MakeKey("a")), nullptr);
+  ASSERT_NE(cache.Get(MakeKey("b")), nullptr);
+
+  cache.Trim(0);
+  ASSERT_EQ(cache.bytes(), 0u);
+}
+
+}  // namespace blink
@@ -10,6 +10,9 @@
 #include "lib/tonic/dart_binding_macros.h"
 #include "lib/tonic/converter/dart_converter.h"
 #include "lib/tonic/dart_library_natives.h"
+#include "third_party/skia/include/core/SkPixmap.h"
+#include "third_party/skia/include/gpu/GrTexture.h"
+#include "third_party/skia/src/image/SkImage_Base.h"
 
 namespace blink {
 
@@ -28,7 +31,8 @@ void CanvasImage::RegisterNatives(tonic::DartLibraryNatives* natives) {
   natives->Register({FOR_EACH_BINDING(DART_REGISTER_NATIVE)});
 }
 
-CanvasImage::CanvasImage() {}
+CanvasImage::CanvasImage()
+    : external_allocation_(ExternalAllocationKind::kImage) {}
 
 CanvasImage::~CanvasImage() {
   // Skia objects must be deleted on the IO thread so that any associated GL
@@ -40,12 +44,22 @@ void CanvasImage::dispose() {
   ClearDartWrapper();
 }
 
+size_t CanvasImage::GetImageBytes() const {
+  if (!image_)
+    return 0;
+  SkPixmap pixmap;
+  if (image_->peekPixels(&pixmap))
+    return pixmap.rowBytes() * pixmap.height();
+  // The texture knows its config and whether it has mipmaps.
+  if (GrTexture* texture = as_IB(image_.get())->peekTexture())
+    return texture->gpuMemorySize();
+  // Images generated lazily, like those of pictures, are rasterized at 32 bits
+  // per pixel when drawn.
+  return static_cast<size_t>(image_->width()) * image_->height() * 4;
+}
+
 size_t CanvasImage::GetAllocationSize() {
-  if (image_) {
-    return image_->width() * image_->height() * 4;
-  } else {
-    return sizeof(CanvasImage);
-  }
+  return external_allocation_.Update(sizeof(CanvasImage) + GetImageBytes());
 }
 
 }  // namespace blink
@@ -5,6 +5,7 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_IMAGE_H_
 #define FLUTTER_LIB_UI_PAINTING_IMAGE_H_
 
+#include "flutter/lib/ui/external_allocation.h"
 #include "lib/tonic/dart_wrappable.h"
 #include "third_party/skia/include/core/SkImage.h"
 
@@ -32,6 +33,10 @@ class CanvasImage final : public ftl::RefCountedThreadSafe<CanvasImage>,
   const sk_sp<SkImage>& image() const { return image_; }
   void set_image(sk_sp<SkImage> image) { image_ = std::move(image); }
 
+  // The bytes of the pixels of the image, whether they are in memory or in a
+  // texture.
+  size_t GetImageBytes() const;
+
   virtual size_t GetAllocationSize() override;
 
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
@@ -40,6 +45,7 @@ class CanvasImage final : public ftl::RefCountedThreadSafe<CanvasImage>,
   CanvasImage();
 
   sk_sp<SkImage> image_;
+  ExternalAllocation external_allocation_;
 };
 
 }  // namespace blink
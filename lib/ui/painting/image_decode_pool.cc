@@ -0,0 +1,109 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/image_decode_pool.h"
+
+#include <string>
+#include <utility>
+
+#include "flutter/common/settings.h"
+#include "lib/ftl/logging.h"
+
+namespace blink {
+namespace {
+
+void UpdateMax(std::atomic<int64_t>* max, int64_t value) {
+  int64_t current = max->load();
+  while (value > current && !max->compare_exchange_weak(current, value)) {
+  }
+}
+
+}  // namespace
+
+constexpr size_t ImageDecodePool::kDefaultWorkerCount;
+
+ImageDecodePool& ImageDecodePool::Get() {
+  // Leaked, as decodes may still be in flight when the process exits.
+  static ImageDecodePool* pool = [] {
+    const Settings& settings = Settings::Get();
+    return new ImageDecodePool(
+        settings.image_decode_worker_count > 0
+            ? settings.image_decode_worker_count
+            : kDefaultWorkerCount,
+        settings.decoded_image_cache_max_bytes > 0
+            ? settings.decoded_image_cache_max_bytes
+            : DecodedImageCache::kDefaultMaxBytes);
+  }();
+  return *pool;
+}
+
+ImageDecodePool::ImageDecodePool(size_t worker_count, size_t cache_max_bytes)
+    : cache_(cache_max_bytes),
+      max_queue_depth_(0),
+      decode_count_(0),
+      total_decode_latency_micros_(0),
+      max_decode_latency_micros_(0) {
+  FTL_DCHECK(worker_count > 0);
+  for (size_t i = 0; i < worker_count; i++) {
+    std::unique_ptr<Worker> worker(new Worker());
+    worker->thread = std::make_unique<fml::Thread>(
+        "image_decode_" + std::to_string(i + 1));
+    worker->pending = 0;
+    workers_.push_back(std::move(worker));
+  }
+}
+
+ImageDecodePool::~ImageDecodePool() {
+  for (auto& worker : workers_)
+    worker->thread->Join();
+}
+
+void ImageDecodePool::PostDecode(ftl::Closure task) {
+  Worker* worker = workers_[0].get();
+  for (auto& candidate : workers_) {
+    if (candidate->pending.load() < worker->pending.load())
+      worker = candidate.get();
+  }
+
+  worker->pending++;
+
+  size_t queue_depth = 0;
+  for (auto& candidate : workers_)
+    queue_depth += candidate->pending.load();
+  size_t max_queue_depth = max_queue_depth_.load();
+  while (queue_depth > max_queue_depth &&
+         !max_queue_depth_.compare_exchange_weak(max_queue_depth,
+                                                 queue_depth)) {
+  }
+
+  worker->thread->GetTaskRunner()->PostTask(
+      [ worker, task = std::move(task) ]() {
+        task();
+        worker->pending--;
+      });
+}
+
+void ImageDecodePool::RecordDecodeLatency(ftl::TimeDelta latency) {
+  const int64_t micros = latency.ToMicroseconds();
+  decode_count_++;
+  total_decode_latency_micros_ += micros;
+  UpdateMax(&max_decode_latency_micros_, micros);
+}
+
+ImageDecodeStats ImageDecodePool::GetStats() const {
+  ImageDecodeStats stats;
+  stats.worker_count = workers_.size();
+  for (const auto& worker : workers_)
+    stats.queue_depth += worker->pending.load();
+  stats.max_queue_depth = max_queue_depth_.load();
+  stats.decode_count = decode_count_.load();
+  stats.total_decode_latency_micros = total_decode_latency_micros_.load();
+  stats.max_decode_latency_micros = max_decode_latency_micros_.load();
+  stats.cache_hit_count = cache_.hit_count();
+  stats.cache_miss_count = cache_.miss_count();
+  stats.cache_bytes = cache_.bytes();
+  return stats;
+}
+
+}  // namespace blink
@@ -0,0 +1,77 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_IMAGE_DECODE_POOL_H_
+#define FLUTTER_LIB_UI_PAINTING_IMAGE_DECODE_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "flutter/fml/thread.h"
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
+#include "lib/ftl/functional/closure.h"
+#include "lib/ftl/macros.h"
+#include "lib/ftl/time/time_delta.h"
+
+namespace blink {
+
+struct ImageDecodeStats {
+  size_t worker_count = 0;
+  // Decodes posted to the workers that have yet to finish.
+  size_t queue_depth = 0;
+  size_t max_queue_depth = 0;
+  uint64_t decode_count = 0;
+  // From the request to the decoded image being ready for the isolate.
+  int64_t total_decode_latency_micros = 0;
+  int64_t max_decode_latency_micros = 0;
+  uint64_t cache_hit_count = 0;
+  uint64_t cache_miss_count = 0;
+  size_t cache_bytes = 0;
+};
+
+// The threads images are decoded on, shared by all isolates, and the cache of
+// what they decoded.
+class ImageDecodePool {
+ public:
+  static constexpr size_t kDefaultWorkerCount = 2;
+
+  // Created from the settings on first use.
+  static ImageDecodePool& Get();
+
+  ImageDecodePool(size_t worker_count, size_t cache_max_bytes);
+
+  ~ImageDecodePool();
+
+  // Runs |task| on the worker with the fewest decodes pending.
+  void PostDecode(ftl::Closure task);
+
+  void RecordDecodeLatency(ftl::TimeDelta latency);
+
+  DecodedImageCache& cache() { return cache_; }
+
+  ImageDecodeStats GetStats() const;
+
+ private:
+  struct Worker {
+    std::unique_ptr<fml::Thread> thread;
+    std::atomic<size_t> pending;
+  };
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  DecodedImageCache cache_;
+  std::atomic<size_t> max_queue_depth_;
+  std::atomic<uint64_t> decode_count_;
+  std::atomic<int64_t> total_decode_latency_micros_;
+  std::atomic<int64_t> max_decode_latency_micros_;
+
+  FTL_DISALLOW_COPY_AND_ASSIGN(ImageDecodePool);
+};
+
+}  // namespace blink
+
+#endif  // FLUTTER_LIB_UI_PAINTING_IMAGE_DECODE_POOL_H_
@@ -6,7 +6,9 @@
 
 #include "flutter/common/threads.h"
 #include "flutter/glue/trace_event.h"
+#include "flutter/lib/ui/painting/decode_scale.h"
 #include "flutter/lib/ui/painting/image.h"
+#include "flutter/lib/ui/painting/image_decode_pool.h"
 #include "flutter/lib/ui/painting/resource_context.h"
 #include "lib/ftl/build_config.h"
 #include "lib/ftl/functional/make_copyable.h"
@@ -14,6 +16,8 @@
 #include "lib/tonic/dart_state.h"
 #include "lib/tonic/logging/dart_invoke.h"
 #include "lib/tonic/typed_data/uint8_list.h"
+#include "third_party/skia/include/codec/SkCodec.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkImageGenerator.h"
 
 using tonic::DartInvoke;
@@ -23,22 +27,46 @@ using tonic::ToDart;
 namespace blink {
 namespace {
 
-sk_sp<SkImage> DecodeImage(sk_sp<SkData> buffer) {
+// Decodes the image into memory. Codecs that can, like those of JPEG and
+// WebP, decode it no larger than needed for the target size.
+sk_sp<SkImage> DecodeImage(sk_sp<SkData> buffer,
+                           int target_width,
+                           int target_height) {
   TRACE_EVENT0("blink", "DecodeImage");
 
   if (buffer == nullptr || buffer->isEmpty()) {
     return nullptr;
   }
 
-  GrContext* context = ResourceContext::Get();
-  if (context) {
-    // This acts as a flag to indicate that we want a color space aware decode.
-    sk_sp<SkColorSpace> dstColorSpace = SkColorSpace::MakeSRGB();
-    return SkImage::MakeCrossContextFromEncoded(context, std::move(buffer),
-                                                false, dstColorSpace.get());
-  } else {
-    return SkImage::MakeFromEncoded(std::move(buffer));
+  std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(std::move(buffer)));
+  if (!codec) {
+    return nullptr;
+  }
+
+  const SkImageInfo& encoded_info = codec->getInfo();
+  SkISize size = encoded_info.dimensions();
+  const float scale = ComputeDecodeScale(size, target_width, target_height);
+  if (scale < 1) {
+    size = codec->getScaledDimensions(scale);
+  }
+
+  SkImageInfo info = encoded_info.makeWH(size.width(), size.height())
+                         .makeColorType(kN32_SkColorType);
+  if (info.alphaType() == kUnpremul_SkAlphaType) {
+    info = info.makeAlphaType(kPremul_SkAlphaType);
+  }
+
+  SkBitmap bitmap;
+  if (!bitmap.tryAllocPixels(info)) {
+    return nullptr;
   }
+  const SkCodec::Result result =
+      codec->getPixels(info, bitmap.getPixels(), bitmap.rowBytes());
+  if (result != SkCodec::kSuccess && result != SkCodec::kIncompleteInput) {
+    return nullptr;
+  }
+  bitmap.setImmutable();
+  return SkImage::MakeFromBitmap(bitmap);
 }
 
 void InvokeImageCallback(sk_sp<SkImage> image,
@@ -56,14 +84,37 @@ void InvokeImageCallback(sk_sp<SkImage> image,
   }
 }
 
+// Runs on a worker of the image decode pool.
 void DecodeImageAndInvokeImageCallback(
     std::unique_ptr<DartPersistentValue> callback,
-    sk_sp<SkData> buffer) {
-  sk_sp<SkImage> image = DecodeImage(std::move(buffer));
-  Threads::UI()->PostTask(
-      ftl::MakeCopyable([ callback = std::move(callback), image ]() mutable {
-        InvokeImageCallback(image, std::move(callback));
-      }));
+    sk_sp<SkData> buffer,
+    int target_width,
+    int target_height,
+    ftl::TimePoint request_time) {
+  DecodedImageCache& cache = ImageDecodePool::Get().cache();
+
+  const DecodedImageKey key =
+      DecodedImageKey::Create(buffer, target_width, target_height);
+
+  sk_sp<SkImage> cached_image = cache.Get(key);
+  if (cached_image) {
+    ImageDecoding::PostImageCallback(std::move(cached_image),
+                                     std::move(callback), request_time);
+    return;
+  }
+
+  sk_sp<SkImage> image =
+      DecodeImage(std::move(buffer), target_width, target_height);
+  Threads::IO()->PostTask(ftl::MakeCopyable([
+    callback = std::move(callback), image = std::move(image), key,
+    request_time
+  ]() mutable {
+    sk_sp<SkImage> uploaded_image =
+        ImageDecoding::UploadImage(std::move(image));
+    ImageDecodePool::Get().cache().Put(key, uploaded_image);
+    ImageDecoding::PostImageCallback(std::move(uploaded_image),
+                                     std::move(callback), request_time);
+  }));
 }
 
 void DecodeImageFromList(Dart_NativeArguments args) {
@@ -82,22 +133,62 @@ void DecodeImageFromList(Dart_NativeArguments args) {
     return;
   }
 
+  const int target_width =
+      tonic::DartConverter<int>::FromArguments(args, 2, exception);
+  const int target_height =
+      tonic::DartConverter<int>::FromArguments(args, 3, exception);
+  if (exception) {
+    Dart_ThrowException(exception);
+    return;
+  }
+
   auto buffer = SkData::MakeWithCopy(list.data(), list.num_elements());
 
-  Threads::IO()->PostTask(ftl::MakeCopyable([
+  ImageDecodePool::Get().PostDecode(ftl::MakeCopyable([
     callback = std::make_unique<DartPersistentValue>(
         tonic::DartState::Current(), callback_handle),
-    buffer = std::move(buffer)
+    buffer = std::move(buffer), target_width, target_height,
+    request_time = ftl::TimePoint::Now()
   ]() mutable {
-    DecodeImageAndInvokeImageCallback(std::move(callback), std::move(buffer));
+    DecodeImageAndInvokeImageCallback(std::move(callback), std::move(buffer),
+                                      target_width, target_height,
+                                      request_time);
   }));
 }
 
 }  // namespace
 
+sk_sp<SkImage> ImageDecoding::UploadImage(sk_sp<SkImage> image) {
+  TRACE_EVENT0("blink", "UploadImage");
+
+  GrContext* context = ResourceContext::Get();
+  SkPixmap pixmap;
+  if (!image || !context || !image->peekPixels(&pixmap)) {
+    return image;
+  }
+
+  // This acts as a flag to indicate that we want a color space aware decode.
+  sk_sp<SkColorSpace> dstColorSpace = SkColorSpace::MakeSRGB();
+  sk_sp<SkImage> texture_image = SkImage::MakeCrossContextFromPixmap(
+      context, pixmap, false, dstColorSpace.get());
+  return texture_image ? texture_image : image;
+}
+
+void ImageDecoding::PostImageCallback(
+    sk_sp<SkImage> image,
+    std::unique_ptr<DartPersistentValue> callback,
+    ftl::TimePoint request_time) {
+  ImageDecodePool::Get().RecordDecodeLatency(ftl::TimePoint::Now() -
+                                             request_time);
+  Threads::UILowPriority()->PostTask(
+      ftl::MakeCopyable([ callback = std::move(callback), image ]() mutable {
+        InvokeImageCallback(image, std::move(callback));
+      }));
+}
+
 void ImageDecoding::RegisterNatives(tonic::DartLibraryNatives* natives) {
   natives->Register({
-      {"decodeImageFromList", DecodeImageFromList, 2, true},
+      {"decodeImageFromList", DecodeImageFromList, 4, true},
   });
 }
 
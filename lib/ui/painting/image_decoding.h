@@ -5,12 +5,29 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_IMAGE_DECODING_H_
 #define FLUTTER_LIB_UI_PAINTING_IMAGE_DECODING_H_
 
+#include <memory>
+
+#include "lib/ftl/time/time_point.h"
 #include "lib/tonic/dart_library_natives.h"
+#include "lib/tonic/dart_persistent_value.h"
+#include "third_party/skia/include/core/SkImage.h"
 
 namespace blink {
 
 class ImageDecoding {
  public:
+  // Uploads a decoded image to the GPU, or returns it as is when there is no
+  // resource context. Must be called on the IO thread, which owns the resource
+  // context.
+  static sk_sp<SkImage> UploadImage(sk_sp<SkImage> image);
+
+  // Hands |image|, which may be null, to |callback| on the UI thread and
+  // records how long it took since |request_time|.
+  static void PostImageCallback(
+      sk_sp<SkImage> image,
+      std::unique_ptr<tonic::DartPersistentValue> callback,
+      ftl::TimePoint request_time);
+
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
 };
 
@@ -0,0 +1,25 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_PAINT_DECODING_H_
+#define FLUTTER_LIB_UI_PAINTING_PAINT_DECODING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "third_party/skia/include/core/SkPaint.h"
+
+namespace blink {
+
+// The number of 32-bit words in the data of a Paint in painting.dart.
+constexpr size_t kPaintDataWordCount = 12;
+
+// Applies the fields encoded in the data of a Paint, which are stored as
+// differences from their defaults, to |paint|. The mask filter and the shader
+// are not part of the data.
+void DecodePaintData(const uint32_t* data, SkPaint* paint);
+
+}  // namespace blink
+
+#endif  // FLUTTER_LIB_UI_PAINTING_PAINT_DECODING_H_
@@ -23,11 +23,15 @@ IMPLEMENT_WRAPPERTYPEINFO(ui, Picture);
 
 DART_BIND_ALL(Picture, FOR_EACH_BINDING)
 
-ftl::RefPtr<Picture> Picture::Create(sk_sp<SkPicture> picture) {
-  return ftl::MakeRefCounted<Picture>(std::move(picture));
+ftl::RefPtr<Picture> Picture::Create(sk_sp<SkPicture> picture,
+                                     size_t referenced_bytes) {
+  return ftl::MakeRefCounted<Picture>(std::move(picture), referenced_bytes);
 }
 
-Picture::Picture(sk_sp<SkPicture> picture) : picture_(std::move(picture)) {}
+Picture::Picture(sk_sp<SkPicture> picture, size_t referenced_bytes)
+    : picture_(std::move(picture)),
+      referenced_bytes_(referenced_bytes),
+      external_allocation_(ExternalAllocationKind::kPicture) {}
 
 Picture::~Picture() {
   // Skia objects must be deleted on the IO thread so that any associated GL
@@ -48,12 +52,23 @@ void Picture::dispose() {
   ClearDartWrapper();
 }
 
+size_t Picture::GetRecordingBytes() const {
+  if (!picture_)
+    return 0;
+  return picture_->approximateBytesUsed();
+}
+
+size_t Picture::GetPictureBytes() const {
+  if (!picture_)
+    return 0;
+  return GetRecordingBytes() + referenced_bytes_;
+}
+
 size_t Picture::GetAllocationSize() {
-  if (picture_) {
-    return picture_->approximateBytesUsed();
-  } else {
-    return sizeof(Picture);
-  }
+  // The images and pictures the recording references are tallied by their own
+  // wrappers, but the Dart heap should know that this one keeps them alive.
+  external_allocation_.Update(sizeof(Picture) + GetRecordingBytes());
+  return sizeof(Picture) + GetPictureBytes();
 }
 
 }  // namespace blink
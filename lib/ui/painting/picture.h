@@ -5,6 +5,7 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_PICTURE_H_
 #define FLUTTER_LIB_UI_PAINTING_PICTURE_H_
 
+#include "flutter/lib/ui/external_allocation.h"
 #include "flutter/lib/ui/painting/image.h"
 #include "lib/tonic/dart_wrappable.h"
 #include "third_party/skia/include/core/SkPicture.h"
@@ -23,7 +24,10 @@ class Picture : public ftl::RefCountedThreadSafe<Picture>,
 
  public:
   ~Picture() override;
-  static ftl::RefPtr<Picture> Create(sk_sp<SkPicture> picture);
+  // |referenced_bytes| are those of the images and pictures drawn into
+  // |picture|, which it keeps alive.
+  static ftl::RefPtr<Picture> Create(sk_sp<SkPicture> picture,
+                                     size_t referenced_bytes = 0);
 
   const sk_sp<SkPicture>& picture() const { return picture_; }
 
@@ -31,14 +35,22 @@ class Picture : public ftl::RefCountedThreadSafe<Picture>,
 
   void dispose();
 
+  // The bytes of the recording alone.
+  size_t GetRecordingBytes() const;
+
+  // The bytes of the recording and of what it references.
+  size_t GetPictureBytes() const;
+
   virtual size_t GetAllocationSize() override;
 
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
 
  private:
-  explicit Picture(sk_sp<SkPicture> picture);
+  Picture(sk_sp<SkPicture> picture, size_t referenced_bytes);
 
   sk_sp<SkPicture> picture_;
+  const size_t referenced_bytes_;
+  ExternalAllocation external_allocation_;
 };
 
 }  // namespace blink
@@ -51,7 +51,8 @@ ftl::RefPtr<Picture> PictureRecorder::endRecording() {
   if (!isRecording())
     return nullptr;
   ftl::RefPtr<Picture> picture =
-      Picture::Create(picture_recorder_.finishRecordingAsPicture());
+      Picture::Create(picture_recorder_.finishRecordingAsPicture(),
+                      canvas_->referenced_bytes());
   canvas_->Clear();
   canvas_->ClearDartWrapper();
   canvas_ = nullptr;
@@ -0,0 +1,267 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/progressive_decode_state.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "flutter/glue/trace_event.h"
+#include "flutter/lib/ui/painting/decode_scale.h"
+#include "third_party/skia/include/core/SkStream.h"
+
+namespace blink {
+namespace {
+
+// Reads the bytes of a progressive decode as they arrive. Reads past the
+// bytes received so far come up short, which codecs report as incomplete
+// input. The state is not referenced, as it owns the codecs reading from the
+// stream.
+class ProgressiveDecodeStream : public SkStream {
+ public:
+  explicit ProgressiveDecodeStream(const ProgressiveDecodeState* state)
+      : state_(state), offset_(0) {}
+
+  size_t read(void* buffer, size_t size) override {
+    const size_t read = state_->Read(offset_, buffer, size);
+    offset_ += read;
+    return read;
+  }
+
+  bool isAtEnd() const override { return state_->IsAtEnd(offset_); }
+
+  bool rewind() override {
+    offset_ = 0;
+    return true;
+  }
+
+ private:
+  const ProgressiveDecodeState* state_;
+  size_t offset_;
+};
+
+SkImageInfo DecodeInfo(const SkImageInfo& encoded_info, const SkISize& size) {
+  SkImageInfo info = encoded_info.makeWH(size.width(), size.height())
+                         .makeColorType(kN32_SkColorType);
+  if (info.alphaType() == kUnpremul_SkAlphaType) {
+    info = info.makeAlphaType(kPremul_SkAlphaType);
+  }
+  return info;
+}
+
+bool IsDecoded(SkCodec::Result result) {
+  return result == SkCodec::kSuccess || result == SkCodec::kIncompleteInput;
+}
+
+// A copy of the pixels, as later decodes keep writing into the bitmap.
+sk_sp<SkImage> SnapshotBitmap(const SkBitmap& bitmap) {
+  SkPixmap pixmap;
+  if (!bitmap.peekPixels(&pixmap))
+    return nullptr;
+  return SkImage::MakeRasterCopy(pixmap);
+}
+
+}  // namespace
+
+ProgressiveDecodeState::ProgressiveDecodeState(int target_width,
+                                               int target_height)
+    : target_width_(target_width),
+      target_height_(target_height),
+      width_(0),
+      height_(0) {}
+
+ProgressiveDecodeState::~ProgressiveDecodeState() = default;
+
+void ProgressiveDecodeState::Append(const uint8_t* data, size_t size) {
+  std::lock_guard<std::mutex> lock(data_mutex_);
+  data_.insert(data_.end(), data, data + size);
+}
+
+void ProgressiveDecodeState::Close() {
+  std::lock_guard<std::mutex> lock(data_mutex_);
+  closed_ = true;
+}
+
+bool ProgressiveDecodeState::closed() const {
+  std::lock_guard<std::mutex> lock(data_mutex_);
+  return closed_;
+}
+
+size_t ProgressiveDecodeState::Read(size_t offset,
+                                    void* buffer,
+                                    size_t size) const {
+  std::lock_guard<std::mutex> lock(data_mutex_);
+  if (offset >= data_.size())
+    return 0;
+  size = std::min(size, data_.size() - offset);
+  if (buffer)
+    memcpy(buffer, data_.data() + offset, size);
+  return size;
+}
+
+bool ProgressiveDecodeState::IsAtEnd(size_t offset) const {
+  std::lock_guard<std::mutex> lock(data_mutex_);
+  return closed_ && offset >= data_.size();
+}
+
+std::unique_ptr<SkCodec> ProgressiveDecodeState::CreateCodec() {
+  // Fails until enough bytes have arrived to read the header.
+  std::unique_ptr<SkCodec> codec(
+      SkCodec::NewFromStream(new ProgressiveDecodeStream(this)));
+  if (codec) {
+    width_.store(codec->getInfo().width());
+    height_.store(codec->getInfo().height());
+  }
+  return codec;
+}
+
+bool ProgressiveDecodeState::PrepareBitmap(const SkCodec& codec) {
+  if (bitmap_.getPixels())
+    return true;
+
+  const SkImageInfo& encoded_info = codec.getInfo();
+  SkISize size = encoded_info.dimensions();
+  const float scale =
+      ComputeDecodeScale(size, target_width_, target_height_);
+  if (scale < 1) {
+    size = codec.getScaledDimensions(scale);
+  }
+
+  if (!bitmap_.tryAllocPixels(DecodeInfo(encoded_info, size)))
+    return false;
+  bitmap_.eraseColor(SK_ColorTRANSPARENT);
+  return true;
+}
+
+sk_sp<SkImage> ProgressiveDecodeState::Finish() {
+  mode_ = Mode::kComplete;
+  codec_.reset();
+  bitmap_.setImmutable();
+  image_ = SkImage::MakeFromBitmap(bitmap_);
+  bitmap_.reset();
+  return image_;
+}
+
+sk_sp<SkImage> ProgressiveDecodeState::DecodeAvailable() {
+  TRACE_EVENT0("blink", "ProgressiveImageDecode");
+
+  std::lock_guard<std::mutex> lock(decode_mutex_);
+  if (mode_ == Mode::kComplete)
+    return image_;
+  if (mode_ == Mode::kFailed)
+    return nullptr;
+
+  // Checked before decoding, so that bytes arriving during the decode are not
+  // mistaken for the end of the image.
+  const bool closed = this->closed();
+
+  if (!codec_) {
+    codec_ = CreateCodec();
+    if (!codec_) {
+      if (closed)
+        mode_ = Mode::kFailed;
+      return nullptr;
+    }
+    if (!PrepareBitmap(*codec_)) {
+      mode_ = Mode::kFailed;
+      return nullptr;
+    }
+  }
+
+  if (mode_ == Mode::kUnknown) {
+    const SkCodec::Result result = codec_->startIncrementalDecode(
+        bitmap_.info(), bitmap_.getPixels(), bitmap_.rowBytes());
+    if (result == SkCodec::kSuccess) {
+      mode_ = Mode::kIncremental;
+    } else if (result == SkCodec::kUnimplemented) {
+      mode_ = Mode::kRedecode;
+    } else if (result == SkCodec::kIncompleteInput && !closed) {
+      return nullptr;
+    } else {
+      mode_ = Mode::kFailed;
+      return nullptr;
+    }
+  }
+
+  if (mode_ == Mode::kIncremental) {
+    int rows_decoded = 0;
+    const SkCodec::Result result = codec_->incrementalDecode(&rows_decoded);
+    if (!IsDecoded(result)) {
+      mode_ = Mode::kFailed;
+      return nullptr;
+    }
+    if (result == SkCodec::kSuccess || closed)
+      return Finish();
+    return SnapshotBitmap(bitmap_);
+  }
+
+  // Codecs without incremental decoding decode all of the bytes received so
+  // far from the start, filling in the rows that are missing.
+  std::unique_ptr<SkCodec> codec = closed ? std::move(codec_) : CreateCodec();
+  if (!codec)
+    return nullptr;
+  const SkCodec::Result result = codec->getPixels(
+      bitmap_.info(), bitmap_.getPixels(), bitmap_.rowBytes());
+  if (!IsDecoded(result)) {
+    mode_ = Mode::kFailed;
+    return nullptr;
+  }
+  if (closed)
+    return Finish();
+  return SnapshotBitmap(bitmap_);
+}
+
+sk_sp<SkImage> ProgressiveDecodeState::DecodeRegion(const SkIRect& requested) {
+  TRACE_EVENT0("blink", "ProgressiveImageDecodeRegion");
+
+  // A codec of its own, so that the progressive decode is not disturbed.
+  std::unique_ptr<SkCodec> codec = CreateCodec();
+  if (!codec)
+    return nullptr;
+
+  const SkImageInfo info =
+      DecodeInfo(codec->getInfo(), codec->getInfo().dimensions());
+  SkIRect region = requested;
+  if (!region.intersect(SkIRect::MakeSize(info.dimensions())))
+    return nullptr;
+
+  SkBitmap bitmap;
+  if (!bitmap.tryAllocPixels(info.makeWH(region.width(), region.height())))
+    return nullptr;
+  bitmap.eraseColor(SK_ColorTRANSPARENT);
+
+  if (codec->startScanlineDecode(info) == SkCodec::kSuccess &&
+      codec->getScanlineOrder() == SkCodec::kTopDown_SkScanlineOrder) {
+    // Only a single row of the full image is held in memory at a time.
+    std::vector<uint32_t> row(info.width());
+    if (!codec->skipScanlines(region.top()))
+      return nullptr;
+    for (int y = 0; y < region.height(); y++) {
+      if (codec->getScanlines(row.data(), 1, info.minRowBytes()) != 1)
+        break;
+      memcpy(bitmap.getAddr32(0, y), row.data() + region.left(),
+             region.width() * sizeof(uint32_t));
+    }
+  } else {
+    // Codecs that cannot decode rows from the top down decode all of it.
+    SkBitmap full_bitmap;
+    if (!full_bitmap.tryAllocPixels(info))
+      return nullptr;
+    const SkCodec::Result result = codec->getPixels(
+        info, full_bitmap.getPixels(), full_bitmap.rowBytes());
+    if (!IsDecoded(result))
+      return nullptr;
+    if (!full_bitmap.readPixels(bitmap.info(), bitmap.getPixels(),
+                                bitmap.rowBytes(), region.left(),
+                                region.top())) {
+      return nullptr;
+    }
+  }
+
+  bitmap.setImmutable();
+  return SkImage::MakeFromBitmap(bitmap);
+}
+
+}  // namespace blink
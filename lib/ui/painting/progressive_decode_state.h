@@ -0,0 +1,94 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_PROGRESSIVE_DECODE_STATE_H_
+#define FLUTTER_LIB_UI_PAINTING_PROGRESSIVE_DECODE_STATE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "lib/ftl/memory/ref_counted.h"
+#include "third_party/skia/include/codec/SkCodec.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkRect.h"
+
+namespace blink {
+
+// The encoded bytes received so far and the decode of them. Bytes are added on
+// the UI thread while workers of the image decode pool decode them.
+class ProgressiveDecodeState
+    : public ftl::RefCountedThreadSafe<ProgressiveDecodeState> {
+ public:
+  ProgressiveDecodeState(int target_width, int target_height);
+
+  void Append(const uint8_t* data, size_t size);
+
+  void Close();
+
+  bool closed() const;
+
+  // Copies up to |size| of the bytes received so far, starting at |offset|,
+  // into |buffer|. Returns the number of bytes copied.
+  size_t Read(size_t offset, void* buffer, size_t size) const;
+
+  // Whether |offset| is past the last byte that will ever arrive.
+  bool IsAtEnd(size_t offset) const;
+
+  int width() const { return width_.load(); }
+  int height() const { return height_.load(); }
+
+  // Decodes everything received so far. Rows that have not arrived yet are
+  // left transparent. Runs on the image decode pool.
+  sk_sp<SkImage> DecodeAvailable();
+
+  // Decodes |region| of the image at full resolution, clipped to the image.
+  // Runs on the image decode pool.
+  sk_sp<SkImage> DecodeRegion(const SkIRect& region);
+
+ private:
+  enum class Mode {
+    kUnknown,
+    // The codec resumes decoding where it stopped once more bytes arrive.
+    kIncremental,
+    // The codec cannot resume, so every decode starts over.
+    kRedecode,
+    kComplete,
+    kFailed,
+  };
+
+  std::unique_ptr<SkCodec> CreateCodec();
+  bool PrepareBitmap(const SkCodec& codec);
+  sk_sp<SkImage> Finish();
+
+  const int target_width_;
+  const int target_height_;
+  std::atomic<int> width_;
+  std::atomic<int> height_;
+
+  mutable std::mutex data_mutex_;
+  std::vector<uint8_t> data_;
+  bool closed_ = false;
+
+  // Held for the whole of a decode, as the codec and bitmap are not
+  // thread-safe and decodes may be posted to different workers.
+  std::mutex decode_mutex_;
+  Mode mode_ = Mode::kUnknown;
+  std::unique_ptr<SkCodec> codec_;
+  SkBitmap bitmap_;
+  sk_sp<SkImage> image_;
+
+  FRIEND_REF_COUNTED_THREAD_SAFE(ProgressiveDecodeState);
+  ~ProgressiveDecodeState();
+  FTL_DISALLOW_COPY_AND_ASSIGN(ProgressiveDecodeState);
+};
+
+}  // namespace blink
+
+#endif  // FLUTTER_LIB_UI_PAINTING_PROGRESSIVE_DECODE_STATE_H_
@@ -0,0 +1,282 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/progressive_decode_state.h"
+
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "third_party/gtest/include/gtest/gtest.h"
+#include "third_party/zlib/zlib.h"
+
+namespace blink {
+namespace {
+
+using PixelFunction = std::function<SkColor(int x, int y)>;
+
+void AppendBigEndian32(std::vector<uint8_t>* bytes, uint32_t value) {
+  for (int shift = 24; shift >= 0; shift -= 8)
+    bytes->push_back(static_cast<uint8_t>(value >> shift));
+}
+
+void AppendLittleEndian(std::vector<uint8_t>* bytes,
+                        uint32_t value,
+                        int size) {
+  for (int i = 0; i < size; i++)
+    bytes->push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+void AppendPngChunk(std::vector<uint8_t>* png,
+                    const char* type,
+                    const std::vector<uint8_t>& data) {
+  AppendBigEndian32(png, data.size());
+  const size_t type_offset = png->size();
+  png->insert(png->end(), type, type + 4);
+  png->insert(png->end(), data.begin(), data.end());
+  AppendBigEndian32(png, crc32(0, png->data() + type_offset, 4 + data.size()));
+}
+
+// A non-interlaced RGBA PNG. The image data is stored uncompressed, so that
+// the rows arrive evenly over its bytes. Sets |image_data_end| to the offset
+// of the end of the image data.
+std::vector<uint8_t> BuildPng(int width,
+                              int height,
+                              const PixelFunction& pixel,
+                              size_t* image_data_end = nullptr) {
+  std::vector<uint8_t> rows;
+  for (int y = 0; y < height; y++) {
+    rows.push_back(0);  // No filter.
+    for (int x = 0; x < width; x++) {
+      const SkColor color = pixel(x, y);
+      rows.push_back(SkColorGetR(color));
+      rows.push_back(SkColorGetG(color));
+      rows.push_back(SkColorGetB(color));
+      rows.push_back(SkColorGetA(color));
+    }
+  }
+  uLongf compressed_size = compressBound(rows.size());
+  std::vector<uint8_t> compressed(compressed_size);
+  EXPECT_EQ(compress2(compressed.data(), &compressed_size, rows.data(),
+                      rows.size(), Z_NO_COMPRESSION),
+            Z_OK);
+  compressed.resize(compressed_size);
+
+  std::vector<uint8_t> header;
+  AppendBigEndian32(&header, width);
+  AppendBigEndian32(&header, height);
+  header.push_back(8);  // Bits per channel.
+  header.push_back(6);  // RGBA.
+  header.push_back(0);  // Deflate.
+  header.push_back(0);  // Adaptive filtering.
+  header.push_back(0);  // Not interlaced.
+
+  std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  AppendPngChunk(&png, "IHDR", header);
+  AppendPngChunk(&png, "IDAT", compressed);
+  if (image_data_end)
+    *image_data_end = png.size() - 4;
+  AppendPngChunk(&png, "IEND", std::vector<uint8_t>());
+  return png;
+}
+
+// An opaque 24-bit BMP. Its rows are stored from the bottom up unless
+// |top_down| is set.
+std::vector<uint8_t> BuildBmp(int width,
+                              int height,
+                              bool top_down,
+                              const PixelFunction& pixel) {
+  const uint32_t row_bytes = (width * 3 + 3) & ~3;
+  const uint32_t data_offset = 14 + 40;
+  std::vector<uint8_t> bmp = {'B', 'M'};
+  AppendLittleEndian(&bmp, data_offset + row_bytes * height, 4);
+  AppendLittleEndian(&bmp, 0, 4);
+  AppendLittleEndian(&bmp, data_offset, 4);
+
+  AppendLittleEndian(&bmp, 40, 4);
+  AppendLittleEndian(&bmp, width, 4);
+  AppendLittleEndian(&bmp, top_down ? -height : height, 4);
+  AppendLittleEndian(&bmp, 1, 2);   // Planes.
+  AppendLittleEndian(&bmp, 24, 2);  // Bits per pixel.
+  AppendLittleEndian(&bmp, 0, 4);   // Uncompressed.
+  AppendLittleEndian(&bmp, row_bytes * height, 4);
+  AppendLittleEndian(&bmp, 2835, 4);
+  AppendLittleEndian(&bmp, 2835, 4);
+  AppendLittleEndian(&bmp, 0, 4);
+  AppendLittleEndian(&bmp, 0, 4);
+
+  for (int row = 0; row < height; row++) {
+    const int y = top_down ? row : height - 1 - row;
+    for (int x = 0; x < width; x++) {
+      const SkColor color = pixel(x, y);
+      bmp.push_back(SkColorGetB(color));
+      bmp.push_back(SkColorGetG(color));
+      bmp.push_back(SkColorGetR(color));
+    }
+    bmp.resize(bmp.size() + row_bytes - width * 3, 0);
+  }
+  return bmp;
+}
+
+// Red on top, blue below.
+SkColor Halves(int x, int y) {
+  return y < 32 ? SK_ColorRED : SK_ColorBLUE;
+}
+
+// Tells every pixel of a 16x16 image from the others.
+SkColor Gradient(int x, int y) {
+  return SkColorSetRGB(x * 16, y * 16, 0x80);
+}
+
+SkColor PixelAt(const sk_sp<SkImage>& image, int x, int y) {
+  SkColor color = 0;
+  const SkImageInfo info =
+      SkImageInfo::Make(1, 1, kBGRA_8888_SkColorType, kUnpremul_SkAlphaType);
+  EXPECT_TRUE(image->readPixels(info, &color, sizeof(color), x, y));
+  return color;
+}
+
+ftl::RefPtr<ProgressiveDecodeState> MakeState(
+    const std::vector<uint8_t>& bytes) {
+  auto state = ftl::MakeRefCounted<ProgressiveDecodeState>(0, 0);
+  state->Append(bytes.data(), bytes.size());
+  state->Close();
+  return state;
+}
+
+void ExpectRegion(const sk_sp<SkImage>& image,
+                  const SkIRect& region,
+                  const PixelFunction& pixel) {
+  ASSERT_TRUE(image);
+  ASSERT_EQ(image->width(), region.width());
+  ASSERT_EQ(image->height(), region.height());
+  for (int y = 0; y < region.height(); y++) {
+    for (int x = 0; x < region.width(); x++) {
+      ASSERT_EQ(PixelAt(image, x, y),
+                pixel(region.left() + x, region.top() + y));
+    }
+  }
+}
+
+}  // namespace
+
+TEST(ProgressiveDecodeState, DecodesPngAsItArrives) {
+  size_t image_data_end = 0;
+  const std::vector<uint8_t> png = BuildPng(64, 64, Halves, &image_data_end);
+  auto state = ftl::MakeRefCounted<ProgressiveDecodeState>(0, 0);
+
+  // Not enough to tell the size of the image.
+  state->Append(png.data(), 8);
+  ASSERT_FALSE(state->DecodeAvailable());
+  ASSERT_EQ(state->width(), 0);
+
+  // The top half of the rows.
+  const size_t partial_size = image_data_end / 2;
+  state->Append(png.data() + 8, partial_size - 8);
+  sk_sp<SkImage> partial = state->DecodeAvailable();
+  ASSERT_TRUE(partial);
+  ASSERT_EQ(state->width(), 64);
+  ASSERT_EQ(state->height(), 64);
+  ASSERT_EQ(partial->width(), 64);
+  ASSERT_EQ(PixelAt(partial, 0, 0), SK_ColorRED);
+  ASSERT_EQ(PixelAt(partial, 63, 63), SK_ColorTRANSPARENT);
+
+  state->Append(png.data() + partial_size, png.size() - partial_size);
+  state->Close();
+  sk_sp<SkImage> complete = state->DecodeAvailable();
+  ASSERT_TRUE(complete);
+  ASSERT_EQ(PixelAt(complete, 0, 0), SK_ColorRED);
+  ASSERT_EQ(PixelAt(complete, 63, 63), SK_ColorBLUE);
+
+  // Frames handed out before are not written to by later decodes.
+  ASSERT_EQ(PixelAt(partial, 63, 63), SK_ColorTRANSPARENT);
+  // Once complete, the image is not decoded again.
+  ASSERT_EQ(state->DecodeAvailable(), complete);
+}
+
+TEST(ProgressiveDecodeState, CloseEndsTruncatedImage) {
+  size_t image_data_end = 0;
+  const std::vector<uint8_t> png = BuildPng(64, 64, Halves, &image_data_end);
+  auto state = ftl::MakeRefCounted<ProgressiveDecodeState>(0, 0);
+  state->Append(png.data(), image_data_end / 2);
+  state->Close();
+
+  sk_sp<SkImage> image = state->DecodeAvailable();
+  ASSERT_TRUE(image);
+  ASSERT_EQ(PixelAt(image, 0, 0), SK_ColorRED);
+  ASSERT_EQ(PixelAt(image, 63, 63), SK_ColorTRANSPARENT);
+  ASSERT_EQ(state->DecodeAvailable(), image);
+}
+
+TEST(ProgressiveDecodeState, CloseBeforeHeaderFails) {
+  const std::vector<uint8_t> png = BuildPng(64, 64, Halves);
+  auto state = ftl::MakeRefCounted<ProgressiveDecodeState>(0, 0);
+  state->Append(png.data(), 8);
+  state->Close();
+
+  ASSERT_FALSE(state->DecodeAvailable());
+  ASSERT_FALSE(state->DecodeAvailable());
+}
+
+TEST(ProgressiveDecodeState, CloseWhileDecodeIsInFlight) {
+  size_t image_data_end = 0;
+  const std::vector<uint8_t> png = BuildPng(64, 64, Halves, &image_data_end);
+  auto state = ftl::MakeRefCounted<ProgressiveDecodeState>(0, 0);
+  const size_t partial_size = image_data_end / 2;
+  state->Append(png.data(), partial_size);
+
+  // Depending on when it reads them, the decode sees some or all of the
+  // remaining bytes, but it must never take the bytes it has for all of them.
+  sk_sp<SkImage> in_flight;
+  std::thread decode([&state, &in_flight]() {
+    in_flight = state->DecodeAvailable();
+  });
+  state->Append(png.data() + partial_size, png.size() - partial_size);
+  state->Close();
+  decode.join();
+  ASSERT_TRUE(in_flight);
+
+  sk_sp<SkImage> complete = state->DecodeAvailable();
+  ASSERT_TRUE(complete);
+  ASSERT_EQ(PixelAt(complete, 0, 0), SK_ColorRED);
+  ASSERT_EQ(PixelAt(complete, 63, 63), SK_ColorBLUE);
+}
+
+TEST(ProgressiveDecodeState, DecodesRegion) {
+  auto state = MakeState(BuildPng(16, 16, Gradient));
+  const SkIRect region = SkIRect::MakeLTRB(3, 5, 9, 7);
+
+  ExpectRegion(state->DecodeRegion(region), region, Gradient);
+}
+
+TEST(ProgressiveDecodeState, ClipsRegionToImage) {
+  auto state = MakeState(BuildPng(16, 16, Gradient));
+
+  ExpectRegion(state->DecodeRegion(SkIRect::MakeLTRB(10, 12, 40, 40)),
+               SkIRect::MakeLTRB(10, 12, 16, 16), Gradient);
+  ExpectRegion(state->DecodeRegion(SkIRect::MakeLTRB(-5, -5, 3, 2)),
+               SkIRect::MakeLTRB(0, 0, 3, 2), Gradient);
+  ASSERT_FALSE(state->DecodeRegion(SkIRect::MakeLTRB(16, 0, 20, 16)));
+  ASSERT_FALSE(state->DecodeRegion(SkIRect::MakeLTRB(-4, -4, 0, 0)));
+}
+
+TEST(ProgressiveDecodeState, DecodesRegionOfBottomUpImage) {
+  // Bottom-up BMPs cannot be decoded a row at a time from the top, so the
+  // region is cut from a decode of all of the image.
+  const SkIRect region = SkIRect::MakeLTRB(3, 5, 9, 7);
+  ExpectRegion(
+      MakeState(BuildBmp(16, 16, false, Gradient))->DecodeRegion(region),
+      region, Gradient);
+  ExpectRegion(
+      MakeState(BuildBmp(16, 16, true, Gradient))->DecodeRegion(region),
+      region, Gradient);
+
+  // Clipped the same way.
+  ExpectRegion(MakeState(BuildBmp(16, 16, false, Gradient))
+                   ->DecodeRegion(SkIRect::MakeLTRB(10, 12, 40, 40)),
+               SkIRect::MakeLTRB(10, 12, 16, 16), Gradient);
+}
+
+}  // namespace blink
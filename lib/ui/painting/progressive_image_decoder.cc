@@ -0,0 +1,133 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/progressive_image_decoder.h"
+
+#include <functional>
+
+#include "flutter/common/threads.h"
+#include "flutter/lib/ui/painting/image_decode_pool.h"
+#include "flutter/lib/ui/painting/image_decoding.h"
+#include "flutter/lib/ui/painting/progressive_decode_state.h"
+#include "lib/ftl/functional/make_copyable.h"
+#include "lib/tonic/dart_args.h"
+#include "lib/tonic/dart_binding_macros.h"
+#include "lib/tonic/dart_library_natives.h"
+#include "lib/tonic/dart_persistent_value.h"
+#include "lib/tonic/dart_state.h"
+#include "lib/tonic/converter/dart_converter.h"
+
+namespace blink {
+namespace {
+
+using DecodeFunction =
+    std::function<sk_sp<SkImage>(ProgressiveDecodeState* state)>;
+
+void PostProgressiveDecode(ftl::RefPtr<ProgressiveDecodeState> state,
+                           Dart_Handle callback_handle,
+                           DecodeFunction decode) {
+  ImageDecodePool::Get().PostDecode(ftl::MakeCopyable([
+    state = std::move(state), decode = std::move(decode),
+    callback = std::make_unique<tonic::DartPersistentValue>(
+        tonic::DartState::Current(), callback_handle),
+    request_time = ftl::TimePoint::Now()
+  ]() mutable {
+    sk_sp<SkImage> image = decode(state.get());
+    Threads::IO()->PostTask(ftl::MakeCopyable([
+      image = std::move(image), callback = std::move(callback), request_time
+    ]() mutable {
+      ImageDecoding::PostImageCallback(
+          ImageDecoding::UploadImage(std::move(image)), std::move(callback),
+          request_time);
+    }));
+  }));
+}
+
+}  // namespace
+
+static void ProgressiveImageDecoder_constructor(Dart_NativeArguments args) {
+  DartCallConstructor(&ProgressiveImageDecoder::Create, args);
+}
+
+IMPLEMENT_WRAPPERTYPEINFO(ui, ProgressiveImageDecoder);
+
+#define FOR_EACH_BINDING(V)                \
+  V(ProgressiveImageDecoder, addData)      \
+  V(ProgressiveImageDecoder, close)        \
+  V(ProgressiveImageDecoder, width)        \
+  V(ProgressiveImageDecoder, height)       \
+  V(ProgressiveImageDecoder, decode)       \
+  V(ProgressiveImageDecoder, decodeRegion) \
+  V(ProgressiveImageDecoder, dispose)
+
+FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
+
+void ProgressiveImageDecoder::RegisterNatives(
+    tonic::DartLibraryNatives* natives) {
+  natives->Register({{"ProgressiveImageDecoder_constructor",
+                      ProgressiveImageDecoder_constructor, 3, true},
+                     FOR_EACH_BINDING(DART_REGISTER_NATIVE)});
+}
+
+ftl::RefPtr<ProgressiveImageDecoder> ProgressiveImageDecoder::Create(
+    int target_width,
+    int target_height) {
+  return ftl::MakeRefCounted<ProgressiveImageDecoder>(target_width,
+                                                      target_height);
+}
+
+ProgressiveImageDecoder::ProgressiveImageDecoder(int target_width,
+                                                 int target_height)
+    : state_(ftl::MakeRefCounted<ProgressiveDecodeState>(target_width,
+                                                         target_height)) {}
+
+ProgressiveImageDecoder::~ProgressiveImageDecoder() {}
+
+void ProgressiveImageDecoder::addData(const tonic::Uint8List& data) {
+  if (state_)
+    state_->Append(data.data(), data.num_elements());
+}
+
+void ProgressiveImageDecoder::close() {
+  if (state_)
+    state_->Close();
+}
+
+int ProgressiveImageDecoder::width() {
+  return state_ ? state_->width() : 0;
+}
+
+int ProgressiveImageDecoder::height() {
+  return state_ ? state_->height() : 0;
+}
+
+void ProgressiveImageDecoder::decode(Dart_Handle callback) {
+  if (!state_)
+    return;
+  PostProgressiveDecode(state_, callback, [](ProgressiveDecodeState* state) {
+    return state->DecodeAvailable();
+  });
+}
+
+void ProgressiveImageDecoder::decodeRegion(int left,
+                                           int top,
+                                           int right,
+                                           int bottom,
+                                           Dart_Handle callback) {
+  if (!state_)
+    return;
+  const SkIRect region = SkIRect::MakeLTRB(left, top, right, bottom);
+  PostProgressiveDecode(state_, callback,
+                        [region](ProgressiveDecodeState* state) {
+                          return state->DecodeRegion(region);
+                        });
+}
+
+void ProgressiveImageDecoder::dispose() {
+  // Decodes in flight keep the state alive until they are done.
+  state_ = nullptr;
+  ClearDartWrapper();
+}
+
+}  // namespace blink
@@ -0,0 +1,64 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_PROGRESSIVE_IMAGE_DECODER_H_
+#define FLUTTER_LIB_UI_PAINTING_PROGRESSIVE_IMAGE_DECODER_H_
+
+#include "lib/ftl/memory/ref_ptr.h"
+#include "lib/tonic/dart_wrappable.h"
+#include "lib/tonic/typed_data/uint8_list.h"
+
+namespace tonic {
+class DartLibraryNatives;
+}  // namespace tonic
+
+namespace blink {
+class ProgressiveDecodeState;
+
+// Decodes an image while its encoded bytes are still arriving. Decoding runs
+// on the image decode pool and resumes where the previous decode stopped for
+// codecs that support incremental decoding.
+class ProgressiveImageDecoder
+    : public ftl::RefCountedThreadSafe<ProgressiveImageDecoder>,
+      public tonic::DartWrappable {
+  DEFINE_WRAPPERTYPEINFO();
+  FRIEND_MAKE_REF_COUNTED(ProgressiveImageDecoder);
+
+ public:
+  static ftl::RefPtr<ProgressiveImageDecoder> Create(int target_width,
+                                                     int target_height);
+
+  ~ProgressiveImageDecoder() override;
+
+  void addData(const tonic::Uint8List& data);
+  void close();
+
+  int width();
+  int height();
+
+  // Decodes everything added so far. Rows that have not arrived yet are left
+  // transparent.
+  void decode(Dart_Handle callback);
+
+  // Decodes the given rectangle of the image at full resolution without
+  // decoding, or holding in memory, the rest of it.
+  void decodeRegion(int left,
+                    int top,
+                    int right,
+                    int bottom,
+                    Dart_Handle callback);
+
+  void dispose();
+
+  static void RegisterNatives(tonic::DartLibraryNatives* natives);
+
+ private:
+  ProgressiveImageDecoder(int target_width, int target_height);
+
+  ftl::RefPtr<ProgressiveDecodeState> state_;
+};
+
+}  // namespace blink
+
+#endif  // FLUTTER_LIB_UI_PAINTING_PROGRESSIVE_IMAGE_DECODER_H_
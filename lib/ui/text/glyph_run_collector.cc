@@ -0,0 +1,261 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/text/glyph_run_collector.h"
+
+#include <utility>
+
+namespace blink {
+namespace {
+
+// The canvas has no pixels, so its size only matters to the clip, which is
+// never consulted.
+constexpr int kCanvasSize = 1 << 20;
+
+}  // namespace
+
+GlyphRunCollector::GlyphRunCollector()
+    : SkCanvas(kCanvasSize, kCanvasSize), complete_(true) {}
+
+GlyphRunCollector::~GlyphRunCollector() = default;
+
+std::vector<GlyphRun> GlyphRunCollector::TakeRuns() {
+  return std::move(runs_);
+}
+
+SkCanvas::SaveLayerStrategy GlyphRunCollector::getSaveLayerStrategy(
+    const SaveLayerRec& rec) {
+  complete_ = false;
+  return kNoLayer_SaveLayerStrategy;
+}
+
+void GlyphRunCollector::onDrawTextBlob(const SkTextBlob* blob,
+                                       SkScalar x,
+                                       SkScalar y,
+                                       const SkPaint& paint) {
+  const SkMatrix& matrix = getTotalMatrix();
+  // Shaders are positioned relative to the canvas, so they would not follow
+  // the blob if it were drawn elsewhere.
+  if (!matrix.isTranslate() || paint.getShader()) {
+    complete_ = false;
+    return;
+  }
+
+  GlyphRun run;
+  run.blob = sk_ref_sp(const_cast<SkTextBlob*>(blob));
+  matrix.mapXY(x, y, &run.origin);
+  run.paint = paint;
+  runs_.push_back(std::move(run));
+}
+
+void GlyphRunCollector::onDrawPaint(const SkPaint& paint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawPoints(PointMode mode,
+                                     size_t count,
+                                     const SkPoint points[],
+                                     const SkPaint& paint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawRect(const SkRect& rect, const SkPaint& paint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawOval(const SkRect& rect, const SkPaint& paint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawRegion(const SkRegion& region,
+                                     const SkPaint& paint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawArc(const SkRect& rect,
+                                  SkScalar start_angle,
+                                  SkScalar sweep_angle,
+                                  bool use_center,
+                                  const SkPaint& paint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawRRect(const SkRRect& rrect,
+                                    const SkPaint& paint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawDRRect(const SkRRect& outer,
+                                     const SkRRect& inner,
+                                     const SkPaint& paint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawPath(const SkPath& path, const SkPaint& paint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawBitmap(const SkBitmap& bitmap,
+                                     SkScalar left,
+                                     SkScalar top,
+                                     const SkPaint* paint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawBitmapRect(const SkBitmap& bitmap,
+                                         const SkRect* src,
+                                         const SkRect& dst,
+                                         const SkPaint* paint,
+                                         SrcRectConstraint constraint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawBitmapNine(const SkBitmap& bitmap,
+                                         const SkIRect& center,
+                                         const SkRect& dst,
+                                         const SkPaint* paint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawBitmapLattice(const SkBitmap& bitmap,
+                                            const Lattice& lattice,
+                                            const SkRect& dst,
+                                            const SkPaint* paint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawImage(const SkImage* image,
+                                    SkScalar left,
+                                    SkScalar top,
+                                    const SkPaint* paint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawImageRect(const SkImage* image,
+                                        const SkRect* src,
+                                        const SkRect& dst,
+                                        const SkPaint* paint,
+                                        SrcRectConstraint constraint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawImageNine(const SkImage* image,
+                                        const SkIRect& center,
+                                        const SkRect& dst,
+                                        const SkPaint* paint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawImageLattice(const SkImage* image,
+                                           const Lattice& lattice,
+                                           const SkRect& dst,
+                                           const SkPaint* paint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawAtlas(const SkImage* atlas,
+                                    const SkRSXform xform[],
+                                    const SkRect tex[],
+                                    const SkColor colors[],
+                                    int count,
+                                    SkBlendMode mode,
+                                    const SkRect* cull,
+                                    const SkPaint* paint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawVerticesObject(const SkVertices* vertices,
+                                             SkBlendMode mode,
+                                             const SkPaint& paint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawPatch(const SkPoint cubics[12],
+                                    const SkColor colors[4],
+                                    const SkPoint tex_coords[4],
+                                    SkBlendMode mode,
+                                    const SkPaint& paint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawText(const void* text,
+                                   size_t byte_length,
+                                   SkScalar x,
+                                   SkScalar y,
+                                   const SkPaint& paint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawPosText(const void* text,
+                                      size_t byte_length,
+                                      const SkPoint pos[],
+                                      const SkPaint& paint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawPosTextH(const void* text,
+                                       size_t byte_length,
+                                       const SkScalar xpos[],
+                                       SkScalar const_y,
+                                       const SkPaint& paint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawTextOnPath(const void* text,
+                                         size_t byte_length,
+                                         const SkPath& path,
+                                         const SkMatrix* matrix,
+                                         const SkPaint& paint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawTextRSXform(const void* text,
+                                          size_t byte_length,
+                                          const SkRSXform xform[],
+                                          const SkRect* cull,
+                                          const SkPaint& paint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawPicture(const SkPicture* picture,
+                                      const SkMatrix* matrix,
+                                      const SkPaint* paint) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawDrawable(SkDrawable* drawable,
+                                       const SkMatrix* matrix) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onDrawAnnotation(const SkRect& rect,
+                                         const char key[],
+                                         SkData* value) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onClipRect(const SkRect& rect,
+                                   SkClipOp op,
+                                   ClipEdgeStyle edge_style) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onClipRRect(const SkRRect& rrect,
+                                    SkClipOp op,
+                                    ClipEdgeStyle edge_style) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onClipPath(const SkPath& path,
+                                   SkClipOp op,
+                                   ClipEdgeStyle edge_style) {
+  complete_ = false;
+}
+
+void GlyphRunCollector::onClipRegion(const SkRegion& device_region,
+                                     SkClipOp op) {
+  complete_ = false;
+}
+
+}  // namespace blink
@@ -0,0 +1,170 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_TEXT_GLYPH_RUN_COLLECTOR_H_
+#define FLUTTER_LIB_UI_TEXT_GLYPH_RUN_COLLECTOR_H_
+
+#include <vector>
+
+#include "lib/ftl/macros.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkPaint.h"
+#include "third_party/skia/include/core/SkTextBlob.h"
+
+namespace blink {
+
+// Positioned glyphs that can be drawn with a single |drawTextBlob|.
+struct GlyphRun {
+  sk_sp<SkTextBlob> blob;
+  SkPoint origin;
+  SkPaint paint;
+};
+
+// A canvas that draws nothing but remembers the text blobs drawn into it,
+// along with where and how they were drawn. Anything it cannot represent as a
+// list of glyph runs, such as clips, layers, shapes, images, text drawn
+// without blobs or transforms other than translations, makes it incomplete.
+// Every drawing and clipping hook of |SkCanvas| is overridden, so nothing is
+// dropped without notice.
+class GlyphRunCollector : public SkCanvas {
+ public:
+  GlyphRunCollector();
+
+  ~GlyphRunCollector() override;
+
+  // Whether drawing the collected runs in order at their origins reproduces
+  // everything drawn into the canvas.
+  bool complete() const { return complete_; }
+
+  std::vector<GlyphRun> TakeRuns();
+
+ protected:
+  SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec& rec) override;
+
+  void onDrawTextBlob(const SkTextBlob* blob,
+                      SkScalar x,
+                      SkScalar y,
+                      const SkPaint& paint) override;
+
+  void onDrawPaint(const SkPaint& paint) override;
+  void onDrawPoints(PointMode mode,
+                    size_t count,
+                    const SkPoint points[],
+                    const SkPaint& paint) override;
+  void onDrawRect(const SkRect& rect, const SkPaint& paint) override;
+  void onDrawOval(const SkRect& rect, const SkPaint& paint) override;
+  void onDrawRegion(const SkRegion& region, const SkPaint& paint) override;
+  void onDrawArc(const SkRect& rect,
+                 SkScalar start_angle,
+                 SkScalar sweep_angle,
+                 bool use_center,
+                 const SkPaint& paint) override;
+  void onDrawRRect(const SkRRect& rrect, const SkPaint& paint) override;
+  void onDrawDRRect(const SkRRect& outer,
+                    const SkRRect& inner,
+                    const SkPaint& paint) override;
+  void onDrawPath(const SkPath& path, const SkPaint& paint) override;
+  void onDrawBitmap(const SkBitmap& bitmap,
+                    SkScalar left,
+                    SkScalar top,
+                    const SkPaint* paint) override;
+  void onDrawBitmapRect(const SkBitmap& bitmap,
+                        const SkRect* src,
+                        const SkRect& dst,
+                        const SkPaint* paint,
+                        SrcRectConstraint constraint) override;
+  void onDrawBitmapNine(const SkBitmap& bitmap,
+                        const SkIRect& center,
+                        const SkRect& dst,
+                        const SkPaint* paint) override;
+  void onDrawBitmapLattice(const SkBitmap& bitmap,
+                           const Lattice& lattice,
+                           const SkRect& dst,
+                           const SkPaint* paint) override;
+  void onDrawImage(const SkImage* image,
+                   SkScalar left,
+                   SkScalar top,
+                   const SkPaint* paint) override;
+  void onDrawImageRect(const SkImage* image,
+                       const SkRect* src,
+                       const SkRect& dst,
+                       const SkPaint* paint,
+                       SrcRectConstraint constraint) override;
+  void onDrawImageNine(const SkImage* image,
+                       const SkIRect& center,
+                       const SkRect& dst,
+                       const SkPaint* paint) override;
+  void onDrawImageLattice(const SkImage* image,
+                          const Lattice& lattice,
+                          const SkRect& dst,
+                          const SkPaint* paint) override;
+  void onDrawAtlas(const SkImage* atlas,
+                   const SkRSXform xform[],
+                   const SkRect tex[],
+                   const SkColor colors[],
+                   int count,
+                   SkBlendMode mode,
+                   const SkRect* cull,
+                   const SkPaint* paint) override;
+  void onDrawVerticesObject(const SkVertices* vertices,
+                            SkBlendMode mode,
+                            const SkPaint& paint) override;
+  void onDrawPatch(const SkPoint cubics[12],
+                   const SkColor colors[4],
+                   const SkPoint tex_coords[4],
+                   SkBlendMode mode,
+                   const SkPaint& paint) override;
+  void onDrawText(const void* text,
+                  size_t byte_length,
+                  SkScalar x,
+                  SkScalar y,
+                  const SkPaint& paint) override;
+  void onDrawPosText(const void* text,
+                     size_t byte_length,
+                     const SkPoint pos[],
+                     const SkPaint& paint) override;
+  void onDrawPosTextH(const void* text,
+                      size_t byte_length,
+                      const SkScalar xpos[],
+                      SkScalar const_y,
+                      const SkPaint& paint) override;
+  void onDrawTextOnPath(const void* text,
+                        size_t byte_length,
+                        const SkPath& path,
+                        const SkMatrix* matrix,
+                        const SkPaint& paint) override;
+  void onDrawTextRSXform(const void* text,
+                         size_t byte_length,
+                         const SkRSXform xform[],
+                         const SkRect* cull,
+                         const SkPaint& paint) override;
+  void onDrawPicture(const SkPicture* picture,
+                     const SkMatrix* matrix,
+                     const SkPaint* paint) override;
+  void onDrawDrawable(SkDrawable* drawable, const SkMatrix* matrix) override;
+  void onDrawAnnotation(const SkRect& rect,
+                        const char key[],
+                        SkData* value) override;
+
+  void onClipRect(const SkRect& rect,
+                  SkClipOp op,
+                  ClipEdgeStyle edge_style) override;
+  void onClipRRect(const SkRRect& rrect,
+                   SkClipOp op,
+                   ClipEdgeStyle edge_style) override;
+  void onClipPath(const SkPath& path,
+                  SkClipOp op,
+                  ClipEdgeStyle edge_style) override;
+  void onClipRegion(const SkRegion& device_region, SkClipOp op) override;
+
+ private:
+  std::vector<GlyphRun> runs_;
+  bool complete_;
+
+  FTL_DISALLOW_COPY_AND_ASSIGN(GlyphRunCollector);
+};
+
+}  // namespace blink
+
+#endif  // FLUTTER_LIB_UI_TEXT_GLYPH_RUN_COLLECTOR_H_
@@ -0,0 +1,95 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/text/glyph_run_collector.h"
+
+#include <functional>
+
+#include "third_party/gtest/include/gtest/gtest.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace blink {
+namespace {
+
+bool CompleteAfter(const std::function<void(SkCanvas*)>& draw) {
+  GlyphRunCollector collector;
+  draw(&collector);
+  return collector.complete();
+}
+
+sk_sp<SkImage> MakeImage() {
+  auto surface = SkSurface::MakeRasterN32Premul(4, 4);
+  surface->getCanvas()->clear(SK_ColorRED);
+  return surface->makeImageSnapshot();
+}
+
+}  // namespace
+
+TEST(GlyphRunCollector, StartsComplete) {
+  GlyphRunCollector collector;
+  ASSERT_TRUE(collector.complete());
+  ASSERT_TRUE(collector.TakeRuns().empty());
+}
+
+TEST(GlyphRunCollector, TranslationsKeepItComplete) {
+  ASSERT_TRUE(CompleteAfter([](SkCanvas* canvas) {
+    canvas->save();
+    canvas->translate(10, 20);
+    canvas->restore();
+  }));
+}
+
+TEST(GlyphRunCollector, ShapesAndPaintsMakeItIncomplete) {
+  SkPaint paint;
+  ASSERT_FALSE(
+      CompleteAfter([&paint](SkCanvas* canvas) { canvas->drawPaint(paint); }));
+  ASSERT_FALSE(CompleteAfter([&paint](SkCanvas* canvas) {
+    canvas->drawArc(SkRect::MakeWH(10, 10), 0, 90, true, paint);
+  }));
+  ASSERT_FALSE(CompleteAfter([&paint](SkCanvas* canvas) {
+    canvas->drawDRRect(SkRRect::MakeRect(SkRect::MakeWH(10, 10)),
+                       SkRRect::MakeRect(SkRect::MakeXYWH(2, 2, 6, 6)), paint);
+  }));
+}
+
+TEST(GlyphRunCollector, TextWithoutBlobsMakesItIncomplete) {
+  SkPaint paint;
+  ASSERT_FALSE(CompleteAfter([&paint](SkCanvas* canvas) {
+    canvas->drawText("a", 1, 0, 0, paint);
+  }));
+  ASSERT_FALSE(CompleteAfter([&paint](SkCanvas* canvas) {
+    const SkPoint pos[] = {{0, 0}};
+    canvas->drawPosText("a", 1, pos, paint);
+  }));
+}
+
+TEST(GlyphRunCollector, ImagesMakeItIncomplete) {
+  sk_sp<SkImage> image = MakeImage();
+  ASSERT_FALSE(CompleteAfter([&image](SkCanvas* canvas) {
+    canvas->drawImage(image, 0, 0);
+  }));
+  ASSERT_FALSE(CompleteAfter([&image](SkCanvas* canvas) {
+    canvas->drawImageRect(image, SkRect::MakeWH(8, 8), nullptr);
+  }));
+}
+
+TEST(GlyphRunCollector, PicturesMakeItIncomplete) {
+  // Pictures of a single operation are played back rather than drawn.
+  SkPictureRecorder recorder;
+  SkCanvas* recording = recorder.beginRecording(SkRect::MakeWH(10, 10));
+  recording->save();
+  recording->translate(1, 1);
+  recording->restore();
+  sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+  ASSERT_FALSE(CompleteAfter(
+      [&picture](SkCanvas* canvas) { canvas->drawPicture(picture); }));
+}
+
+TEST(GlyphRunCollector, ClipsMakeItIncomplete) {
+  ASSERT_FALSE(CompleteAfter(
+      [](SkCanvas* canvas) { canvas->clipRect(SkRect::MakeWH(5, 5)); }));
+}
+
+}  // namespace blink
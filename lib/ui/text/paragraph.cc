@@ -5,9 +5,14 @@
 #include "flutter/lib/ui/text/paragraph.h"
 
 #include "flutter/common/threads.h"
+#include "flutter/lib/ui/text/glyph_run_collector.h"
+#include "flutter/lib/ui/ui_dart_state.h"
+#include "flutter/sky/engine/core/rendering/InlineTextBox.h"
 #include "flutter/sky/engine/core/rendering/PaintInfo.h"
+#include "flutter/sky/engine/core/rendering/RenderInline.h"
 #include "flutter/sky/engine/core/rendering/RenderText.h"
 #include "flutter/sky/engine/core/rendering/RenderParagraph.h"
+#include "flutter/sky/engine/core/rendering/RootInlineBox.h"
 #include "flutter/sky/engine/core/rendering/style/RenderStyle.h"
 #include "flutter/sky/engine/platform/fonts/FontCache.h"
 #include "flutter/sky/engine/platform/graphics/GraphicsContext.h"
@@ -17,6 +22,7 @@
 #include "lib/tonic/dart_args.h"
 #include "lib/tonic/dart_binding_macros.h"
 #include "lib/tonic/dart_library_natives.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
 
 using tonic::ToDart;
 
@@ -40,8 +46,27 @@ IMPLEMENT_WRAPPERTYPEINFO(ui, Paragraph);
 
 DART_BIND_ALL(Paragraph, FOR_EACH_BINDING)
 
-Paragraph::Paragraph(PassOwnPtr<RenderView> renderView)
-    : m_renderView(renderView) {}
+namespace {
+
+// Text may be painted outside the bounds of the paragraph, for example by
+// glyphs with overhangs or by shadows, so the recordings made of paragraphs
+// are not culled.
+const SkRect kUnboundedRecording =
+    SkRect::MakeLTRB(-1.0e6f, -1.0e6f, 1.0e6f, 1.0e6f);
+
+ParagraphLayoutCache& layoutCache() {
+  return UIDartState::Current()->paragraph_layout_cache();
+}
+
+}  // namespace
+
+Paragraph::Paragraph(PassOwnPtr<RenderView> renderView, std::string content)
+    : m_renderView(renderView),
+      m_content(std::move(content)),
+      m_width(-1),
+      m_maxWidth(-1),
+      m_renderViewMaxWidth(-1),
+      m_externalAllocation(ExternalAllocationKind::kParagraph) {}
 
 Paragraph::~Paragraph() {
   if (m_renderView) {
@@ -52,39 +77,80 @@ Paragraph::~Paragraph() {
 }
 
 size_t Paragraph::GetAllocationSize() {
-  // We don't have an accurate accounting of the paragraph's memory consumption,
-  // so return a fixed size to indicate that its impact is more than the size
-  // of the Paragraph class.
-  return 2000;
+  return m_externalAllocation.Update(computeAllocationSize());
+}
+
+size_t Paragraph::computeAllocationSize() const {
+  size_t bytes = sizeof(Paragraph) + m_content.capacity();
+  if (!m_renderView)
+    return bytes;
+
+  // Paragraphs are built of a paragraph, inlines and text. Each has a style
+  // of its own.
+  bytes += sizeof(RenderView);
+  for (RenderObject* object = m_renderView->firstChild(); object;
+       object = object->nextInPreOrder(m_renderView.get())) {
+    bytes += sizeof(RenderStyle);
+    if (object->isText()) {
+      RenderText* text = toRenderText(object);
+      bytes += sizeof(RenderText) + text->textLength() * sizeof(UChar);
+      for (InlineTextBox* box = text->firstTextBox(); box;
+           box = box->nextTextBox())
+        bytes += sizeof(InlineTextBox);
+    } else if (object->isRenderParagraph()) {
+      RenderParagraph* paragraph = toRenderParagraph(object);
+      bytes += sizeof(RenderParagraph);
+      for (RootInlineBox* line = paragraph->firstRootBox(); line;
+           line = line->nextRootBox())
+        bytes += sizeof(RootInlineBox);
+    } else {
+      bytes += sizeof(RenderInline);
+    }
+  }
+  return bytes;
 }
 
 double Paragraph::width() {
+  if (m_layout)
+    return m_layout->width;
   return firstChildBox()->width();
 }
 
 double Paragraph::height() {
+  if (m_layout)
+    return m_layout->height;
   return firstChildBox()->height();
 }
 
 double Paragraph::minIntrinsicWidth() {
+  if (m_layout)
+    return m_layout->min_intrinsic_width;
   return firstChildBox()->minPreferredLogicalWidth();
 }
 
 double Paragraph::maxIntrinsicWidth() {
+  if (m_layout)
+    return m_layout->max_intrinsic_width;
   return firstChildBox()->maxPreferredLogicalWidth();
 }
 
 double Paragraph::alphabeticBaseline() {
+  if (m_layout)
+    return m_layout->alphabetic_baseline;
   return firstChildBox()->firstLineBoxBaseline(
       FontBaselineOrAuto(AlphabeticBaseline));
 }
 
 double Paragraph::ideographicBaseline() {
+  if (m_layout)
+    return m_layout->ideographic_baseline;
   return firstChildBox()->firstLineBoxBaseline(
       FontBaselineOrAuto(IdeographicBaseline));
 }
 
 bool Paragraph::didExceedMaxLines() {
+  if (m_layout)
+    return m_layout->did_exceed_max_lines;
   RenderBox* box = firstChildBox();
   ASSERT(box->isRenderParagraph());
   RenderParagraph* paragraph = static_cast<RenderParagraph*>(box);
@@ -92,11 +158,43 @@ bool Paragraph::didExceedMaxLines() {
 }
 
 void Paragraph::layout(double width) {
+  m_width = width;
+  m_maxWidth = LayoutUnit(width);  // Handles infinity properly.
+
+  ParagraphLayoutCache& cache = layoutCache();
+  m_layout = cache.Get(m_content, m_width);
+  if (m_layout)
+    return;
+
+  ensureRenderViewLayout();
+
+  // Read back through the render tree now that |m_layout| is still null.
+  auto layout = std::make_shared<ParagraphLayout>();
+  layout->width = this->width();
+  layout->height = height();
+  layout->min_intrinsic_width = minIntrinsicWidth();
+  layout->max_intrinsic_width = maxIntrinsicWidth();
+  layout->alphabetic_baseline = alphabeticBaseline();
+  layout->ideographic_baseline = ideographicBaseline();
+  layout->did_exceed_max_lines = didExceedMaxLines();
+
+  m_layout = layout;
+  cache.Put(m_content, m_width, m_layout);
+}
+
+void Paragraph::ensureRenderViewLayout() {
+  if (m_renderViewMaxWidth == m_maxWidth)
+    return;
+
   FontCachePurgePreventer fontCachePurgePreventer;
 
-  int maxWidth = LayoutUnit(width);  // Handles infinity properly.
-  m_renderView->setFrameViewSize(IntSize(maxWidth, intMaxForLayoutUnit));
+  m_renderView->setFrameViewSize(IntSize(m_maxWidth, intMaxForLayoutUnit));
   m_renderView->layout();
+  m_renderViewMaxWidth = m_maxWidth;
+
+  // Laying out adds line boxes. Dart keeps the size the paragraph was wrapped
+  // with, but the engine-wide tally follows.
+  m_externalAllocation.Update(computeAllocationSize());
 }
 
 void Paragraph::paint(Canvas* canvas, double x, double y) {
@@ -104,12 +202,55 @@ void Paragraph::paint(Canvas* canvas, double x, double y) {
   if (!skCanvas)
     return;
 
+  if (!m_layout) {
+    // Painting without a layout is not worth remembering.
+    skCanvas->translate(x, y);
+    paintRenderView(skCanvas);
+    skCanvas->translate(-x, -y);
+    return;
+  }
+
+  if (!m_layout->painted) {
+    ensureRenderViewLayout();
+
+    auto layout = std::make_shared<ParagraphLayout>(*m_layout);
+    layout->painted = true;
+
+    // Most paragraphs are plain text. Capture their blobs so that painting
+    // them again is a handful of drawTextBlob calls that share the blobs
+    // instead of a walk of the render tree or a nested picture.
+    GlyphRunCollector collector;
+    paintRenderView(&collector);
+    if (collector.complete()) {
+      layout->glyph_runs = collector.TakeRuns();
+    } else {
+      SkPictureRecorder recorder;
+      paintRenderView(recorder.beginRecording(kUnboundedRecording));
+      layout->picture = recorder.finishRecordingAsPicture();
+    }
+
+    m_layout = layout;
+    layoutCache().Put(m_content, m_width, m_layout);
+  }
+
+  if (m_layout->picture) {
+    const SkMatrix translation = SkMatrix::MakeTrans(x, y);
+    skCanvas->drawPicture(m_layout->picture.get(), &translation, nullptr);
+    return;
+  }
+
+  for (const GlyphRun& run : m_layout->glyph_runs) {
+    skCanvas->drawTextBlob(run.blob.get(), x + run.origin.x(),
+                           y + run.origin.y(), run.paint);
+  }
+}
+
+void Paragraph::paintRenderView(SkCanvas* skCanvas) {
   FontCachePurgePreventer fontCachePurgePreventer;
 
   // Very simplified painting to allow painting an arbitrary (layer-less)
   // subtree.
   RenderBox* box = firstChildBox();
-  skCanvas->translate(x, y);
 
   GraphicsContext context(skCanvas);
   Vector<RenderBox*> layers;
@@ -119,14 +260,14 @@ void Paragraph::paint(Canvas* canvas, double x, double y) {
   box->paint(paintInfo, LayoutPoint(), layers);
   // Note we're ignoring any layers encountered.
   // TODO(abarth): Remove the concept of RenderLayers.
-
-  skCanvas->translate(-x, -y);
 }
 
 std::vector<TextBox> Paragraph::getRectsForRange(unsigned start, unsigned end) {
   if (end <= start || start == end)
     return std::vector<TextBox>();
 
+  ensureRenderViewLayout();
+
   unsigned offset = 0;
   std::vector<TextBox> boxes;
   for (RenderObject* object = m_renderView.get(); object;
@@ -165,6 +306,7 @@ int Paragraph::absoluteOffsetForPosition(const PositionWithAffinity& position) {
 }
 
 Dart_Handle Paragraph::getPositionForOffset(double dx, double dy) {
+  ensureRenderViewLayout();
   LayoutPoint point(dx, dy);
   PositionWithAffinity position = m_renderView->positionForPoint(point);
   Dart_Handle result = Dart_NewList(2);
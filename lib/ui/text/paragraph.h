@@ -5,7 +5,12 @@
 #ifndef FLUTTER_LIB_UI_TEXT_PARAGRAPH_H_
 #define FLUTTER_LIB_UI_TEXT_PARAGRAPH_H_
 
+#include <memory>
+#include <string>
+
+#include "flutter/lib/ui/external_allocation.h"
 #include "flutter/lib/ui/painting/canvas.h"
+#include "flutter/lib/ui/text/paragraph_layout_cache.h"
 #include "flutter/lib/ui/text/text_box.h"
 #include "flutter/sky/engine/core/rendering/RenderView.h"
 #include "lib/tonic/dart_wrappable.h"
@@ -22,8 +27,11 @@ class Paragraph : public ftl::RefCountedThreadSafe<Paragraph>,
   FRIEND_MAKE_REF_COUNTED(Paragraph);
 
  public:
-  static ftl::RefPtr<Paragraph> create(PassOwnPtr<RenderView> renderView) {
-    return ftl::MakeRefCounted<Paragraph>(renderView);
+  // |content| identifies what |renderView| was built from. See
+  // |ParagraphLayoutCache|.
+  static ftl::RefPtr<Paragraph> create(PassOwnPtr<RenderView> renderView,
+                                       std::string content) {
+    return ftl::MakeRefCounted<Paragraph>(renderView, std::move(content));
   }
 
   ~Paragraph() override;
@@ -54,9 +62,29 @@ class Paragraph : public ftl::RefCountedThreadSafe<Paragraph>,
 
   int absoluteOffsetForPosition(const PositionWithAffinity& position);
 
-  explicit Paragraph(PassOwnPtr<RenderView> renderView);
+  // Lays out the render tree at the width of the last call to |layout|
+  // unless it already is. Layouts taken from the cache leave the render tree
+  // alone till something needs its line boxes.
+  void ensureRenderViewLayout();
+
+  void paintRenderView(SkCanvas* canvas);
+
+  // The bytes of the render tree, including its line boxes once laid out.
+  size_t computeAllocationSize() const;
+
+  Paragraph(PassOwnPtr<RenderView> renderView, std::string content);
 
   OwnPtr<RenderView> m_renderView;
+  std::string m_content;
+  // The width of the last call to |layout|, or -1.
+  double m_width;
+  // |m_width| as the render tree lays it out, or -1.
+  int m_maxWidth;
+  // The width the render tree was last laid out at, or -1.
+  int m_renderViewMaxWidth;
+  // Null before the first call to |layout|.
+  std::shared_ptr<const ParagraphLayout> m_layout;
+  ExternalAllocation m_externalAllocation;
 };
 
 }  // namespace blink
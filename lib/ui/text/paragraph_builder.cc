@@ -154,6 +154,35 @@ PassRefPtr<RenderStyle> decodeParagraphStyle(
   return style.release();
 }
 
+// Tags telling apart the calls recorded in the content of a paragraph.
+const char kParagraphStyleTag = 'P';
+const char kPushStyleTag = 'S';
+const char kPopTag = 'p';
+const char kTextTag = 'T';
+
+void appendBytes(std::string& content, const void* data, size_t size) {
+  content.append(static_cast<const char*>(data), size);
+}
+
+void appendInt32List(std::string& content, tonic::Int32List& list) {
+  const uint32_t count = list.num_elements();
+  appendBytes(content, &count, sizeof(count));
+  for (uint32_t i = 0; i < count; i++) {
+    const int32_t value = list[i];
+    appendBytes(content, &value, sizeof(value));
+  }
+}
+
+void appendString(std::string& content, const std::string& string) {
+  const uint32_t size = string.size();
+  appendBytes(content, &size, sizeof(size));
+  content.append(string);
+}
+
+void appendDouble(std::string& content, double value) {
+  appendBytes(content, &value, sizeof(value));
+}
+
 Color getColorFromARGB(int argb) {
   return Color((argb & 0x00FF0000) >> 16, (argb & 0x0000FF00) >> 8,
                (argb & 0x000000FF) >> 0, (argb & 0xFF000000) >> 24);
@@ -200,6 +229,14 @@ ParagraphBuilder::ParagraphBuilder(tonic::Int32List& encoded,
 
   RefPtr<RenderStyle> paragraphStyle = decodeParagraphStyle(
       m_renderView->style(), encoded, fontFamily, fontSize, lineHeight, ellipsis);
+
+  m_content.push_back(kParagraphStyleTag);
+  appendInt32List(m_content, encoded);
+  appendString(m_content, fontFamily);
+  appendDouble(m_content, fontSize);
+  appendDouble(m_content, lineHeight);
+  appendString(m_content, ellipsis);
+
   encoded.Release();
 
   m_renderParagraph = new RenderParagraph();
@@ -290,6 +327,14 @@ void ParagraphBuilder::pushStyle(tonic::Int32List& encoded,
     style->setLineHeight(Length(height * 100.0, Percent));
   }
 
+  m_content.push_back(kPushStyleTag);
+  appendInt32List(m_content, encoded);
+  appendString(m_content, fontFamily);
+  appendDouble(m_content, fontSize);
+  appendDouble(m_content, letterSpacing);
+  appendDouble(m_content, wordSpacing);
+  appendDouble(m_content, height);
+
   encoded.Release();
 
   RenderObject* span = new RenderInline();
@@ -299,8 +344,10 @@ void ParagraphBuilder::pushStyle(tonic::Int32List& encoded,
 }
 
 void ParagraphBuilder::pop() {
-  if (m_currentRenderObject)
+  if (m_currentRenderObject) {
     m_currentRenderObject = m_currentRenderObject->parent();
+    m_content.push_back(kPopTag);
+  }
 }
 
 void ParagraphBuilder::addText(const std::string& text) {
@@ -311,11 +358,14 @@ void ParagraphBuilder::addText(const std::string& text) {
   style->inheritFrom(m_currentRenderObject->style());
   renderText->setStyle(style.release());
   m_currentRenderObject->addChild(renderText);
+
+  m_content.push_back(kTextTag);
+  appendString(m_content, text);
 }
 
 ftl::RefPtr<Paragraph> ParagraphBuilder::build() {
   m_currentRenderObject = nullptr;
-  return Paragraph::create(m_renderView.release());
+  return Paragraph::create(m_renderView.release(), std::move(m_content));
 }
 
 void ParagraphBuilder::createRenderView() {
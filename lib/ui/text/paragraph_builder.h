@@ -55,6 +55,9 @@ class ParagraphBuilder : public ftl::RefCountedThreadSafe<ParagraphBuilder>,
   OwnPtr<RenderView> m_renderView;
   RenderObject* m_renderParagraph;
   RenderObject* m_currentRenderObject;
+  // Everything the paragraph was built from, in order. Paragraphs with the
+  // same content lay out the same.
+  std::string m_content;
 };
 
 }  // namespace blink
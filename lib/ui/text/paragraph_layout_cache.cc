@@ -0,0 +1,109 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/text/paragraph_layout_cache.h"
+
+#include <iterator>
+
+namespace blink {
+namespace {
+
+std::string MakeKey(const std::string& content, double width) {
+  // Zero and negative zero lay out the same but differ in their bits.
+  if (width == 0)
+    width = 0;
+  std::string key(content);
+  key.append(reinterpret_cast<const char*>(&width), sizeof(width));
+  return key;
+}
+
+size_t EstimateBytes(const std::string& key, const ParagraphLayout& layout) {
+  // The key is held by both the list and the index.
+  size_t bytes = 2 * key.size() + sizeof(ParagraphLayout);
+  if (layout.picture)
+    bytes += layout.picture->approximateBytesUsed();
+  if (!layout.glyph_runs.empty()) {
+    // Skia does not report the size of text blobs. Assume that each byte of
+    // the content, which includes the text, became a positioned glyph.
+    bytes += layout.glyph_runs.size() * sizeof(GlyphRun) +
+             key.size() * (sizeof(uint16_t) + sizeof(SkPoint));
+  }
+  return bytes;
+}
+
+}  // namespace
+
+constexpr size_t ParagraphLayoutCache::kDefaultMaxBytes;
+
+ParagraphLayoutCache::ParagraphLayoutCache()
+    : max_bytes_(kDefaultMaxBytes), bytes_(0) {}
+
+ParagraphLayoutCache::~ParagraphLayoutCache() = default;
+
+std::shared_ptr<const ParagraphLayout> ParagraphLayoutCache::Get(
+    const std::string& content,
+    double width) {
+  auto found = index_.find(MakeKey(content, width));
+  if (found == index_.end()) {
+    miss_count_.Increment();
+    return nullptr;
+  }
+
+  hit_count_.Increment();
+  entries_.splice(entries_.begin(), entries_, found->second);
+  return found->second->layout;
+}
+
+void ParagraphLayoutCache::Put(const std::string& content,
+                               double width,
+                               std::shared_ptr<const ParagraphLayout> layout) {
+  if (!layout)
+    return;
+
+  std::string key = MakeKey(content, width);
+
+  auto found = index_.find(key);
+  if (found != index_.end())
+    Erase(found->second);
+
+  const size_t bytes = EstimateBytes(key, *layout);
+  if (bytes > max_bytes_)
+    return;
+
+  entries_.push_front(Entry{key, std::move(layout), bytes});
+  index_.emplace(std::move(key), entries_.begin());
+  bytes_ += bytes;
+
+  EvictToBudget();
+}
+
+void ParagraphLayoutCache::SetMaxBytes(size_t max_bytes) {
+  max_bytes_ = max_bytes;
+  EvictToBudget();
+}
+
+void ParagraphLayoutCache::Trim() {
+  const size_t target_bytes = max_bytes_ - max_bytes_ / 4;
+  while (bytes_ > target_bytes && !entries_.empty())
+    Erase(std::prev(entries_.end()));
+}
+
+void ParagraphLayoutCache::Clear() {
+  entries_.clear();
+  index_.clear();
+  bytes_ = 0;
+}
+
+void ParagraphLayoutCache::Erase(EntryList::iterator entry) {
+  bytes_ -= entry->bytes;
+  index_.erase(entry->key);
+  entries_.erase(entry);
+}
+
+void ParagraphLayoutCache::EvictToBudget() {
+  while (bytes_ > max_bytes_ && !entries_.empty())
+    Erase(std::prev(entries_.end()));
+}
+
+}  // namespace blink
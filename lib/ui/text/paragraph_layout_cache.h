@@ -0,0 +1,113 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_TEXT_PARAGRAPH_LAYOUT_CACHE_H_
+#define FLUTTER_LIB_UI_TEXT_PARAGRAPH_LAYOUT_CACHE_H_
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/flow/instrumentation.h"
+#include "flutter/lib/ui/text/glyph_run_collector.h"
+#include "lib/ftl/macros.h"
+#include "third_party/skia/include/core/SkPicture.h"
+
+namespace blink {
+
+// What a paragraph laid out at a given width looks like from the outside.
+struct ParagraphLayout {
+  double width = 0;
+  double height = 0;
+  double min_intrinsic_width = 0;
+  double max_intrinsic_width = 0;
+  double alphabetic_baseline = 0;
+  double ideographic_baseline = 0;
+  bool did_exceed_max_lines = false;
+  // Whether what the paragraph draws has been captured below. Happens the
+  // first time the paragraph is painted.
+  bool painted = false;
+  // The text of the paragraph relative to its origin, in painting order. Only
+  // used when the paragraph draws nothing but text blobs, which rules out
+  // decorations for example.
+  std::vector<GlyphRun> glyph_runs;
+  // The glyph runs and decorations of the paragraph, ready to be drawn at its
+  // origin. Only set for paragraphs that cannot be drawn as |glyph_runs|.
+  sk_sp<SkPicture> picture;
+};
+
+// Maps the content of a paragraph, as recorded by |ParagraphBuilder|, and the
+// width it was laid out at to its layout, so that identical paragraphs do not
+// have to be laid out and painted again. Once the estimated size of the
+// layouts exceeds the byte budget, the least recently used ones are evicted.
+//
+// Layouts depend on the fonts available to the isolate, so each isolate has
+// its own cache. Must only be used on the thread of that isolate.
+class ParagraphLayoutCache {
+ public:
+  static constexpr size_t kDefaultMaxBytes = 2 * 1024 * 1024;
+
+  ParagraphLayoutCache();
+
+  ~ParagraphLayoutCache();
+
+  // Returns null if there is no layout for the content at the width.
+  // Widths are compared exactly, as any difference may change where lines
+  // break.
+  std::shared_ptr<const ParagraphLayout> Get(const std::string& content,
+                                             double width);
+
+  // Replaces any layout cached for the content at the width.
+  void Put(const std::string& content,
+           double width,
+           std::shared_ptr<const ParagraphLayout> layout);
+
+  void SetMaxBytes(size_t max_bytes);
+
+  // Evicts the least recently used layouts until a quarter of the budget is
+  // free. Meant for moderate memory pressure.
+  void Trim();
+
+  // Evicts every layout, as when the platform is low on memory.
+  void Clear();
+
+  size_t max_bytes() const { return max_bytes_; }
+
+  size_t bytes() const { return bytes_; }
+
+  size_t entry_count() const { return entries_.size(); }
+
+  const flow::Counter& hit_count() const { return hit_count_; }
+
+  const flow::Counter& miss_count() const { return miss_count_; }
+
+ private:
+  struct Entry {
+    std::string key;
+    std::shared_ptr<const ParagraphLayout> layout;
+    size_t bytes;
+  };
+
+  // Most recently used first.
+  using EntryList = std::list<Entry>;
+
+  size_t max_bytes_;
+  size_t bytes_;
+  EntryList entries_;
+  std::unordered_map<std::string, EntryList::iterator> index_;
+  flow::Counter hit_count_;
+  flow::Counter miss_count_;
+
+  void Erase(EntryList::iterator entry);
+
+  void EvictToBudget();
+
+  FTL_DISALLOW_COPY_AND_ASSIGN(ParagraphLayoutCache);
+};
+
+}  // namespace blink
+
+#endif  // FLUTTER_LIB_UI_TEXT_PARAGRAPH_LAYOUT_CACHE_H_
@@ -0,0 +1,117 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/text/paragraph_layout_cache.h"
+
+#include "third_party/gtest/include/gtest/gtest.h"
+
+namespace blink {
+namespace {
+
+std::shared_ptr<const ParagraphLayout> MakeLayout(double height) {
+  auto layout = std::make_shared<ParagraphLayout>();
+  layout->height = height;
+  return layout;
+}
+
+// The bytes a layout without glyph runs or picture is accounted for.
+size_t EntryBytes(const std::string& content) {
+  return 2 * (content.size() + sizeof(double)) + sizeof(ParagraphLayout);
+}
+
+}  // namespace
+
+TEST(ParagraphLayoutCache, ReturnsLayoutForSameContentAndWidth) {
+  ParagraphLayoutCache cache;
+  auto layout = MakeLayout(10);
+  cache.Put("hello", 100.5, layout);
+
+  ASSERT_EQ(cache.Get("hello", 100.5), layout);
+  ASSERT_EQ(cache.hit_count().count(), 1u);
+  ASSERT_EQ(cache.miss_count().count(), 0u);
+  ASSERT_EQ(cache.entry_count(), 1u);
+}
+
+TEST(ParagraphLayoutCache, MissesOnDifferentContent) {
+  ParagraphLayoutCache cache;
+  cache.Put("hello", 100, MakeLayout(10));
+
+  // The content recorded by ParagraphBuilder includes the styles, so a style
+  // change is a content change.
+  ASSERT_EQ(cache.Get("hellO", 100), nullptr);
+  ASSERT_EQ(cache.Get("hello ", 100), nullptr);
+  ASSERT_EQ(cache.miss_count().count(), 2u);
+}
+
+TEST(ParagraphLayoutCache, MissesOnFractionalWidthChange) {
+  ParagraphLayoutCache cache;
+  cache.Put("hello", 100.25, MakeLayout(10));
+
+  ASSERT_EQ(cache.Get("hello", 100.75), nullptr);
+  ASSERT_EQ(cache.Get("hello", 100), nullptr);
+  ASSERT_NE(cache.Get("hello", 100.25), nullptr);
+}
+
+TEST(ParagraphLayoutCache, TreatsZeroWidthsAlike) {
+  ParagraphLayoutCache cache;
+  cache.Put("hello", -0.0, MakeLayout(10));
+
+  ASSERT_NE(cache.Get("hello", 0.0), nullptr);
+}
+
+TEST(ParagraphLayoutCache, ReplacesLayoutPutAgain) {
+  ParagraphLayoutCache cache;
+  cache.Put("hello", 100, MakeLayout(10));
+  auto replacement = MakeLayout(20);
+  cache.Put("hello", 100, replacement);
+
+  ASSERT_EQ(cache.Get("hello", 100), replacement);
+  ASSERT_EQ(cache.entry_count(), 1u);
+  ASSERT_EQ(cache.bytes(), EntryBytes("hello"));
+}
+
+TEST(ParagraphLayoutCache, EvictsLeastRecentlyUsedOverBudget) {
+  ParagraphLayoutCache cache;
+  cache.SetMaxBytes(2 * EntryBytes("a"));
+
+  cache.Put("a", 100, MakeLayout(1));
+  cache.Put("b", 100, MakeLayout(2));
+  // Makes "b" the least recently used.
+  ASSERT_NE(cache.Get("a", 100), nullptr);
+  cache.Put("c", 100, MakeLayout(3));
+
+  ASSERT_EQ(cache.entry_count(), 2u);
+  ASSERT_EQ(cache.bytes(), 2 * EntryBytes("a"));
+  ASSERT_NE(cache.Get("a", 100), nullptr);
+  ASSERT_EQ(cache.Get("b", 100), nullptr);
+  ASSERT_NE(cache.Get("c", 100), nullptr);
+}
+
+TEST(ParagraphLayoutCache, DoesNotCacheLayoutsOverBudget) {
+  ParagraphLayoutCache cache;
+  cache.SetMaxBytes(EntryBytes("a") - 1);
+  cache.Put("a", 100, MakeLayout(1));
+
+  ASSERT_EQ(cache.entry_count(), 0u);
+  ASSERT_EQ(cache.bytes(), 0u);
+}
+
+TEST(ParagraphLayoutCache, TrimLeavesAQuarterOfTheBudgetFree) {
+  ParagraphLayoutCache cache;
+  cache.SetMaxBytes(4 * EntryBytes("a"));
+  cache.Put("a", 100, MakeLayout(1));
+  cache.Put("b", 100, MakeLayout(2));
+  cache.Put("c", 100, MakeLayout(3));
+  cache.Put("d", 100, MakeLayout(4));
+
+  cache.Trim();
+  ASSERT_EQ(cache.entry_count(), 3u);
+  ASSERT_EQ(cache.Get("a", 100), nullptr);
+
+  cache.Clear();
+  ASSERT_EQ(cache.entry_count(), 0u);
+  ASSERT_EQ(cache.bytes(), 0u);
+}
+
+}  // namespace blink
@@ -0,0 +1,217 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Compares the ways a laid out paragraph can be painted into the picture of a
+// frame: replaying the drawing calls its render tree makes, drawing the
+// picture it was recorded into once, and drawing the glyph runs collected
+// from it. Reports the time taken to record a frame full of paragraphs, the
+// number of operations the frame picture holds and plays back, and the time
+// taken to rasterize it.
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "flutter/lib/ui/text/glyph_run_collector.h"
+#include "lib/ftl/time/time_delta.h"
+#include "lib/ftl/time/time_point.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace {
+
+constexpr int kFrameWidth = 1080;
+constexpr int kFrameHeight = 1920;
+constexpr size_t kParagraphCount = 60;
+constexpr size_t kLinesPerParagraph = 8;
+constexpr size_t kRunsPerLine = 3;
+constexpr float kLineHeight = 20;
+constexpr size_t kIterations = 50;
+
+const SkRect kUnboundedRecording =
+    SkRect::MakeLTRB(-1.0e6f, -1.0e6f, 1.0e6f, 1.0e6f);
+
+struct TextBox {
+  sk_sp<SkTextBlob> blob;
+  SkPoint offset;
+  SkPaint paint;
+};
+
+sk_sp<SkTextBlob> MakeBlob(const char* text, const SkPaint& paint) {
+  SkPaint glyph_paint(paint);
+  glyph_paint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+
+  const int count = paint.textToGlyphs(text, strlen(text), nullptr);
+  SkTextBlobBuilder builder;
+  const SkTextBlobBuilder::RunBuffer& buffer =
+      builder.allocRunPosH(glyph_paint, count, 0);
+  paint.textToGlyphs(text, strlen(text), buffer.glyphs);
+
+  std::vector<SkScalar> widths(count);
+  glyph_paint.getTextWidths(buffer.glyphs, count * sizeof(uint16_t),
+                            widths.data());
+  SkScalar x = 0;
+  for (int i = 0; i < count; i++) {
+    buffer.pos[i] = x;
+    x += widths[i];
+  }
+  return builder.make();
+}
+
+// The text boxes of a paragraph, one per style run on each line.
+std::vector<TextBox> MakeParagraph() {
+  static const char* kWords[] = {"The quick brown ", "fox jumps over ",
+                                 "the lazy dog. "};
+  static const SkColor kColors[] = {SK_ColorBLACK, SK_ColorBLUE,
+                                    SK_ColorDKGRAY};
+
+  std::vector<TextBox> boxes;
+  for (size_t line = 0; line < kLinesPerParagraph; line++) {
+    float x = 0;
+    for (size_t run = 0; run < kRunsPerLine; run++) {
+      TextBox box;
+      box.paint.setAntiAlias(true);
+      box.paint.setTextSize(14);
+      box.paint.setColor(kColors[run % 3]);
+      box.blob = MakeBlob(kWords[run % 3], box.paint);
+      box.offset = SkPoint::Make(x, line * kLineHeight);
+      boxes.push_back(box);
+      x += box.blob->bounds().width();
+    }
+  }
+  return boxes;
+}
+
+// What painting the render tree of the paragraph asks of the canvas: the
+// graphics context saves and translates around every text box.
+void PaintRenderTree(SkCanvas* canvas, const std::vector<TextBox>& boxes) {
+  for (const TextBox& box : boxes) {
+    canvas->save();
+    canvas->translate(box.offset.x(), box.offset.y());
+    canvas->drawTextBlob(box.blob.get(), 0, kLineHeight, box.paint);
+    canvas->restore();
+  }
+}
+
+enum class Strategy {
+  kRenderTree,
+  kPicture,
+  kGlyphRuns,
+};
+
+struct Paragraph {
+  std::vector<TextBox> boxes;
+  sk_sp<SkPicture> picture;
+  std::vector<blink::GlyphRun> glyph_runs;
+};
+
+void PaintParagraph(SkCanvas* canvas,
+                    const Paragraph& paragraph,
+                    Strategy strategy,
+                    SkScalar x,
+                    SkScalar y) {
+  switch (strategy) {
+    case Strategy::kRenderTree:
+      canvas->translate(x, y);
+      PaintRenderTree(canvas, paragraph.boxes);
+      canvas->translate(-x, -y);
+      break;
+    case Strategy::kPicture: {
+      const SkMatrix translation = SkMatrix::MakeTrans(x, y);
+      canvas->drawPicture(paragraph.picture.get(), &translation, nullptr);
+      break;
+    }
+    case Strategy::kGlyphRuns:
+      for (const blink::GlyphRun& run : paragraph.glyph_runs) {
+        canvas->drawTextBlob(run.blob.get(), x + run.origin.x(),
+                             y + run.origin.y(), run.paint);
+      }
+      break;
+  }
+}
+
+sk_sp<SkPicture> RecordFrame(const std::vector<Paragraph>& paragraphs,
+                             Strategy strategy) {
+  SkPictureRecorder recorder;
+  SkCanvas* canvas = recorder.beginRecording(
+      SkRect::MakeWH(kFrameWidth, kFrameHeight));
+  const float paragraph_height = kLinesPerParagraph * kLineHeight;
+  for (size_t i = 0; i < paragraphs.size(); i++) {
+    PaintParagraph(canvas, paragraphs[i], strategy, 16,
+                   (i * paragraph_height) / 4);
+  }
+  return recorder.finishRecordingAsPicture();
+}
+
+double MicrosecondsPerIteration(ftl::TimeDelta delta) {
+  return static_cast<double>(delta.ToNanoseconds()) / 1000 / kIterations;
+}
+
+void Run(const char* name,
+         const std::vector<Paragraph>& paragraphs,
+         Strategy strategy) {
+  sk_sp<SkPicture> frame;
+  ftl::TimeDelta record_time = ftl::TimeDelta::Zero();
+  for (size_t i = 0; i < kIterations; i++) {
+    const ftl::TimePoint start = ftl::TimePoint::Now();
+    frame = RecordFrame(paragraphs, strategy);
+    record_time = record_time + (ftl::TimePoint::Now() - start);
+  }
+
+  int played_ops = frame->approximateOpCount();
+  if (strategy == Strategy::kPicture) {
+    // Nested pictures are recorded as one operation each, but all of theirs
+    // are played back.
+    for (const Paragraph& paragraph : paragraphs)
+      played_ops += paragraph.picture->approximateOpCount();
+  }
+
+  sk_sp<SkSurface> surface = SkSurface::MakeRaster(
+      SkImageInfo::MakeN32Premul(kFrameWidth, kFrameHeight));
+  ftl::TimeDelta raster_time = ftl::TimeDelta::Zero();
+  for (size_t i = 0; i < kIterations; i++) {
+    const ftl::TimePoint start = ftl::TimePoint::Now();
+    surface->getCanvas()->clear(SK_ColorWHITE);
+    frame->playback(surface->getCanvas());
+    surface->getCanvas()->flush();
+    raster_time = raster_time + (ftl::TimePoint::Now() - start);
+  }
+
+  printf("%-12s %12.1f %12d %12d %12.1f\n", name,
+         MicrosecondsPerIteration(record_time), frame->approximateOpCount(),
+         played_ops, MicrosecondsPerIteration(raster_time));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::vector<Paragraph> paragraphs(kParagraphCount);
+  for (Paragraph& paragraph : paragraphs) {
+    paragraph.boxes = MakeParagraph();
+
+    SkPictureRecorder recorder;
+    PaintRenderTree(recorder.beginRecording(kUnboundedRecording),
+                    paragraph.boxes);
+    paragraph.picture = recorder.finishRecordingAsPicture();
+
+    blink::GlyphRunCollector collector;
+    PaintRenderTree(&collector, paragraph.boxes);
+    if (!collector.complete()) {
+      fprintf(stderr, "Paragraphs could not be collected as glyph runs.\n");
+      return 1;
+    }
+    paragraph.glyph_runs = collector.TakeRuns();
+  }
+
+  printf("%zu paragraphs of %zu lines with %zu runs each, %zu iterations\n",
+         kParagraphCount, kLinesPerParagraph, kRunsPerLine, kIterations);
+  printf("%-12s %12s %12s %12s %12s\n", "strategy", "record (us)", "ops",
+         "played ops", "raster (us)");
+  Run("render tree", paragraphs, Strategy::kRenderTree);
+  Run("picture", paragraphs, Strategy::kPicture);
+  Run("glyph runs", paragraphs, Strategy::kGlyphRuns);
+
+  return 0;
+}
@@ -4,6 +4,7 @@
 
 #include "flutter/lib/ui/ui_dart_state.h"
 
+#include "flutter/lib/ui/text/paragraph_layout_cache.h"
 #include "flutter/lib/ui/window/window.h"
 #include "flutter/sky/engine/platform/fonts/FontSelector.h"
 #include "lib/tonic/converter/dart_converter.h"
@@ -18,7 +19,8 @@ UIDartState::UIDartState(IsolateClient* isolate_client,
                          std::unique_ptr<Window> window)
     : isolate_client_(isolate_client),
       main_port_(ILLEGAL_PORT),
-      window_(std::move(window)) {}
+      window_(std::move(window)),
+      paragraph_layout_cache_(std::make_unique<ParagraphLayoutCache>()) {}
 
 UIDartState::~UIDartState() {
   main_port_ = ILLEGAL_PORT;
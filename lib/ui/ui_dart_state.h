@@ -5,6 +5,7 @@
 #ifndef FLUTTER_LIB_UI_UI_DART_STATE_H_
 #define FLUTTER_LIB_UI_UI_DART_STATE_H_
 
+#include <memory>
 #include <utility>
 
 #include "dart/runtime/include/dart_api.h"
@@ -15,6 +16,7 @@
 
 namespace blink {
 class FontSelector;
+class ParagraphLayoutCache;
 class Window;
 
 class IsolateClient {
@@ -42,6 +44,10 @@ class UIDartState : public tonic::DartState {
   void set_font_selector(PassRefPtr<FontSelector> selector);
   PassRefPtr<FontSelector> font_selector();
 
+  ParagraphLayoutCache& paragraph_layout_cache() {
+    return *paragraph_layout_cache_;
+  }
+
  private:
   void DidSetIsolate() override;
 
@@ -50,6 +56,7 @@ class UIDartState : public tonic::DartState {
   std::string debug_name_;
   std::unique_ptr<Window> window_;
   RefPtr<FontSelector> font_selector_;
+  std::unique_ptr<ParagraphLayoutCache> paragraph_layout_cache_;
 };
 
 }  // namespace blink
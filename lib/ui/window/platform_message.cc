@@ -6,19 +6,30 @@
 
 #include <utility>
 
+#include "lib/ftl/logging.h"
+
 namespace blink {
 
 PlatformMessage::PlatformMessage(std::string channel,
-                                 std::vector<uint8_t> data,
+                                 ftl::RefPtr<PlatformMessageBuffer> data,
                                  ftl::RefPtr<PlatformMessageResponse> response)
     : channel_(std::move(channel)),
       data_(std::move(data)),
       hasData_(true),
+      response_(std::move(response)) {
+  FTL_DCHECK(data_);
+}
+PlatformMessage::PlatformMessage(std::string channel,
+                                 std::vector<uint8_t> data,
+                                 ftl::RefPtr<PlatformMessageResponse> response)
+    : channel_(std::move(channel)),
+      data_(PlatformMessageBuffer::Create(std::move(data))),
+      hasData_(true),
       response_(std::move(response)) {}
 PlatformMessage::PlatformMessage(std::string channel,
                                  ftl::RefPtr<PlatformMessageResponse> response)
     : channel_(std::move(channel)),
-      data_(),
+      data_(PlatformMessageBuffer::Create(std::vector<uint8_t>())),
       hasData_(false),
       response_(std::move(response)) {}
 
@@ -8,6 +8,7 @@
 #include <string>
 #include <vector>
 
+#include "flutter/lib/ui/window/platform_message_buffer.h"
 #include "flutter/lib/ui/window/platform_message_response.h"
 #include "lib/ftl/memory/ref_counted.h"
 #include "lib/ftl/memory/ref_ptr.h"
@@ -20,7 +21,9 @@ class PlatformMessage : public ftl::RefCountedThreadSafe<PlatformMessage> {
 
  public:
   const std::string& channel() const { return channel_; }
-  const std::vector<uint8_t>& data() const { return data_; }
+  // Empty if the message has no data.
+  const PlatformMessageBuffer& data() const { return *data_; }
+  const ftl::RefPtr<PlatformMessageBuffer>& buffer() const { return data_; }
   bool hasData() { return hasData_; }
 
   const ftl::RefPtr<PlatformMessageResponse>& response() const {
@@ -28,6 +31,9 @@ class PlatformMessage : public ftl::RefCountedThreadSafe<PlatformMessage> {
   }
 
  private:
+  PlatformMessage(std::string name,
+                  ftl::RefPtr<PlatformMessageBuffer> data,
+                  ftl::RefPtr<PlatformMessageResponse> response);
   PlatformMessage(std::string name,
                   std::vector<uint8_t> data,
                   ftl::RefPtr<PlatformMessageResponse> response);
@@ -36,7 +42,7 @@ class PlatformMessage : public ftl::RefCountedThreadSafe<PlatformMessage> {
   ~PlatformMessage();
 
   std::string channel_;
-  std::vector<uint8_t> data_;
+  ftl::RefPtr<PlatformMessageBuffer> data_;
   bool hasData_;
   ftl::RefPtr<PlatformMessageResponse> response_;
 };
@@ -0,0 +1,96 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/window/platform_message_buffer.h"
+
+#include <string.h>
+
+#include <utility>
+
+#include "flutter/glue/trace_event.h"
+#include "lib/ftl/logging.h"
+
+namespace blink {
+namespace {
+
+// Below this size, copying into the Dart heap is cheaper than setting up the
+// finalizer of an external ByteData.
+constexpr size_t kExternalByteDataThreshold = 1024;
+
+Dart_Handle CopyToByteData(const PlatformMessageBuffer& buffer) {
+  Dart_Handle data_handle =
+      Dart_NewTypedData(Dart_TypedData_kByteData, buffer.size());
+  if (Dart_IsError(data_handle))
+    return data_handle;
+
+  Dart_TypedData_Type type;
+  void* data = nullptr;
+  intptr_t num_bytes = 0;
+  FTL_CHECK(!Dart_IsError(
+      Dart_TypedDataAcquireData(data_handle, &type, &data, &num_bytes)));
+
+  memcpy(data, buffer.data(), num_bytes);
+  Dart_TypedDataReleaseData(data_handle);
+  return data_handle;
+}
+
+}  // namespace
+
+ftl::RefPtr<PlatformMessageBuffer> PlatformMessageBuffer::Create(
+    std::vector<uint8_t> data) {
+  return ftl::MakeRefCounted<PlatformMessageBuffer>(std::move(data));
+}
+
+ftl::RefPtr<PlatformMessageBuffer> PlatformMessageBuffer::Create(
+    std::unique_ptr<fml::Mapping> mapping) {
+  return ftl::MakeRefCounted<PlatformMessageBuffer>(std::move(mapping));
+}
+
+ftl::RefPtr<PlatformMessageBuffer> PlatformMessageBuffer::Copy(
+    const uint8_t* data,
+    size_t size) {
+  TRACE_EVENT0("flutter", "PlatformMessageBuffer::Copy");
+  return Create(std::vector<uint8_t>(data, data + size));
+}
+
+PlatformMessageBuffer::PlatformMessageBuffer(std::vector<uint8_t> data)
+    : vector_(std::move(data)), data_(vector_.data()), size_(vector_.size()) {}
+
+PlatformMessageBuffer::PlatformMessageBuffer(
+    std::unique_ptr<fml::Mapping> mapping)
+    : mapping_(std::move(mapping)),
+      data_(mapping_ ? mapping_->GetMapping() : nullptr),
+      size_(mapping_ ? mapping_->GetSize() : 0) {}
+
+PlatformMessageBuffer::~PlatformMessageBuffer() = default;
+
+Dart_Handle ToByteData(ftl::RefPtr<PlatformMessageBuffer> buffer) {
+  if (!CanShareWithDart(*buffer))
+    return CopyToByteData(*buffer);
+
+  Dart_Handle data_handle = Dart_NewExternalTypedData(
+      Dart_TypedData_kByteData, const_cast<uint8_t*>(buffer->data()),
+      buffer->size());
+  if (Dart_IsError(data_handle))
+    return data_handle;
+
+  // The reference is handed over to the finalizer.
+  PlatformMessageBuffer* peer = buffer.get();
+  peer->AddRef();
+  Dart_NewWeakPersistentHandle(data_handle, peer, peer->size(),
+                               ReleaseSharedBuffer);
+  return data_handle;
+}
+
+bool CanShareWithDart(const PlatformMessageBuffer& buffer) {
+  return buffer.owns_data() && buffer.size() >= kExternalByteDataThreshold;
+}
+
+void ReleaseSharedBuffer(void* isolate_callback_data,
+                         Dart_WeakPersistentHandle handle,
+                         void* peer) {
+  static_cast<PlatformMessageBuffer*>(peer)->Release();
+}
+
+}  // namespace blink
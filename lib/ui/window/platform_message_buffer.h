@@ -0,0 +1,84 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_WINDOW_PLATFORM_MESSAGE_BUFFER_H_
+#define FLUTTER_LIB_UI_WINDOW_PLATFORM_MESSAGE_BUFFER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "dart/runtime/include/dart_api.h"
+#include "flutter/fml/mapping.h"
+#include "lib/ftl/memory/ref_counted.h"
+#include "lib/ftl/memory/ref_ptr.h"
+
+namespace blink {
+
+// The immutable payload of a platform message or of a response to one. It is
+// passed between the platform, UI and Dart by reference rather than copied.
+class PlatformMessageBuffer
+    : public ftl::RefCountedThreadSafe<PlatformMessageBuffer> {
+  FRIEND_REF_COUNTED_THREAD_SAFE(PlatformMessageBuffer);
+  FRIEND_MAKE_REF_COUNTED(PlatformMessageBuffer);
+
+ public:
+  // Takes over the bytes of |data| without copying them.
+  static ftl::RefPtr<PlatformMessageBuffer> Create(std::vector<uint8_t> data);
+
+  // Keeps |mapping| alive for as long as the buffer is referenced. Used for
+  // responses to flutter/assets, which refer to the mapped asset archive.
+  static ftl::RefPtr<PlatformMessageBuffer> Create(
+      std::unique_ptr<fml::Mapping> mapping);
+
+  // For bytes the buffer cannot own, such as those of a Dart typed list,
+  // which the garbage collector may move.
+  static ftl::RefPtr<PlatformMessageBuffer> Copy(const uint8_t* data,
+                                                 size_t size);
+
+  const uint8_t* data() const { return data_; }
+
+  size_t size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  // Whether the bytes are on the heap and owned by the buffer. The bytes of a
+  // mapping may be read only, like those of a mapped asset archive.
+  bool owns_data() const { return !mapping_; }
+
+ private:
+  std::vector<uint8_t> vector_;
+  std::unique_ptr<fml::Mapping> mapping_;
+  const uint8_t* data_;
+  size_t size_;
+
+  explicit PlatformMessageBuffer(std::vector<uint8_t> data);
+
+  explicit PlatformMessageBuffer(std::unique_ptr<fml::Mapping> mapping);
+
+  ~PlatformMessageBuffer();
+
+  FTL_DISALLOW_COPY_AND_ASSIGN(PlatformMessageBuffer);
+};
+
+// Returns a ByteData with the contents of |buffer|. Large buffers that own
+// their bytes are not copied: the ByteData refers to the bytes of the buffer,
+// which it keeps alive until it is garbage collected. Buffers backed by a
+// mapping are always copied, as Dart may write into the ByteData.
+Dart_Handle ToByteData(ftl::RefPtr<PlatformMessageBuffer> buffer);
+
+// Whether ToByteData hands the bytes of |buffer| to Dart without copying them.
+bool CanShareWithDart(const PlatformMessageBuffer& buffer);
+
+// The finalizer of the ByteData that shares the bytes of |peer|, a
+// PlatformMessageBuffer. Releases the reference ToByteData handed over to it.
+void ReleaseSharedBuffer(void* isolate_callback_data,
+                         Dart_WeakPersistentHandle handle,
+                         void* peer);
+
+}  // namespace blink
+
+#endif  // FLUTTER_LIB_UI_WINDOW_PLATFORM_MESSAGE_BUFFER_H_
@@ -0,0 +1,110 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/window/platform_message_buffer.h"
+
+#include <vector>
+
+#include "third_party/gtest/include/gtest/gtest.h"
+
+namespace blink {
+namespace {
+
+// Read only, like a mapped asset archive. Tells when it is destroyed.
+class TestMapping : public fml::Mapping {
+ public:
+  TestMapping(size_t size, bool* destroyed)
+      : data_(size, 0x2A), destroyed_(destroyed) {}
+
+  ~TestMapping() override { *destroyed_ = true; }
+
+  size_t GetSize() const override { return data_.size(); }
+
+  const uint8_t* GetMapping() const override { return data_.data(); }
+
+ private:
+  const std::vector<uint8_t> data_;
+  bool* destroyed_;
+
+  FTL_DISALLOW_COPY_AND_ASSIGN(TestMapping);
+};
+
+ftl::RefPtr<PlatformMessageBuffer> MakeMappedBuffer(size_t size,
+                                                    bool* destroyed) {
+  return PlatformMessageBuffer::Create(
+      std::unique_ptr<fml::Mapping>(new TestMapping(size, destroyed)));
+}
+
+}  // namespace
+
+TEST(PlatformMessageBuffer, TakesOverVectorWithoutCopying) {
+  std::vector<uint8_t> data(100, 7);
+  const uint8_t* bytes = data.data();
+  auto buffer = PlatformMessageBuffer::Create(std::move(data));
+
+  ASSERT_EQ(buffer->data(), bytes);
+  ASSERT_EQ(buffer->size(), 100u);
+  ASSERT_TRUE(buffer->owns_data());
+}
+
+TEST(PlatformMessageBuffer, CopiesBytesItCannotOwn) {
+  const uint8_t bytes[] = {1, 2, 3};
+  auto buffer = PlatformMessageBuffer::Copy(bytes, sizeof(bytes));
+
+  ASSERT_NE(buffer->data(), bytes);
+  ASSERT_EQ(std::vector<uint8_t>(buffer->data(), buffer->data() + 3),
+            std::vector<uint8_t>(bytes, bytes + 3));
+  ASSERT_TRUE(buffer->owns_data());
+}
+
+TEST(PlatformMessageBuffer, KeepsMappingAliveWhileReferenced) {
+  bool destroyed = false;
+  auto buffer = MakeMappedBuffer(16, &destroyed);
+  ASSERT_EQ(buffer->size(), 16u);
+  ASSERT_EQ(buffer->data()[0], 0x2A);
+  ASSERT_FALSE(buffer->owns_data());
+
+  auto other_reference = buffer;
+  buffer = nullptr;
+  ASSERT_FALSE(destroyed);
+  other_reference = nullptr;
+  ASSERT_TRUE(destroyed);
+}
+
+TEST(PlatformMessageBuffer, EmptyBuffers) {
+  ASSERT_TRUE(PlatformMessageBuffer::Create(std::vector<uint8_t>())->empty());
+  ASSERT_TRUE(
+      PlatformMessageBuffer::Create(std::unique_ptr<fml::Mapping>())->empty());
+}
+
+TEST(PlatformMessageBuffer, SharesOnlyLargeOwnedBuffersWithDart) {
+  ASSERT_FALSE(CanShareWithDart(
+      *PlatformMessageBuffer::Create(std::vector<uint8_t>(1023))));
+  ASSERT_TRUE(CanShareWithDart(
+      *PlatformMessageBuffer::Create(std::vector<uint8_t>(1024))));
+
+  const std::vector<uint8_t> bytes(4096);
+  ASSERT_TRUE(CanShareWithDart(
+      *PlatformMessageBuffer::Copy(bytes.data(), bytes.size())));
+
+  // Dart may write into the ByteData, which the mapping may not allow.
+  bool destroyed = false;
+  ASSERT_FALSE(CanShareWithDart(*MakeMappedBuffer(4096, &destroyed)));
+}
+
+TEST(PlatformMessageBuffer, FinalizerReleasesReferenceHandedOver) {
+  bool destroyed = false;
+  auto buffer = MakeMappedBuffer(16, &destroyed);
+
+  // As ToByteData does for the ByteData it returns.
+  PlatformMessageBuffer* peer = buffer.get();
+  peer->AddRef();
+  buffer = nullptr;
+  ASSERT_FALSE(destroyed);
+
+  ReleaseSharedBuffer(nullptr, nullptr, peer);
+  ASSERT_TRUE(destroyed);
+}
+
+}  // namespace blink
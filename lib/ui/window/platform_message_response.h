@@ -5,8 +5,7 @@
 #ifndef FLUTTER_LIB_UI_PLATFORM_PLATFORM_MESSAGE_RESPONSE_H_
 #define FLUTTER_LIB_UI_PLATFORM_PLATFORM_MESSAGE_RESPONSE_H_
 
-#include <vector>
-
+#include "flutter/lib/ui/window/platform_message_buffer.h"
 #include "lib/ftl/memory/ref_counted.h"
 #include "lib/ftl/memory/ref_ptr.h"
 
@@ -18,7 +17,7 @@ class PlatformMessageResponse
 
  public:
   // Callable on any thread.
-  virtual void Complete(std::vector<uint8_t> data) = 0;
+  virtual void Complete(ftl::RefPtr<PlatformMessageBuffer> data) = 0;
   virtual void CompleteEmpty() = 0;
 
   bool is_complete() const { return is_complete_; }
@@ -26,7 +26,8 @@ PlatformMessageResponseDart::~PlatformMessageResponseDart() {
   }
 }
 
-void PlatformMessageResponseDart::Complete(std::vector<uint8_t> data) {
+void PlatformMessageResponseDart::Complete(
+    ftl::RefPtr<PlatformMessageBuffer> data) {
   if (callback_.is_empty())
     return;
   FTL_DCHECK(!is_complete_);
@@ -38,19 +39,8 @@ void PlatformMessageResponseDart::Complete(std::vector<uint8_t> data) {
           return;
         tonic::DartState::Scope scope(dart_state);
 
-        Dart_Handle byte_buffer = Dart_NewTypedData(
-            Dart_TypedData_kByteData, data.size());
+        Dart_Handle byte_buffer = ToByteData(std::move(data));
         DART_CHECK_VALID(byte_buffer);
-
-        void* buffer;
-        intptr_t length;
-        Dart_TypedData_Type type;
-        DART_CHECK_VALID(
-            Dart_TypedDataAcquireData(byte_buffer, &type, &buffer, &length));
-        FTL_CHECK(type == Dart_TypedData_kByteData);
-        FTL_CHECK(static_cast<size_t>(length) == data.size());
-        memcpy(buffer, data.data(), length);
-        Dart_TypedDataReleaseData(byte_buffer);
         tonic::DartInvoke(callback.Release(), {byte_buffer});
       }));
 }
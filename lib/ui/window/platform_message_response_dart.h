@@ -15,7 +15,7 @@ class PlatformMessageResponseDart : public PlatformMessageResponse {
 
  public:
   // Callable on any thread.
-  void Complete(std::vector<uint8_t> data) override;
+  void Complete(ftl::RefPtr<PlatformMessageBuffer> data) override;
   void CompleteEmpty() override;
 
  protected:
@@ -0,0 +1,120 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/window/pointer_data_queue.h"
+
+#include <string.h>
+
+namespace blink {
+namespace {
+
+bool IsCoalescable(const PointerData& data) {
+  return data.change == PointerData::Change::kMove ||
+         data.change == PointerData::Change::kHover;
+}
+
+PointerData Resample(const PointerData& previous,
+                     const PointerData& current,
+                     int64_t sample_time) {
+  const double t =
+      static_cast<double>(sample_time - previous.time_stamp) /
+      static_cast<double>(current.time_stamp - previous.time_stamp);
+  PointerData result = current;
+  result.time_stamp = sample_time;
+  result.physical_x =
+      previous.physical_x + (current.physical_x - previous.physical_x) * t;
+  result.physical_y =
+      previous.physical_y + (current.physical_y - previous.physical_y) * t;
+  return result;
+}
+
+}  // namespace
+
+PointerDataQueue::PointerDataQueue()
+    : enqueued_count_(0), coalesced_count_(0), resampled_count_(0) {}
+
+PointerDataQueue::~PointerDataQueue() = default;
+
+void PointerDataQueue::Enqueue(const PointerDataPacket& packet) {
+  const std::vector<uint8_t>& bytes = packet.data();
+  const size_t count = bytes.size() / sizeof(PointerData);
+  for (size_t i = 0; i < count; i++) {
+    PointerData data;
+    memcpy(&data, &bytes[i * sizeof(PointerData)], sizeof(PointerData));
+    enqueued_count_++;
+
+    if (IsCoalescable(data)) {
+      // Only the most recent event of the device may absorb this one, so that
+      // the events of a device stay in order.
+      QueuedPointerData* last = nullptr;
+      for (auto it = queue_.rbegin(); it != queue_.rend(); ++it) {
+        if (it->data.device == data.device) {
+          last = &*it;
+          break;
+        }
+      }
+      if (last != nullptr && last->data.change == data.change &&
+          last->data.kind == data.kind && last->data.buttons == data.buttons) {
+        last->previous = last->data;
+        last->has_previous = true;
+        last->data = data;
+        coalesced_count_++;
+        continue;
+      }
+    }
+
+    queue_.push_back({data, PointerData(), false});
+  }
+}
+
+bool PointerDataQueue::CanResample(size_t index, int64_t sample_time) const {
+  const QueuedPointerData& queued = queue_[index];
+  if (!queued.has_previous || !IsCoalescable(queued.data))
+    return false;
+  if (sample_time <= queued.previous.time_stamp ||
+      sample_time >= queued.data.time_stamp) {
+    return false;
+  }
+  // Keeping the move queued is only correct if nothing follows it.
+  for (size_t i = index + 1; i < queue_.size(); i++) {
+    if (queue_[i].data.device == queued.data.device)
+      return false;
+  }
+  return true;
+}
+
+int64_t PointerDataQueue::GetSampleTime(ftl::TimePoint frame_time) {
+  static const ftl::TimeDelta kResampleLatency =
+      ftl::TimeDelta::FromMilliseconds(5);
+
+  if (frame_time <= ftl::TimePoint())
+    return 0;
+  return (frame_time - kResampleLatency).ToEpochDelta().ToMicroseconds();
+}
+
+std::unique_ptr<PointerDataPacket> PointerDataQueue::Flush(
+    int64_t sample_time) {
+  if (queue_.empty())
+    return nullptr;
+
+  std::unique_ptr<PointerDataPacket> packet(
+      new PointerDataPacket(queue_.size()));
+  std::vector<QueuedPointerData> retained;
+  for (size_t i = 0; i < queue_.size(); i++) {
+    const QueuedPointerData& queued = queue_[i];
+    if (sample_time > 0 && CanResample(i, sample_time)) {
+      PointerData resampled =
+          Resample(queued.previous, queued.data, sample_time);
+      packet->SetPointerData(i, resampled);
+      retained.push_back({queued.data, resampled, true});
+      resampled_count_++;
+    } else {
+      packet->SetPointerData(i, queued.data);
+    }
+  }
+  queue_.swap(retained);
+  return packet;
+}
+
+}  // namespace blink
@@ -0,0 +1,74 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_WINDOW_POINTER_DATA_QUEUE_H_
+#define FLUTTER_LIB_UI_WINDOW_POINTER_DATA_QUEUE_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "flutter/lib/ui/window/pointer_data.h"
+#include "flutter/lib/ui/window/pointer_data_packet.h"
+#include "lib/ftl/macros.h"
+#include "lib/ftl/time/time_point.h"
+
+namespace blink {
+
+// Collects the pointer events that arrive between two frames so that they can
+// be dispatched to Dart as a single packet. Consecutive moves (and hovers) of
+// a device are coalesced into the last one.
+class PointerDataQueue {
+ public:
+  PointerDataQueue();
+
+  ~PointerDataQueue();
+
+  void Enqueue(const PointerDataPacket& packet);
+
+  // Returns the queued events as one packet and empties the queue, or null if
+  // there are none.
+  //
+  // If |sample_time| (in the microseconds of PointerData::time_stamp) is
+  // positive, the last move of each device is resampled to that time when it
+  // lies between the last two moves that were coalesced. The move that was
+  // resampled stays queued so that the final position is delivered with the
+  // next flush.
+  std::unique_ptr<PointerDataPacket> Flush(int64_t sample_time);
+
+  // The sample time to flush the queue with for a frame that begins at
+  // |frame_time|, or zero if |frame_time| is unknown. Moves are resampled a
+  // little behind the frame so that there usually are samples on either side
+  // to interpolate between.
+  static int64_t GetSampleTime(ftl::TimePoint frame_time);
+
+  bool empty() const { return queue_.empty(); }
+
+  // Counters since the queue was created.
+  uint64_t enqueued_count() const { return enqueued_count_; }
+  uint64_t coalesced_count() const { return coalesced_count_; }
+  uint64_t resampled_count() const { return resampled_count_; }
+
+ private:
+  struct QueuedPointerData {
+    PointerData data;
+    // The move that |data| was coalesced with, if any.
+    PointerData previous;
+    bool has_previous;
+  };
+
+  bool CanResample(size_t index, int64_t sample_time) const;
+
+  std::vector<QueuedPointerData> queue_;
+  uint64_t enqueued_count_;
+  uint64_t coalesced_count_;
+  uint64_t resampled_count_;
+
+  FTL_DISALLOW_COPY_AND_ASSIGN(PointerDataQueue);
+};
+
+}  // namespace blink
+
+#endif  // FLUTTER_LIB_UI_WINDOW_POINTER_DATA_QUEUE_H_
@@ -0,0 +1,202 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/window/pointer_data_queue.h"
+
+#include <string.h>
+
+#include "third_party/gtest/include/gtest/gtest.h"
+
+namespace blink {
+namespace {
+
+PointerData MakeData(PointerData::Change change,
+                     int64_t device,
+                     int64_t time_stamp,
+                     double x,
+                     double y) {
+  PointerData data;
+  data.Clear();
+  data.time_stamp = time_stamp;
+  data.change = change;
+  data.kind = PointerData::DeviceKind::kTouch;
+  data.device = device;
+  data.physical_x = x;
+  data.physical_y = y;
+  return data;
+}
+
+void Enqueue(PointerDataQueue* queue, const std::vector<PointerData>& events) {
+  PointerDataPacket packet(events.size());
+  for (size_t i = 0; i < events.size(); i++)
+    packet.SetPointerData(i, events[i]);
+  queue->Enqueue(packet);
+}
+
+std::vector<PointerData> Unpack(const PointerDataPacket& packet) {
+  const std::vector<uint8_t>& bytes = packet.data();
+  std::vector<PointerData> events(bytes.size() / sizeof(PointerData));
+  if (!events.empty())
+    memcpy(events.data(), bytes.data(), bytes.size());
+  return events;
+}
+
+std::vector<PointerData> Flush(PointerDataQueue* queue, int64_t sample_time) {
+  std::unique_ptr<PointerDataPacket> packet = queue->Flush(sample_time);
+  if (!packet)
+    return {};
+  return Unpack(*packet);
+}
+
+constexpr PointerData::Change kDown = PointerData::Change::kDown;
+constexpr PointerData::Change kMove = PointerData::Change::kMove;
+constexpr PointerData::Change kUp = PointerData::Change::kUp;
+
+}  // namespace
+
+TEST(PointerDataQueue, FlushOfEmptyQueueReturnsNull) {
+  PointerDataQueue queue;
+  ASSERT_TRUE(queue.empty());
+  ASSERT_EQ(queue.Flush(0), nullptr);
+}
+
+TEST(PointerDataQueue, CoalescesConsecutiveMovesOfADevice) {
+  PointerDataQueue queue;
+  Enqueue(&queue, {MakeData(kMove, 1, 1000, 0, 0),
+                   MakeData(kMove, 1, 2000, 5, 1),
+                   MakeData(kMove, 1, 3000, 10, 2)});
+
+  std::vector<PointerData> events = Flush(&queue, 0);
+  ASSERT_EQ(events.size(), 1u);
+  ASSERT_EQ(events[0].time_stamp, 3000);
+  ASSERT_EQ(events[0].physical_x, 10);
+  ASSERT_EQ(events[0].physical_y, 2);
+  ASSERT_EQ(queue.enqueued_count(), 3u);
+  ASSERT_EQ(queue.coalesced_count(), 2u);
+  ASSERT_TRUE(queue.empty());
+}
+
+TEST(PointerDataQueue, KeepsDownAndUpEvents) {
+  PointerDataQueue queue;
+  Enqueue(&queue, {MakeData(kDown, 1, 1000, 0, 0),
+                   MakeData(kMove, 1, 2000, 5, 0),
+                   MakeData(kMove, 1, 3000, 10, 0),
+                   MakeData(kUp, 1, 4000, 10, 0),
+                   MakeData(kDown, 1, 5000, 20, 0),
+                   MakeData(kMove, 1, 6000, 25, 0)});
+
+  std::vector<PointerData> events = Flush(&queue, 0);
+  ASSERT_EQ(events.size(), 5u);
+  ASSERT_EQ(events[0].change, kDown);
+  ASSERT_EQ(events[1].change, kMove);
+  ASSERT_EQ(events[1].time_stamp, 3000);
+  ASSERT_EQ(events[2].change, kUp);
+  ASSERT_EQ(events[3].change, kDown);
+  ASSERT_EQ(events[4].change, kMove);
+  ASSERT_EQ(events[4].time_stamp, 6000);
+}
+
+TEST(PointerDataQueue, KeepsTheOrderOfEventsAcrossDevices) {
+  PointerDataQueue queue;
+  Enqueue(&queue, {MakeData(kMove, 1, 1000, 0, 0),
+                   MakeData(kMove, 2, 1500, 100, 0),
+                   MakeData(kMove, 1, 2000, 5, 0),
+                   MakeData(kDown, 3, 2500, 50, 0),
+                   MakeData(kMove, 2, 3000, 105, 0)});
+
+  // Each device's moves are coalesced into its first queued move, so the
+  // relative order of the devices is that of their first events.
+  std::vector<PointerData> events = Flush(&queue, 0);
+  ASSERT_EQ(events.size(), 3u);
+  ASSERT_EQ(events[0].device, 1);
+  ASSERT_EQ(events[0].time_stamp, 2000);
+  ASSERT_EQ(events[1].device, 2);
+  ASSERT_EQ(events[1].time_stamp, 3000);
+  ASSERT_EQ(events[2].device, 3);
+  ASSERT_EQ(events[2].change, kDown);
+}
+
+TEST(PointerDataQueue, DoesNotCoalesceMovesWithDifferentButtons) {
+  PointerDataQueue queue;
+  PointerData pressed = MakeData(kMove, 1, 2000, 5, 0);
+  pressed.buttons = 1;
+  Enqueue(&queue, {MakeData(kMove, 1, 1000, 0, 0), pressed});
+
+  ASSERT_EQ(Flush(&queue, 0).size(), 2u);
+}
+
+TEST(PointerDataQueue, ResamplesTheLastMoveToTheSampleTime) {
+  PointerDataQueue queue;
+  Enqueue(&queue, {MakeData(kMove, 1, 1000, 0, 40),
+                   MakeData(kMove, 1, 3000, 20, 0)});
+
+  std::vector<PointerData> events = Flush(&queue, 1500);
+  ASSERT_EQ(events.size(), 1u);
+  ASSERT_EQ(events[0].time_stamp, 1500);
+  ASSERT_DOUBLE_EQ(events[0].physical_x, 5);
+  ASSERT_DOUBLE_EQ(events[0].physical_y, 30);
+  ASSERT_EQ(queue.resampled_count(), 1u);
+}
+
+TEST(PointerDataQueue, KeepsTheLastSampleQueuedAfterResampling) {
+  PointerDataQueue queue;
+  Enqueue(&queue, {MakeData(kMove, 1, 1000, 0, 0),
+                   MakeData(kMove, 1, 3000, 20, 0)});
+
+  ASSERT_EQ(Flush(&queue, 2000).size(), 1u);
+  ASSERT_FALSE(queue.empty());
+
+  // Nothing newer arrived, so the real last sample is delivered as is.
+  std::vector<PointerData> events = Flush(&queue, 4000);
+  ASSERT_EQ(events.size(), 1u);
+  ASSERT_EQ(events[0].time_stamp, 3000);
+  ASSERT_EQ(events[0].physical_x, 20);
+  ASSERT_TRUE(queue.empty());
+}
+
+TEST(PointerDataQueue, ResamplesBetweenTheResampledAndTheNextMove) {
+  PointerDataQueue queue;
+  Enqueue(&queue, {MakeData(kMove, 1, 1000, 0, 0),
+                   MakeData(kMove, 1, 3000, 20, 0)});
+  ASSERT_EQ(Flush(&queue, 2000)[0].physical_x, 10);
+
+  Enqueue(&queue, {MakeData(kMove, 1, 4000, 40, 0)});
+  std::vector<PointerData> events = Flush(&queue, 3500);
+  ASSERT_EQ(events.size(), 1u);
+  ASSERT_DOUBLE_EQ(events[0].physical_x, 30);
+}
+
+TEST(PointerDataQueue, DoesNotResampleOutsideTheCoalescedMoves) {
+  PointerDataQueue queue;
+  Enqueue(&queue, {MakeData(kMove, 1, 1000, 0, 0),
+                   MakeData(kMove, 1, 3000, 20, 0)});
+
+  std::vector<PointerData> events = Flush(&queue, 5000);
+  ASSERT_EQ(events.size(), 1u);
+  ASSERT_EQ(events[0].time_stamp, 3000);
+  ASSERT_TRUE(queue.empty());
+}
+
+TEST(PointerDataQueue, DoesNotResampleAMoveFollowedByAnUp) {
+  PointerDataQueue queue;
+  Enqueue(&queue, {MakeData(kMove, 1, 1000, 0, 0),
+                   MakeData(kMove, 1, 3000, 20, 0),
+                   MakeData(kUp, 1, 3500, 20, 0)});
+
+  std::vector<PointerData> events = Flush(&queue, 2000);
+  ASSERT_EQ(events.size(), 2u);
+  ASSERT_EQ(events[0].time_stamp, 3000);
+  ASSERT_EQ(events[1].change, kUp);
+  ASSERT_TRUE(queue.empty());
+  ASSERT_EQ(queue.resampled_count(), 0u);
+}
+
+TEST(PointerDataQueue, SampleTimeTrailsTheFrameTime) {
+  ASSERT_EQ(PointerDataQueue::GetSampleTime(ftl::TimePoint()), 0);
+  ASSERT_EQ(PointerDataQueue::GetSampleTime(ftl::TimePoint::FromEpochDelta(
+                ftl::TimeDelta::FromMilliseconds(100))),
+            95000);
+}
+
+}  // namespace blink
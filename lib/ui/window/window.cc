@@ -85,11 +85,14 @@ void SendPlatformMessage(Dart_Handle window,
     UIDartState::Current()->window()->client()->HandlePlatformMessage(
         ftl::MakeRefCounted<PlatformMessage>(name, response));
   } else {
-    const uint8_t* buffer = static_cast<const uint8_t*>(data.data());
-
+    // The bytes of the ByteData may be moved by the garbage collector, so
+    // this is the one copy the message gets on its way to the platform.
     UIDartState::Current()->window()->client()->HandlePlatformMessage(
         ftl::MakeRefCounted<PlatformMessage>(
-            name, std::vector<uint8_t>(buffer, buffer + data.length_in_bytes()),
+            name,
+            PlatformMessageBuffer::Copy(
+                static_cast<const uint8_t*>(data.data()),
+                data.length_in_bytes()),
             response));
   }
 }
@@ -105,10 +108,10 @@ void RespondToPlatformMessage(Dart_Handle window,
     UIDartState::Current()->window()->CompletePlatformMessageEmptyResponse(
         response_id);
   } else {
-    const uint8_t* buffer = static_cast<const uint8_t*>(data.data());
     UIDartState::Current()->window()->CompletePlatformMessageResponse(
         response_id,
-        std::vector<uint8_t>(buffer, buffer + data.length_in_bytes()));
+        PlatformMessageBuffer::Copy(static_cast<const uint8_t*>(data.data()),
+                                    data.length_in_bytes()));
   }
 }
 
@@ -175,9 +178,8 @@ void Window::DispatchPlatformMessage(ftl::RefPtr<PlatformMessage> message) {
   if (!dart_state)
     return;
   tonic::DartState::Scope scope(dart_state);
-  Dart_Handle data_handle = (message->hasData())
-      ? ToByteData(message->data())
-      : Dart_Null();
+  Dart_Handle data_handle =
+      (message->hasData()) ? ToByteData(message->buffer()) : Dart_Null();
   if (Dart_IsError(data_handle))
     return;
 
@@ -244,8 +246,9 @@ void Window::CompletePlatformMessageEmptyResponse(int response_id) {
   response->CompleteEmpty();
 }
 
-void Window::CompletePlatformMessageResponse(int response_id,
-                                             std::vector<uint8_t> data) {
+void Window::CompletePlatformMessageResponse(
+    int response_id,
+    ftl::RefPtr<PlatformMessageBuffer> data) {
   if (!response_id)
     return;
   auto it = pending_responses_.find(response_id);
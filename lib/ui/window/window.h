@@ -50,8 +50,9 @@ class Window {
   void DispatchSemanticsAction(int32_t id, SemanticsAction action);
   void BeginFrame(ftl::TimePoint frameTime);
 
-  void CompletePlatformMessageResponse(int response_id,
-                                       std::vector<uint8_t> data);
+  void CompletePlatformMessageResponse(
+      int response_id,
+      ftl::RefPtr<PlatformMessageBuffer> data);
   void CompletePlatformMessageEmptyResponse(int response_id);
 
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
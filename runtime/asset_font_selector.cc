@@ -31,7 +31,7 @@ struct AssetFontSelector::TypefaceAsset {
   TypefaceAsset();
   ~TypefaceAsset();
   sk_sp<SkTypeface> typeface;
-  std::vector<uint8_t> data;
+  std::unique_ptr<fml::Mapping> data;
 };
 
 namespace {
@@ -220,14 +220,18 @@ sk_sp<SkTypeface> AssetFontSelector::getTypefaceAsset(
   }
 
   std::unique_ptr<TypefaceAsset> typeface_asset(new TypefaceAsset);
-  if (!asset_store_->GetAsBuffer(asset_path, &typeface_asset->data)) {
+  typeface_asset->data = asset_store_->GetAsMapping(asset_path);
+  if (!typeface_asset->data) {
     typeface_cache_.insert(std::make_pair(asset_path, nullptr));
     return nullptr;
   }
 
+  // The stream does not copy the font data, which remains owned by the
+  // typeface asset.
   sk_sp<SkFontMgr> font_mgr(SkFontMgr::RefDefault());
-  SkMemoryStream* typeface_stream = new SkMemoryStream(
-      typeface_asset->data.data(), typeface_asset->data.size());
+  SkMemoryStream* typeface_stream =
+      new SkMemoryStream(typeface_asset->data->GetMapping(),
+                         typeface_asset->data->GetSize());
   typeface_asset->typeface =
       sk_sp<SkTypeface>(font_mgr->createFromStream(typeface_stream));
   if (typeface_asset->typeface == nullptr) {
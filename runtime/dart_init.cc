@@ -254,7 +254,8 @@ Dart_Isolate IsolateCreateCallback(const char* script_uri,
       const std::string& bundle_path = entry_path;
       ftl::RefPtr<ZipAssetStore> zip_asset_store =
           ftl::MakeRefCounted<ZipAssetStore>(
-              GetUnzipperProviderForPath(std::move(bundle_path)));
+              GetUnzipperProviderForPath(bundle_path),
+              std::make_unique<fml::FileMapping>(bundle_path));
       zip_asset_store->GetAsBuffer(kKernelAssetKey, &kernel_data);
       zip_asset_store->GetAsBuffer(kSnapshotAssetKey, &snapshot_data);
     }
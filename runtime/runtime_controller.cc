@@ -4,12 +4,17 @@
 
 #include "flutter/runtime/runtime_controller.h"
 
+#include "dart/runtime/include/dart_tools_api.h"
 #include "flutter/glue/trace_event.h"
 #include "flutter/lib/ui/compositing/scene.h"
+#include "flutter/lib/ui/text/paragraph_layout_cache.h"
 #include "flutter/lib/ui/ui_dart_state.h"
 #include "flutter/lib/ui/window/window.h"
 #include "flutter/runtime/dart_controller.h"
 #include "flutter/runtime/runtime_delegate.h"
+#include "flutter/sky/engine/platform/fonts/FontCache.h"
+#include "flutter/sky/engine/platform/fonts/harfbuzz/HarfBuzzShapeCache.h"
+#include "flutter/sky/engine/platform/fonts/harfbuzz/HarfBuzzShaper.h"
 #include "lib/tonic/dart_message_handler.h"
 
 using tonic::DartState;
@@ -76,6 +81,58 @@ void RuntimeController::BeginFrame(ftl::TimePoint frame_time) {
   GetWindow()->BeginFrame(frame_time);
 }
 
+void RuntimeController::NotifyIdle(ftl::TimePoint deadline) {
+  TRACE_EVENT0("flutter", "RuntimeController::NotifyIdle");
+  UIDartState* dart_state = dart_controller_->dart_state();
+  if (!dart_state)
+    return;
+  tonic::DartState::Scope scope(dart_state);
+
+  // The layout cache never exceeds its budget, and trimming it further every
+  // frame would throw away layouts the next frame may reuse. It is trimmed
+  // when the memory budget asks for it. Font data is only purged once there is
+  // more of it than the font cache keeps.
+  FontCache::fontCache()->purge(PurgeIfNeeded);
+
+  const ftl::TimeDelta remaining = deadline - ftl::TimePoint::Now();
+  if (remaining <= ftl::TimeDelta::Zero())
+    return;
+  // The Dart VM measures the deadline on its own clock.
+  Dart_NotifyIdle(Dart_TimelineGetMicros() + remaining.ToMicroseconds());
+}
+
+void RuntimeController::TrimCaches(bool release_all) {
+  TRACE_EVENT0("flutter", "RuntimeController::TrimCaches");
+  UIDartState* dart_state = dart_controller_->dart_state();
+  if (!dart_state)
+    return;
+  tonic::DartState::Scope scope(dart_state);
+
+  if (release_all) {
+    dart_state->paragraph_layout_cache().Clear();
+    FontCache::fontCache()->purge(ForcePurge);
+  } else {
+    dart_state->paragraph_layout_cache().Trim();
+    FontCache::fontCache()->purge(PurgeIfNeeded);
+  }
+}
+
+size_t RuntimeController::GetTextCacheBytes() {
+  UIDartState* dart_state = dart_controller_->dart_state();
+  if (!dart_state)
+    return 0;
+  return dart_state->paragraph_layout_cache().bytes();
+}
+
+void RuntimeController::ClearShapeCache() {
+  TRACE_EVENT0("flutter", "RuntimeController::ClearShapeCache");
+  harfBuzzShapeCache().clear();
+}
+
+size_t RuntimeController::GetShapeCacheBytes() {
+  return harfBuzzShapeCache().bytes();
+}
+
 void RuntimeController::DispatchPlatformMessage(
     ftl::RefPtr<PlatformMessage> message) {
   TRACE_EVENT0("flutter", "RuntimeController::DispatchPlatformMessage");
@@ -38,6 +38,23 @@ class RuntimeController : public WindowClient, public IsolateClient {
 
   void BeginFrame(ftl::TimePoint frame_time);
 
+  // Tells the isolate it has nothing to do until |deadline|. Font data over
+  // the limits of the font cache is purged first, the garbage collector gets
+  // what is left.
+  void NotifyIdle(ftl::TimePoint deadline);
+
+  // Releases the cached text layouts and fonts. Unless |release_all| is set,
+  // only what was least recently used is released.
+  void TrimCaches(bool release_all);
+
+  // The bytes held by the text layout cache of the isolate.
+  size_t GetTextCacheBytes();
+
+  // The shaped runs of text are cached for every runtime on the UI thread.
+  static void ClearShapeCache();
+
+  static size_t GetShapeCacheBytes();
+
   void DispatchPlatformMessage(ftl::RefPtr<PlatformMessage> message);
   void DispatchPointerDataPacket(const PointerDataPacket& packet);
   void DispatchSemanticsAction(int32_t id, SemanticsAction action);
@@ -4,11 +4,18 @@
 
 #include "flutter/shell/common/animator.h"
 
+#include "flutter/common/settings.h"
 #include "flutter/common/threads.h"
 #include "flutter/fml/trace_event.h"
 #include "lib/ftl/time/stopwatch.h"
 
 namespace shell {
+namespace {
+
+// The vsync interval of a 60Hz display.
+constexpr int64_t kFrameIntervalMicros = 16667;
+
+}  // namespace
 
 Animator::Animator(ftl::WeakPtr<Rasterizer> rasterizer,
                    VsyncWaiter* waiter,
@@ -16,10 +23,16 @@ Animator::Animator(ftl::WeakPtr<Rasterizer> rasterizer,
     : rasterizer_(rasterizer),
       waiter_(waiter),
       engine_(engine),
-      layer_tree_pipeline_(ftl::MakeRefCounted<LayerTreePipeline>(3)),
+      layer_tree_pipeline_(ftl::MakeRefCounted<LayerTreePipeline>(
+          blink::Settings::Get().layer_tree_pipeline_depth > 0
+              ? blink::Settings::Get().layer_tree_pipeline_depth
+              : LayerTreePipeline::kDefaultDepth)),
       pending_frame_semaphore_(1),
       frame_number_(1),
       paused_(false),
+      adaptive_frame_start_(blink::Settings::Get().adaptive_frame_start),
+      skip_stale_frames_(blink::Settings::Get().skip_stale_frames),
+      frame_start_pending_(false),
       weak_factory_(this) {}
 
 Animator::~Animator() = default;
@@ -40,6 +53,8 @@ void Animator::Start() {
 void Animator::BeginFrame(ftl::TimePoint frame_time) {
   TRACE_EVENT_ASYNC_END0("flutter", "Frame Request Pending", frame_number_++);
 
+  last_vsync_time_ = frame_time;
+
   pending_frame_semaphore_.Signal();
 
   if (!producer_continuation_) {
@@ -62,17 +77,89 @@ void Animator::BeginFrame(ftl::TimePoint frame_time) {
   // to service potential frame.
   FTL_DCHECK(producer_continuation_);
 
+  if (frame_start_pending_) {
+    // An earlier begin frame was delayed and has yet to start the frame.
+    return;
+  }
+
+  const ftl::TimeDelta delay = ComputeFrameStartDelay();
+  if (delay > ftl::TimeDelta::Zero()) {
+    TRACE_EVENT_INSTANT0("flutter", "FrameStartDelayed");
+    frame_start_pending_ = true;
+    blink::Threads::UI()->PostDelayedTask(
+        [self = weak_factory_.GetWeakPtr()]() {
+          if (!self) {
+            return;
+          }
+          self->frame_start_pending_ = false;
+          // The animator may have been stopped while the frame was delayed.
+          if (self->paused_) {
+            return;
+          }
+          self->StartFrame();
+        },
+        delay);
+    return;
+  }
+
+  StartFrame();
+}
+
+void Animator::StartFrame() {
   // TODO(abarth): We should use |frame_time| instead, but the frame time we get
   // on Android appears to be unstable.
   last_begin_frame_time_ = ftl::TimePoint::Now();
-  engine_->BeginFrame(last_begin_frame_time_);
+  // Waiters with a virtual clock rely on their vsync time being passed through
+  // to make frames deterministic.
+  engine_->BeginFrame(waiter_->HasReliableFrameTimes()
+                          ? last_vsync_time_
+                          : last_begin_frame_time_);
+}
+
+ftl::TimeDelta Animator::ComputeFrameStartDelay() const {
+  // Never delay a frame by more than a frame interval.
+  const ftl::TimeDelta kMaxFrameStartDelay =
+      ftl::TimeDelta::FromMicroseconds(kFrameIntervalMicros);
+
+  if (!adaptive_frame_start_) {
+    return ftl::TimeDelta::Zero();
+  }
+
+  const size_t pending = layer_tree_pipeline_->pending_count();
+  if (pending == 0) {
+    // The GPU thread is idle and will pick up the frame right away.
+    return ftl::TimeDelta::Zero();
+  }
+
+  // Estimate when the GPU thread gets to the frame we are about to produce.
+  // When it skips stale frames, it only rasterizes the newest pending one
+  // before ours.
+  const ftl::TimeDelta raster_time =
+      layer_tree_pipeline_->last_consume_duration();
+  ftl::TimeDelta gpu_busy_time = raster_time;
+  if (!skip_stale_frames_) {
+    gpu_busy_time = ftl::TimeDelta::FromNanoseconds(
+        raster_time.ToNanoseconds() * static_cast<int64_t>(pending));
+  }
+
+  // Starting any earlier than necessary to be done by then only makes the
+  // frame reflect older input.
+  ftl::TimeDelta delay = gpu_busy_time - last_frame_build_time_;
+  if (delay < ftl::TimeDelta::Zero()) {
+    return ftl::TimeDelta::Zero();
+  }
+  if (delay > kMaxFrameStartDelay) {
+    delay = kMaxFrameStartDelay;
+  }
+  return delay;
 }
 
 void Animator::Render(std::unique_ptr<flow::LayerTree> layer_tree) {
+  last_frame_build_time_ = ftl::TimePoint::Now() - last_begin_frame_time_;
+
   if (layer_tree) {
     // Note the frame time for instrumentation.
-    layer_tree->set_construction_time(ftl::TimePoint::Now() -
-                                      last_begin_frame_time_);
+    layer_tree->set_construction_time(last_frame_build_time_);
   }
 
   // Commit the pending continuation.
@@ -84,6 +171,41 @@ void Animator::Render(std::unique_ptr<flow::LayerTree> layer_tree) {
           return;
         rasterizer->Draw(pipeline);
       });
+
+  ScheduleIdleNotification();
+}
+
+ftl::TimePoint Animator::ComputeIdleDeadline(ftl::TimePoint last_vsync_time,
+                                             ftl::TimePoint now) {
+  const ftl::TimeDelta frame_interval =
+      ftl::TimeDelta::FromMicroseconds(kFrameIntervalMicros);
+
+  // The vsync time may be off on some platforms, so never promise more than a
+  // frame interval from now.
+  ftl::TimePoint deadline = last_vsync_time + frame_interval;
+  if (deadline > now + frame_interval)
+    deadline = now + frame_interval;
+  if (deadline <= now)
+    return ftl::TimePoint();
+  return deadline;
+}
+
+void Animator::ScheduleIdleNotification() {
+  const ftl::TimePoint deadline =
+      ComputeIdleDeadline(last_vsync_time_, ftl::TimePoint::Now());
+  if (deadline == ftl::TimePoint())
+    return;
+
+  // Render is called from within the frame callback of the isolate, which may
+  // still have work to do after it returns.
+  blink::Threads::UI()->PostTask(
+      [ self = weak_factory_.GetWeakPtr(), deadline ]() {
+        if (!self || self->paused_)
+          return;
+        if (ftl::TimePoint::Now() >= deadline)
+          return;
+        self->engine_->NotifyIdle(deadline);
+      });
 }
 
 void Animator::RequestFrame() {
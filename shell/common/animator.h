@@ -32,23 +32,45 @@ class Animator {
 
   void Stop();
 
+  bool paused() const { return paused_; }
+
+  // The end of the idle time after a frame that started at |last_vsync_time|,
+  // or a null time point if the next frame is already due at |now|.
+  static ftl::TimePoint ComputeIdleDeadline(ftl::TimePoint last_vsync_time,
+                                            ftl::TimePoint now);
+
  private:
   using LayerTreePipeline = flutter::Pipeline<flow::LayerTree>;
 
   void BeginFrame(ftl::TimePoint frame_time);
 
+  void StartFrame();
+
+  // How long to wait after a vsync before building the frame so that it is
+  // ready just as the GPU thread catches up with the frames queued before it.
+  ftl::TimeDelta ComputeFrameStartDelay() const;
+
   void AwaitVSync();
 
+  // Lets the engine use what is left of the frame interval once the frame has
+  // been rendered.
+  void ScheduleIdleNotification();
+
   ftl::WeakPtr<Rasterizer> rasterizer_;
   VsyncWaiter* waiter_;
   Engine* engine_;
 
+  ftl::TimePoint last_vsync_time_;
   ftl::TimePoint last_begin_frame_time_;
+  ftl::TimeDelta last_frame_build_time_;
   ftl::RefPtr<LayerTreePipeline> layer_tree_pipeline_;
   flutter::Semaphore pending_frame_semaphore_;
   LayerTreePipeline::ProducerContinuation producer_continuation_;
   int64_t frame_number_;
   bool paused_;
+  const bool adaptive_frame_start_;
+  const bool skip_stale_frames_;
+  bool frame_start_pending_;
 
   ftl::WeakPtrFactory<Animator> weak_factory_;
 
@@ -0,0 +1,42 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/animator.h"
+
+#include "third_party/gtest/include/gtest/gtest.h"
+
+namespace shell {
+namespace {
+
+ftl::TimeDelta Micros(int64_t micros) {
+  return ftl::TimeDelta::FromMicroseconds(micros);
+}
+
+}  // namespace
+
+TEST(Animator, IdleUntilNextVsync) {
+  const ftl::TimePoint vsync = ftl::TimePoint::Now();
+  const ftl::TimePoint now = vsync + Micros(6000);
+
+  ASSERT_EQ(Animator::ComputeIdleDeadline(vsync, now), vsync + Micros(16667));
+}
+
+TEST(Animator, IdleAtMostOneFrameIntervalFromNow) {
+  const ftl::TimePoint now = ftl::TimePoint::Now();
+  // A vsync time in the future, as some platforms report.
+  const ftl::TimePoint vsync = now + Micros(10000);
+
+  ASSERT_EQ(Animator::ComputeIdleDeadline(vsync, now), now + Micros(16667));
+}
+
+TEST(Animator, NoIdleTimeOnceNextFrameIsDue) {
+  const ftl::TimePoint vsync = ftl::TimePoint::Now();
+
+  ASSERT_EQ(Animator::ComputeIdleDeadline(vsync, vsync + Micros(16667)),
+            ftl::TimePoint());
+  ASSERT_EQ(Animator::ComputeIdleDeadline(vsync, vsync + Micros(40000)),
+            ftl::TimePoint());
+}
+
+}  // namespace shell
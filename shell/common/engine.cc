@@ -17,6 +17,7 @@
 #include "flutter/assets/zip_asset_store.h"
 #include "flutter/common/settings.h"
 #include "flutter/common/threads.h"
+#include "flutter/fml/mapping.h"
 #include "flutter/glue/trace_event.h"
 #include "flutter/lib/snapshot/snapshot.h"
 #include "flutter/runtime/asset_font_selector.h"
@@ -43,6 +44,7 @@ constexpr char kAssetChannel[] = "flutter/assets";
 constexpr char kLifecycleChannel[] = "flutter/lifecycle";
 constexpr char kNavigationChannel[] = "flutter/navigation";
 constexpr char kLocalizationChannel[] = "flutter/localization";
+constexpr char kSystemChannel[] = "flutter/system";
 
 bool PathExists(const std::string& path) {
   return access(path.c_str(), R_OK) == 0;
@@ -73,11 +75,29 @@ Engine::Engine(PlatformView* platform_view)
           platform_view->GetVsyncWaiter(),
           this)),
       load_script_error_(tonic::kNoError),
+      batch_pointer_events_(blink::Settings::Get().batch_pointer_events),
+      resample_pointer_events_(blink::Settings::Get().resample_pointer_events),
       activity_running_(false),
       have_surface_(false),
-      weak_factory_(this) {}
-
-Engine::~Engine() {}
+      weak_factory_(this) {
+  text_cache_budget_id_ = MemoryBudget::Get().Register(
+      "text", blink::Threads::UI(),
+      [engine = GetWeakPtr()](MemoryTrimLevel level) {
+        if (engine)
+          engine->TrimTextCaches(level);
+      });
+  shape_cache_budget_id_ = MemoryBudget::Get().Register(
+      "shape_cache", blink::Threads::UI(),
+      [engine = GetWeakPtr()](MemoryTrimLevel level) {
+        if (engine)
+          engine->TrimShapeCache();
+      });
+}
+
+Engine::~Engine() {
+  MemoryBudget::Get().Unregister(shape_cache_budget_id_);
+  MemoryBudget::Get().Unregister(text_cache_budget_id_);
+}
 
 ftl::WeakPtr<Engine> Engine::GetWeakPtr() {
   return weak_factory_.GetWeakPtr();
@@ -236,10 +256,16 @@ void Engine::RunBundleAndSource(const std::string& bundle_path,
 
 void Engine::BeginFrame(ftl::TimePoint frame_time) {
   TRACE_EVENT0("flutter", "Engine::BeginFrame");
+  DispatchQueuedPointerData(frame_time);
   if (runtime_)
     runtime_->BeginFrame(frame_time);
 }
 
+void Engine::NotifyIdle(ftl::TimePoint deadline) {
+  if (runtime_)
+    runtime_->NotifyIdle(deadline);
+}
+
 void Engine::RunFromSource(const std::string& main,
                            const std::string& packages,
                            const std::string& bundle_path) {
@@ -303,6 +329,9 @@ void Engine::DispatchPlatformMessage(
   } else if (message->channel() == kLocalizationChannel) {
     if (HandleLocalizationPlatformMessage(std::move(message)))
       return;
+  } else if (message->channel() == kSystemChannel) {
+    if (HandleSystemPlatformMessage(message.get()))
+      return;
   }
 
   if (runtime_) {
@@ -330,6 +359,30 @@ bool Engine::HandleLifecyclePlatformMessage(blink::PlatformMessage* message) {
   return false;
 }
 
+bool Engine::HandleSystemPlatformMessage(blink::PlatformMessage* message) {
+  const auto& data = message->data();
+
+  rapidjson::Document document;
+  document.Parse(reinterpret_cast<const char*>(data.data()), data.size());
+  if (document.HasParseError() || !document.IsObject())
+    return false;
+  auto root = document.GetObject();
+  auto type = root.FindMember("type");
+  if (type == root.MemberEnd() || type->value != "memoryPressure")
+    return false;
+
+  // Platforms that do not grade the pressure only report it once memory is
+  // low.
+  MemoryTrimLevel level = MemoryTrimLevel::kCritical;
+  auto level_member = root.FindMember("level");
+  if (level_member != root.MemberEnd() && level_member->value == "moderate")
+    level = MemoryTrimLevel::kModerate;
+  MemoryBudget::Get().Trim(level);
+
+  // The framework releases its own caches too.
+  return false;
+}
+
 bool Engine::HandleNavigationPlatformMessage(
     ftl::RefPtr<blink::PlatformMessage> message) {
   FTL_DCHECK(!runtime_);
@@ -379,8 +432,40 @@ bool Engine::HandleLocalizationPlatformMessage(
 }
 
 void Engine::DispatchPointerDataPacket(const PointerDataPacket& packet) {
-  if (runtime_)
+  if (!runtime_)
+    return;
+
+  // Without frames coming there is nothing to batch the events up to.
+  if (!batch_pointer_events_ || animator_->paused()) {
     runtime_->DispatchPointerDataPacket(packet);
+    return;
+  }
+
+  pointer_data_queue_.Enqueue(packet);
+  animator_->RequestFrame();
+}
+
+void Engine::DispatchQueuedPointerData(ftl::TimePoint frame_time) {
+  if (pointer_data_queue_.empty())
+    return;
+
+  int64_t sample_time = 0;
+  if (resample_pointer_events_)
+    sample_time = blink::PointerDataQueue::GetSampleTime(frame_time);
+
+  std::unique_ptr<PointerDataPacket> packet =
+      pointer_data_queue_.Flush(sample_time);
+  TRACE_EVENT2(
+      "flutter", "Engine::DispatchQueuedPointerData", "enqueued",
+      std::to_string(pointer_data_queue_.enqueued_count()).c_str(),
+      "coalesced",
+      std::to_string(pointer_data_queue_.coalesced_count()).c_str());
+  if (runtime_)
+    runtime_->DispatchPointerDataPacket(*packet);
+
+  // A move kept back by resampling goes out with the next frame.
+  if (!pointer_data_queue_.empty())
+    animator_->RequestFrame();
 }
 
 void Engine::DispatchSemanticsAction(int id, blink::SemanticsAction action) {
@@ -414,7 +499,8 @@ void Engine::ConfigureAssetBundle(const std::string& path) {
 
   if (S_ISREG(stat_result.st_mode)) {
     asset_store_ = ftl::MakeRefCounted<blink::ZipAssetStore>(
-        blink::GetUnzipperProviderForPath(path));
+        blink::GetUnzipperProviderForPath(path),
+        std::make_unique<fml::FileMapping>(path));
     return;
   }
 }
@@ -441,6 +527,7 @@ void Engine::DidCreateSecondaryIsolate(Dart_Isolate isolate) {}
 
 void Engine::StopAnimator() {
   animator_->Stop();
+  DispatchQueuedPointerData(ftl::TimePoint());
 }
 
 void Engine::StartAnimatorIfPossible() {
@@ -470,6 +557,31 @@ void Engine::Render(std::unique_ptr<flow::LayerTree> layer_tree) {
 
   layer_tree->set_frame_size(frame_size);
   animator_->Render(std::move(layer_tree));
+
+  ReportTextCacheBytes();
+}
+
+void Engine::TrimTextCaches(MemoryTrimLevel level) {
+  if (!runtime_)
+    return;
+  runtime_->TrimCaches(level == MemoryTrimLevel::kCritical);
+  ReportTextCacheBytes();
+}
+
+void Engine::TrimShapeCache() {
+  // Shaped runs are cheap to recompute next to layouts, so even a moderate
+  // trim releases all of them.
+  blink::RuntimeController::ClearShapeCache();
+  ReportTextCacheBytes();
+}
+
+void Engine::ReportTextCacheBytes() {
+  // Skia and the font cache do not report the memory held by fonts, so only
+  // the paragraph layouts and shaped runs count towards the budget.
+  MemoryBudget::Get().ReportBytes(
+      text_cache_budget_id_, runtime_ ? runtime_->GetTextCacheBytes() : 0);
+  MemoryBudget::Get().ReportBytes(
+      shape_cache_budget_id_, blink::RuntimeController::GetShapeCacheBytes());
 }
 
 void Engine::UpdateSemantics(std::vector<blink::SemanticsNode> update) {
@@ -502,12 +614,25 @@ void Engine::HandleAssetPlatformMessage(
   const auto& data = message->data();
   std::string asset_name(reinterpret_cast<const char*>(data.data()),
                          data.size());
+
+  // Assets in a bundle directory have to be read into memory. Those in the
+  // archive are handed to Dart straight out of its mapping when they are
+  // stored uncompressed.
   std::vector<uint8_t> asset_data;
-  if (GetAssetAsBuffer(asset_name, &asset_data)) {
-    response->Complete(std::move(asset_data));
-  } else {
-    response->CompleteEmpty();
+  if (directory_asset_bundle_ &&
+      directory_asset_bundle_->GetAsBuffer(asset_name, &asset_data)) {
+    response->Complete(
+        blink::PlatformMessageBuffer::Create(std::move(asset_data)));
+    return;
+  }
+  if (asset_store_) {
+    if (auto mapping = asset_store_->GetAsMapping(asset_name)) {
+      response->Complete(
+          blink::PlatformMessageBuffer::Create(std::move(mapping)));
+      return;
+    }
   }
+  response->CompleteEmpty();
 }
 
 bool Engine::GetAssetAsBuffer(const std::string& name,
@@ -7,9 +7,11 @@
 
 #include "flutter/assets/zip_asset_store.h"
 #include "flutter/lib/ui/window/platform_message.h"
+#include "flutter/lib/ui/window/pointer_data_queue.h"
 #include "flutter/lib/ui/window/viewport_metrics.h"
 #include "flutter/runtime/runtime_controller.h"
 #include "flutter/runtime/runtime_delegate.h"
+#include "flutter/shell/common/memory_budget.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "lib/ftl/macros.h"
 #include "lib/ftl/memory/weak_ptr.h"
@@ -51,6 +53,10 @@ class Engine : public blink::RuntimeDelegate {
 
   void BeginFrame(ftl::TimePoint frame_time);
 
+  // Called once the frame has been handed to the GPU thread. Nothing is
+  // expected of the UI isolate until |deadline|.
+  void NotifyIdle(ftl::TimePoint deadline);
+
   void RunFromSource(const std::string& main,
                      const std::string& packages,
                      const std::string& bundle);
@@ -83,10 +89,17 @@ class Engine : public blink::RuntimeDelegate {
   void StopAnimator();
   void StartAnimatorIfPossible();
 
+  void DispatchQueuedPointerData(ftl::TimePoint frame_time);
+
   void ConfigureAssetBundle(const std::string& path);
   void ConfigureRuntime(const std::string& script_uri);
 
+  void TrimTextCaches(MemoryTrimLevel level);
+  void TrimShapeCache();
+  void ReportTextCacheBytes();
+
   bool HandleLifecyclePlatformMessage(blink::PlatformMessage* message);
+  bool HandleSystemPlatformMessage(blink::PlatformMessage* message);
   bool HandleNavigationPlatformMessage(
       ftl::RefPtr<blink::PlatformMessage> message);
   bool HandleLocalizationPlatformMessage(
@@ -104,12 +117,17 @@ class Engine : public blink::RuntimeDelegate {
   std::string language_code_;
   std::string country_code_;
   bool semantics_enabled_ = false;
+  const bool batch_pointer_events_;
+  const bool resample_pointer_events_;
+  blink::PointerDataQueue pointer_data_queue_;
   // TODO(abarth): Unify these two behind a common interface.
   ftl::RefPtr<blink::ZipAssetStore> asset_store_;
   std::unique_ptr<blink::DirectoryAssetBundle> directory_asset_bundle_;
   // TODO(eseidel): This should move into an AnimatorStateMachine.
   bool activity_running_;
   bool have_surface_;
+  MemoryBudget::ClientId text_cache_budget_id_;
+  MemoryBudget::ClientId shape_cache_budget_id_;
   ftl::WeakPtrFactory<Engine> weak_factory_;
 
   FTL_DISALLOW_COPY_AND_ASSIGN(Engine);
@@ -0,0 +1,101 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_timing_log.h"
+
+#include <fcntl.h>
+
+#include <utility>
+
+#include "lib/ftl/files/eintr_wrapper.h"
+#include "lib/ftl/files/file_descriptor.h"
+#include "lib/ftl/logging.h"
+
+namespace shell {
+namespace {
+
+constexpr char kMagic[] = {'F', 'L', 'T', 'M'};
+constexpr size_t kFieldCount = 10;
+constexpr size_t kRecordSize = kFieldCount * sizeof(uint64_t);
+// About a second worth of frames at 60Hz.
+constexpr size_t kRecordsPerFlush = 60;
+
+void AppendUint32(std::vector<uint8_t>* buffer, uint32_t value) {
+  for (size_t i = 0; i < sizeof(value); i++) {
+    buffer->push_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+
+void AppendUint64(std::vector<uint8_t>* buffer, uint64_t value) {
+  for (size_t i = 0; i < sizeof(value); i++) {
+    buffer->push_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+
+uint64_t Microseconds(ftl::TimeDelta delta) {
+  return static_cast<uint64_t>(delta.ToMicroseconds());
+}
+
+}  // namespace
+
+constexpr uint32_t FrameTimingLog::kVersion;
+
+std::unique_ptr<FrameTimingLog> FrameTimingLog::Open(const std::string& path) {
+  ftl::UniqueFD fd(
+      HANDLE_EINTR(open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)));
+  if (!fd.is_valid()) {
+    FTL_LOG(ERROR) << "Could not create the frame timing log at " << path;
+    return nullptr;
+  }
+
+  std::unique_ptr<FrameTimingLog> log(new FrameTimingLog(std::move(fd)));
+  log->buffer_.insert(log->buffer_.end(), kMagic, kMagic + sizeof(kMagic));
+  AppendUint32(&log->buffer_, kVersion);
+  AppendUint32(&log->buffer_, kRecordSize);
+  AppendUint32(&log->buffer_, 0);
+  log->Flush();
+  return log;
+}
+
+FrameTimingLog::FrameTimingLog(ftl::UniqueFD fd) : fd_(std::move(fd)) {
+  buffer_.reserve(kRecordsPerFlush * kRecordSize);
+}
+
+FrameTimingLog::~FrameTimingLog() {
+  Flush();
+}
+
+void FrameTimingLog::Append(const flow::FrameTiming& timing) {
+  AppendUint64(&buffer_, timing.frame_number);
+  AppendUint64(&buffer_,
+               Microseconds(timing.raster_start - ftl::TimePoint()));
+  AppendUint64(&buffer_, Microseconds(timing.build_time));
+  AppendUint64(&buffer_, Microseconds(timing.raster_time));
+  AppendUint64(&buffer_, Microseconds(timing.preroll_time));
+  AppendUint64(&buffer_, Microseconds(timing.paint_time));
+  AppendUint64(&buffer_, timing.raster_cache_hits);
+  AppendUint64(&buffer_, timing.raster_cache_misses);
+  AppendUint64(&buffer_, timing.raster_cache_bytes);
+  AppendUint64(&buffer_, timing.gpu_resource_bytes);
+
+  if (buffer_.size() >= kRecordsPerFlush * kRecordSize) {
+    Flush();
+  }
+}
+
+void FrameTimingLog::Flush() {
+  if (buffer_.empty() || !fd_.is_valid()) {
+    return;
+  }
+  if (!ftl::WriteFileDescriptor(fd_.get(),
+                                reinterpret_cast<const char*>(buffer_.data()),
+                                buffer_.size())) {
+    FTL_LOG(ERROR) << "Could not write the frame timing log. No more frame "
+                      "timings will be logged.";
+    fd_.reset();
+  }
+  buffer_.clear();
+}
+
+}  // namespace shell
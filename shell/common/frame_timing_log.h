@@ -0,0 +1,56 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_FRAME_TIMING_LOG_H_
+#define FLUTTER_SHELL_COMMON_FRAME_TIMING_LOG_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/flow/frame_timing.h"
+#include "lib/ftl/files/unique_fd.h"
+#include "lib/ftl/macros.h"
+
+namespace shell {
+
+// Streams the timings of drawn frames to a file as they come in.
+//
+// The file starts with a 16 byte header: the magic "FLTM", followed by the
+// format version, the size in bytes of a record and a reserved word, each a
+// little endian uint32. Records follow back to back, each a sequence of little
+// endian uint64 fields in this order: frame number, raster start, build time,
+// raster time, preroll time and paint time in microseconds, raster cache hits
+// and misses, raster cache bytes and GPU resource bytes. Readers should skip
+// any bytes of a record past the fields they know about.
+class FrameTimingLog {
+ public:
+  static constexpr uint32_t kVersion = 1;
+
+  // Returns null if the file cannot be created.
+  static std::unique_ptr<FrameTimingLog> Open(const std::string& path);
+
+  // Writes the records not yet written.
+  ~FrameTimingLog();
+
+  // Records are buffered and written in batches so that the thread drawing
+  // frames rarely blocks on the file.
+  void Append(const flow::FrameTiming& timing);
+
+  void Flush();
+
+ private:
+  ftl::UniqueFD fd_;
+  std::vector<uint8_t> buffer_;
+
+  explicit FrameTimingLog(ftl::UniqueFD fd);
+
+  FTL_DISALLOW_COPY_AND_ASSIGN(FrameTimingLog);
+};
+
+}  // namespace shell
+
+#endif  // FLUTTER_SHELL_COMMON_FRAME_TIMING_LOG_H_
@@ -0,0 +1,148 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/memory_budget.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "flutter/common/settings.h"
+#include "flutter/glue/trace_event.h"
+#include "lib/ftl/logging.h"
+
+namespace shell {
+
+MemoryBudget& MemoryBudget::Get() {
+  // Leaked, as trims may still be posted when the process exits.
+  static MemoryBudget* budget =
+      new MemoryBudget(blink::Settings::Get().memory_budget_bytes);
+  return *budget;
+}
+
+MemoryBudget::MemoryBudget(size_t max_bytes)
+    : max_bytes_(max_bytes), next_id_(1), total_bytes_(0) {}
+
+MemoryBudget::~MemoryBudget() = default;
+
+MemoryBudget::ClientId MemoryBudget::Register(
+    std::string name,
+    ftl::RefPtr<ftl::TaskRunner> task_runner,
+    TrimCallback trim) {
+  FTL_DCHECK(task_runner);
+  FTL_DCHECK(trim);
+  std::lock_guard<std::mutex> lock(mutex_);
+  const ClientId id = next_id_++;
+  Client& client = clients_[id];
+  client.name = std::move(name);
+  client.task_runner = std::move(task_runner);
+  client.trim = std::move(trim);
+  return id;
+}
+
+void MemoryBudget::Unregister(ClientId id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = clients_.find(id);
+  if (found == clients_.end())
+    return;
+  total_bytes_ -= found->second.bytes;
+  clients_.erase(found);
+}
+
+void MemoryBudget::ReportBytes(ClientId id, size_t bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = clients_.find(id);
+  if (found == clients_.end())
+    return;
+  Client& client = found->second;
+  const bool grew = bytes > client.bytes;
+  total_bytes_ = total_bytes_ - client.bytes + bytes;
+  client.bytes = bytes;
+  // Only growth can push the total over budget. Reports made after a trim
+  // that could not release anything must not ask for another one.
+  if (grew)
+    TrimOverBudgetLocked();
+}
+
+void MemoryBudget::Trim(MemoryTrimLevel level) {
+  TRACE_EVENT1("flutter", "MemoryBudget::Trim", "level",
+               level == MemoryTrimLevel::kCritical ? "critical" : "moderate");
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& entry : clients_)
+    PostTrimLocked(entry.first, &entry.second, level);
+}
+
+size_t MemoryBudget::GetTotalBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return total_bytes_;
+}
+
+std::vector<MemoryBudget::ClientStats> MemoryBudget::GetClientStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<ClientStats> stats;
+  stats.reserve(clients_.size());
+  for (const auto& entry : clients_) {
+    ClientStats client_stats;
+    client_stats.name = entry.second.name;
+    client_stats.bytes = entry.second.bytes;
+    client_stats.trim_count = entry.second.trim_count;
+    stats.push_back(std::move(client_stats));
+  }
+  return stats;
+}
+
+void MemoryBudget::TrimOverBudgetLocked() {
+  if (max_bytes_ == 0 || total_bytes_ <= max_bytes_)
+    return;
+
+  // The largest clients are asked first, till what they hold covers the
+  // excess. Clients with a trim pending have yet to report its effect.
+  std::vector<std::pair<size_t, ClientId>> candidates;
+  for (const auto& entry : clients_) {
+    if (entry.second.bytes > 0 && !entry.second.trim_pending)
+      candidates.emplace_back(entry.second.bytes, entry.first);
+  }
+  std::sort(candidates.begin(), candidates.end(),
+            [](const std::pair<size_t, ClientId>& lhs,
+               const std::pair<size_t, ClientId>& rhs) {
+              return lhs.first > rhs.first;
+            });
+
+  const size_t excess = total_bytes_ - max_bytes_;
+  size_t covered = 0;
+  for (const auto& candidate : candidates) {
+    if (covered >= excess)
+      break;
+    PostTrimLocked(candidate.second, &clients_[candidate.second],
+                   MemoryTrimLevel::kModerate);
+    covered += candidate.first;
+  }
+}
+
+void MemoryBudget::PostTrimLocked(ClientId id,
+                                  Client* client,
+                                  MemoryTrimLevel level) {
+  // A pending trim is enough unless this one asks for more.
+  if (client->trim_pending && level == MemoryTrimLevel::kModerate)
+    return;
+  client->trim_pending = true;
+  client->task_runner->PostTask([this, id, level]() { RunTrim(id, level); });
+}
+
+void MemoryBudget::RunTrim(ClientId id, MemoryTrimLevel level) {
+  TrimCallback trim;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = clients_.find(id);
+    if (found == clients_.end())
+      return;
+    Client& client = found->second;
+    client.trim_pending = false;
+    client.trim_count++;
+    trim = client.trim;
+  }
+  // Called unlocked, as clients report their bytes once they have trimmed.
+  trim(level);
+}
+
+}  // namespace shell
@@ -0,0 +1,103 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_MEMORY_BUDGET_H_
+#define FLUTTER_SHELL_COMMON_MEMORY_BUDGET_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "lib/ftl/macros.h"
+#include "lib/ftl/memory/ref_ptr.h"
+#include "lib/ftl/tasks/task_runner.h"
+
+namespace shell {
+
+// How much a cache is asked to release.
+enum class MemoryTrimLevel {
+  // Release what has not been used recently.
+  kModerate,
+  // Release everything that can be recreated.
+  kCritical,
+};
+
+// Coordinates the memory held by the caches of the engine, which live on
+// different threads. Caches register with the task runner they live on and
+// report the bytes they hold as those change. They are asked to trim when the
+// total exceeds the budget or when the platform reports memory pressure.
+class MemoryBudget {
+ public:
+  using ClientId = uint64_t;
+  using TrimCallback = std::function<void(MemoryTrimLevel level)>;
+
+  struct ClientStats {
+    std::string name;
+    size_t bytes = 0;
+    uint64_t trim_count = 0;
+  };
+
+  // Created from the settings on first use.
+  static MemoryBudget& Get();
+
+  // With a |max_bytes| of zero, caches are only trimmed on memory pressure.
+  explicit MemoryBudget(size_t max_bytes);
+
+  ~MemoryBudget();
+
+  // |trim| is only ever called on |task_runner|.
+  ClientId Register(std::string name,
+                    ftl::RefPtr<ftl::TaskRunner> task_runner,
+                    TrimCallback trim);
+
+  // Must be called on the task runner the client registered with. Trims
+  // already posted to the client are dropped.
+  void Unregister(ClientId id);
+
+  // May be called on any thread. Asks the largest clients for a moderate trim
+  // if the client grew and the total is now over budget.
+  void ReportBytes(ClientId id, size_t bytes);
+
+  // Asks every client to trim.
+  void Trim(MemoryTrimLevel level);
+
+  size_t max_bytes() const { return max_bytes_; }
+
+  size_t GetTotalBytes() const;
+
+  std::vector<ClientStats> GetClientStats() const;
+
+ private:
+  struct Client {
+    std::string name;
+    ftl::RefPtr<ftl::TaskRunner> task_runner;
+    TrimCallback trim;
+    size_t bytes = 0;
+    bool trim_pending = false;
+    uint64_t trim_count = 0;
+  };
+
+  const size_t max_bytes_;
+  mutable std::mutex mutex_;
+  std::map<ClientId, Client> clients_;
+  ClientId next_id_;
+  size_t total_bytes_;
+
+  void TrimOverBudgetLocked();
+
+  void PostTrimLocked(ClientId id, Client* client, MemoryTrimLevel level);
+
+  void RunTrim(ClientId id, MemoryTrimLevel level);
+
+  FTL_DISALLOW_COPY_AND_ASSIGN(MemoryBudget);
+};
+
+}  // namespace shell
+
+#endif  // FLUTTER_SHELL_COMMON_MEMORY_BUDGET_H_
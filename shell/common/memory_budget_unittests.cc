@@ -0,0 +1,206 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/memory_budget.h"
+
+#include <vector>
+
+#include "lib/ftl/memory/ref_counted.h"
+#include "third_party/gtest/include/gtest/gtest.h"
+
+namespace shell {
+namespace {
+
+// Holds on to the posted tasks till the test runs them.
+class ManualTaskRunner : public ftl::TaskRunner {
+ public:
+  void PostTask(ftl::Closure task) override { tasks_.push_back(task); }
+
+  void PostTaskForTime(ftl::Closure task,
+                       ftl::TimePoint target_time) override {
+    PostTask(task);
+  }
+
+  void PostDelayedTask(ftl::Closure task, ftl::TimeDelta delay) override {
+    PostTask(task);
+  }
+
+  bool RunsTasksOnCurrentThread() override { return true; }
+
+  size_t pending_task_count() const { return tasks_.size(); }
+
+  void RunPendingTasks() {
+    std::vector<ftl::Closure> tasks;
+    tasks.swap(tasks_);
+    for (const auto& task : tasks)
+      task();
+  }
+
+ private:
+  std::vector<ftl::Closure> tasks_;
+
+  ManualTaskRunner() = default;
+  ~ManualTaskRunner() override = default;
+
+  FRIEND_MAKE_REF_COUNTED(ManualTaskRunner);
+  FRIEND_REF_COUNTED_THREAD_SAFE(ManualTaskRunner);
+  FTL_DISALLOW_COPY_AND_ASSIGN(ManualTaskRunner);
+};
+
+// A client that records the trims it was asked for.
+struct TestClient {
+  MemoryBudget::ClientId id = 0;
+  std::vector<MemoryTrimLevel> trims;
+
+  MemoryBudget::TrimCallback MakeCallback() {
+    return [this](MemoryTrimLevel level) { trims.push_back(level); };
+  }
+};
+
+}  // namespace
+
+TEST(MemoryBudget, TotalsReportedBytes) {
+  auto runner = ftl::MakeRefCounted<ManualTaskRunner>();
+  MemoryBudget budget(1000);
+  TestClient a;
+  TestClient b;
+  a.id = budget.Register("a", runner, a.MakeCallback());
+  b.id = budget.Register("b", runner, b.MakeCallback());
+
+  budget.ReportBytes(a.id, 300);
+  budget.ReportBytes(b.id, 200);
+  budget.ReportBytes(a.id, 100);
+  ASSERT_EQ(budget.GetTotalBytes(), 300u);
+  ASSERT_EQ(runner->pending_task_count(), 0u);
+
+  std::vector<MemoryBudget::ClientStats> stats = budget.GetClientStats();
+  ASSERT_EQ(stats.size(), 2u);
+  ASSERT_EQ(stats[0].name, "a");
+  ASSERT_EQ(stats[0].bytes, 100u);
+  ASSERT_EQ(stats[1].name, "b");
+  ASSERT_EQ(stats[1].bytes, 200u);
+}
+
+TEST(MemoryBudget, TrimsLargestClientsOverBudget) {
+  auto runner = ftl::MakeRefCounted<ManualTaskRunner>();
+  MemoryBudget budget(1000);
+  TestClient small;
+  TestClient large;
+  small.id = budget.Register("small", runner, small.MakeCallback());
+  large.id = budget.Register("large", runner, large.MakeCallback());
+
+  budget.ReportBytes(large.id, 700);
+  budget.ReportBytes(small.id, 200);
+  ASSERT_EQ(runner->pending_task_count(), 0u);
+
+  // The excess of 100 bytes is covered by the largest client alone.
+  budget.ReportBytes(small.id, 400);
+  runner->RunPendingTasks();
+  ASSERT_TRUE(small.trims.empty());
+  ASSERT_EQ(large.trims.size(), 1u);
+  ASSERT_EQ(large.trims[0], MemoryTrimLevel::kModerate);
+}
+
+TEST(MemoryBudget, DoesNotTrimWhenAClientShrinks) {
+  auto runner = ftl::MakeRefCounted<ManualTaskRunner>();
+  MemoryBudget budget(1000);
+  TestClient client;
+  client.id = budget.Register("client", runner, client.MakeCallback());
+
+  budget.ReportBytes(client.id, 1500);
+  runner->RunPendingTasks();
+  ASSERT_EQ(client.trims.size(), 1u);
+
+  // A trim that could not release everything must not ask for another one.
+  budget.ReportBytes(client.id, 1200);
+  ASSERT_EQ(runner->pending_task_count(), 0u);
+}
+
+TEST(MemoryBudget, DoesNotTrimWithoutABudget) {
+  auto runner = ftl::MakeRefCounted<ManualTaskRunner>();
+  MemoryBudget budget(0);
+  TestClient client;
+  client.id = budget.Register("client", runner, client.MakeCallback());
+
+  budget.ReportBytes(client.id, 1 << 30);
+  ASSERT_EQ(runner->pending_task_count(), 0u);
+}
+
+TEST(MemoryBudget, CoalescesTrimsWhileOneIsPending) {
+  auto runner = ftl::MakeRefCounted<ManualTaskRunner>();
+  MemoryBudget budget(1000);
+  TestClient client;
+  client.id = budget.Register("client", runner, client.MakeCallback());
+
+  budget.ReportBytes(client.id, 1100);
+  budget.ReportBytes(client.id, 1200);
+  budget.Trim(MemoryTrimLevel::kModerate);
+  ASSERT_EQ(runner->pending_task_count(), 1u);
+
+  runner->RunPendingTasks();
+  ASSERT_EQ(client.trims.size(), 1u);
+  ASSERT_EQ(budget.GetClientStats()[0].trim_count, 1u);
+
+  // Once the trim ran, growth asks for another.
+  budget.ReportBytes(client.id, 1300);
+  ASSERT_EQ(runner->pending_task_count(), 1u);
+}
+
+TEST(MemoryBudget, CriticalTrimIsPostedDespitePendingTrim) {
+  auto runner = ftl::MakeRefCounted<ManualTaskRunner>();
+  MemoryBudget budget(1000);
+  TestClient client;
+  client.id = budget.Register("client", runner, client.MakeCallback());
+
+  budget.ReportBytes(client.id, 1100);
+  budget.Trim(MemoryTrimLevel::kCritical);
+  runner->RunPendingTasks();
+
+  ASSERT_EQ(client.trims.size(), 2u);
+  ASSERT_EQ(client.trims[0], MemoryTrimLevel::kModerate);
+  ASSERT_EQ(client.trims[1], MemoryTrimLevel::kCritical);
+}
+
+TEST(MemoryBudget, TrimAsksEveryClient) {
+  auto runner = ftl::MakeRefCounted<ManualTaskRunner>();
+  MemoryBudget budget(1000);
+  TestClient a;
+  TestClient b;
+  a.id = budget.Register("a", runner, a.MakeCallback());
+  b.id = budget.Register("b", runner, b.MakeCallback());
+
+  budget.Trim(MemoryTrimLevel::kCritical);
+  runner->RunPendingTasks();
+  ASSERT_EQ(a.trims.size(), 1u);
+  ASSERT_EQ(a.trims[0], MemoryTrimLevel::kCritical);
+  ASSERT_EQ(b.trims.size(), 1u);
+  ASSERT_EQ(b.trims[0], MemoryTrimLevel::kCritical);
+}
+
+TEST(MemoryBudget, UnregisterDropsBytesAndPendingTrims) {
+  auto runner = ftl::MakeRefCounted<ManualTaskRunner>();
+  MemoryBudget budget(1000);
+  TestClient a;
+  TestClient b;
+  a.id = budget.Register("a", runner, a.MakeCallback());
+  b.id = budget.Register("b", runner, b.MakeCallback());
+
+  budget.ReportBytes(a.id, 600);
+  budget.ReportBytes(b.id, 500);
+  ASSERT_EQ(runner->pending_task_count(), 1u);
+
+  budget.Unregister(a.id);
+  ASSERT_EQ(budget.GetTotalBytes(), 500u);
+  ASSERT_EQ(budget.GetClientStats().size(), 1u);
+
+  runner->RunPendingTasks();
+  ASSERT_TRUE(a.trims.empty());
+
+  // Reports of an unregistered client are ignored.
+  budget.ReportBytes(a.id, 2000);
+  ASSERT_EQ(budget.GetTotalBytes(), 500u);
+  ASSERT_EQ(runner->pending_task_count(), 0u);
+}
+
+}  // namespace shell
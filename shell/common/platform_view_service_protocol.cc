@@ -4,12 +4,16 @@
 
 #include "flutter/shell/common/platform_view_service_protocol.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 #include <string>
 #include <vector>
 
 #include "flutter/common/threads.h"
+#include "flutter/lib/ui/external_allocation.h"
+#include "flutter/lib/ui/painting/image_decode_pool.h"
+#include "flutter/shell/common/memory_budget.h"
 #include "flutter/shell/common/picture_serializer.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/shell.h"
@@ -98,6 +102,21 @@ static void AppendIsolateRef(std::stringstream* stream,
   *stream << "\"number\":\"" << main_port << "\"}";
 }
 
+static void AppendFrameTiming(std::stringstream* stream,
+                              const flow::FrameTiming& timing) {
+  *stream << "{\"number\":" << timing.frame_number
+          << ",\"rasterStart\":"
+          << (timing.raster_start - ftl::TimePoint()).ToMicroseconds()
+          << ",\"build\":" << timing.build_time.ToMicroseconds()
+          << ",\"raster\":" << timing.raster_time.ToMicroseconds()
+          << ",\"preroll\":" << timing.preroll_time.ToMicroseconds()
+          << ",\"paint\":" << timing.paint_time.ToMicroseconds()
+          << ",\"rasterCacheHits\":" << timing.raster_cache_hits
+          << ",\"rasterCacheMisses\":" << timing.raster_cache_misses
+          << ",\"rasterCacheBytes\":" << timing.raster_cache_bytes
+          << ",\"gpuResourceBytes\":" << timing.gpu_resource_bytes << "}";
+}
+
 static void AppendFlutterView(std::stringstream* stream,
                               uintptr_t view_id,
                               int64_t isolate_id,
@@ -122,6 +141,19 @@ void PlatformViewServiceProtocol::RegisterHook(bool running_precompiled_code) {
   // Screenshot.
   Dart_RegisterRootServiceRequestCallback(kScreenshotExtensionName, &Screenshot,
                                           nullptr);
+  // Timings of recently drawn frames.
+  Dart_RegisterRootServiceRequestCallback(kFrameTimingsExtensionName,
+                                          &FrameTimings, nullptr);
+  // Statistics of the image decode pool and the decoded image cache.
+  Dart_RegisterRootServiceRequestCallback(kImageDecodeStatsExtensionName,
+                                          &ImageDecodeStats, nullptr);
+  // Native memory held by the Dart wrappers of images, paragraphs and
+  // pictures.
+  Dart_RegisterRootServiceRequestCallback(kExternalAllocationsExtensionName,
+                                          &ExternalAllocations, nullptr);
+  // The memory budget shared by the caches of the engine.
+  Dart_RegisterRootServiceRequestCallback(kMemoryBudgetExtensionName,
+                                          &MemoryBudgetStats, nullptr);
   // The following set of service protocol extensions require debug build
   if (running_precompiled_code) {
     return;
@@ -314,4 +346,161 @@ void PlatformViewServiceProtocol::ScreenshotGpuTask(SkBitmap* bitmap) {
   canvas->flush();
 }
 
+const char* PlatformViewServiceProtocol::kFrameTimingsExtensionName =
+    "_flutter.frameTimings";
+
+bool PlatformViewServiceProtocol::FrameTimings(const char* method,
+                                               const char** param_keys,
+                                               const char** param_values,
+                                               intptr_t num_params,
+                                               void* user_data,
+                                               const char** json_object) {
+  // Clients polling for new frames pass the number of the last frame they
+  // have seen.
+  uint64_t after_frame_number = 0;
+  const char* since =
+      ValueForKey(param_keys, param_values, num_params, "since");
+  if (since != NULL) {
+    char* end = nullptr;
+    after_frame_number = strtoull(since, &end, 10);
+    if (end == since || *end != '\0') {
+      return ErrorBadParameter(json_object, "since", since);
+    }
+  }
+
+  ftl::AutoResetWaitableEvent latch;
+  std::vector<flow::FrameTiming> frames;
+  bool available = false;
+  blink::Threads::Gpu()->PostTask(
+      [&latch, &frames, &available, after_frame_number]() {
+        available = FrameTimingsGpuTask(after_frame_number, &frames);
+        latch.Signal();
+      });
+
+  latch.Wait();
+
+  if (!available)
+    return ErrorServer(json_object, "frame timings are not available");
+
+  std::stringstream response;
+  response << "{\"type\":\"FrameTimings\",\"frames\":[";
+  for (size_t i = 0; i < frames.size(); i++) {
+    if (i > 0) {
+      response << ',';
+    }
+    AppendFrameTiming(&response, frames[i]);
+  }
+  response << "]}";
+  *json_object = strdup(response.str().c_str());
+  return true;
+}
+
+const char* PlatformViewServiceProtocol::kImageDecodeStatsExtensionName =
+    "_flutter.imageDecodeStats";
+
+bool PlatformViewServiceProtocol::ImageDecodeStats(const char* method,
+                                                   const char** param_keys,
+                                                   const char** param_values,
+                                                   intptr_t num_params,
+                                                   void* user_data,
+                                                   const char** json_object) {
+  const blink::ImageDecodeStats stats =
+      blink::ImageDecodePool::Get().GetStats();
+
+  std::stringstream response;
+  response << "{\"type\":\"ImageDecodeStats\""
+           << ",\"workerCount\":" << stats.worker_count
+           << ",\"queueDepth\":" << stats.queue_depth
+           << ",\"maxQueueDepth\":" << stats.max_queue_depth
+           << ",\"decodeCount\":" << stats.decode_count
+           << ",\"totalDecodeLatencyMicros\":"
+           << stats.total_decode_latency_micros
+           << ",\"maxDecodeLatencyMicros\":" << stats.max_decode_latency_micros
+           << ",\"cacheHitCount\":" << stats.cache_hit_count
+           << ",\"cacheMissCount\":" << stats.cache_miss_count
+           << ",\"cacheBytes\":" << stats.cache_bytes << "}";
+  *json_object = strdup(response.str().c_str());
+  return true;
+}
+
+const char* PlatformViewServiceProtocol::kExternalAllocationsExtensionName =
+    "_flutter.externalAllocations";
+
+bool PlatformViewServiceProtocol::ExternalAllocations(
+    const char* method,
+    const char** param_keys,
+    const char** param_values,
+    intptr_t num_params,
+    void* user_data,
+    const char** json_object) {
+  using blink::ExternalAllocation;
+  using blink::ExternalAllocationKind;
+
+  std::stringstream response;
+  response << "{\"type\":\"ExternalAllocations\""
+           << ",\"totalBytes\":" << ExternalAllocation::GetTotalBytes()
+           << ",\"imageBytes\":"
+           << ExternalAllocation::GetTotalBytes(ExternalAllocationKind::kImage)
+           << ",\"paragraphBytes\":"
+           << ExternalAllocation::GetTotalBytes(
+                  ExternalAllocationKind::kParagraph)
+           << ",\"pictureBytes\":"
+           << ExternalAllocation::GetTotalBytes(
+                  ExternalAllocationKind::kPicture)
+           << "}";
+  *json_object = strdup(response.str().c_str());
+  return true;
+}
+
+const char* PlatformViewServiceProtocol::kMemoryBudgetExtensionName =
+    "_flutter.memoryBudget";
+
+bool PlatformViewServiceProtocol::MemoryBudgetStats(
+    const char* method,
+    const char** param_keys,
+    const char** param_values,
+    intptr_t num_params,
+    void* user_data,
+    const char** json_object) {
+  shell::MemoryBudget& budget = shell::MemoryBudget::Get();
+
+  std::stringstream response;
+  response << "{\"type\":\"MemoryBudget\""
+           << ",\"maxBytes\":" << budget.max_bytes()
+           << ",\"totalBytes\":" << budget.GetTotalBytes()
+           << ",\"clients\":[";
+  bool first = true;
+  for (const auto& client : budget.GetClientStats()) {
+    if (!first)
+      response << ",";
+    first = false;
+    response << "{\"name\":\"" << client.name << "\""
+             << ",\"bytes\":" << client.bytes
+             << ",\"trimCount\":" << client.trim_count << "}";
+  }
+  response << "]}";
+  *json_object = strdup(response.str().c_str());
+  return true;
+}
+
+bool PlatformViewServiceProtocol::FrameTimingsGpuTask(
+    uint64_t after_frame_number,
+    std::vector<flow::FrameTiming>* frames) {
+  std::vector<ftl::WeakPtr<Rasterizer>> rasterizers;
+  Shell::Shared().GetRasterizers(&rasterizers);
+  if (rasterizers.size() != 1)
+    return false;
+
+  Rasterizer* rasterizer = rasterizers[0].get();
+  if (rasterizer == nullptr)
+    return false;
+
+  const flow::FrameTimingHistory* history = rasterizer->GetFrameTimings();
+  if (history == nullptr)
+    return false;
+
+  history->GetFramesAfter(after_frame_number, frames);
+  return true;
+}
+
 }  // namespace shell
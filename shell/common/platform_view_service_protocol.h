@@ -6,8 +6,10 @@
 #define SHELL_COMMON_VIEW_SERVICE_PROTOCOL_H_
 
 #include <memory>
+#include <vector>
 
 #include "dart/runtime/include/dart_tools_api.h"
+#include "flutter/flow/frame_timing.h"
 #include "flutter/shell/common/platform_view.h"
 #include "lib/ftl/synchronization/waitable_event.h"
 #include "third_party/skia/include/core/SkBitmap.h"
@@ -43,6 +45,40 @@ class PlatformViewServiceProtocol {
                          void* user_data,
                          const char** json_object);
   static void ScreenshotGpuTask(SkBitmap* bitmap);
+
+  static const char* kFrameTimingsExtensionName;
+  static bool FrameTimings(const char* method,
+                           const char** param_keys,
+                           const char** param_values,
+                           intptr_t num_params,
+                           void* user_data,
+                           const char** json_object);
+  static const char* kImageDecodeStatsExtensionName;
+  static bool ImageDecodeStats(const char* method,
+                               const char** param_keys,
+                               const char** param_values,
+                               intptr_t num_params,
+                               void* user_data,
+                               const char** json_object);
+
+  static const char* kExternalAllocationsExtensionName;
+  static bool ExternalAllocations(const char* method,
+                                  const char** param_keys,
+                                  const char** param_values,
+                                  intptr_t num_params,
+                                  void* user_data,
+                                  const char** json_object);
+
+  static const char* kMemoryBudgetExtensionName;
+  static bool MemoryBudgetStats(const char* method,
+                                const char** param_keys,
+                                const char** param_values,
+                                intptr_t num_params,
+                                void* user_data,
+                                const char** json_object);
+
+  static bool FrameTimingsGpuTask(uint64_t after_frame_number,
+                                  std::vector<flow::FrameTiming>* frames);
 };
 
 }  // namespace shell
@@ -8,4 +8,8 @@ namespace shell {
 
 Rasterizer::~Rasterizer() = default;
 
+const flow::FrameTimingHistory* Rasterizer::GetFrameTimings() {
+  return nullptr;
+}
+
 }  // namespace shell
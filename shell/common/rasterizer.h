@@ -7,6 +7,7 @@
 
 #include <memory>
 
+#include "flutter/flow/frame_timing.h"
 #include "flutter/flow/layers/layer_tree.h"
 #include "flutter/shell/common/surface.h"
 #include "flutter/synchronization/pipeline.h"
@@ -33,6 +34,10 @@ class Rasterizer {
 
   virtual flow::LayerTree* GetLastLayerTree() = 0;
 
+  // The timings of the frames drawn most recently, or null if the rasterizer
+  // does not keep them. Must be called on the GPU thread.
+  virtual const flow::FrameTimingHistory* GetFrameTimings();
+
   virtual void Draw(
       ftl::RefPtr<flutter::Pipeline<flow::LayerTree>> pipeline) = 0;
 };
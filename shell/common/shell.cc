@@ -15,14 +15,18 @@
 #include "flutter/fml/icu_util.h"
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/trace_event.h"
+#include "flutter/lib/ui/painting/image_decode_pool.h"
+#include "flutter/lib/ui/painting/resource_context.h"
 #include "flutter/runtime/dart_init.h"
 #include "flutter/shell/common/diagnostic/diagnostic_server.h"
 #include "flutter/shell/common/engine.h"
+#include "flutter/shell/common/memory_budget.h"
 #include "flutter/shell/common/platform_view_service_protocol.h"
 #include "flutter/shell/common/skia_event_tracer_impl.h"
 #include "flutter/shell/common/switches.h"
 #include "lib/ftl/files/unique_fd.h"
 #include "third_party/skia/include/core/SkGraphics.h"
+#include "third_party/skia/include/gpu/GrContext.h"
 
 namespace shell {
 namespace {
@@ -65,6 +69,36 @@ void ServiceIsolateHook(bool running_precompiled) {
   }
 }
 
+// The caches of the IO thread live as long as the process, so their clients
+// are never unregistered.
+void RegisterIOThreadMemoryClients() {
+  MemoryBudget& budget = MemoryBudget::Get();
+
+  // Uploads are not kept in the resource cache of the IO context, but it still
+  // holds scratch resources, so it is only ever asked to trim.
+  budget.Register("io_resources", blink::Threads::IO(),
+                  [](MemoryTrimLevel level) {
+                    GrContext* context = blink::ResourceContext::Get();
+                    if (!context)
+                      return;
+                    if (level == MemoryTrimLevel::kCritical)
+                      context->freeGpuResources();
+                    else
+                      context->purgeAllUnlockedResources();
+                  });
+
+  blink::DecodedImageCache& cache = blink::ImageDecodePool::Get().cache();
+  MemoryBudget::ClientId images_id = budget.Register(
+      "decoded_images", blink::Threads::IO(),
+      [&cache](MemoryTrimLevel level) {
+        cache.Trim(level == MemoryTrimLevel::kCritical ? 0
+                                                       : cache.bytes() / 2);
+      });
+  cache.SetBytesObserver([images_id](size_t bytes) {
+    MemoryBudget::Get().ReportBytes(images_id, bytes);
+  });
+}
+
 }  // namespace
 
 Shell::Shell(ftl::CommandLine command_line)
@@ -82,10 +116,14 @@ Shell::Shell(ftl::CommandLine command_line)
                          gpu_thread_->GetTaskRunner(),
                          ui_thread_->GetTaskRunner(),
                          io_thread_->GetTaskRunner());
+  threads.SetUIPriorityTaskRunners(
+      ui_thread_->GetTaskRunner(fml::TaskPriority::High),
+      ui_thread_->GetTaskRunner(fml::TaskPriority::Low));
   blink::Threads::Set(threads);
 
   blink::Threads::Gpu()->PostTask([this]() { InitGpuThread(); });
   blink::Threads::UI()->PostTask([this]() { InitUIThread(); });
+  blink::Threads::IO()->PostTask(RegisterIOThreadMemoryClients);
 
   blink::SetServiceIsolateHook(ServiceIsolateHook);
   blink::SetRegisterNativeServiceProtocolExtensionHook(
@@ -147,6 +185,100 @@ void Shell::InitStandalone(ftl::CommandLine command_line,
   settings.enable_software_rendering =
       command_line.HasOption(FlagForSwitch(Switch::EnableSoftwareRendering));
 
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::SoftwareRasterWorkerCount))) {
+    if (!GetSwitchValue(command_line, Switch::SoftwareRasterWorkerCount,
+                        &settings.software_raster_worker_count)) {
+      FTL_LOG(INFO) << "Software raster worker count specified was malformed. "
+                       "Will rasterize on the GPU thread alone.";
+    }
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::SoftwareRasterTileSize))) {
+    if (!GetSwitchValue(command_line, Switch::SoftwareRasterTileSize,
+                        &settings.software_raster_tile_size)) {
+      FTL_LOG(INFO) << "Software raster tile size specified was malformed. "
+                       "Will use the default.";
+    }
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::MemoryBudgetBytes))) {
+    if (!GetSwitchValue(command_line, Switch::MemoryBudgetBytes,
+                        &settings.memory_budget_bytes)) {
+      FTL_LOG(INFO) << "Memory budget specified was malformed. Caches will "
+                       "only be trimmed on memory pressure.";
+    }
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::RasterCacheMaxBytes))) {
+    if (!GetSwitchValue(command_line, Switch::RasterCacheMaxBytes,
+                        &settings.raster_cache_max_bytes)) {
+      FTL_LOG(INFO) << "Raster cache byte budget specified was malformed. "
+                       "Will use the default.";
+    }
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::RasterCacheMaxUnusedFrames))) {
+    if (!GetSwitchValue(command_line, Switch::RasterCacheMaxUnusedFrames,
+                        &settings.raster_cache_max_unused_frames)) {
+      FTL_LOG(INFO) << "Raster cache unused frame count specified was "
+                       "malformed. Will use the default.";
+    }
+  }
+
+  settings.defer_raster_cache_population =
+      command_line.HasOption(FlagForSwitch(Switch::DeferRasterCachePopulation));
+
+  settings.enable_partial_repaint =
+      command_line.HasOption(FlagForSwitch(Switch::EnablePartialRepaint));
+
+  if (command_line.HasOption(FlagForSwitch(Switch::PipelineDepth))) {
+    if (!GetSwitchValue(command_line, Switch::PipelineDepth,
+                        &settings.layer_tree_pipeline_depth)) {
+      FTL_LOG(INFO) << "Pipeline depth specified was malformed. Will use the "
+                       "default.";
+    }
+  }
+
+  settings.skip_stale_frames =
+      command_line.HasOption(FlagForSwitch(Switch::SkipStaleFrames));
+
+  settings.adaptive_frame_start =
+      command_line.HasOption(FlagForSwitch(Switch::AdaptiveFrameStart));
+
+  settings.resample_pointer_events =
+      command_line.HasOption(FlagForSwitch(Switch::ResamplePointerEvents));
+
+  settings.batch_pointer_events =
+      settings.resample_pointer_events ||
+      command_line.HasOption(FlagForSwitch(Switch::BatchPointerEvents));
+
+  if (command_line.HasOption(FlagForSwitch(Switch::ImageDecodeWorkerCount))) {
+    if (!GetSwitchValue(command_line, Switch::ImageDecodeWorkerCount,
+                        &settings.image_decode_worker_count)) {
+      FTL_LOG(INFO) << "Image decode worker count specified was malformed. "
+                       "Will use the default.";
+    }
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::DecodedImageCacheMaxBytes))) {
+    if (!GetSwitchValue(command_line, Switch::DecodedImageCacheMaxBytes,
+                        &settings.decoded_image_cache_max_bytes)) {
+      FTL_LOG(INFO) << "Decoded image cache size specified was malformed. "
+                       "Will use the default.";
+    }
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::PrerollWorkerCount))) {
+    if (!GetSwitchValue(command_line, Switch::PrerollWorkerCount,
+                        &settings.preroll_worker_count)) {
+      FTL_LOG(INFO) << "Preroll worker count specified was malformed. Will "
+                       "preroll on the GPU thread alone.";
+    }
+  }
+
   settings.endless_trace_buffer =
       command_line.HasOption(FlagForSwitch(Switch::EndlessTraceBuffer));
 
@@ -172,6 +304,12 @@ void Shell::InitStandalone(ftl::CommandLine command_line,
   command_line.GetOptionValue(FlagForSwitch(Switch::CacheDirPath),
                               &settings.temp_directory_path);
 
+  command_line.GetOptionValue(FlagForSwitch(Switch::FrameTimingLog),
+                              &settings.frame_timing_log_path);
+
+  command_line.GetOptionValue(FlagForSwitch(Switch::TraceToFile),
+                              &settings.trace_file_path);
+
   settings.use_test_fonts =
       command_line.HasOption(FlagForSwitch(Switch::UseTestFonts));
 
@@ -194,6 +332,11 @@ void Shell::InitStandalone(ftl::CommandLine command_line,
 void Shell::Init(ftl::CommandLine command_line) {
 #if FLUTTER_RUNTIME_MODE != FLUTTER_RUNTIME_MODE_RELEASE
   InitSkiaEventTracer();
+
+  const std::string& trace_file_path = blink::Settings::Get().trace_file_path;
+  if (!trace_file_path.empty()) {
+    fml::tracing::StartTracingToFile(trace_file_path);
+  }
 #endif
 
   FTL_DCHECK(!g_shell);
@@ -214,6 +357,26 @@ TracingController& Shell::tracing_controller() {
   return tracing_controller_;
 }
 
+void Shell::StopTracingToFile() {
+#if FLUTTER_RUNTIME_MODE != FLUTTER_RUNTIME_MODE_RELEASE
+  if (blink::Settings::Get().trace_file_path.empty())
+    return;
+
+  const ftl::RefPtr<ftl::TaskRunner> task_runners[] = {
+      blink::Threads::Gpu(), blink::Threads::UI(), blink::Threads::IO()};
+  for (const auto& task_runner : task_runners) {
+    ftl::AutoResetWaitableEvent latch;
+    task_runner->PostTask([&latch] {
+      fml::tracing::FlushCurrentThreadTraceEvents();
+      latch.Signal();
+    });
+    latch.Wait();
+  }
+
+  fml::tracing::StopTracingToFile();
+#endif
+}
+
 void Shell::InitGpuThread() {
   gpu_thread_checker_.reset(new ftl::ThreadChecker());
 }
@@ -36,6 +36,12 @@ class Shell {
 
   TracingController& tracing_controller();
 
+  // Writes the trace events still buffered by the engine threads to the file
+  // named by |Settings::trace_file_path| and closes it. Call this on the
+  // platform thread before the process exits. Does nothing when the shell is
+  // not tracing to a file.
+  void StopTracingToFile();
+
   // Maintain a list of rasterizers.
   // These APIs must only be accessed on the GPU thread.
   void AddRasterizer(const ftl::WeakPtr<Rasterizer>& rasterizer);
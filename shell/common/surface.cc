@@ -10,7 +10,26 @@ namespace shell {
 
 SurfaceFrame::SurfaceFrame(sk_sp<SkSurface> surface,
                            SubmitCallback submit_callback)
-    : submitted_(false), surface_(surface), submit_callback_(submit_callback) {
+    : submitted_(false),
+      buffer_age_(0),
+      has_damage_(false),
+      damage_(SkIRect::MakeEmpty()),
+      surface_(surface),
+      canvas_(nullptr),
+      submit_callback_(submit_callback) {
+  FTL_DCHECK(submit_callback_);
+}
+
+SurfaceFrame::SurfaceFrame(sk_sp<SkSurface> surface,
+                           SkCanvas* canvas,
+                           SubmitCallback submit_callback)
+    : submitted_(false),
+      buffer_age_(0),
+      has_damage_(false),
+      damage_(SkIRect::MakeEmpty()),
+      surface_(surface),
+      canvas_(canvas),
+      submit_callback_(submit_callback) {
   FTL_DCHECK(submit_callback_);
 }
 
@@ -32,6 +51,9 @@ bool SurfaceFrame::Submit() {
 }
 
 SkCanvas* SurfaceFrame::SkiaCanvas() {
+  if (canvas_ != nullptr) {
+    return canvas_;
+  }
   return surface_ != nullptr ? surface_->getCanvas() : nullptr;
 }
 
@@ -55,6 +77,10 @@ Surface::Surface() : scale_(1.0) {}
 
 Surface::~Surface() = default;
 
+bool Surface::MakeRenderContextCurrent() {
+  return true;
+}
+
 bool Surface::SupportsScaling() const {
   return false;
 }
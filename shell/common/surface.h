@@ -22,6 +22,12 @@ class SurfaceFrame {
 
   SurfaceFrame(sk_sp<SkSurface> surface, SubmitCallback submit_callback);
 
+  // For frames that are drawn with |canvas| and only transferred to
+  // |surface| once submitted. |canvas| must remain valid till then.
+  SurfaceFrame(sk_sp<SkSurface> surface,
+               SkCanvas* canvas,
+               SubmitCallback submit_callback);
+
   ~SurfaceFrame();
 
   bool Submit();
@@ -30,9 +36,33 @@ class SurfaceFrame {
 
   sk_sp<SkSurface> SkiaSurface() const;
 
+  // The number of frames since the contents of the buffer backing this frame
+  // were submitted, or zero if its contents are undefined. A buffer age of one
+  // means that the buffer holds the previous frame.
+  size_t buffer_age() const { return buffer_age_; }
+
+  void set_buffer_age(size_t buffer_age) { buffer_age_ = buffer_age; }
+
+  // The pixels of the frame that may differ from the contents of the buffer,
+  // in device pixels with the origin at the top left. Frames without damage
+  // may have changed anywhere.
+  bool has_damage() const { return has_damage_; }
+
+  const SkIRect& damage() const { return damage_; }
+
+  void set_damage(const SkIRect& damage) {
+    damage_ = damage;
+    has_damage_ = true;
+  }
+
  private:
   bool submitted_;
+  size_t buffer_age_;
+  bool has_damage_;
+  SkIRect damage_;
   sk_sp<SkSurface> surface_;
+  // Null if the frame is drawn with the canvas of |surface_|.
+  SkCanvas* canvas_;
   SubmitCallback submit_callback_;
 
   bool PerformSubmit();
@@ -54,6 +84,10 @@ class Surface {
 
   virtual GrContext* GetContext() = 0;
 
+  // Makes the rendering context of the surface current on the calling thread
+  // so that work may be done with |GetContext| outside of a frame.
+  virtual bool MakeRenderContextCurrent();
+
   virtual bool SupportsScaling() const;
 
   double GetScale() const;
@@ -65,15 +65,90 @@ DEF_SWITCH(EnableSoftwareRendering,
            "Enable rendering using the Skia software backend. This is useful"
            "when testing Flutter on emulators. By default, Flutter will"
            "attempt to either use OpenGL or Vulkan.")
+DEF_SWITCH(SoftwareRasterWorkerCount,
+           "software-raster-worker-count",
+           "With software rendering, the number of additional threads that "
+           "rasterize tiles of each frame alongside the GPU thread. By "
+           "default, frames are rasterized on the GPU thread alone.")
+DEF_SWITCH(SoftwareRasterTileSize,
+           "software-raster-tile-size",
+           "With software rendering and raster workers, the width and height "
+           "in pixels of the tiles frames are split into. The default is 256.")
+DEF_SWITCH(DeferRasterCachePopulation,
+           "defer-raster-cache-population",
+           "Rasterize pictures for the raster cache after the frame that first "
+           "needs them has been submitted instead of while that frame is "
+           "being rendered. Frames draw the pictures directly till their "
+           "images are ready.")
+DEF_SWITCH(DecodedImageCacheMaxBytes,
+           "decoded-image-cache-max-bytes",
+           "The size in bytes of the cache of recently decoded images, which "
+           "lets images decoded again skip decoding. Defaults to 16MB.")
+DEF_SWITCH(EnablePartialRepaint,
+           "enable-partial-repaint",
+           "Compare each layer tree with the previous one and only repaint "
+           "the regions of the frame that changed. Only takes effect on "
+           "surfaces that report the age of their buffers.")
+DEF_SWITCH(AdaptiveFrameStart,
+           "adaptive-frame-start",
+           "Delay building a frame after the vsync when the GPU thread is "
+           "still busy with earlier frames, so that the frame reflects newer "
+           "input by the time it is rasterized.")
+DEF_SWITCH(BatchPointerEvents,
+           "batch-pointer-events",
+           "Queue the pointer events that arrive between frames and dispatch "
+           "them together at the start of the next frame, coalescing "
+           "consecutive moves of each pointer.")
 DEF_SWITCH(FLX, "flx", "Specify the the FLX path.")
+DEF_SWITCH(FrameTimingLog,
+           "frame-timing-log",
+           "Stream the timings of every rasterized frame to a binary log at "
+           "the given path. The timings of recent frames are also available "
+           "from the _flutter.frameTimings service protocol extension.")
+DEF_SWITCH(RasterCacheMaxBytes,
+           "raster-cache-max-bytes",
+           "The maximum number of bytes of rasterized pictures the raster "
+           "cache may hold. Least recently used images are evicted when the "
+           "budget is exceeded.")
+DEF_SWITCH(RasterCacheMaxUnusedFrames,
+           "raster-cache-max-unused-frames",
+           "The number of consecutive frames a rasterized picture may go "
+           "unused before it is evicted from the raster cache.")
 DEF_SWITCH(Help, "help", "Display this help text.")
 DEF_SWITCH(LogTag, "log-tag", "Tag associated with log messages.")
 DEF_SWITCH(MainDartFile, "dart-main", "The path to the main Dart file.")
+DEF_SWITCH(MemoryBudgetBytes,
+           "memory-budget-bytes",
+           "The bytes the raster cache, GPU resources, decoded images and text "
+           "caches may hold in total before the largest of them are trimmed. "
+           "By default, caches are only trimmed on memory pressure.")
 DEF_SWITCH(NonInteractive,
            "non-interactive",
            "Make the shell non-interactive. By default, the shell attempts "
            "to setup a window and create an OpenGL context.")
+DEF_SWITCH(ImageDecodeWorkerCount,
+           "image-decode-worker-count",
+           "The number of threads images are decoded on. Defaults to 2.")
 DEF_SWITCH(Packages, "packages", "Specify the path to the packages.")
+DEF_SWITCH(PipelineDepth,
+           "pipeline-depth",
+           "The number of frames the UI thread may produce ahead of the GPU "
+           "thread. Lower values reduce latency, higher values smooth over "
+           "occasional slow frames. Defaults to 3.")
+DEF_SWITCH(PrerollWorkerCount,
+           "preroll-worker-count",
+           "The number of additional threads used to preroll independent "
+           "subtrees of each layer tree concurrently. By default, layer trees "
+           "are prerolled on the GPU thread alone.")
+DEF_SWITCH(ResamplePointerEvents,
+           "resample-pointer-events",
+           "Resample the coalesced pointer moves to a point in time shortly "
+           "before the start of each frame for smoother tracking. Implies "
+           "--batch-pointer-events.")
+DEF_SWITCH(SkipStaleFrames,
+           "skip-stale-frames",
+           "When the GPU thread falls behind, rasterize only the newest of "
+           "the queued frames and drop the others.")
 DEF_SWITCH(StartPaused,
            "start-paused",
            "Start the application paused in the Dart debugger.")
@@ -81,6 +156,11 @@ DEF_SWITCH(TraceStartup,
            "trace-startup",
            "Trace early application lifecycle. Automatically switches to an "
            "endless trace buffer.")
+DEF_SWITCH(TraceToFile,
+           "trace-to-file",
+           "Also write the trace events of the engine to the file at the "
+           "given path in the Chrome trace event format. The trace is never "
+           "written in release mode.")
 DEF_SWITCH(UseTestFonts,
            "use-test-fonts",
            "Running tests that layout and measure text will not yield "
@@ -92,6 +172,17 @@ DEF_SWITCH(RunForever,
            "run-forever",
            "In non-interactive mode, keep the shell running after the Dart "
            "script has completed.")
+DEF_SWITCH(HeadlessRendering,
+           "headless-rendering",
+           "In non-interactive mode, rasterize frames into an offscreen "
+           "buffer using the Skia software backend. Vsync is simulated by a "
+           "virtual clock that advances by one 60Hz interval per frame, so "
+           "runs are reproducible on machines with no display or GPU.")
+DEF_SWITCH(FrameTimingsOutput,
+           "frame-timings-output",
+           "In non-interactive mode, write the build and raster times of the "
+           "frames rendered to the given path as JSON once the script has "
+           "completed. Implies --headless-rendering.")
 DEF_SWITCH(DartNonCheckedMode,
            "dart-non-checked-mode",
            "Dart code runs in checked mode when the runtime mode is debug. In "
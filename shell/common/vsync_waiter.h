@@ -17,6 +17,11 @@ class VsyncWaiter {
 
   virtual void AsyncWaitForVsync(Callback callback) = 0;
 
+  // Whether the frame times passed to callbacks may be used as the time of
+  // the frame. Platform vsync times are not stable enough for that on all
+  // devices.
+  virtual bool HasReliableFrameTimes() const;
+
   virtual ~VsyncWaiter();
 };
 
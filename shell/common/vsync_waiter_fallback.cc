@@ -35,7 +35,7 @@ void VsyncWaiterFallback::AsyncWaitForVsync(Callback callback) {
   ftl::TimePoint now = ftl::TimePoint::Now();
   ftl::TimePoint next = SnapToNextTick(now, phase_, interval);
 
-  blink::Threads::UI()->PostDelayedTask(
+  blink::Threads::UIHighPriority()->PostDelayedTask(
       [self = weak_factory_.GetWeakPtr()] {
         if (!self)
           return;
@@ -7,23 +7,70 @@
 #include <string>
 #include <utility>
 
+#include "flutter/common/settings.h"
 #include "flutter/common/threads.h"
 #include "flutter/glue/trace_event.h"
 #include "flutter/shell/common/picture_serializer.h"
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/common/shell.h"
+#include "lib/ftl/time/time_point.h"
+#include "third_party/skia/include/core/SkMatrix.h"
 #include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/gpu/GrContext.h"
 
 namespace shell {
 
 GPURasterizer::GPURasterizer(std::unique_ptr<flow::ProcessInfo> info)
-    : compositor_context_(std::move(info)), weak_factory_(this) {
+    : compositor_context_(std::move(info)),
+      partial_repaint_enabled_(blink::Settings::Get().enable_partial_repaint),
+      skip_stale_frames_(blink::Settings::Get().skip_stale_frames),
+      raster_cache_population_pending_(false),
+      raster_cache_budget_id_(0),
+      gpu_resources_budget_id_(0),
+      weak_factory_(this) {
+  const blink::Settings& settings = blink::Settings::Get();
+  if (settings.raster_cache_max_bytes > 0) {
+    compositor_context_.raster_cache().SetMaxBytes(
+        settings.raster_cache_max_bytes);
+  }
+  if (settings.raster_cache_max_unused_frames > 0) {
+    compositor_context_.raster_cache().SetMaxUnusedFrames(
+        settings.raster_cache_max_unused_frames);
+  }
+  compositor_context_.raster_cache().SetDeferredRasterization(
+      settings.defer_raster_cache_population);
+  compositor_context_.SetPrerollWorkerCount(settings.preroll_worker_count);
+  if (!settings.frame_timing_log_path.empty()) {
+    frame_timing_log_ = FrameTimingLog::Open(settings.frame_timing_log_path);
+    if (frame_timing_log_) {
+      FrameTimingLog* log = frame_timing_log_.get();
+      compositor_context_.SetFrameTimingObserver(
+          [log](const flow::FrameTiming& timing) { log->Append(timing); });
+    }
+  }
+
   auto weak_ptr = weak_factory_.GetWeakPtr();
   blink::Threads::Gpu()->PostTask(
       [weak_ptr]() { Shell::Shared().AddRasterizer(weak_ptr); });
+
+  MemoryBudget& budget = MemoryBudget::Get();
+  raster_cache_budget_id_ = budget.Register(
+      "raster_cache", blink::Threads::Gpu(),
+      [weak_ptr](MemoryTrimLevel level) {
+        if (weak_ptr)
+          weak_ptr->TrimRasterCache(level);
+      });
+  gpu_resources_budget_id_ = budget.Register(
+      "gpu_resources", blink::Threads::Gpu(),
+      [weak_ptr](MemoryTrimLevel level) {
+        if (weak_ptr)
+          weak_ptr->TrimGpuResources(level);
+      });
 }
 
 GPURasterizer::~GPURasterizer() {
+  MemoryBudget::Get().Unregister(raster_cache_budget_id_);
+  MemoryBudget::Get().Unregister(gpu_resources_budget_id_);
   weak_factory_.InvalidateWeakPtrs();
   Shell::Shared().PurgeRasterizers();
 }
@@ -62,6 +109,8 @@ void GPURasterizer::Clear(SkColor color, const SkISize& size) {
   canvas->clear(color);
 
   frame->Submit();
+
+  damage_history_.clear();
 }
 
 void GPURasterizer::Teardown(
@@ -70,20 +119,44 @@ void GPURasterizer::Teardown(
     surface_.reset();
   }
   last_layer_tree_.reset();
+  damage_history_.clear();
   compositor_context_.OnGrContextDestroyed();
+  ReportMemoryUsage();
   teardown_completion_event->Signal();
 }
 
+void GPURasterizer::SetFrameTimingsCallback(FrameTimingsCallback callback) {
+  frame_timings_callback_ = std::move(callback);
+}
+
 flow::LayerTree* GPURasterizer::GetLastLayerTree() {
   return last_layer_tree_.get();
 }
 
+const flow::FrameTimingHistory* GPURasterizer::GetFrameTimings() {
+  return &compositor_context_.frame_timings();
+}
+
 void GPURasterizer::Draw(
     ftl::RefPtr<flutter::Pipeline<flow::LayerTree>> pipeline) {
   TRACE_EVENT0("flutter", "GPURasterizer::Draw");
 
-  flutter::Pipeline<flow::LayerTree>::Consumer consumer =
-      std::bind(&GPURasterizer::DoDraw, this, std::placeholders::_1);
+  auto consumer = [this](std::unique_ptr<flow::LayerTree> layer_tree) {
+    DoDraw(std::move(layer_tree));
+  };
+
+  if (skip_stale_frames_) {
+    // Everything queued up is handled in one go, so there is no need to come
+    // back for more.
+    size_t dropped = 0;
+    if (pipeline->ConsumeLatest(consumer, &dropped) !=
+            flutter::PipelineConsumeResult::NoneAvailable &&
+        dropped > 0) {
+      TRACE_EVENT_INSTANT0("flutter", "StaleFramesDropped");
+      dropped_frame_count_.Increment(dropped);
+    }
+    return;
+  }
 
   // Consume as many pipeline items as possible. But yield the event loop
   // between successive tries.
@@ -112,32 +185,188 @@ void GPURasterizer::DoDraw(std::unique_ptr<flow::LayerTree> layer_tree) {
   // for instrumentation.
   compositor_context_.engine_time().SetLapTime(layer_tree->construction_time());
 
-  DrawToSurface(*layer_tree);
+  const ftl::TimePoint raster_start = ftl::TimePoint::Now();
+
+  if (!DrawToSurface(*layer_tree)) {
+    // The contents of the next buffer are now unknown.
+    damage_history_.clear();
+  }
+
+  if (frame_timings_callback_) {
+    frame_timings_callback_(layer_tree->construction_time(),
+                            ftl::TimePoint::Now() - raster_start);
+  }
 
   last_layer_tree_ = std::move(layer_tree);
+
+  if (compositor_context_.raster_cache().HasPendingPictures()) {
+    SchedulePopulateRasterCache();
+  }
+
+  ReportMemoryUsage();
 }
 
-void GPURasterizer::DrawToSurface(flow::LayerTree& layer_tree) {
+void GPURasterizer::SchedulePopulateRasterCache() {
+  if (raster_cache_population_pending_) {
+    return;
+  }
+
+  raster_cache_population_pending_ = true;
+
+  auto weak_this = weak_factory_.GetWeakPtr();
+  blink::Threads::Gpu()->PostTask([weak_this]() {
+    if (weak_this) {
+      weak_this->PopulateRasterCache();
+    }
+  });
+}
+
+void GPURasterizer::PopulateRasterCache() {
+  // Rasterizing pending pictures is done in small slices so that a frame
+  // arriving in the meantime does not wait for all of them.
+  static const ftl::TimeDelta kRasterCachePopulationBudget =
+      ftl::TimeDelta::FromMilliseconds(4);
+
+  raster_cache_population_pending_ = false;
+
+  if (!surface_ || !surface_->MakeRenderContextCurrent()) {
+    return;
+  }
+
+  if (compositor_context_.raster_cache().RasterizePendingPictures(
+          surface_->GetContext(), kRasterCachePopulationBudget)) {
+    SchedulePopulateRasterCache();
+  }
+
+  ReportMemoryUsage();
+}
+
+void GPURasterizer::TrimRasterCache(MemoryTrimLevel level) {
+  TRACE_EVENT0("flutter", "GPURasterizer::TrimRasterCache");
+  if (level == MemoryTrimLevel::kCritical) {
+    compositor_context_.raster_cache().Clear();
+  } else {
+    compositor_context_.raster_cache().EvictUnusedEntries();
+  }
+  ReportMemoryUsage();
+}
+
+void GPURasterizer::TrimGpuResources(MemoryTrimLevel level) {
+  TRACE_EVENT0("flutter", "GPURasterizer::TrimGpuResources");
+  if (!surface_ || !surface_->GetContext() ||
+      !surface_->MakeRenderContextCurrent()) {
+    return;
+  }
+  GrContext* context = surface_->GetContext();
+  if (level == MemoryTrimLevel::kCritical) {
+    context->freeGpuResources();
+  } else {
+    context->purgeAllUnlockedResources();
+  }
+  ReportMemoryUsage();
+}
+
+void GPURasterizer::ReportMemoryUsage() {
+  MemoryBudget& budget = MemoryBudget::Get();
+  const size_t raster_cache_bytes =
+      compositor_context_.raster_cache().bytes_used();
+  budget.ReportBytes(raster_cache_budget_id_, raster_cache_bytes);
+
+  GrContext* context = surface_ ? surface_->GetContext() : nullptr;
+  if (!context) {
+    budget.ReportBytes(gpu_resources_budget_id_, 0);
+    return;
+  }
+  size_t resource_bytes = 0;
+  context->getResourceCacheUsage(nullptr, &resource_bytes);
+  // On the GPU, the images of the raster cache are among these resources.
+  budget.ReportBytes(gpu_resources_budget_id_,
+                     resource_bytes > raster_cache_bytes
+                         ? resource_bytes - raster_cache_bytes
+                         : 0);
+}
+
+bool GPURasterizer::DrawToSurface(flow::LayerTree& layer_tree) {
   auto frame = surface_->AcquireFrame(layer_tree.frame_size());
 
   if (frame == nullptr) {
-    return;
+    return false;
   }
 
   auto canvas = frame->SkiaCanvas();
 
   if (canvas == nullptr) {
-    return;
+    return false;
   }
 
   auto compositor_frame =
       compositor_context_.AcquireFrame(surface_->GetContext(), canvas);
+  compositor_frame.timing().build_time = layer_tree.construction_time();
+
+  layer_tree.Preroll(compositor_frame);
+
+  SkAutoCanvasRestore save(canvas, true);
+
+  if (partial_repaint_enabled_) {
+    // Surfaces may scale the canvas, so damage is tracked in device pixels,
+    // which is also what buffer ages refer to.
+    const SkMatrix device_matrix = canvas->getTotalMatrix();
+    const SkIRect repaint_rect =
+        ComputeRepaintRect(layer_tree, device_matrix,
+                           canvas->getBaseLayerSize(), frame->buffer_age());
+    frame->set_damage(repaint_rect);
+    if (repaint_rect.isEmpty()) {
+      // Nothing changed. The buffer still needs to be presented, though.
+      return frame->Submit();
+    }
+    canvas->resetMatrix();
+    canvas->clipRect(SkRect::Make(repaint_rect));
+    canvas->setMatrix(device_matrix);
+  }
 
   canvas->clear(SK_ColorBLACK);
 
-  layer_tree.Raster(compositor_frame);
+  layer_tree.Paint(compositor_frame);
 
-  frame->Submit();
+  return frame->Submit();
+}
+
+SkIRect GPURasterizer::ComputeRepaintRect(const flow::LayerTree& layer_tree,
+                                          const SkMatrix& device_matrix,
+                                          const SkISize& device_size,
+                                          size_t buffer_age) {
+  // Buffers older than this are repainted in their entirety.
+  static const size_t kMaxDamageHistory = 4;
+
+  const SkIRect frame_rect = SkIRect::MakeSize(device_size);
+
+  SkIRect damage = frame_rect;
+  if (last_layer_tree_ && !damage_history_.empty()) {
+    SkRect device_damage =
+        SkRect::Make(layer_tree.ComputeDamage(*last_layer_tree_));
+    device_matrix.mapRect(&device_damage);
+    damage = device_damage.roundOut();
+    if (!damage.intersect(frame_rect)) {
+      damage.setEmpty();
+    }
+  }
+
+  damage_history_.push_front(damage);
+  if (damage_history_.size() > kMaxDamageHistory) {
+    damage_history_.pop_back();
+  }
+
+  if (buffer_age == 0 || buffer_age > damage_history_.size()) {
+    return frame_rect;
+  }
+
+  // The buffer holds the frame drawn |buffer_age| frames ago. It is missing
+  // the damage of all frames since.
+  SkIRect repaint_rect = SkIRect::MakeEmpty();
+  for (size_t i = 0; i < buffer_age; i++) {
+    repaint_rect.join(damage_history_[i]);
+  }
+  return repaint_rect;
 }
 
 }  // namespace shell
@@ -5,7 +5,12 @@
 #ifndef SHELL_GPU_DIRECT_GPU_RASTERIZER_H_
 #define SHELL_GPU_DIRECT_GPU_RASTERIZER_H_
 
+#include <deque>
+#include <functional>
+
 #include "flutter/flow/compositor_context.h"
+#include "flutter/shell/common/frame_timing_log.h"
+#include "flutter/shell/common/memory_budget.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "lib/ftl/memory/weak_ptr.h"
 #include "lib/ftl/synchronization/waitable_event.h"
@@ -33,17 +38,62 @@ class GPURasterizer : public Rasterizer {
 
   flow::LayerTree* GetLastLayerTree() override;
 
+  const flow::FrameTimingHistory* GetFrameTimings() override;
+
   void Draw(ftl::RefPtr<flutter::Pipeline<flow::LayerTree>> pipeline) override;
 
+  const flow::Counter& dropped_frame_count() const {
+    return dropped_frame_count_;
+  }
+
+  // Called on the GPU thread for every frame drawn with the time the UI
+  // thread took to build its layer tree and the time it took to rasterize.
+  using FrameTimingsCallback =
+      std::function<void(ftl::TimeDelta build_time,
+                         ftl::TimeDelta raster_time)>;
+
+  // Must be called before the first frame is drawn or on the GPU thread.
+  void SetFrameTimingsCallback(FrameTimingsCallback callback);
+
  private:
   std::unique_ptr<Surface> surface_;
   flow::CompositorContext compositor_context_;
   std::unique_ptr<flow::LayerTree> last_layer_tree_;
+  const bool partial_repaint_enabled_;
+  // The damage of the most recently drawn frames, newest first. Empty if the
+  // contents of the previous frame are unknown.
+  std::deque<SkIRect> damage_history_;
+  const bool skip_stale_frames_;
+  // Frames dropped unrasterized because a newer one was already queued up.
+  flow::Counter dropped_frame_count_;
+  bool raster_cache_population_pending_;
+  FrameTimingsCallback frame_timings_callback_;
+  std::unique_ptr<FrameTimingLog> frame_timing_log_;
+  MemoryBudget::ClientId raster_cache_budget_id_;
+  MemoryBudget::ClientId gpu_resources_budget_id_;
   ftl::WeakPtrFactory<GPURasterizer> weak_factory_;
 
   void DoDraw(std::unique_ptr<flow::LayerTree> layer_tree);
 
-  void DrawToSurface(flow::LayerTree& layer_tree);
+  bool DrawToSurface(flow::LayerTree& layer_tree);
+
+  // Returns the region of a frame with the given buffer age that must be
+  // repainted to draw |layer_tree|, in the device pixels of a canvas of
+  // |device_size| that maps the layer tree through |device_matrix|.
+  SkIRect ComputeRepaintRect(const flow::LayerTree& layer_tree,
+                             const SkMatrix& device_matrix,
+                             const SkISize& device_size,
+                             size_t buffer_age);
+
+  void SchedulePopulateRasterCache();
+
+  void PopulateRasterCache();
+
+  void TrimRasterCache(MemoryTrimLevel level);
+
+  void TrimGpuResources(MemoryTrimLevel level);
+
+  void ReportMemoryUsage();
 
   FTL_DISALLOW_COPY_AND_ASSIGN(GPURasterizer);
 };
@@ -86,13 +86,17 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceGL::AcquireFrame(const SkISize& size) {
 
   SurfaceFrame::SubmitCallback submit_callback = [weak_this](
       const SurfaceFrame& surface_frame, SkCanvas* canvas) {
-    return weak_this ? weak_this->PresentSurface(canvas) : false;
+    return weak_this ? weak_this->PresentSurface(surface_frame, canvas)
+                     : false;
   };
 
-  return std::make_unique<SurfaceFrame>(surface, submit_callback);
+  auto frame = std::make_unique<SurfaceFrame>(surface, submit_callback);
+  frame->set_buffer_age(delegate_->GLContextBufferAge());
+  return frame;
 }
 
-bool GPUSurfaceGL::PresentSurface(SkCanvas* canvas) {
+bool GPUSurfaceGL::PresentSurface(const SurfaceFrame& frame,
+                                  SkCanvas* canvas) {
   if (delegate_ == nullptr || canvas == nullptr) {
     return false;
   }
@@ -102,6 +106,16 @@ bool GPUSurfaceGL::PresentSurface(SkCanvas* canvas) {
     canvas->flush();
   }
 
+  if (frame.has_damage()) {
+    // The surface is created with a bottom left origin while the damage is
+    // measured from the top left.
+    const SkIRect& damage = frame.damage();
+    const int height = frame.SkiaSurface()->height();
+    delegate_->GLContextSetDamageRegion(SkIRect::MakeLTRB(
+        damage.left(), height - damage.bottom(), damage.right(),
+        height - damage.top()));
+  }
+
   delegate_->GLContextPresent();
 
   return true;
@@ -171,4 +185,8 @@ GrContext* GPUSurfaceGL::GetContext() {
   return context_.get();
 }
 
+bool GPUSurfaceGL::MakeRenderContextCurrent() {
+  return delegate_->GLContextMakeCurrent();
+}
+
 }  // namespace shell
@@ -23,6 +23,15 @@ class GPUSurfaceGLDelegate {
 
   virtual intptr_t GLContextFBO() const = 0;
 
+  // The age of the buffer the next frame will be drawn into as defined by
+  // EGL_EXT_buffer_age. Zero if the contents of the buffer are undefined.
+  virtual size_t GLContextBufferAge() { return 0; }
+
+  // The region the next |GLContextPresent| changes, in window coordinates
+  // with the origin at the bottom left. Presents without a region set change
+  // the whole window.
+  virtual void GLContextSetDamageRegion(const SkIRect& region) {}
+
   // TODO: Update Mac desktop and make this pure virtual.
   virtual sk_sp<SkColorSpace> ColorSpace() const { return nullptr; }
 };
@@ -41,6 +50,8 @@ class GPUSurfaceGL : public Surface {
 
   GrContext* GetContext() override;
 
+  bool MakeRenderContextCurrent() override;
+
  private:
   GPUSurfaceGLDelegate* delegate_;
   sk_sp<GrContext> context_;
@@ -51,7 +62,7 @@ class GPUSurfaceGL : public Surface {
 
   sk_sp<SkSurface> AcquireSurface(const SkISize& size);
 
-  bool PresentSurface(SkCanvas* canvas);
+  bool PresentSurface(const SurfaceFrame& frame, SkCanvas* canvas);
 
   bool SelectPixelConfig(GrPixelConfig* config);
 
@@ -5,12 +5,42 @@
 #include "flutter/shell/gpu/gpu_surface_software.h"
 
 #include <memory>
+#include <vector>
+
+#include "flutter/common/settings.h"
+#include "flutter/glue/trace_event.h"
 #include "lib/ftl/logging.h"
+#include "third_party/skia/include/core/SkBBHFactory.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkPixmap.h"
 
 namespace shell {
+namespace {
+
+constexpr int kDefaultTileSize = 256;
+
+int TileSizeFromSettings(const blink::Settings& settings) {
+  return settings.software_raster_tile_size > 0
+             ? settings.software_raster_tile_size
+             : kDefaultTileSize;
+}
+
+}  // namespace
 
 GPUSurfaceSoftware::GPUSurfaceSoftware(GPUSurfaceSoftwareDelegate* delegate)
-    : delegate_(delegate), weak_factory_(this) {}
+    : GPUSurfaceSoftware(delegate,
+                         blink::Settings::Get().software_raster_worker_count,
+                         TileSizeFromSettings(blink::Settings::Get())) {}
+
+GPUSurfaceSoftware::GPUSurfaceSoftware(GPUSurfaceSoftwareDelegate* delegate,
+                                       size_t raster_worker_count,
+                                       int tile_size)
+    : delegate_(delegate), tile_size_(tile_size), weak_factory_(this) {
+  if (raster_worker_count > 0 && tile_size_ > 0) {
+    raster_worker_pool_ =
+        std::make_unique<flow::PrerollWorkerPool>(raster_worker_count);
+  }
+}
 
 GPUSurfaceSoftware::~GPUSurfaceSoftware() = default;
 
@@ -47,6 +77,12 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
     return nullptr;
   }
 
+  if (raster_worker_pool_) {
+    auto frame = AcquireTiledFrame(std::move(backing_store), scale);
+    frame->set_buffer_age(delegate_->BackingStoreAge());
+    return frame;
+  }
+
   // If the surface has been scaled, we need to apply the inverse scaling to the
   // underlying canvas so that coordinates are mapped to the same spot
   // irrespective of surface scaling.
@@ -68,7 +104,102 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
     return self->delegate_->PresentBackingStore(surface_frame.SkiaSurface());
   };
 
-  return std::make_unique<SurfaceFrame>(backing_store, on_submit);
+  auto frame = std::make_unique<SurfaceFrame>(backing_store, on_submit);
+  frame->set_buffer_age(delegate_->BackingStoreAge());
+  return frame;
+}
+
+std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireTiledFrame(
+    sk_sp<SkSurface> backing_store,
+    double scale) {
+  // The frame is recorded in full before any tile is rasterized. The bounding
+  // box hierarchy lets each tile skip the operations that miss it.
+  SkRTreeFactory rtree_factory;
+  auto recorder = std::make_shared<SkPictureRecorder>();
+  SkCanvas* canvas = recorder->beginRecording(
+      SkRect::MakeIWH(backing_store->width(), backing_store->height()),
+      &rtree_factory);
+  canvas->scale(scale, scale);
+
+  SurfaceFrame::SubmitCallback
+      on_submit = [ self = weak_factory_.GetWeakPtr(), recorder ](
+                      const SurfaceFrame& surface_frame, SkCanvas* canvas)
+                      ->bool {
+    if (!self || !self->IsValid() || canvas == nullptr) {
+      return false;
+    }
+
+    // Whatever the frame is still clipped to when submitted bounds the
+    // pixels it may touch.
+    SkIRect clip;
+    if (!canvas->getDeviceClipBounds(&clip)) {
+      clip.setEmpty();
+    }
+
+    sk_sp<SkPicture> picture = recorder->finishRecordingAsPicture();
+    sk_sp<SkSurface> backing_store = surface_frame.SkiaSurface();
+    if (picture) {
+      self->RasterizeTiles(*picture, clip, backing_store.get());
+    }
+
+    backing_store->getCanvas()->flush();
+
+    return self->delegate_->PresentBackingStore(std::move(backing_store));
+  };
+
+  return std::make_unique<SurfaceFrame>(std::move(backing_store), canvas,
+                                        on_submit);
+}
+
+void GPUSurfaceSoftware::RasterizeTiles(const SkPicture& picture,
+                                        const SkIRect& clip,
+                                        SkSurface* backing_store) {
+  TRACE_EVENT0("flutter", "GPUSurfaceSoftware::RasterizeTiles");
+
+  SkPixmap pixmap;
+  if (!backing_store->peekPixels(&pixmap)) {
+    // Only raster backing stores can be shared between threads.
+    backing_store->getCanvas()->drawPicture(&picture);
+    return;
+  }
+
+  SkIRect bounds = SkIRect::MakeWH(pixmap.width(), pixmap.height());
+  if (!bounds.intersect(clip)) {
+    return;
+  }
+
+  // Tiles are laid out on a fixed grid so that a pixel is always drawn by
+  // the same tile, whatever the clip.
+  std::vector<SkIRect> tiles;
+  const int left = bounds.left() - bounds.left() % tile_size_;
+  const int top = bounds.top() - bounds.top() % tile_size_;
+  for (int y = top; y < bounds.bottom(); y += tile_size_) {
+    for (int x = left; x < bounds.right(); x += tile_size_) {
+      SkIRect tile = SkIRect::MakeXYWH(x, y, tile_size_, tile_size_);
+      if (tile.intersect(bounds)) {
+        tiles.push_back(tile);
+      }
+    }
+  }
+
+  // Each tile is drawn through a canvas of its own onto pixels no other tile
+  // touches. Pictures may be played back on several threads at once.
+  raster_worker_pool_->ParallelFor(
+      tiles.size(), [&picture, &pixmap, &tiles](size_t index) {
+        const SkIRect& tile = tiles[index];
+        SkPixmap tile_pixmap;
+        if (!pixmap.extractSubset(&tile_pixmap, tile)) {
+          return;
+        }
+        std::unique_ptr<SkCanvas> canvas = SkCanvas::MakeRasterDirect(
+            tile_pixmap.info(), tile_pixmap.writable_addr(),
+            tile_pixmap.rowBytes());
+        if (!canvas) {
+          return;
+        }
+        canvas->translate(-tile.x(), -tile.y());
+        canvas->drawPicture(&picture);
+      });
 }
 
 GrContext* GPUSurfaceSoftware::GetContext() {
@@ -5,9 +5,13 @@
 #ifndef FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_H_
 #define FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_H_
 
+#include <memory>
+
+#include "flutter/flow/preroll_worker_pool.h"
 #include "flutter/shell/common/surface.h"
 #include "lib/ftl/macros.h"
 #include "lib/ftl/memory/weak_ptr.h"
+#include "third_party/skia/include/core/SkPicture.h"
 #include "third_party/skia/include/core/SkSurface.h"
 
 namespace shell {
@@ -16,12 +20,26 @@ class GPUSurfaceSoftwareDelegate {
  public:
   virtual sk_sp<SkSurface> AcquireBackingStore(const SkISize& size) = 0;
   virtual bool PresentBackingStore(sk_sp<SkSurface> backing_store) = 0;
+
+  // The number of frames since the contents of the backing store returned by
+  // the last call to |AcquireBackingStore| were presented. Zero if its
+  // contents are undefined.
+  virtual size_t BackingStoreAge() { return 0; }
 };
 
 class GPUSurfaceSoftware : public Surface {
  public:
+  // Rasterizes as configured by the software raster settings.
   GPUSurfaceSoftware(GPUSurfaceSoftwareDelegate* delegate);
 
+  // With a non-zero |raster_worker_count| and |tile_size|, frames are
+  // recorded and then rasterized in square tiles of |tile_size| pixels by
+  // the thread submitting them together with |raster_worker_count| others.
+  // Otherwise, frames are rasterized directly into the backing store.
+  GPUSurfaceSoftware(GPUSurfaceSoftwareDelegate* delegate,
+                     size_t raster_worker_count,
+                     int tile_size);
+
   ~GPUSurfaceSoftware() override;
 
   bool Setup() override;
@@ -36,9 +54,22 @@ class GPUSurfaceSoftware : public Surface {
 
  private:
   GPUSurfaceSoftwareDelegate* delegate_;
+  const int tile_size_;
+  // Null unless frames are rasterized in tiles.
+  std::unique_ptr<flow::PrerollWorkerPool> raster_worker_pool_;
 
   ftl::WeakPtrFactory<GPUSurfaceSoftware> weak_factory_;
 
+  std::unique_ptr<SurfaceFrame> AcquireTiledFrame(
+      sk_sp<SkSurface> backing_store,
+      double scale);
+
+  // Plays |picture| back into the pixels of |backing_store| that lie within
+  // |clip|, one tile per task.
+  void RasterizeTiles(const SkPicture& picture,
+                      const SkIRect& clip,
+                      SkSurface* backing_store);
+
   FTL_DISALLOW_COPY_AND_ASSIGN(GPUSurfaceSoftware);
 };
 
@@ -0,0 +1,143 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/gpu/gpu_surface_software.h"
+
+#include "third_party/gtest/include/gtest/gtest.h"
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkPixmap.h"
+#include "third_party/skia/include/core/SkRRect.h"
+#include "third_party/skia/include/effects/SkGradientShader.h"
+
+namespace {
+
+constexpr int kFrameWidth = 300;
+constexpr int kFrameHeight = 200;
+
+class OffscreenDelegate : public shell::GPUSurfaceSoftwareDelegate {
+ public:
+  sk_sp<SkSurface> AcquireBackingStore(const SkISize& size) override {
+    if (!backing_store_ || backing_store_->width() != size.width() ||
+        backing_store_->height() != size.height()) {
+      backing_store_ = SkSurface::MakeRaster(
+          SkImageInfo::MakeN32Premul(size.width(), size.height()));
+      backing_store_->getCanvas()->clear(SK_ColorTRANSPARENT);
+    }
+    return backing_store_;
+  }
+
+  bool PresentBackingStore(sk_sp<SkSurface> backing_store) override {
+    return backing_store != nullptr;
+  }
+
+  SkSurface* backing_store() const { return backing_store_.get(); }
+
+ private:
+  sk_sp<SkSurface> backing_store_;
+};
+
+// Antialiased shapes, gradients and strokes that cross the tile grid.
+void DrawFrame(SkCanvas* canvas, const SkRect* clip) {
+  if (clip) {
+    canvas->clipRect(*clip, true);
+  }
+  canvas->clear(SK_ColorWHITE);
+
+  const SkColor colors[] = {SK_ColorBLUE, SK_ColorCYAN};
+  for (int y = 0; y < kFrameHeight; y += 45) {
+    for (int x = 0; x < kFrameWidth; x += 70) {
+      const SkRect card = SkRect::MakeXYWH(x + 3.5f, y + 2.25f, 61, 38);
+      const SkPoint points[] = {{card.left(), card.top()},
+                                {card.right(), card.bottom()}};
+
+      SkPaint fill;
+      fill.setAntiAlias(true);
+      fill.setShader(SkGradientShader::MakeLinear(
+          points, colors, nullptr, 2, SkShader::kClamp_TileMode));
+      canvas->drawRRect(SkRRect::MakeRectXY(card, 6, 6), fill);
+
+      SkPaint stroke;
+      stroke.setAntiAlias(true);
+      stroke.setStyle(SkPaint::kStroke_Style);
+      stroke.setStrokeWidth(2.5f);
+      stroke.setColor(SK_ColorRED);
+      SkPath path;
+      path.moveTo(card.left(), card.bottom());
+      path.cubicTo(card.left() + 20, card.top(), card.right() - 20,
+                   card.bottom(), card.right(), card.top());
+      canvas->drawPath(path, stroke);
+    }
+  }
+}
+
+void DrawWithSurface(shell::GPUSurfaceSoftware* surface,
+                     double scale,
+                     const SkRect* clip) {
+  surface->SetScale(scale);
+  auto frame = surface->AcquireFrame(SkISize::Make(kFrameWidth, kFrameHeight));
+  ASSERT_TRUE(frame);
+  DrawFrame(frame->SkiaCanvas(), clip);
+  ASSERT_TRUE(frame->Submit());
+}
+
+void ExpectSamePixels(SkSurface* expected, SkSurface* actual) {
+  SkPixmap expected_pixels;
+  SkPixmap actual_pixels;
+  ASSERT_TRUE(expected->peekPixels(&expected_pixels));
+  ASSERT_TRUE(actual->peekPixels(&actual_pixels));
+  ASSERT_EQ(expected_pixels.width(), actual_pixels.width());
+  ASSERT_EQ(expected_pixels.height(), actual_pixels.height());
+
+  for (int y = 0; y < expected_pixels.height(); y++) {
+    for (int x = 0; x < expected_pixels.width(); x++) {
+      ASSERT_EQ(*expected_pixels.addr32(x, y), *actual_pixels.addr32(x, y))
+          << "at " << x << "," << y;
+    }
+  }
+}
+
+void ExpectTiledMatchesDirect(double scale, const SkRect* clip) {
+  OffscreenDelegate direct_delegate;
+  shell::GPUSurfaceSoftware direct(&direct_delegate, 0, 0);
+  DrawWithSurface(&direct, scale, clip);
+
+  OffscreenDelegate tiled_delegate;
+  shell::GPUSurfaceSoftware tiled(&tiled_delegate, 3, 64);
+  DrawWithSurface(&tiled, scale, clip);
+
+  ExpectSamePixels(direct_delegate.backing_store(),
+                   tiled_delegate.backing_store());
+}
+
+}  // namespace
+
+TEST(GPUSurfaceSoftware, TiledFrameMatchesDirectFrame) {
+  ExpectTiledMatchesDirect(1.0, nullptr);
+}
+
+TEST(GPUSurfaceSoftware, TiledFrameMatchesDirectFrameWhenScaled) {
+  ExpectTiledMatchesDirect(1.5, nullptr);
+}
+
+TEST(GPUSurfaceSoftware, TiledFrameMatchesDirectFrameWithinClip) {
+  // Neither edge of the clip falls on the 64 pixel tile grid, and the
+  // antialiased clip covers partial pixels.
+  const SkRect clip = SkRect::MakeLTRB(37.5f, 41.25f, 203.75f, 177.5f);
+  ExpectTiledMatchesDirect(1.0, &clip);
+}
+
+TEST(GPUSurfaceSoftware, TiledFrameLeavesPixelsOutsideClipUntouched) {
+  const SkRect clip = SkRect::MakeLTRB(70, 10, 131, 150);
+  OffscreenDelegate delegate;
+  shell::GPUSurfaceSoftware tiled(&delegate, 2, 64);
+  DrawWithSurface(&tiled, 1.0, &clip);
+
+  SkPixmap pixels;
+  ASSERT_TRUE(delegate.backing_store()->peekPixels(&pixels));
+  ASSERT_EQ(*pixels.addr32(69, 80), 0u);
+  ASSERT_EQ(*pixels.addr32(131, 80), 0u);
+  ASSERT_EQ(*pixels.addr32(100, 9), 0u);
+  ASSERT_EQ(*pixels.addr32(100, 150), 0u);
+  ASSERT_NE(*pixels.addr32(100, 80), 0u);
+}
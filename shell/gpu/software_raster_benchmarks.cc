@@ -0,0 +1,132 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures software rasterization of a busy phone-sized frame through
+// GPUSurfaceSoftware for a varying number of raster workers and tile sizes.
+// Zero workers rasterize directly into the backing store as before.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <thread>
+
+#include "flutter/shell/gpu/gpu_surface_software.h"
+#include "lib/ftl/time/time_delta.h"
+#include "lib/ftl/time/time_point.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/effects/SkGradientShader.h"
+
+namespace {
+
+constexpr int kFrameWidth = 1080;
+constexpr int kFrameHeight = 1920;
+constexpr size_t kIterations = 50;
+
+class OffscreenDelegate : public shell::GPUSurfaceSoftwareDelegate {
+ public:
+  sk_sp<SkSurface> AcquireBackingStore(const SkISize& size) override {
+    if (!backing_store_ || backing_store_->width() != size.width() ||
+        backing_store_->height() != size.height()) {
+      backing_store_ = SkSurface::MakeRaster(
+          SkImageInfo::MakeN32Premul(size.width(), size.height()));
+    }
+    return backing_store_;
+  }
+
+  bool PresentBackingStore(sk_sp<SkSurface> backing_store) override {
+    return backing_store != nullptr;
+  }
+
+ private:
+  sk_sp<SkSurface> backing_store_;
+};
+
+// A scrolling list of cards: gradient filled rounded rectangles with stroked
+// circles and paths on top.
+sk_sp<SkPicture> MakeFrameContents() {
+  SkPictureRecorder recorder;
+  SkCanvas* canvas =
+      recorder.beginRecording(SkRect::MakeWH(kFrameWidth, kFrameHeight));
+
+  canvas->clear(SK_ColorWHITE);
+
+  const SkColor colors[] = {SK_ColorBLUE, SK_ColorCYAN};
+  for (int y = 0; y < kFrameHeight; y += 60) {
+    for (int x = 0; x < kFrameWidth; x += 120) {
+      const SkRect card = SkRect::MakeXYWH(x + 4, y + 4, 112, 52);
+      const SkPoint points[] = {{card.left(), card.top()},
+                                {card.right(), card.bottom()}};
+
+      SkPaint fill;
+      fill.setAntiAlias(true);
+      fill.setShader(SkGradientShader::MakeLinear(
+          points, colors, nullptr, 2, SkShader::kClamp_TileMode));
+      canvas->drawRRect(SkRRect::MakeRectXY(card, 8, 8), fill);
+
+      SkPaint stroke;
+      stroke.setAntiAlias(true);
+      stroke.setStyle(SkPaint::kStroke_Style);
+      stroke.setStrokeWidth(3);
+      stroke.setColor(SK_ColorWHITE);
+      canvas->drawCircle(card.left() + 26, card.centerY(), 18, stroke);
+
+      SkPath path;
+      path.moveTo(card.left() + 52, card.bottom() - 10);
+      path.cubicTo(card.left() + 70, card.top(), card.left() + 90,
+                   card.bottom(), card.right() - 8, card.top() + 10);
+      canvas->drawPath(path, stroke);
+    }
+  }
+
+  return recorder.finishRecordingAsPicture();
+}
+
+ftl::TimeDelta MeasureFrames(const SkPicture& contents,
+                             size_t worker_count,
+                             int tile_size) {
+  OffscreenDelegate delegate;
+  shell::GPUSurfaceSoftware surface(&delegate, worker_count, tile_size);
+
+  ftl::TimeDelta total = ftl::TimeDelta::Zero();
+  for (size_t i = 0; i < kIterations; i++) {
+    const auto start = ftl::TimePoint::Now();
+    auto frame = surface.AcquireFrame(SkISize::Make(kFrameWidth, kFrameHeight));
+    // Played back the way the layer tree would paint, op by op, rather than
+    // nested as a single picture.
+    contents.playback(frame->SkiaCanvas());
+    frame->Submit();
+    total = total + (ftl::TimePoint::Now() - start);
+  }
+  return total;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  sk_sp<SkPicture> contents = MakeFrameContents();
+
+  const size_t max_workers =
+      std::max<size_t>(std::thread::hardware_concurrency(), 1) - 1;
+
+  printf("%dx%d frame, %zu iterations\n", kFrameWidth, kFrameHeight,
+         kIterations);
+  printf("%8s %10s %18s %10s\n", "workers", "tile", "frame (ms)", "speedup");
+
+  const double direct_ms =
+      MeasureFrames(*contents, 0, 0).ToMillisecondsF() / kIterations;
+  printf("%8d %10s %18.2f %9.2fx\n", 0, "-", direct_ms, 1.0);
+
+  for (size_t workers = 1; workers <= std::max<size_t>(max_workers, 1);
+       workers *= 2) {
+    for (int tile_size : {64, 128, 256, 512}) {
+      const double ms =
+          MeasureFrames(*contents, workers, tile_size).ToMillisecondsF() /
+          kIterations;
+      printf("%8zu %10d %18.2f %9.2fx\n", workers, tile_size, ms,
+             direct_ms / ms);
+    }
+  }
+
+  return 0;
+}
@@ -14,6 +14,10 @@
 #define EGL_GL_COLORSPACE_SRGB_KHR 0x3089
 #endif
 
+#ifndef EGL_BUFFER_AGE_EXT
+#define EGL_BUFFER_AGE_EXT 0x313D
+#endif
+
 namespace shell {
 
 template <class T>
@@ -183,6 +187,10 @@ AndroidContextGL::AndroidContextGL(ftl::RefPtr<AndroidEnvironmentGL> env,
       config_(nullptr),
       surface_(EGL_NO_SURFACE),
       context_(EGL_NO_CONTEXT),
+      buffer_age_support_(false),
+      swap_buffers_with_damage_(nullptr),
+      has_damage_region_(false),
+      damage_region_(SkIRect::MakeEmpty()),
       valid_(false) {
   if (!environment_->IsValid()) {
     return;
@@ -218,6 +226,12 @@ AndroidContextGL::AndroidContextGL(ftl::RefPtr<AndroidEnvironmentGL> env,
 
   const char* exts = eglQueryString(environment_->Display(), EGL_EXTENSIONS);
   srgb_support_ = strstr(exts, "EGL_KHR_gl_colorspace");
+  buffer_age_support_ = strstr(exts, "EGL_EXT_buffer_age");
+  if (strstr(exts, "EGL_KHR_swap_buffers_with_damage")) {
+    swap_buffers_with_damage_ =
+        reinterpret_cast<PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC>(
+            eglGetProcAddress("eglSwapBuffersWithDamageKHR"));
+  }
 
   if (!this->CreatePBufferSurface()) {
     FTL_LOG(ERROR) << "Could not create the EGL surface.";
@@ -271,6 +285,14 @@ bool AndroidContextGL::ClearCurrent() {
 
 bool AndroidContextGL::SwapBuffers() {
   TRACE_EVENT0("flutter", "AndroidContextGL::SwapBuffers");
+  if (has_damage_region_ && swap_buffers_with_damage_ != nullptr) {
+    has_damage_region_ = false;
+    EGLint rect[4] = {damage_region_.x(), damage_region_.y(),
+                      damage_region_.width(), damage_region_.height()};
+    return swap_buffers_with_damage_(environment_->Display(), surface_, rect,
+                                     1);
+  }
+  has_damage_region_ = false;
   return eglSwapBuffers(environment_->Display(), surface_);
 }
 
@@ -311,4 +333,23 @@ bool AndroidContextGL::SupportsSRGB() const {
   return srgb_support_;
 }
 
+void AndroidContextGL::SetDamageRegion(const SkIRect& region) {
+  damage_region_ = region;
+  has_damage_region_ = true;
+}
+
+size_t AndroidContextGL::GetBufferAge() {
+  if (!buffer_age_support_ || window_ == nullptr) {
+    return 0;
+  }
+
+  EGLint age = 0;
+  if (!eglQuerySurface(environment_->Display(), surface_, EGL_BUFFER_AGE_EXT,
+                       &age)) {
+    LogLastEGLError();
+    return 0;
+  }
+  return age > 0 ? age : 0;
+}
+
 }  // namespace shell
@@ -5,12 +5,15 @@
 #ifndef FLUTTER_SHELL_PLATFORM_ANDROID_ANDROID_CONTEXT_GL_H_
 #define FLUTTER_SHELL_PLATFORM_ANDROID_ANDROID_CONTEXT_GL_H_
 
+#include <EGL/eglext.h>
+
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/platform/android/android_environment_gl.h"
 #include "flutter/shell/platform/android/android_native_window.h"
 #include "lib/ftl/macros.h"
 #include "lib/ftl/memory/ref_counted.h"
 #include "lib/ftl/memory/ref_ptr.h"
+#include "third_party/skia/include/core/SkRect.h"
 #include "third_party/skia/include/core/SkSize.h"
 
 namespace shell {
@@ -38,6 +41,15 @@ class AndroidContextGL : public ftl::RefCountedThreadSafe<AndroidContextGL> {
 
   bool SupportsSRGB() const;
 
+  // The age of the back buffer of the window surface as defined by
+  // EGL_EXT_buffer_age, or zero if it is unknown.
+  size_t GetBufferAge();
+
+  // Limits the next |SwapBuffers| to |region|, in window coordinates with the
+  // origin at the bottom left, where EGL_KHR_swap_buffers_with_damage is
+  // supported.
+  void SetDamageRegion(const SkIRect& region);
+
  private:
   ftl::RefPtr<AndroidEnvironmentGL> environment_;
   ftl::RefPtr<AndroidNativeWindow> window_;
@@ -45,6 +57,10 @@ class AndroidContextGL : public ftl::RefCountedThreadSafe<AndroidContextGL> {
   EGLSurface surface_;
   EGLContext context_;
   bool srgb_support_;
+  bool buffer_age_support_;
+  PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC swap_buffers_with_damage_;
+  bool has_damage_region_;
+  SkIRect damage_region_;
   bool valid_;
 
   AndroidContextGL(ftl::RefPtr<AndroidEnvironmentGL> env,
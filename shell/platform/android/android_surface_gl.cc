@@ -154,6 +154,16 @@ intptr_t AndroidSurfaceGL::GLContextFBO() const {
   return 0;
 }
 
+size_t AndroidSurfaceGL::GLContextBufferAge() {
+  FTL_DCHECK(onscreen_context_ && onscreen_context_->IsValid());
+  return onscreen_context_->GetBufferAge();
+}
+
+void AndroidSurfaceGL::GLContextSetDamageRegion(const SkIRect& region) {
+  FTL_DCHECK(onscreen_context_ && onscreen_context_->IsValid());
+  onscreen_context_->SetDamageRegion(region);
+}
+
 void AndroidSurfaceGL::SetFlutterView(
     const fml::jni::JavaObjectWeakGlobalRef& flutter_view) {}
 
@@ -47,6 +47,10 @@ class AndroidSurfaceGL : public GPUSurfaceGLDelegate, public AndroidSurface {
 
   intptr_t GLContextFBO() const override;
 
+  size_t GLContextBufferAge() override;
+
+  void GLContextSetDamageRegion(const SkIRect& region) override;
+
   sk_sp<SkColorSpace> ColorSpace() const override {
     // TODO:
     // We can render more consistently across devices when Android makes it
@@ -212,7 +212,9 @@ public final class FlutterActivityDelegate
         // Use a trim level delivered while the application is running so the
         // framework has a chance to react to the notification.
         if (level == TRIM_MEMORY_RUNNING_LOW) {
-            flutterView.onMemoryPressure();
+            flutterView.onMemoryPressure("moderate");
+        } else if (level == TRIM_MEMORY_RUNNING_CRITICAL) {
+            flutterView.onMemoryPressure("critical");
         }
     }
 
@@ -242,8 +242,19 @@ public class FlutterView extends SurfaceView
     }
 
     public void onMemoryPressure() {
-        Map<String, Object> message = new HashMap<>(1);
+        onMemoryPressure("critical");
+    }
+
+    /**
+     * Asks the engine and the framework to release memory.
+     *
+     * @param level either "moderate", to release what has not been used
+     *     recently, or "critical", to release everything that can be recreated.
+     */
+    public void onMemoryPressure(String level) {
+        Map<String, Object> message = new HashMap<>(2);
         message.put("type", "memoryPressure");
+        message.put("level", level);
         mFlutterSystemChannel.send(message);
     }
 
@@ -33,7 +33,7 @@ class PlatformMessageResponseAndroid : public blink::PlatformMessageResponse {
   FRIEND_MAKE_REF_COUNTED(PlatformMessageResponseAndroid);
 
  public:
-  void Complete(std::vector<uint8_t> data) override {
+  void Complete(ftl::RefPtr<blink::PlatformMessageBuffer> data) override {
     ftl::RefPtr<PlatformMessageResponseAndroid> self(this);
     blink::Threads::Platform()->PostTask(
         ftl::MakeCopyable([ self, data = std::move(data) ]() mutable {
@@ -304,11 +304,10 @@ void PlatformViewAndroid::InvokePlatformMessageResponseCallback(
     return;
   uint8_t* response_data =
       static_cast<uint8_t*>(env->GetDirectBufferAddress(java_response_data));
-  std::vector<uint8_t> response = std::vector<uint8_t>(
-      response_data, response_data + java_response_position);
   auto message_response = std::move(it->second);
   pending_responses_.erase(it);
-  message_response->Complete(std::move(response));
+  message_response->Complete(
+      blink::PlatformMessageBuffer::Copy(response_data, java_response_position));
 }
 
 void PlatformViewAndroid::InvokePlatformMessageEmptyResponseCallback(
@@ -359,7 +358,7 @@ void PlatformViewAndroid::HandlePlatformMessage(
 
 void PlatformViewAndroid::HandlePlatformMessageResponse(
     int response_id,
-    std::vector<uint8_t> data) {
+    ftl::RefPtr<blink::PlatformMessageBuffer> data) {
   JNIEnv* env = fml::jni::AttachCurrentThread();
 
   fml::jni::ScopedJavaLocalRef<jobject> view = flutter_view_.get(env);
@@ -367,9 +366,9 @@ void PlatformViewAndroid::HandlePlatformMessageResponse(
   if (view.is_null())
     return;
   fml::jni::ScopedJavaLocalRef<jbyteArray> data_array(
-      env, env->NewByteArray(data.size()));
-  env->SetByteArrayRegion(data_array.obj(), 0, data.size(),
-                          reinterpret_cast<const jbyte*>(data.data()));
+      env, env->NewByteArray(data->size()));
+  env->SetByteArrayRegion(data_array.obj(), 0, data->size(),
+                          reinterpret_cast<const jbyte*>(data->data()));
 
   FlutterViewHandlePlatformMessageResponse(env, view.obj(), response_id,
                                            data_array.obj());
@@ -88,8 +88,9 @@ class PlatformViewAndroid : public PlatformView {
   void HandlePlatformMessage(
       ftl::RefPtr<blink::PlatformMessage> message) override;
 
-  void HandlePlatformMessageResponse(int response_id,
-                                     std::vector<uint8_t> data);
+  void HandlePlatformMessageResponse(
+      int response_id,
+      ftl::RefPtr<blink::PlatformMessageBuffer> data);
 
   void HandlePlatformMessageEmptyResponse(int response_id);
 
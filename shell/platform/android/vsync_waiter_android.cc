@@ -40,7 +40,7 @@ void VsyncWaiterAndroid::OnVsync(long frameTimeNanos) {
   Callback callback = std::move(callback_);
   callback_ = Callback();
 
-  blink::Threads::UI()->PostTask([callback, frameTimeNanos] {
+  blink::Threads::UIHighPriority()->PostTask([callback, frameTimeNanos] {
     callback(ftl::TimePoint::FromEpochDelta(
         ftl::TimeDelta::FromNanoseconds(frameTimeNanos)));
   });
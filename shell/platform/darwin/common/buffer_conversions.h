@@ -7,13 +7,16 @@
 
 #include <Foundation/Foundation.h>
 
-#include <vector>
+#include "flutter/lib/ui/window/platform_message_buffer.h"
 
 namespace shell {
 
-std::vector<uint8_t> GetVectorFromNSData(NSData* data);
+// Neither conversion copies the bytes. The buffer holds on to an immutable
+// copy of |data|, which for immutable NSData is |data| itself.
+ftl::RefPtr<blink::PlatformMessageBuffer> GetBufferFromNSData(NSData* data);
 
-NSData* GetNSDataFromVector(const std::vector<uint8_t>& buffer);
+// The returned NSData keeps |buffer| alive.
+NSData* GetNSDataFromBuffer(ftl::RefPtr<blink::PlatformMessageBuffer> buffer);
 
 }  // namespace shell
 
@@ -5,14 +5,43 @@
 #include "flutter/shell/platform/darwin/common/buffer_conversions.h"
 
 namespace shell {
+namespace {
 
-std::vector<uint8_t> GetVectorFromNSData(NSData* data) {
-  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.bytes);
-  return std::vector<uint8_t>(bytes, bytes + data.length);
+class NSDataMapping : public fml::Mapping {
+ public:
+  explicit NSDataMapping(NSData* data) : data_([data copy]) {}
+
+  ~NSDataMapping() override { [data_ release]; }
+
+  size_t GetSize() const override { return data_.length; }
+
+  const uint8_t* GetMapping() const override {
+    return static_cast<const uint8_t*>(data_.bytes);
+  }
+
+ private:
+  NSData* data_;
+
+  FTL_DISALLOW_COPY_AND_ASSIGN(NSDataMapping);
+};
+
+}  // namespace
+
+ftl::RefPtr<blink::PlatformMessageBuffer> GetBufferFromNSData(NSData* data) {
+  return blink::PlatformMessageBuffer::Create(
+      std::unique_ptr<fml::Mapping>(new NSDataMapping(data)));
 }
 
-NSData* GetNSDataFromVector(const std::vector<uint8_t>& buffer) {
-  return [NSData dataWithBytes:buffer.data() length:buffer.size()];
+NSData* GetNSDataFromBuffer(ftl::RefPtr<blink::PlatformMessageBuffer> buffer) {
+  void* bytes = const_cast<uint8_t*>(buffer->data());
+  const NSUInteger length = buffer->size();
+  return [[[NSData alloc] initWithBytesNoCopy:bytes
+                                       length:length
+                                  deallocator:^(void*, NSUInteger) {
+                                    // Releases the buffer along with the
+                                    // block.
+                                    (void)buffer;
+                                  }] autorelease];
 }
 
 }  // namespace shell
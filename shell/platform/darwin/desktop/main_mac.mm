@@ -31,6 +31,7 @@ int main(int argc, const char* argv[]) {
     if (!shell::InitForTesting(std::move(command_line)))
       return 1;
     fml::MessageLoop::GetCurrent().Run();
+    shell::Shell::Shared().StopTracingToFile();
     return EXIT_SUCCESS;
   } else {
     return NSApplicationMain(argc, argv);
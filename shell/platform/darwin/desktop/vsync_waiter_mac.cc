@@ -45,7 +45,7 @@ void VsyncWaiterMac::OnDisplayLink() {
   auto callback = std::move(callback_);
   callback_ = Callback();
 
-  blink::Threads::UI()->PostTask(
+  blink::Threads::UIHighPriority()->PostTask(
       [callback, frame_time] { callback(frame_time); });
 }
 
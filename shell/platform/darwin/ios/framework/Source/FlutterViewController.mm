@@ -30,11 +30,11 @@ class PlatformMessageResponseDarwin : public blink::PlatformMessageResponse {
   FRIEND_MAKE_REF_COUNTED(PlatformMessageResponseDarwin);
 
  public:
-  void Complete(std::vector<uint8_t> data) override {
+  void Complete(ftl::RefPtr<blink::PlatformMessageBuffer> data) override {
     ftl::RefPtr<PlatformMessageResponseDarwin> self(this);
     blink::Threads::Platform()->PostTask(
         ftl::MakeCopyable([ self, data = std::move(data) ]() mutable {
-          self->callback_.get()(shell::GetNSDataFromVector(data));
+          self->callback_.get()(shell::GetNSDataFromBuffer(std::move(data)));
         }));
   }
 
@@ -630,7 +630,7 @@ constexpr CGFloat kStandardStatusBarHeight = 20.0;
   ftl::RefPtr<blink::PlatformMessage> platformMessage =
       (message == nil) ? ftl::MakeRefCounted<blink::PlatformMessage>(channel.UTF8String, response)
                        : ftl::MakeRefCounted<blink::PlatformMessage>(
-                             channel.UTF8String, shell::GetVectorFromNSData(message), response);
+                             channel.UTF8String, shell::GetBufferFromNSData(message), response);
   _platformView->DispatchPlatformMessage(platformMessage);
 }
 
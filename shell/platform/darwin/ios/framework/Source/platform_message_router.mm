@@ -4,8 +4,6 @@
 
 #include "flutter/shell/platform/darwin/ios/framework/Source/platform_message_router.h"
 
-#include <vector>
-
 #include "flutter/shell/platform/darwin/common/buffer_conversions.h"
 
 namespace shell {
@@ -21,12 +19,12 @@ void PlatformMessageRouter::HandlePlatformMessage(ftl::RefPtr<blink::PlatformMes
     FlutterBinaryMessageHandler handler = it->second;
     NSData* data = nil;
     if (message->hasData()) {
-      data = GetNSDataFromVector(message->data());
+      data = GetNSDataFromBuffer(message->buffer());
     }
     handler(data, ^(NSData* reply) {
       if (completer) {
         if (reply) {
-          completer->Complete(GetVectorFromNSData(reply));
+          completer->Complete(GetBufferFromNSData(reply));
         } else {
           completer->CompleteEmpty();
         }
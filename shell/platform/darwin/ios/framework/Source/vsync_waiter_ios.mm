@@ -57,7 +57,7 @@
   //
   // We are not using the PostTask for thread switching, but to make task
   // observers work.
-  blink::Threads::UI()->PostTask([callback = _pendingCallback]() {
+  blink::Threads::UIHighPriority()->PostTask([callback = _pendingCallback]() {
     callback(ftl::TimePoint::Now());
   });
 
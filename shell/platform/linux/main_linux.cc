@@ -111,9 +111,21 @@ void RunNonInteractive(ftl::CommandLine initial_command_line,
     latch.Wait();
   }
 
+  int exit_code = ConvertErrorTypeToExitCode(error);
+
+  std::string frame_timings_path;
+  if (initial_command_line.GetOptionValue(
+          shell::FlagForSwitch(shell::Switch::FrameTimingsOutput),
+          &frame_timings_path) &&
+      !test_runner.WriteFrameTimings(frame_timings_path) && exit_code == 0) {
+    exit_code = kErrorExitCode;
+  }
+
+  shell::Shell::Shared().StopTracingToFile();
+
   // The script has completed and the engine may not be in a clean state,
   // so just stop the process.
-  exit(ConvertErrorTypeToExitCode(error));
+  exit(exit_code);
 }
 
 }  // namespace
@@ -0,0 +1,107 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/testing/frame_timings_recorder.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "lib/ftl/files/file.h"
+#include "third_party/rapidjson/rapidjson/stringbuffer.h"
+#include "third_party/rapidjson/rapidjson/writer.h"
+
+namespace shell {
+namespace {
+
+using Writer = rapidjson::Writer<rapidjson::StringBuffer>;
+
+// Nearest-rank percentile of an ascending list of times.
+ftl::TimeDelta Percentile(const std::vector<ftl::TimeDelta>& sorted,
+                          double percentile) {
+  if (sorted.empty())
+    return ftl::TimeDelta::Zero();
+  size_t rank = static_cast<size_t>(std::ceil(percentile * sorted.size()));
+  return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+void WriteDistribution(Writer& writer,
+                       const char* name,
+                       std::vector<ftl::TimeDelta> times) {
+  std::sort(times.begin(), times.end());
+
+  writer.Key(name);
+  writer.StartObject();
+  writer.Key("p50");
+  writer.Double(Percentile(times, 0.50).ToMillisecondsF());
+  writer.Key("p90");
+  writer.Double(Percentile(times, 0.90).ToMillisecondsF());
+  writer.Key("p99");
+  writer.Double(Percentile(times, 0.99).ToMillisecondsF());
+  writer.Key("max");
+  writer.Double(times.empty() ? 0.0 : times.back().ToMillisecondsF());
+  writer.EndObject();
+}
+
+}  // namespace
+
+FrameTimingsRecorder::FrameTimingsRecorder(ftl::TimeDelta frame_budget)
+    : frame_budget_(frame_budget) {}
+
+FrameTimingsRecorder::~FrameTimingsRecorder() = default;
+
+void FrameTimingsRecorder::AddFrame(ftl::TimeDelta build_time,
+                                    ftl::TimeDelta raster_time) {
+  ftl::MutexLocker lock(&mutex_);
+  build_times_.push_back(build_time);
+  raster_times_.push_back(raster_time);
+}
+
+std::string FrameTimingsRecorder::ToJSON() const {
+  std::vector<ftl::TimeDelta> build_times;
+  std::vector<ftl::TimeDelta> raster_times;
+  {
+    ftl::MutexLocker lock(&mutex_);
+    build_times = build_times_;
+    raster_times = raster_times_;
+  }
+
+  // The UI and GPU threads work on different frames at the same time, so a
+  // frame only misses its vsync if one of the two takes longer than a frame.
+  size_t missed_build = 0;
+  size_t missed_raster = 0;
+  size_t missed = 0;
+  for (size_t i = 0; i < build_times.size(); i++) {
+    const bool build_over = build_times[i] > frame_budget_;
+    const bool raster_over = raster_times[i] > frame_budget_;
+    missed_build += build_over;
+    missed_raster += raster_over;
+    missed += build_over || raster_over;
+  }
+
+  rapidjson::StringBuffer buffer;
+  Writer writer(buffer);
+  writer.StartObject();
+  writer.Key("frame_count");
+  writer.Uint64(build_times.size());
+  writer.Key("frame_budget_ms");
+  writer.Double(frame_budget_.ToMillisecondsF());
+  writer.Key("missed_frame_count");
+  writer.Uint64(missed);
+  writer.Key("missed_build_count");
+  writer.Uint64(missed_build);
+  writer.Key("missed_raster_count");
+  writer.Uint64(missed_raster);
+  WriteDistribution(writer, "build_time_ms", std::move(build_times));
+  WriteDistribution(writer, "raster_time_ms", std::move(raster_times));
+  writer.EndObject();
+
+  return std::string(buffer.GetString(), buffer.GetSize());
+}
+
+bool FrameTimingsRecorder::WriteJSON(const std::string& path) const {
+  const std::string json = ToJSON();
+  return files::WriteFile(path, json.data(), json.size());
+}
+
+}  // namespace shell
@@ -0,0 +1,49 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_TESTING_FRAME_TIMINGS_RECORDER_H_
+#define FLUTTER_SHELL_TESTING_FRAME_TIMINGS_RECORDER_H_
+
+#include <string>
+#include <vector>
+
+#include "lib/ftl/macros.h"
+#include "lib/ftl/synchronization/mutex.h"
+#include "lib/ftl/synchronization/thread_annotations.h"
+#include "lib/ftl/time/time_delta.h"
+
+namespace shell {
+
+// Collects the build and raster times of the frames drawn by the test shell
+// and summarizes them for benchmarks.
+class FrameTimingsRecorder {
+ public:
+  // Frames whose build or raster time exceeds |frame_budget| are counted as
+  // missed.
+  explicit FrameTimingsRecorder(ftl::TimeDelta frame_budget);
+
+  ~FrameTimingsRecorder();
+
+  // May be called on any thread.
+  void AddFrame(ftl::TimeDelta build_time, ftl::TimeDelta raster_time);
+
+  // Returns a JSON object with the frame count, the number of missed frames
+  // and the 50th, 90th and 99th percentile build and raster times in
+  // milliseconds.
+  std::string ToJSON() const;
+
+  bool WriteJSON(const std::string& path) const;
+
+ private:
+  const ftl::TimeDelta frame_budget_;
+  mutable ftl::Mutex mutex_;
+  std::vector<ftl::TimeDelta> build_times_ FTL_GUARDED_BY(mutex_);
+  std::vector<ftl::TimeDelta> raster_times_ FTL_GUARDED_BY(mutex_);
+
+  FTL_DISALLOW_COPY_AND_ASSIGN(FrameTimingsRecorder);
+};
+
+}  // namespace shell
+
+#endif  // FLUTTER_SHELL_TESTING_FRAME_TIMINGS_RECORDER_H_
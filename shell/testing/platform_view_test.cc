@@ -6,19 +6,62 @@
 
 #include "flutter/shell/common/null_rasterizer.h"
 #include "flutter/shell/common/shell.h"
+#include "flutter/shell/gpu/gpu_rasterizer.h"
+#include "flutter/shell/testing/vsync_waiter_virtual.h"
 
 namespace shell {
+namespace {
 
-PlatformViewTest::PlatformViewTest()
-    : PlatformView(std::unique_ptr<Rasterizer>(new NullRasterizer())) {
+constexpr ftl::TimeDelta kFrameInterval =
+    ftl::TimeDelta::FromSecondsF(1.0 / 60.0);
+
+std::unique_ptr<Rasterizer> CreateRasterizer(bool headless_rendering) {
+  if (headless_rendering)
+    return std::make_unique<GPURasterizer>(nullptr);
+  return std::unique_ptr<Rasterizer>(new NullRasterizer());
+}
+
+}  // namespace
+
+PlatformViewTest::PlatformViewTest(bool headless_rendering)
+    : PlatformView(CreateRasterizer(headless_rendering)),
+      headless_rendering_(headless_rendering),
+      backing_store_presented_(false),
+      backing_store_age_(0) {
+  if (!headless_rendering_)
+    return;
+
+  frame_timings_recorder_ =
+      std::make_unique<FrameTimingsRecorder>(kFrameInterval);
+  // No frame can have been drawn yet as there is no surface.
+  static_cast<GPURasterizer&>(rasterizer())
+      .SetFrameTimingsCallback(
+          [recorder = frame_timings_recorder_.get()](
+              ftl::TimeDelta build_time, ftl::TimeDelta raster_time) {
+            recorder->AddFrame(build_time, raster_time);
+          });
 }
 
 void PlatformViewTest::Attach() {
   CreateEngine();
   PostAddToShellTask();
+  if (headless_rendering_)
+    NotifyCreated(std::make_unique<GPUSurfaceSoftware>(this));
+}
+
+PlatformViewTest::~PlatformViewTest() {
+  // The surface refers back to this view.
+  if (headless_rendering_ && engine_)
+    NotifyDestroyed();
 }
 
-PlatformViewTest::~PlatformViewTest() = default;
+VsyncWaiter* PlatformViewTest::GetVsyncWaiter() {
+  if (!headless_rendering_)
+    return PlatformView::GetVsyncWaiter();
+  if (!vsync_waiter_)
+    vsync_waiter_ = std::make_unique<VsyncWaiterVirtual>(kFrameInterval);
+  return vsync_waiter_.get();
+}
 
 bool PlatformViewTest::ResourceContextMakeCurrent() {
   return false;
@@ -28,4 +71,32 @@ void PlatformViewTest::RunFromSource(const std::string& assets_directory,
                                      const std::string& main,
                                      const std::string& packages) {}
 
+sk_sp<SkSurface> PlatformViewTest::AcquireBackingStore(const SkISize& size) {
+  if (backing_store_ != nullptr &&
+      SkISize::Make(backing_store_->width(), backing_store_->height()) ==
+          size) {
+    // Nothing but the rasterizer touches the buffer, so it still holds the
+    // frame presented last.
+    backing_store_age_ = backing_store_presented_ ? 1 : 0;
+    return backing_store_;
+  }
+
+  backing_store_ = SkSurface::MakeRaster(
+      SkImageInfo::MakeN32Premul(size.width(), size.height()));
+  backing_store_presented_ = false;
+  backing_store_age_ = 0;
+  return backing_store_;
+}
+
+bool PlatformViewTest::PresentBackingStore(sk_sp<SkSurface> backing_store) {
+  if (backing_store == nullptr || backing_store != backing_store_)
+    return false;
+  backing_store_presented_ = true;
+  return true;
+}
+
+size_t PlatformViewTest::BackingStoreAge() {
+  return backing_store_age_;
+}
+
 }  // namespace shell
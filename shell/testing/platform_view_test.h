@@ -5,7 +5,11 @@
 #ifndef SHELL_TESTING_PLATFORM_VIEW_TEST_H_
 #define SHELL_TESTING_PLATFORM_VIEW_TEST_H_
 
+#include <memory>
+
 #include "flutter/shell/common/platform_view.h"
+#include "flutter/shell/gpu/gpu_surface_software.h"
+#include "flutter/shell/testing/frame_timings_recorder.h"
 #include "lib/ftl/macros.h"
 #include "lib/ftl/memory/weak_ptr.h"
 
@@ -13,21 +17,45 @@ namespace shell {
 
 class Shell;
 
-class PlatformViewTest : public PlatformView {
+class PlatformViewTest : public PlatformView,
+                         public GPUSurfaceSoftwareDelegate {
  public:
-  PlatformViewTest();
+  // With |headless_rendering|, frames are rasterized in software into an
+  // offscreen buffer on a virtual vsync clock and their timings recorded.
+  // Otherwise, frames are dropped unrasterized.
+  explicit PlatformViewTest(bool headless_rendering);
 
   ~PlatformViewTest();
 
   void Attach();
 
+  // Null unless rendering headless.
+  const FrameTimingsRecorder* frame_timings_recorder() const {
+    return frame_timings_recorder_.get();
+  }
+
+  VsyncWaiter* GetVsyncWaiter() override;
+
   bool ResourceContextMakeCurrent() override;
 
   void RunFromSource(const std::string& assets_directory,
                      const std::string& main,
                      const std::string& packages) override;
 
+  // |GPUSurfaceSoftwareDelegate| implementation. Called on the GPU thread.
+  sk_sp<SkSurface> AcquireBackingStore(const SkISize& size) override;
+
+  bool PresentBackingStore(sk_sp<SkSurface> backing_store) override;
+
+  size_t BackingStoreAge() override;
+
  private:
+  const bool headless_rendering_;
+  std::unique_ptr<FrameTimingsRecorder> frame_timings_recorder_;
+  sk_sp<SkSurface> backing_store_;
+  bool backing_store_presented_;
+  size_t backing_store_age_;
+
   FTL_DISALLOW_COPY_AND_ASSIGN(PlatformViewTest);
 };
 
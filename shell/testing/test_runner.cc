@@ -10,10 +10,19 @@
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/common/shell.h"
 #include "flutter/shell/testing/platform_view_test.h"
+#include "lib/ftl/logging.h"
 
 namespace shell {
 
-TestRunner::TestRunner() : platform_view_(std::make_unique<PlatformViewTest>()) {
+namespace {
+
+TestRunner* g_test_runner = nullptr;
+
+}  // namespace
+
+TestRunner::TestRunner(const Options& options)
+    : platform_view_(
+          std::make_unique<PlatformViewTest>(options.headless_rendering)) {
   platform_view_->Attach();
   blink::ViewportMetrics metrics;
   metrics.device_pixel_ratio = 3.0;
@@ -29,13 +38,35 @@ TestRunner::TestRunner() : platform_view_(std::make_unique<PlatformViewTest>())
 
 TestRunner::~TestRunner() = default;
 
-TestRunner& TestRunner::Shared() {
-  static TestRunner* g_test_runner = nullptr;
+void TestRunner::Initialize(const Options& options) {
   if (!g_test_runner)
-    g_test_runner = new TestRunner();
+    g_test_runner = new TestRunner(options);
+}
+
+TestRunner& TestRunner::Shared() {
+  Initialize(Options());
   return *g_test_runner;
 }
 
+PlatformView& TestRunner::platform_view() {
+  return *platform_view_;
+}
+
+bool TestRunner::WriteFrameTimings(const std::string& path) {
+  const FrameTimingsRecorder* recorder =
+      platform_view_->frame_timings_recorder();
+  if (!recorder) {
+    FTL_LOG(ERROR) << "Frame timings are only recorded when rendering "
+                      "headless.";
+    return false;
+  }
+  if (!recorder->WriteJSON(path)) {
+    FTL_LOG(ERROR) << "Could not write frame timings to " << path;
+    return false;
+  }
+  return true;
+}
+
 void TestRunner::Run(const TestDescriptor& test) {
   blink::Threads::UI()->PostTask(
       [ engine = platform_view_->engine().GetWeakPtr(), test ] {
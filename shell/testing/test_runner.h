@@ -14,9 +14,19 @@
 namespace shell {
 
 class PlatformView;
+class PlatformViewTest;
 
 class TestRunner {
  public:
+  struct Options {
+    // See |PlatformViewTest|.
+    bool headless_rendering = false;
+  };
+
+  // Creates the shared runner. Must be called before the first call to
+  // |Shared| for |options| to take effect.
+  static void Initialize(const Options& options);
+
   static TestRunner& Shared();
 
   struct TestDescriptor {
@@ -26,13 +36,17 @@ class TestRunner {
 
   void Run(const TestDescriptor& test);
 
-  PlatformView& platform_view() { return *platform_view_; }
+  PlatformView& platform_view();
+
+  // Writes the timings of the frames rendered so far to |path| as JSON.
+  // Fails unless rendering headless.
+  bool WriteFrameTimings(const std::string& path);
 
  private:
-  TestRunner();
+  explicit TestRunner(const Options& options);
   ~TestRunner();
 
-  std::unique_ptr<PlatformView> platform_view_;
+  std::unique_ptr<PlatformViewTest> platform_view_;
 
   FTL_DISALLOW_COPY_AND_ASSIGN(TestRunner);
 };
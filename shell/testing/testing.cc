@@ -10,6 +10,12 @@
 namespace shell {
 
 bool InitForTesting(const ftl::CommandLine& command_line) {
+  TestRunner::Options options;
+  options.headless_rendering =
+      command_line.HasOption(FlagForSwitch(Switch::HeadlessRendering)) ||
+      command_line.HasOption(FlagForSwitch(Switch::FrameTimingsOutput));
+  TestRunner::Initialize(options);
+
   TestRunner::TestDescriptor test;
   test.packages = command_line.GetOptionValueWithDefault(
       FlagForSwitch(Switch::Packages), "");
@@ -0,0 +1,38 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/testing/vsync_waiter_virtual.h"
+
+#include "flutter/common/threads.h"
+#include "lib/ftl/logging.h"
+
+namespace shell {
+
+VsyncWaiterVirtual::VsyncWaiterVirtual(ftl::TimeDelta interval)
+    : interval_(interval),
+      frame_time_(ftl::TimePoint::Now()),
+      weak_factory_(this) {}
+
+VsyncWaiterVirtual::~VsyncWaiterVirtual() = default;
+
+void VsyncWaiterVirtual::AsyncWaitForVsync(Callback callback) {
+  FTL_DCHECK(!callback_);
+  callback_ = std::move(callback);
+
+  blink::Threads::UIHighPriority()->PostTask(
+      [self = weak_factory_.GetWeakPtr()] {
+        if (!self)
+          return;
+        self->frame_time_ = self->frame_time_ + self->interval_;
+        Callback callback = std::move(self->callback_);
+        self->callback_ = Callback();
+        callback(self->frame_time_);
+      });
+}
+
+bool VsyncWaiterVirtual::HasReliableFrameTimes() const {
+  return true;
+}
+
+}  // namespace shell
@@ -0,0 +1,40 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_TESTING_VSYNC_WAITER_VIRTUAL_H_
+#define FLUTTER_SHELL_TESTING_VSYNC_WAITER_VIRTUAL_H_
+
+#include "flutter/shell/common/vsync_waiter.h"
+#include "lib/ftl/macros.h"
+#include "lib/ftl/memory/weak_ptr.h"
+#include "lib/ftl/time/time_delta.h"
+#include "lib/ftl/time/time_point.h"
+
+namespace shell {
+
+// Signals vsync as soon as it is asked for, with frame times taken from a
+// clock that advances by exactly one interval per frame. Animations therefore
+// produce the same frames no matter how fast the machine is.
+class VsyncWaiterVirtual : public VsyncWaiter {
+ public:
+  explicit VsyncWaiterVirtual(ftl::TimeDelta interval);
+  ~VsyncWaiterVirtual() override;
+
+  void AsyncWaitForVsync(Callback callback) override;
+
+  bool HasReliableFrameTimes() const override;
+
+ private:
+  const ftl::TimeDelta interval_;
+  ftl::TimePoint frame_time_;
+  Callback callback_;
+
+  ftl::WeakPtrFactory<VsyncWaiterVirtual> weak_factory_;
+
+  FTL_DISALLOW_COPY_AND_ASSIGN(VsyncWaiterVirtual);
+};
+
+}  // namespace shell
+
+#endif  // FLUTTER_SHELL_TESTING_VSYNC_WAITER_VIRTUAL_H_
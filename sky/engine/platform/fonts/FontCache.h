@@ -89,6 +89,10 @@ public:
     unsigned short generation();
     void invalidate();
 
+    // Releases the font data nothing refers to anymore once there is enough of
+    // it. Cheap enough for the idle time between frames.
+    void purge(PurgeSeverity = PurgeIfNeeded);
+
 #if ENABLE(OPENTYPE_VERTICAL)
     typedef uint32_t FontFileKey;
     PassRefPtr<OpenTypeVerticalData> getVerticalData(const FontFileKey&, const FontPlatformData&);
@@ -110,8 +114,6 @@ private:
     FontCache();
     ~FontCache();
 
-    void purge(PurgeSeverity = PurgeIfNeeded);
-
     void disablePurging() { m_purgePreventCount++; }
     void enablePurging()
     {
@@ -75,6 +75,8 @@ public:
     SkFontID uniqueID() const;
     unsigned hash() const;
 
+    bool syntheticBold() const { return m_syntheticBold; }
+    bool syntheticItalic() const { return m_syntheticItalic; }
     FontOrientation orientation() const { return m_orientation; }
     void setOrientation(FontOrientation orientation) { m_orientation = orientation; }
     void setSyntheticBold(bool syntheticBold) { m_syntheticBold = syntheticBold; }
@@ -0,0 +1,132 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/sky/engine/platform/fonts/harfbuzz/HarfBuzzShapeCache.h"
+
+#include <string.h>
+
+#include "flutter/sky/engine/wtf/Assertions.h"
+#include "flutter/sky/engine/wtf/HashFunctions.h"
+#include "flutter/sky/engine/wtf/StdLibExtras.h"
+#include "flutter/sky/engine/wtf/StringHasher.h"
+
+namespace blink {
+
+unsigned HarfBuzzShapeCacheKey::hash() const
+{
+    unsigned h = StringHasher::computeHash<UChar>(characters, length);
+    h = WTF::pairIntHash(h, fontID);
+    h = WTF::pairIntHash(h, bitwise_cast<uint32_t>(fontSize));
+    h = WTF::pairIntHash(h, fontFlags | (static_cast<unsigned>(direction) << 8));
+    h = WTF::pairIntHash(h, static_cast<unsigned>(script));
+    h = WTF::pairIntHash(h, WTF::PtrHash<hb_language_t>::hash(language));
+    if (featureCount)
+        h = WTF::pairIntHash(h, StringHasher::hashMemory(features, featureCount * sizeof(hb_feature_t)));
+    return h;
+}
+
+bool HarfBuzzShapeCache::Entry::matches(const HarfBuzzShapeCacheKey& key) const
+{
+    return fontID == key.fontID
+        && fontSize == key.fontSize
+        && fontFlags == key.fontFlags
+        && direction == key.direction
+        && script == key.script
+        && language == key.language
+        && characters.size() == key.length
+        && features.size() == key.featureCount
+        && !memcmp(characters.data(), key.characters, key.length * sizeof(UChar))
+        && (!key.featureCount || !memcmp(features.data(), key.features, key.featureCount * sizeof(hb_feature_t)));
+}
+
+HarfBuzzShapeCache::HarfBuzzShapeCache(size_t maxBytes)
+    : m_maxBytes(maxBytes)
+    , m_bytes(0)
+    , m_hitCount(0)
+    , m_missCount(0)
+{
+}
+
+HarfBuzzShapeCache::~HarfBuzzShapeCache()
+{
+}
+
+const HarfBuzzShapedGlyph* HarfBuzzShapeCache::find(const HarfBuzzShapeCacheKey& key, unsigned* glyphCount)
+{
+    const unsigned hash = key.hash();
+    auto range = m_index.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        EntryList::iterator entry = it->second;
+        if (!entry->matches(key))
+            continue;
+        m_entries.splice(m_entries.begin(), m_entries, entry);
+        m_hitCount++;
+        *glyphCount = entry->glyphs.size();
+        return entry->glyphs.data();
+    }
+    m_missCount++;
+    return 0;
+}
+
+void HarfBuzzShapeCache::add(const HarfBuzzShapeCacheKey& key, const HarfBuzzShapedGlyph* glyphs, unsigned glyphCount)
+{
+    const size_t bytes = sizeof(Entry) + sizeof(EntryIndex::value_type)
+        + key.length * sizeof(UChar)
+        + key.featureCount * sizeof(hb_feature_t)
+        + glyphCount * sizeof(HarfBuzzShapedGlyph);
+    if (bytes > m_maxBytes)
+        return;
+
+    const unsigned hash = key.hash();
+    auto range = m_index.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second->matches(key)) {
+            evict(it->second);
+            break;
+        }
+    }
+
+    m_entries.emplace_front();
+    Entry& entry = m_entries.front();
+    entry.hash = hash;
+    entry.characters.assign(key.characters, key.characters + key.length);
+    entry.fontID = key.fontID;
+    entry.fontSize = key.fontSize;
+    entry.fontFlags = key.fontFlags;
+    entry.direction = key.direction;
+    entry.script = key.script;
+    entry.language = key.language;
+    entry.features.assign(key.features, key.features + key.featureCount);
+    entry.glyphs.assign(glyphs, glyphs + glyphCount);
+    entry.bytes = bytes;
+
+    m_index.emplace(hash, m_entries.begin());
+    m_bytes += bytes;
+
+    while (m_bytes > m_maxBytes)
+        evict(--m_entries.end());
+}
+
+void HarfBuzzShapeCache::clear()
+{
+    m_index.clear();
+    m_entries.clear();
+    m_bytes = 0;
+}
+
+void HarfBuzzShapeCache::evict(EntryList::iterator entry)
+{
+    auto range = m_index.equal_range(entry->hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == entry) {
+            m_index.erase(it);
+            break;
+        }
+    }
+    ASSERT(m_bytes >= entry->bytes);
+    m_bytes -= entry->bytes;
+    m_entries.erase(entry);
+}
+
+} // namespace blink
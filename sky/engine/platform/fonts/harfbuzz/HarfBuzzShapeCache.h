@@ -0,0 +1,134 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_ENGINE_PLATFORM_FONTS_HARFBUZZ_HARFBUZZSHAPECACHE_H_
+#define SKY_ENGINE_PLATFORM_FONTS_HARFBUZZ_HARFBUZZSHAPECACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "hb.h"
+#include "flutter/sky/engine/wtf/Noncopyable.h"
+#include "flutter/sky/engine/wtf/unicode/Unicode.h"
+
+namespace blink {
+
+// One glyph of a shaped run, in the visual order HarfBuzz produced it in.
+// Positions are in HarfBuzz 16.16 fixed point.
+struct HarfBuzzShapedGlyph {
+    uint16_t glyph;
+    uint32_t cluster;
+    hb_position_t advance;
+    hb_position_t offsetX;
+    hb_position_t offsetY;
+};
+
+// Everything that influences the result of shaping a run. The key does not
+// own any of the memory it points to; the cache copies what it needs when an
+// entry is added, so looking up a run never allocates.
+struct HarfBuzzShapeCacheKey {
+    HarfBuzzShapeCacheKey(const UChar* characters, unsigned length)
+        : characters(characters)
+        , length(length)
+        , fontID(0)
+        , fontSize(0)
+        , fontFlags(0)
+        , direction(HB_DIRECTION_INVALID)
+        , script(HB_SCRIPT_INVALID)
+        , language(HB_LANGUAGE_INVALID)
+        , features(0)
+        , featureCount(0)
+    {
+    }
+
+    enum FontFlags {
+        SyntheticBold = 1 << 0,
+        SyntheticItalic = 1 << 1,
+        VerticalOrientation = 1 << 2,
+        // The text was upper-cased before shaping to synthesize small caps.
+        SmallCapsUpperCased = 1 << 3,
+    };
+
+    const UChar* characters;
+    unsigned length;
+    uint32_t fontID;
+    float fontSize;
+    unsigned fontFlags;
+    hb_direction_t direction;
+    hb_script_t script;
+    // Languages are interned by HarfBuzz and compared by pointer.
+    hb_language_t language;
+    const hb_feature_t* features;
+    unsigned featureCount;
+
+    unsigned hash() const;
+};
+
+// Remembers the glyphs HarfBuzz produced for recently shaped runs. Only the
+// glyph ids, clusters and positions are kept, not the HarfBuzz buffers they
+// were read from. Entries are found by hashing their key and confirmed by
+// comparing it in full. The least recently used entries are evicted once the
+// glyphs and keys held exceed the byte budget.
+//
+// Not thread safe. Text is only shaped on the UI thread.
+class HarfBuzzShapeCache {
+    WTF_MAKE_NONCOPYABLE(HarfBuzzShapeCache);
+public:
+    static const size_t defaultMaxBytes = 1 << 20;
+
+    explicit HarfBuzzShapeCache(size_t maxBytes = defaultMaxBytes);
+    ~HarfBuzzShapeCache();
+
+    // Returns null if the run is not in the cache. The glyphs remain valid
+    // until the next call to add. Sets |glyphCount| otherwise.
+    const HarfBuzzShapedGlyph* find(const HarfBuzzShapeCacheKey&, unsigned* glyphCount);
+
+    void add(const HarfBuzzShapeCacheKey&, const HarfBuzzShapedGlyph* glyphs, unsigned glyphCount);
+
+    void clear();
+
+    size_t bytes() const { return m_bytes; }
+    size_t maxBytes() const { return m_maxBytes; }
+    size_t entryCount() const { return m_entries.size(); }
+    size_t hitCount() const { return m_hitCount; }
+    size_t missCount() const { return m_missCount; }
+
+private:
+    struct Entry {
+        unsigned hash;
+        std::vector<UChar> characters;
+        uint32_t fontID;
+        float fontSize;
+        unsigned fontFlags;
+        hb_direction_t direction;
+        hb_script_t script;
+        hb_language_t language;
+        std::vector<hb_feature_t> features;
+        std::vector<HarfBuzzShapedGlyph> glyphs;
+        size_t bytes;
+
+        bool matches(const HarfBuzzShapeCacheKey&) const;
+    };
+
+    // Most recently used first.
+    typedef std::list<Entry> EntryList;
+    typedef std::unordered_multimap<unsigned, EntryList::iterator> EntryIndex;
+
+    void evict(EntryList::iterator);
+
+    const size_t m_maxBytes;
+    EntryList m_entries;
+    EntryIndex m_index;
+    size_t m_bytes;
+    size_t m_hitCount;
+    size_t m_missCount;
+};
+
+} // namespace blink
+
+#endif  // SKY_ENGINE_PLATFORM_FONTS_HARFBUZZ_HARFBUZZSHAPECACHE_H_
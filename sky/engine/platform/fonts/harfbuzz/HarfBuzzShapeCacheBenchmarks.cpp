@@ -0,0 +1,372 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Replays a Zipf distributed stream of text runs drawn from multilingual
+// corpora through the shape cache used by HarfBuzzShaper and through a copy
+// of the run cache it replaced, which was keyed on the text alone and held at
+// most 256 runs.
+//
+// Without arguments, misses are "shaped" into one glyph per code unit so that
+// only the cost of the caches themselves is measured. Given the path to a
+// font file, misses are shaped by HarfBuzz with that font instead.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <unicode/ustring.h>
+#include "hb.h"
+#include "hb-ot.h"
+#include "flutter/sky/engine/platform/fonts/harfbuzz/HarfBuzzShapeCache.h"
+
+namespace {
+
+using blink::HarfBuzzShapeCache;
+using blink::HarfBuzzShapeCacheKey;
+using blink::HarfBuzzShapedGlyph;
+
+const size_t kVocabularySize = 20000;
+const size_t kRunCount = 500000;
+
+struct Corpus {
+    const char* name;
+    hb_script_t script;
+    hb_direction_t direction;
+    const char* language;
+    std::vector<const char*> words;
+};
+
+std::vector<Corpus> makeCorpora()
+{
+    return {
+        { "latin", HB_SCRIPT_LATIN, HB_DIRECTION_LTR, "en", {
+            "the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog",
+            "settings", "account", "message", "photos", "search", "cancel",
+            "continue", "notifications", "privacy", "Straße", "café", "naïve",
+            "déjà", "vu", "über", "façade", "Zoë", "Ångström", "piñata" } },
+        { "cyrillic", HB_SCRIPT_CYRILLIC, HB_DIRECTION_LTR, "ru", {
+            "привет", "мир", "настройки", "сообщение", "отмена", "поиск",
+            "фотографии", "уведомления", "продолжить", "конфиденциальность",
+            "быстрая", "лиса", "собака", "ёлка" } },
+        { "greek", HB_SCRIPT_GREEK, HB_DIRECTION_LTR, "el", {
+            "καλημέρα", "κόσμε", "ρυθμίσεις", "μήνυμα", "ακύρωση",
+            "αναζήτηση", "φωτογραφίες", "ειδοποιήσεις", "συνέχεια" } },
+        { "arabic", HB_SCRIPT_ARABIC, HB_DIRECTION_RTL, "ar", {
+            "مرحبا", "بالعالم", "الإعدادات", "رسالة", "إلغاء", "بحث",
+            "الصور", "الإشعارات", "متابعة", "الخصوصية", "سريع", "الثعلب" } },
+        { "devanagari", HB_SCRIPT_DEVANAGARI, HB_DIRECTION_LTR, "hi", {
+            "नमस्ते", "दुनिया", "सेटिंग्स", "संदेश", "रद्द", "खोज", "तस्वीरें",
+            "सूचनाएं", "जारी", "गोपनीयता", "क्षत्रिय", "श्री" } },
+        { "han", HB_SCRIPT_HAN, HB_DIRECTION_LTR, "zh", {
+            "你好", "世界", "设置", "消息", "取消", "搜索", "照片", "通知",
+            "继续", "隐私", "快速的", "狐狸", "跳过", "懒狗" } },
+    };
+}
+
+struct Run {
+    std::vector<UChar> text;
+    const Corpus* corpus;
+    uint32_t fontID;
+    float fontSize;
+};
+
+class Random {
+public:
+    explicit Random(uint32_t seed) : m_state(seed) { }
+
+    uint32_t next()
+    {
+        m_state = m_state * 1664525u + 1013904223u;
+        return m_state >> 8;
+    }
+
+    double nextDouble() { return next() / static_cast<double>(1 << 24); }
+
+private:
+    uint32_t m_state;
+};
+
+std::vector<UChar> toUTF16(const std::string& utf8)
+{
+    std::vector<UChar> result(utf8.size() + 1);
+    int32_t length = 0;
+    UErrorCode status = U_ZERO_ERROR;
+    u_strFromUTF8(result.data(), result.size(), &length, utf8.data(), utf8.size(), &status);
+    result.resize(U_SUCCESS(status) ? length : 0);
+    return result;
+}
+
+// Runs of one to four words, each in one of three sizes of the font used for
+// its script. Most scripts are rarely mixed within a paragraph, so every run
+// is taken from one corpus.
+std::vector<Run> makeVocabulary(const std::vector<Corpus>& corpora)
+{
+    static const float sizes[] = { 14, 16, 20 };
+    Random random(1);
+    std::vector<Run> vocabulary;
+    for (size_t i = 0; i < kVocabularySize; ++i) {
+        const Corpus& corpus = corpora[random.next() % corpora.size()];
+        std::string text;
+        for (size_t words = 1 + random.next() % 4; words; --words) {
+            if (!text.empty())
+                text += ' ';
+            text += corpus.words[random.next() % corpus.words.size()];
+        }
+        Run run;
+        run.text = toUTF16(text);
+        run.corpus = &corpus;
+        run.fontID = 1 + (&corpus - corpora.data());
+        run.fontSize = sizes[random.next() % 3];
+        vocabulary.push_back(run);
+    }
+    return vocabulary;
+}
+
+// Indices into the vocabulary where the run of rank r is drawn with a
+// probability proportional to 1 / (r + 1).
+std::vector<size_t> makeZipfStream(const std::vector<size_t>& candidates)
+{
+    std::vector<double> cumulative(candidates.size());
+    double sum = 0;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        sum += 1.0 / (i + 1);
+        cumulative[i] = sum;
+    }
+    Random random(2);
+    std::vector<size_t> stream(kRunCount);
+    for (size_t i = 0; i < kRunCount; ++i) {
+        double target = random.nextDouble() * sum;
+        size_t rank = std::lower_bound(cumulative.begin(), cumulative.end(), target) - cumulative.begin();
+        stream[i] = candidates[std::min(rank, candidates.size() - 1)];
+    }
+    return stream;
+}
+
+class Shaper {
+public:
+    explicit Shaper(const char* fontPath)
+        : m_buffer(hb_buffer_create())
+        , m_font(0)
+    {
+        if (!fontPath)
+            return;
+        FILE* file = fopen(fontPath, "rb");
+        if (!file) {
+            fprintf(stderr, "Could not open %s\n", fontPath);
+            exit(1);
+        }
+        std::vector<char> data;
+        char chunk[4096];
+        size_t read;
+        while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+            data.insert(data.end(), chunk, chunk + read);
+        fclose(file);
+
+        hb_blob_t* blob = hb_blob_create(data.data(), data.size(), HB_MEMORY_MODE_DUPLICATE, 0, 0);
+        hb_face_t* face = hb_face_create(blob, 0);
+        m_font = hb_font_create(face);
+        hb_ot_font_set_funcs(m_font);
+        hb_face_destroy(face);
+        hb_blob_destroy(blob);
+    }
+
+    ~Shaper()
+    {
+        if (m_font)
+            hb_font_destroy(m_font);
+        hb_buffer_destroy(m_buffer);
+    }
+
+    void shape(const Run& run, std::vector<HarfBuzzShapedGlyph>* glyphs)
+    {
+        if (!m_font) {
+            glyphs->resize(run.text.size());
+            for (size_t i = 0; i < run.text.size(); ++i)
+                (*glyphs)[i] = { run.text[i], static_cast<uint32_t>(i), 10 << 16, 0, 0 };
+            return;
+        }
+
+        hb_font_set_scale(m_font, run.fontSize * (1 << 16), run.fontSize * (1 << 16));
+        hb_buffer_set_script(m_buffer, run.corpus->script);
+        hb_buffer_set_direction(m_buffer, run.corpus->direction);
+        hb_buffer_set_language(m_buffer, hb_language_from_string(run.corpus->language, -1));
+        hb_buffer_add_utf16(m_buffer, reinterpret_cast<const uint16_t*>(run.text.data()), run.text.size(), 0, run.text.size());
+        hb_shape(m_font, m_buffer, 0, 0);
+
+        unsigned count = hb_buffer_get_length(m_buffer);
+        const hb_glyph_info_t* infos = hb_buffer_get_glyph_infos(m_buffer, 0);
+        const hb_glyph_position_t* positions = hb_buffer_get_glyph_positions(m_buffer, 0);
+        glyphs->resize(count);
+        for (unsigned i = 0; i < count; ++i) {
+            (*glyphs)[i] = { static_cast<uint16_t>(infos[i].codepoint), infos[i].cluster,
+                positions[i].x_advance, positions[i].x_offset, positions[i].y_offset };
+        }
+        hb_buffer_clear_contents(m_buffer);
+    }
+
+private:
+    hb_buffer_t* m_buffer;
+    hb_font_t* m_font;
+};
+
+// The run cache HarfBuzzShaper used to have. A lookup builds a std::wstring
+// from the text and a hit on a run shaped with another font or direction
+// throws the cached run away.
+class LegacyRunCache {
+public:
+    static const size_t maxSize = 256;
+
+    const std::vector<HarfBuzzShapedGlyph>* find(const Run& run)
+    {
+        std::wstring key(run.text.begin(), run.text.end());
+        auto it = m_map.find(key);
+        if (it == m_map.end())
+            return 0;
+        Entry& entry = *it->second;
+        if (entry.fontID == run.fontID && entry.fontSize == run.fontSize
+            && entry.direction == run.corpus->direction && entry.language == run.corpus->language) {
+            m_lru.splice(m_lru.end(), m_lru, it->second);
+            return &entry.glyphs;
+        }
+        m_lru.erase(it->second);
+        m_map.erase(it);
+        return 0;
+    }
+
+    void add(const Run& run, const std::vector<HarfBuzzShapedGlyph>& glyphs)
+    {
+        std::wstring key(run.text.begin(), run.text.end());
+        m_lru.push_back({ key, run.fontID, run.fontSize, run.corpus->direction, run.corpus->language, glyphs });
+        if (!m_map.insert(std::make_pair(key, --m_lru.end())).second) {
+            m_lru.pop_back();
+            return;
+        }
+        if (m_map.size() > maxSize) {
+            m_map.erase(m_lru.front().key);
+            m_lru.pop_front();
+        }
+    }
+
+private:
+    struct Entry {
+        std::wstring key;
+        uint32_t fontID;
+        float fontSize;
+        hb_direction_t direction;
+        std::string language;
+        std::vector<HarfBuzzShapedGlyph> glyphs;
+    };
+
+    std::list<Entry> m_lru;
+    std::map<std::wstring, std::list<Entry>::iterator> m_map;
+};
+
+struct Result {
+    size_t hits;
+    double nanosecondsPerRun;
+};
+
+template <typename Clock = std::chrono::steady_clock>
+double nanosecondsSince(typename Clock::time_point start)
+{
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+Result runLegacy(const std::vector<Run>& vocabulary, const std::vector<size_t>& stream, Shaper& shaper)
+{
+    LegacyRunCache cache;
+    std::vector<HarfBuzzShapedGlyph> glyphs;
+    size_t hits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t index : stream) {
+        const Run& run = vocabulary[index];
+        if (cache.find(run)) {
+            hits++;
+            continue;
+        }
+        shaper.shape(run, &glyphs);
+        cache.add(run, glyphs);
+    }
+    return { hits, nanosecondsSince(start) / stream.size() };
+}
+
+Result runHashed(const std::vector<Run>& vocabulary, const std::vector<size_t>& stream, Shaper& shaper, size_t maxBytes, size_t* bytes)
+{
+    HarfBuzzShapeCache cache(maxBytes);
+    std::vector<HarfBuzzShapedGlyph> glyphs;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t index : stream) {
+        const Run& run = vocabulary[index];
+        HarfBuzzShapeCacheKey key(run.text.data(), run.text.size());
+        key.fontID = run.fontID;
+        key.fontSize = run.fontSize;
+        key.direction = run.corpus->direction;
+        key.script = run.corpus->script;
+        key.language = hb_language_from_string(run.corpus->language, -1);
+        unsigned glyphCount;
+        if (cache.find(key, &glyphCount))
+            continue;
+        shaper.shape(run, &glyphs);
+        cache.add(key, glyphs.data(), glyphs.size());
+    }
+    *bytes = cache.bytes();
+    return { cache.hitCount(), nanosecondsSince(start) / stream.size() };
+}
+
+// The legacy cache is bounded by run count and does not know its size, so
+// its bytes are left blank.
+void printResult(const char* corpus, const char* cache, const Result& result, size_t bytes)
+{
+    char bytesString[32] = "-";
+    if (bytes)
+        snprintf(bytesString, sizeof(bytesString), "%zu", bytes);
+    printf("%-12s %-18s %9.1f%% %12.0f %12s\n", corpus, cache,
+        100.0 * result.hits / kRunCount, result.nanosecondsPerRun, bytesString);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::vector<Corpus> corpora = makeCorpora();
+    std::vector<Run> vocabulary = makeVocabulary(corpora);
+    Shaper shaper(argc > 1 ? argv[1] : 0);
+
+    printf("Shaping: %s\n", argc > 1 ? argv[1] : "none, one glyph per code unit");
+    printf("%-12s %-18s %10s %12s %12s\n", "corpus", "cache", "hit rate", "ns per run", "bytes");
+
+    std::vector<std::pair<const char*, std::vector<size_t>>> streams;
+    for (const Corpus& corpus : corpora) {
+        std::vector<size_t> candidates;
+        for (size_t i = 0; i < vocabulary.size(); ++i) {
+            if (vocabulary[i].corpus == &corpus)
+                candidates.push_back(i);
+        }
+        streams.push_back(std::make_pair(corpus.name, makeZipfStream(candidates)));
+    }
+    std::vector<size_t> all(vocabulary.size());
+    for (size_t i = 0; i < all.size(); ++i)
+        all[i] = i;
+    streams.push_back(std::make_pair("mixed", makeZipfStream(all)));
+
+    for (const auto& stream : streams) {
+        printResult(stream.first, "legacy 256 runs", runLegacy(vocabulary, stream.second, shaper), 0);
+        const size_t budgets[] = { 256 << 10, HarfBuzzShapeCache::defaultMaxBytes, 4 << 20 };
+        for (size_t budget : budgets) {
+            char name[32];
+            snprintf(name, sizeof(name), "hashed %zu KB", budget >> 10);
+            size_t bytes = 0;
+            Result result = runHashed(vocabulary, stream.second, shaper, budget, &bytes);
+            printResult(stream.first, name, result, bytes);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,199 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/sky/engine/platform/fonts/harfbuzz/HarfBuzzShapeCache.h"
+
+#include <unordered_map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace blink {
+
+namespace {
+
+const UChar kHello[] = { 'h', 'e', 'l', 'l', 'o' };
+const UChar kWorld[] = { 'w', 'o', 'r', 'l', 'd' };
+const UChar kThere[] = { 't', 'h', 'e', 'r', 'e' };
+
+HarfBuzzShapeCacheKey makeKey(const UChar* characters, uint32_t fontID = 1)
+{
+    HarfBuzzShapeCacheKey key(characters, 5);
+    key.fontID = fontID;
+    key.fontSize = 14;
+    key.direction = HB_DIRECTION_LTR;
+    key.script = HB_SCRIPT_LATIN;
+    key.language = hb_language_from_string("en", -1);
+    return key;
+}
+
+std::vector<HarfBuzzShapedGlyph> makeGlyphs(uint16_t firstGlyph)
+{
+    std::vector<HarfBuzzShapedGlyph> glyphs;
+    for (uint16_t i = 0; i < 5; i++)
+        glyphs.push_back({ static_cast<uint16_t>(firstGlyph + i), i, 10 << 16, 0, 0 });
+    return glyphs;
+}
+
+void add(HarfBuzzShapeCache& cache, const HarfBuzzShapeCacheKey& key, uint16_t firstGlyph)
+{
+    std::vector<HarfBuzzShapedGlyph> glyphs = makeGlyphs(firstGlyph);
+    cache.add(key, glyphs.data(), glyphs.size());
+}
+
+// Returns the first glyph of the cached run, or -1 if it is not cached.
+int findFirstGlyph(HarfBuzzShapeCache& cache, const HarfBuzzShapeCacheKey& key)
+{
+    unsigned glyphCount = 0;
+    const HarfBuzzShapedGlyph* glyphs = cache.find(key, &glyphCount);
+    if (!glyphs)
+        return -1;
+    EXPECT_EQ(glyphCount, 5u);
+    return glyphs[0].glyph;
+}
+
+// The bytes an entry of five characters and glyphs is accounted for.
+size_t entryBytes()
+{
+    HarfBuzzShapeCache cache;
+    add(cache, makeKey(kHello), 0);
+    return cache.bytes();
+}
+
+} // namespace
+
+TEST(HarfBuzzShapeCacheTest, FindsAddedRun)
+{
+    HarfBuzzShapeCache cache;
+    add(cache, makeKey(kHello), 100);
+
+    // The key does not own its characters, so the cache must have copied them.
+    std::vector<UChar> copy(kHello, kHello + 5);
+    HarfBuzzShapeCacheKey key = makeKey(kHello);
+    key.characters = copy.data();
+
+    unsigned glyphCount = 0;
+    const HarfBuzzShapedGlyph* glyphs = cache.find(key, &glyphCount);
+    ASSERT_TRUE(glyphs);
+    ASSERT_EQ(glyphCount, 5u);
+    for (unsigned i = 0; i < glyphCount; i++) {
+        EXPECT_EQ(glyphs[i].glyph, 100 + i);
+        EXPECT_EQ(glyphs[i].cluster, i);
+        EXPECT_EQ(glyphs[i].advance, 10 << 16);
+    }
+    EXPECT_EQ(cache.hitCount(), 1u);
+    EXPECT_EQ(cache.missCount(), 0u);
+    EXPECT_EQ(cache.entryCount(), 1u);
+}
+
+TEST(HarfBuzzShapeCacheTest, MissesOnAnyKeyDifference)
+{
+    HarfBuzzShapeCache cache;
+    add(cache, makeKey(kHello), 100);
+
+    EXPECT_EQ(findFirstGlyph(cache, makeKey(kWorld)), -1);
+    EXPECT_EQ(findFirstGlyph(cache, makeKey(kHello, 2)), -1);
+
+    HarfBuzzShapeCacheKey bold = makeKey(kHello);
+    bold.fontFlags = HarfBuzzShapeCacheKey::SyntheticBold;
+    EXPECT_EQ(findFirstGlyph(cache, bold), -1);
+
+    HarfBuzzShapeCacheKey rtl = makeKey(kHello);
+    rtl.direction = HB_DIRECTION_RTL;
+    EXPECT_EQ(findFirstGlyph(cache, rtl), -1);
+
+    const hb_feature_t noLigatures = { HB_TAG('l', 'i', 'g', 'a'), 0, 0, static_cast<unsigned>(-1) };
+    HarfBuzzShapeCacheKey withFeature = makeKey(kHello);
+    withFeature.features = &noLigatures;
+    withFeature.featureCount = 1;
+    EXPECT_EQ(findFirstGlyph(cache, withFeature), -1);
+
+    EXPECT_EQ(cache.missCount(), 5u);
+    EXPECT_EQ(findFirstGlyph(cache, makeKey(kHello)), 100);
+}
+
+TEST(HarfBuzzShapeCacheTest, ComparesKeysWithSameHashInFull)
+{
+    // Keys that only differ in their font collide eventually.
+    std::unordered_map<unsigned, uint32_t> fontIDsByHash;
+    uint32_t firstFontID = 0;
+    uint32_t secondFontID = 0;
+    for (uint32_t fontID = 1; fontID < (1u << 22) && !secondFontID; fontID++) {
+        const unsigned hash = makeKey(kHello, fontID).hash();
+        auto found = fontIDsByHash.find(hash);
+        if (found != fontIDsByHash.end()) {
+            firstFontID = found->second;
+            secondFontID = fontID;
+        } else {
+            fontIDsByHash.emplace(hash, fontID);
+        }
+    }
+    ASSERT_NE(secondFontID, 0u);
+    const HarfBuzzShapeCacheKey first = makeKey(kHello, firstFontID);
+    const HarfBuzzShapeCacheKey second = makeKey(kHello, secondFontID);
+    ASSERT_EQ(first.hash(), second.hash());
+
+    HarfBuzzShapeCache cache;
+    add(cache, first, 100);
+    EXPECT_EQ(findFirstGlyph(cache, second), -1);
+
+    add(cache, second, 200);
+    EXPECT_EQ(cache.entryCount(), 2u);
+    EXPECT_EQ(findFirstGlyph(cache, first), 100);
+    EXPECT_EQ(findFirstGlyph(cache, second), 200);
+}
+
+TEST(HarfBuzzShapeCacheTest, ReplacesRunAddedAgain)
+{
+    HarfBuzzShapeCache cache;
+    add(cache, makeKey(kHello), 100);
+    add(cache, makeKey(kHello), 200);
+
+    EXPECT_EQ(cache.entryCount(), 1u);
+    EXPECT_EQ(cache.bytes(), entryBytes());
+    EXPECT_EQ(findFirstGlyph(cache, makeKey(kHello)), 200);
+}
+
+TEST(HarfBuzzShapeCacheTest, EvictsLeastRecentlyUsedOverBudget)
+{
+    HarfBuzzShapeCache cache(2 * entryBytes());
+    add(cache, makeKey(kHello), 100);
+    add(cache, makeKey(kWorld), 200);
+    // Makes "world" the least recently used.
+    EXPECT_EQ(findFirstGlyph(cache, makeKey(kHello)), 100);
+    add(cache, makeKey(kThere), 300);
+
+    EXPECT_EQ(cache.entryCount(), 2u);
+    EXPECT_EQ(cache.bytes(), 2 * entryBytes());
+    EXPECT_EQ(findFirstGlyph(cache, makeKey(kHello)), 100);
+    EXPECT_EQ(findFirstGlyph(cache, makeKey(kWorld)), -1);
+    EXPECT_EQ(findFirstGlyph(cache, makeKey(kThere)), 300);
+}
+
+TEST(HarfBuzzShapeCacheTest, DoesNotCacheRunsOverBudget)
+{
+    HarfBuzzShapeCache cache(entryBytes() - 1);
+    add(cache, makeKey(kHello), 100);
+
+    EXPECT_EQ(cache.entryCount(), 0u);
+    EXPECT_EQ(cache.bytes(), 0u);
+}
+
+TEST(HarfBuzzShapeCacheTest, ClearReleasesEverything)
+{
+    HarfBuzzShapeCache cache;
+    add(cache, makeKey(kHello), 100);
+    add(cache, makeKey(kWorld), 200);
+    EXPECT_EQ(cache.bytes(), 2 * entryBytes());
+
+    cache.clear();
+    EXPECT_EQ(cache.bytes(), 0u);
+    EXPECT_EQ(cache.entryCount(), 0u);
+    EXPECT_EQ(findFirstGlyph(cache, makeKey(kHello)), -1);
+
+    add(cache, makeKey(kHello), 300);
+    EXPECT_EQ(findFirstGlyph(cache, makeKey(kHello)), 300);
+}
+
+} // namespace blink
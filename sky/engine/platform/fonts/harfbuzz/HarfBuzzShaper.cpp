@@ -40,16 +40,13 @@
 #include "flutter/sky/engine/platform/fonts/Font.h"
 #include "flutter/sky/engine/platform/fonts/GlyphBuffer.h"
 #include "flutter/sky/engine/platform/fonts/harfbuzz/HarfBuzzFace.h"
+#include "flutter/sky/engine/platform/fonts/harfbuzz/HarfBuzzShapeCache.h"
 #include "flutter/sky/engine/platform/text/SurrogatePairAwareTextIterator.h"
 #include "flutter/sky/engine/platform/text/TextBreakIterator.h"
 #include "flutter/sky/engine/wtf/Compiler.h"
 #include "flutter/sky/engine/wtf/MathExtras.h"
 #include "flutter/sky/engine/wtf/unicode/Unicode.h"
 
-#include <list>
-#include <map>
-#include <string>
-
 namespace blink {
 
 template<typename T>
@@ -77,135 +74,10 @@ private:
 };
 
 
-static const unsigned cHarfBuzzCacheMaxSize = 256;
-
-struct CachedShapingResultsLRUNode;
-struct CachedShapingResults;
-typedef std::map<std::wstring, CachedShapingResults*> CachedShapingResultsMap;
-typedef std::list<CachedShapingResultsLRUNode*> CachedShapingResultsLRU;
-
-struct CachedShapingResults {
-    CachedShapingResults(hb_buffer_t* harfBuzzBuffer, const Font* runFont, hb_direction_t runDir, const String& newLocale);
-    ~CachedShapingResults();
-
-    hb_buffer_t* buffer;
-    Font font;
-    hb_direction_t dir;
-    String locale;
-    CachedShapingResultsLRU::iterator lru;
-};
-
-struct CachedShapingResultsLRUNode {
-    CachedShapingResultsLRUNode(const CachedShapingResultsMap::iterator& cacheEntry);
-    ~CachedShapingResultsLRUNode();
-
-    CachedShapingResultsMap::iterator entry;
-};
-
-CachedShapingResults::CachedShapingResults(hb_buffer_t* harfBuzzBuffer, const Font* fontData, hb_direction_t dirData, const String& newLocale)
-    : buffer(harfBuzzBuffer)
-    , font(*fontData)
-    , dir(dirData)
-    , locale(newLocale)
+HarfBuzzShapeCache& harfBuzzShapeCache()
 {
-}
-
-CachedShapingResults::~CachedShapingResults()
-{
-    hb_buffer_destroy(buffer);
-}
-
-CachedShapingResultsLRUNode::CachedShapingResultsLRUNode(const CachedShapingResultsMap::iterator& cacheEntry)
-    : entry(cacheEntry)
-{
-}
-
-CachedShapingResultsLRUNode::~CachedShapingResultsLRUNode()
-{
-}
-
-class HarfBuzzRunCache {
-public:
-    HarfBuzzRunCache();
-    ~HarfBuzzRunCache();
-
-    CachedShapingResults* find(const std::wstring& key) const;
-    void remove(CachedShapingResults* node);
-    void moveToBack(CachedShapingResults* node);
-    bool insert(const std::wstring& key, CachedShapingResults* run);
-
-private:
-    CachedShapingResultsMap m_harfBuzzRunMap;
-    CachedShapingResultsLRU m_harfBuzzRunLRU;
-};
-
-
-HarfBuzzRunCache::HarfBuzzRunCache()
-{
-}
-
-HarfBuzzRunCache::~HarfBuzzRunCache()
-{
-    for (CachedShapingResultsMap::iterator it = m_harfBuzzRunMap.begin(); it != m_harfBuzzRunMap.end(); ++it)
-        delete it->second;
-    for (CachedShapingResultsLRU::iterator it = m_harfBuzzRunLRU.begin(); it != m_harfBuzzRunLRU.end(); ++it)
-        delete *it;
-}
-
-bool HarfBuzzRunCache::insert(const std::wstring& key, CachedShapingResults* data)
-{
-    std::pair<CachedShapingResultsMap::iterator, bool> results =
-        m_harfBuzzRunMap.insert(CachedShapingResultsMap::value_type(key, data));
-
-    if (!results.second)
-        return false;
-
-    CachedShapingResultsLRUNode* node = new CachedShapingResultsLRUNode(results.first);
-
-    m_harfBuzzRunLRU.push_back(node);
-    data->lru = --m_harfBuzzRunLRU.end();
-
-    if (m_harfBuzzRunMap.size() > cHarfBuzzCacheMaxSize) {
-        CachedShapingResultsLRUNode* lru = m_harfBuzzRunLRU.front();
-        CachedShapingResults* foo = lru->entry->second;
-        m_harfBuzzRunMap.erase(lru->entry);
-        m_harfBuzzRunLRU.pop_front();
-        delete foo;
-        delete lru;
-    }
-
-    return true;
-}
-
-inline CachedShapingResults* HarfBuzzRunCache::find(const std::wstring& key) const
-{
-    CachedShapingResultsMap::const_iterator it = m_harfBuzzRunMap.find(key);
-
-    return it != m_harfBuzzRunMap.end() ? it->second : 0;
-}
-
-inline void HarfBuzzRunCache::remove(CachedShapingResults* node)
-{
-    CachedShapingResultsLRUNode* lruNode = *node->lru;
-
-    m_harfBuzzRunLRU.erase(node->lru);
-    m_harfBuzzRunMap.erase(lruNode->entry);
-    delete lruNode;
-    delete node;
-}
-
-inline void HarfBuzzRunCache::moveToBack(CachedShapingResults* node)
-{
-    CachedShapingResultsLRUNode* lruNode = *node->lru;
-    m_harfBuzzRunLRU.erase(node->lru);
-    m_harfBuzzRunLRU.push_back(lruNode);
-    node->lru = --m_harfBuzzRunLRU.end();
-}
-
-HarfBuzzRunCache& harfBuzzRunCache()
-{
-    DEFINE_STATIC_LOCAL(HarfBuzzRunCache, globalHarfBuzzRunCache, ());
-    return globalHarfBuzzRunCache;
+    DEFINE_STATIC_LOCAL(HarfBuzzShapeCache, globalHarfBuzzShapeCache, ());
+    return globalHarfBuzzShapeCache;
 }
 
 static inline float harfBuzzPositionToFloat(hb_position_t value)
@@ -263,9 +135,9 @@ HarfBuzzShaper::HarfBuzzRun::~HarfBuzzRun()
 {
 }
 
-inline void HarfBuzzShaper::HarfBuzzRun::applyShapeResult(hb_buffer_t* harfBuzzBuffer)
+inline void HarfBuzzShaper::HarfBuzzRun::applyShapeResult(unsigned numGlyphs)
 {
-    m_numGlyphs = hb_buffer_get_length(harfBuzzBuffer);
+    m_numGlyphs = numGlyphs;
     m_glyphs.resize(m_numGlyphs);
     m_advances.resize(m_numGlyphs);
     m_glyphToCharacterIndexes.resize(m_numGlyphs);
@@ -807,10 +679,11 @@ bool HarfBuzzShaper::shapeHarfBuzzRuns()
 {
     HarfBuzzScopedPtr<hb_buffer_t> harfBuzzBuffer(hb_buffer_create(), hb_buffer_destroy);
 
-    HarfBuzzRunCache& runCache = harfBuzzRunCache();
+    HarfBuzzShapeCache& shapeCache = harfBuzzShapeCache();
     const FontDescription& fontDescription = m_font->fontDescription();
-    const String& localeString = fontDescription.locale();
-    CString locale = localeString.latin1();
+    CString locale = fontDescription.locale().latin1();
+    hb_language_t language = hb_language_from_string(locale.data(), locale.length());
+    Vector<HarfBuzzShapedGlyph, 256> shapedGlyphs;
 
     for (unsigned i = 0; i < m_harfBuzzRuns.size(); ++i) {
         unsigned runIndex = m_run.rtl() ? m_harfBuzzRuns.size() - i - 1 : i;
@@ -824,40 +697,48 @@ bool HarfBuzzShaper::shapeHarfBuzzRuns()
         if (!face)
             return false;
 
-        hb_buffer_set_language(harfBuzzBuffer.get(), hb_language_from_string(locale.data(), locale.length()));
-        hb_buffer_set_script(harfBuzzBuffer.get(), currentRun->script());
-        hb_buffer_set_direction(harfBuzzBuffer.get(), currentRun->direction());
-
         const UChar* src = m_normalizedBuffer.get() + currentRun->startIndex();
-        std::wstring key(src, src + currentRun->numCharacters());
-
-        CachedShapingResults* cachedResults = runCache.find(key);
-        if (cachedResults) {
-            if (cachedResults->dir == currentRun->direction() && cachedResults->font == *m_font && cachedResults->locale == localeString) {
-                currentRun->applyShapeResult(cachedResults->buffer);
-                setGlyphPositionsForHarfBuzzRun(currentRun, cachedResults->buffer);
-
-                hb_buffer_clear_contents(harfBuzzBuffer.get());
-
-                runCache.moveToBack(cachedResults);
-
-                continue;
-            }
-
-            runCache.remove(cachedResults);
+        bool upperCase = fontDescription.variant() == FontVariantSmallCaps && u_islower(src[0]);
+
+        HarfBuzzShapeCacheKey key(src, currentRun->numCharacters());
+        key.fontID = platformData->uniqueID();
+        key.fontSize = platformData->size();
+        if (platformData->syntheticBold())
+            key.fontFlags |= HarfBuzzShapeCacheKey::SyntheticBold;
+        if (platformData->syntheticItalic())
+            key.fontFlags |= HarfBuzzShapeCacheKey::SyntheticItalic;
+        if (fontDescription.orientation() == Vertical)
+            key.fontFlags |= HarfBuzzShapeCacheKey::VerticalOrientation;
+        if (upperCase)
+            key.fontFlags |= HarfBuzzShapeCacheKey::SmallCapsUpperCased;
+        key.direction = currentRun->direction();
+        key.script = currentRun->script();
+        key.language = language;
+        key.features = m_features.isEmpty() ? 0 : m_features.data();
+        key.featureCount = m_features.size();
+
+        unsigned numGlyphs = 0;
+        if (const HarfBuzzShapedGlyph* cachedGlyphs = shapeCache.find(key, &numGlyphs)) {
+            currentRun->applyShapeResult(numGlyphs);
+            setGlyphPositionsForHarfBuzzRun(currentRun, cachedGlyphs);
+            continue;
         }
 
+        hb_buffer_set_language(harfBuzzBuffer.get(), language);
+        hb_buffer_set_script(harfBuzzBuffer.get(), currentRun->script());
+        hb_buffer_set_direction(harfBuzzBuffer.get(), currentRun->direction());
+
         // Add a space as pre-context to the buffer. This prevents showing dotted-circle
         // for combining marks at the beginning of runs.
         static const uint16_t preContext = ' ';
         hb_buffer_add_utf16(harfBuzzBuffer.get(), &preContext, 1, 1, 0);
 
-        if (fontDescription.variant() == FontVariantSmallCaps && u_islower(m_normalizedBuffer[currentRun->startIndex()])) {
-            String upperText = String(m_normalizedBuffer.get() + currentRun->startIndex(), currentRun->numCharacters()).upper();
+        if (upperCase) {
+            String upperText = String(src, currentRun->numCharacters()).upper();
             ASSERT(!upperText.is8Bit()); // m_normalizedBuffer is 16 bit, therefore upperText is 16 bit, even after we call makeUpper().
             hb_buffer_add_utf16(harfBuzzBuffer.get(), toUint16(upperText.characters16()), currentRun->numCharacters(), 0, currentRun->numCharacters());
         } else {
-            hb_buffer_add_utf16(harfBuzzBuffer.get(), toUint16(m_normalizedBuffer.get() + currentRun->startIndex()), currentRun->numCharacters(), 0, currentRun->numCharacters());
+            hb_buffer_add_utf16(harfBuzzBuffer.get(), toUint16(src), currentRun->numCharacters(), 0, currentRun->numCharacters());
         }
 
         if (fontDescription.orientation() == Vertical)
@@ -866,22 +747,35 @@ bool HarfBuzzShaper::shapeHarfBuzzRuns()
         HarfBuzzScopedPtr<hb_font_t> harfBuzzFont(face->createFont(), hb_font_destroy);
 
         hb_shape(harfBuzzFont.get(), harfBuzzBuffer.get(), m_features.isEmpty() ? 0 : m_features.data(), m_features.size());
-        currentRun->applyShapeResult(harfBuzzBuffer.get());
-        setGlyphPositionsForHarfBuzzRun(currentRun, harfBuzzBuffer.get());
 
-        runCache.insert(key, new CachedShapingResults(harfBuzzBuffer.get(), m_font, currentRun->direction(), localeString));
+        // Copy out the little of the result we need so that the buffer can be
+        // reused for the next run and the cache holds no HarfBuzz objects.
+        numGlyphs = hb_buffer_get_length(harfBuzzBuffer.get());
+        const hb_glyph_info_t* glyphInfos = hb_buffer_get_glyph_infos(harfBuzzBuffer.get(), 0);
+        const hb_glyph_position_t* glyphPositions = hb_buffer_get_glyph_positions(harfBuzzBuffer.get(), 0);
+        shapedGlyphs.resize(numGlyphs);
+        for (unsigned j = 0; j < numGlyphs; ++j) {
+            HarfBuzzShapedGlyph& glyph = shapedGlyphs[j];
+            glyph.glyph = glyphInfos[j].codepoint;
+            glyph.cluster = glyphInfos[j].cluster;
+            glyph.advance = glyphPositions[j].x_advance;
+            glyph.offsetX = glyphPositions[j].x_offset;
+            glyph.offsetY = glyphPositions[j].y_offset;
+        }
+        hb_buffer_clear_contents(harfBuzzBuffer.get());
+
+        currentRun->applyShapeResult(numGlyphs);
+        setGlyphPositionsForHarfBuzzRun(currentRun, shapedGlyphs.data());
 
-        harfBuzzBuffer.set(hb_buffer_create());
+        shapeCache.add(key, shapedGlyphs.data(), numGlyphs);
     }
 
     return true;
 }
 
-void HarfBuzzShaper::setGlyphPositionsForHarfBuzzRun(HarfBuzzRun* currentRun, hb_buffer_t* harfBuzzBuffer)
+void HarfBuzzShaper::setGlyphPositionsForHarfBuzzRun(HarfBuzzRun* currentRun, const HarfBuzzShapedGlyph* shapedGlyphs)
 {
     const SimpleFontData* currentFontData = currentRun->fontData();
-    hb_glyph_info_t* glyphInfos = hb_buffer_get_glyph_infos(harfBuzzBuffer, 0);
-    hb_glyph_position_t* glyphPositions = hb_buffer_get_glyph_positions(harfBuzzBuffer, 0);
 
     if (!currentRun->hasGlyphToCharacterIndexes()) {
         // FIXME: https://crbug.com/337886
@@ -897,16 +791,16 @@ void HarfBuzzShaper::setGlyphPositionsForHarfBuzzRun(HarfBuzzRun* currentRun, hb
     // HarfBuzz returns the shaping result in visual order. We need not to flip for RTL.
     for (size_t i = 0; i < numGlyphs; ++i) {
         bool runEnd = i + 1 == numGlyphs;
-        uint16_t glyph = glyphInfos[i].codepoint;
-        float offsetX = harfBuzzPositionToFloat(glyphPositions[i].x_offset);
-        float offsetY = -harfBuzzPositionToFloat(glyphPositions[i].y_offset);
-        float advance = harfBuzzPositionToFloat(glyphPositions[i].x_advance);
+        uint16_t glyph = shapedGlyphs[i].glyph;
+        float offsetX = harfBuzzPositionToFloat(shapedGlyphs[i].offsetX);
+        float offsetY = -harfBuzzPositionToFloat(shapedGlyphs[i].offsetY);
+        float advance = harfBuzzPositionToFloat(shapedGlyphs[i].advance);
 
-        unsigned currentCharacterIndex = currentRun->startIndex() + glyphInfos[i].cluster;
-        bool isClusterEnd = runEnd || glyphInfos[i].cluster != glyphInfos[i + 1].cluster;
+        unsigned currentCharacterIndex = currentRun->startIndex() + shapedGlyphs[i].cluster;
+        bool isClusterEnd = runEnd || shapedGlyphs[i].cluster != shapedGlyphs[i + 1].cluster;
         float spacing = 0;
 
-        glyphToCharacterIndexes[i] = glyphInfos[i].cluster;
+        glyphToCharacterIndexes[i] = shapedGlyphs[i].cluster;
 
         if (isClusterEnd && !Character::treatAsZeroWidthSpace(m_normalizedBuffer[currentCharacterIndex]))
             spacing += m_letterSpacing;
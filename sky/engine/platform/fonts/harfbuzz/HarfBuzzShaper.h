@@ -47,8 +47,13 @@ namespace blink {
 
 class Font;
 class GlyphBuffer;
+class HarfBuzzShapeCache;
+struct HarfBuzzShapedGlyph;
 class SimpleFontData;
 
+// The cache every HarfBuzzShaper looks runs up in. UI thread only.
+HarfBuzzShapeCache& harfBuzzShapeCache();
+
 class HarfBuzzShaper final {
 public:
     enum ForTextEmphasisOrNot {
@@ -76,7 +81,7 @@ private:
             return adoptPtr(new HarfBuzzRun(fontData, startIndex, numCharacters, direction, script));
         }
 
-        void applyShapeResult(hb_buffer_t*);
+        void applyShapeResult(unsigned numGlyphs);
         void setGlyphAndPositions(unsigned index, uint16_t glyphId, float advance, float offsetX, float offsetY);
         void setWidth(float width) { m_width = width; }
 
@@ -131,7 +136,7 @@ private:
     bool fillGlyphBuffer(GlyphBuffer*);
     void fillGlyphBufferFromHarfBuzzRun(GlyphBuffer*, HarfBuzzRun*, float& carryAdvance);
     void fillGlyphBufferForTextEmphasis(GlyphBuffer*, HarfBuzzRun* currentRun);
-    void setGlyphPositionsForHarfBuzzRun(HarfBuzzRun*, hb_buffer_t*);
+    void setGlyphPositionsForHarfBuzzRun(HarfBuzzRun*, const HarfBuzzShapedGlyph*);
     void addHarfBuzzRun(unsigned startCharacter, unsigned endCharacter, const SimpleFontData*, UScriptCode);
 
     const Font* m_font;
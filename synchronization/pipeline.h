@@ -6,15 +6,16 @@
 #define SYNCHRONIZATION_PIPELINE_H_
 
 #include "flutter/glue/trace_event.h"
-#include "flutter/synchronization/pipeline.h"
-#include "flutter/synchronization/semaphore.h"
-#include "lib/ftl/functional/closure.h"
+#include "lib/ftl/compiler_specific.h"
+#include "lib/ftl/logging.h"
 #include "lib/ftl/macros.h"
 #include "lib/ftl/memory/ref_counted.h"
-#include "lib/ftl/synchronization/mutex.h"
+#include "lib/ftl/time/time_delta.h"
+#include "lib/ftl/time/time_point.h"
 
+#include <atomic>
+#include <functional>
 #include <memory>
-#include <queue>
 
 namespace flutter {
 
@@ -24,56 +25,68 @@ enum class PipelineConsumeResult {
   MoreAvailable,
 };
 
+/// A fixed capacity queue handing resources from a single producer thread to
+/// a single consumer thread. The producer first reserves a spot in the
+/// pipeline and completes the resource later. Neither side ever blocks or
+/// takes a lock, and no memory is allocated after construction.
+///
+/// All calls to |Produce| and to the methods of the continuations it returns
+/// must be made on one thread. All calls to |Consume| must be made on one
+/// thread, which may be another one.
 template <class R>
 class Pipeline : public ftl::RefCountedThreadSafe<Pipeline<R>> {
  public:
   using Resource = R;
   using ResourcePtr = std::unique_ptr<Resource>;
 
+  /// The depth used by pipelines whose owners have no better idea.
+  static constexpr uint32_t kDefaultDepth = 3;
+
   /// Denotes a spot in the pipeline reserved for the producer to finish
   /// preparing a completed pipeline resource.
   class ProducerContinuation {
    public:
-    ProducerContinuation() : trace_id_(0) {}
+    ProducerContinuation() : pipeline_(nullptr), trace_id_(0) {}
 
     ProducerContinuation(ProducerContinuation&& other)
-        : continuation_(other.continuation_), trace_id_(other.trace_id_) {
-      other.continuation_ = nullptr;
+        : pipeline_(other.pipeline_), trace_id_(other.trace_id_) {
+      other.pipeline_ = nullptr;
       other.trace_id_ = 0;
     }
 
     ProducerContinuation& operator=(ProducerContinuation&& other) {
-      std::swap(continuation_, other.continuation_);
+      std::swap(pipeline_, other.pipeline_);
       std::swap(trace_id_, other.trace_id_);
       return *this;
     }
 
     ~ProducerContinuation() {
-      if (continuation_) {
-        continuation_(nullptr, trace_id_);
+      if (pipeline_) {
+        pipeline_->ProducerCommit(nullptr);
         TRACE_EVENT_ASYNC_END0("flutter", "PipelineProduce", trace_id_);
       }
     }
 
     void Complete(ResourcePtr resource) {
-      if (continuation_) {
-        continuation_(std::move(resource), trace_id_);
-        continuation_ = nullptr;
+      if (pipeline_) {
+        pipeline_->ProducerCommit(std::move(resource));
+        pipeline_ = nullptr;
         TRACE_EVENT_ASYNC_END0("flutter", "PipelineProduce", trace_id_);
       }
     }
 
-    operator bool() const { return continuation_ != nullptr; }
+    operator bool() const { return pipeline_ != nullptr; }
 
    private:
     friend class Pipeline;
-    using Continuation = std::function<void(ResourcePtr, size_t)>;
 
-    Continuation continuation_;
+    // Not a reference. The owner of the continuation is expected to keep the
+    // pipeline alive.
+    Pipeline* pipeline_;
     size_t trace_id_;
 
-    ProducerContinuation(Continuation continuation, size_t trace_id)
-        : continuation_(continuation), trace_id_(trace_id) {
+    ProducerContinuation(Pipeline* pipeline, size_t trace_id)
+        : pipeline_(pipeline), trace_id_(trace_id) {
       TRACE_EVENT_ASYNC_BEGIN0("flutter", "PipelineProduce", trace_id_);
     }
 
@@ -81,77 +94,178 @@ class Pipeline : public ftl::RefCountedThreadSafe<Pipeline<R>> {
   };
 
   explicit Pipeline(uint32_t depth)
-      : empty_(depth), available_(0), last_trace_id_(0) {}
+      : depth_(depth),
+        slots_(depth > 0 ? new ResourcePtr[depth] : nullptr),
+        reserved_(0),
+        last_trace_id_(0),
+        committed_(0),
+        consumed_(0),
+        last_consume_duration_(0) {}
 
   ~Pipeline() = default;
 
-  bool IsValid() const { return empty_.IsValid() && available_.IsValid(); }
+  bool IsValid() const { return depth_ > 0; }
+
+  uint32_t depth() const { return depth_; }
 
   ProducerContinuation Produce() {
-    if (!empty_.TryWait()) {
+    // Spots are freed up only once the consumer is done with a resource.
+    if (reserved_ - consumed_.value.load(std::memory_order_acquire) >=
+        depth_) {
       return {};
     }
 
-    return ProducerContinuation{
-        std::bind(&Pipeline::ProducerCommit, this, std::placeholders::_1,
-                  std::placeholders::_2),  // continuation
-        ++last_trace_id_};                 // trace id
+    reserved_++;
+
+    return ProducerContinuation{this, ++last_trace_id_};
   }
 
   using Consumer = std::function<void(ResourcePtr)>;
 
   FTL_WARN_UNUSED_RESULT
-  PipelineConsumeResult Consume(Consumer consumer) {
+  PipelineConsumeResult Consume(const Consumer& consumer) {
     if (consumer == nullptr) {
       return PipelineConsumeResult::NoneAvailable;
     }
 
-    if (!available_.TryWait()) {
+    return Consume<Consumer>(consumer);
+  }
+
+  /// Like the above but avoids wrapping |consumer| in a std::function.
+  template <class Callable>
+  FTL_WARN_UNUSED_RESULT PipelineConsumeResult
+  Consume(const Callable& consumer) {
+    const size_t consumed = consumed_.value.load(std::memory_order_relaxed);
+    const size_t committed =
+        committed_.value.load(std::memory_order_acquire);
+
+    if (consumed == committed) {
       return PipelineConsumeResult::NoneAvailable;
     }
 
-    ResourcePtr resource;
-    size_t trace_id = 0;
-    size_t items_count = 0;
+    InvokeConsumer(consumer, std::move(slots_[consumed % depth_]));
+
+    // Only now may the producer reuse the spot.
+    consumed_.value.store(consumed + 1, std::memory_order_release);
 
-    {
-      ftl::MutexLocker lock(&queue_mutex_);
-      std::tie(resource, trace_id) = std::move(queue_.front());
-      queue_.pop();
-      items_count = queue_.size();
+    return committed - consumed > 1 ? PipelineConsumeResult::MoreAvailable
+                                    : PipelineConsumeResult::Done;
+  }
+
+  /// Like |Consume| but hands only the most recently completed resource to
+  /// |consumer|. The older resources still waiting are destroyed unconsumed
+  /// and their number is stored in |dropped_count|, if given. Null resources,
+  /// committed by abandoned continuations, are never preferred over others
+  /// and never counted as dropped.
+  template <class Callable>
+  FTL_WARN_UNUSED_RESULT PipelineConsumeResult
+  ConsumeLatest(const Callable& consumer, size_t* dropped_count) {
+    const size_t consumed = consumed_.value.load(std::memory_order_relaxed);
+    const size_t committed =
+        committed_.value.load(std::memory_order_acquire);
+
+    if (consumed == committed) {
+      return PipelineConsumeResult::NoneAvailable;
+    }
+
+    ResourcePtr latest;
+    size_t dropped = 0;
+    for (size_t i = consumed; i < committed; i++) {
+      ResourcePtr resource = std::move(slots_[i % depth_]);
+      if (!resource) {
+        continue;
+      }
+      if (latest) {
+        dropped++;
+      }
+      latest = std::move(resource);
     }
 
-    {
-      TRACE_EVENT0("flutter", "PipelineConsume");
-      consumer(std::move(resource));
+    if (dropped_count) {
+      *dropped_count = dropped;
     }
 
-    empty_.Signal();
+    InvokeConsumer(consumer, std::move(latest));
 
-    return items_count > 0 ? PipelineConsumeResult::MoreAvailable
-                           : PipelineConsumeResult::Done;
+    consumed_.value.store(committed, std::memory_order_release);
+
+    return PipelineConsumeResult::Done;
+  }
+
+  /// The number of completed resources not yet consumed, including one the
+  /// consumer may be busy with. May be called from either thread but is only
+  /// a snapshot.
+  size_t pending_count() const {
+    return committed_.value.load(std::memory_order_acquire) -
+           consumed_.value.load(std::memory_order_acquire);
+  }
+
+  /// How long the consumer took for the most recently consumed resource. May
+  /// be called from either thread.
+  ftl::TimeDelta last_consume_duration() const {
+    return ftl::TimeDelta::FromNanoseconds(
+        last_consume_duration_.load(std::memory_order_relaxed));
   }
 
  private:
-  Semaphore empty_;
-  Semaphore available_;
-  ftl::Mutex queue_mutex_;
-  std::queue<std::pair<ResourcePtr, size_t>> queue_;
+  // Assumed size of a cache line. Counters written by different threads are
+  // kept this far apart so that they do not contend.
+  static constexpr size_t kCacheLineSize = 64;
+
+  // Padded rather than aligned since pipelines are allocated with the default
+  // operator new, which makes no promises about alignment beyond that of the
+  // fundamental types. Two consecutive counters still never share a line.
+  struct PaddedCounter {
+    std::atomic_size_t value;
+    char padding[kCacheLineSize - sizeof(std::atomic_size_t)];
+
+    explicit PaddedCounter(size_t initial) : value(initial) {}
+  };
+
+  const uint32_t depth_;
+  const std::unique_ptr<ResourcePtr[]> slots_;
+
+  // Written by the producer only. Counts spots handed out by Produce.
+  size_t reserved_;
   std::atomic_size_t last_trace_id_;
+  // Written by the producer only. Counts resources made available. Resources
+  // are placed in the order they are completed in, which need not be the
+  // order their spots were reserved in.
+  PaddedCounter committed_;
+  // Written by the consumer only. Counts resources the consumer is done with.
+  PaddedCounter consumed_;
+  // Written by the consumer only. In nanoseconds.
+  std::atomic<int64_t> last_consume_duration_;
+
+  template <class Callable>
+  void InvokeConsumer(const Callable& consumer, ResourcePtr resource) {
+    TRACE_EVENT0("flutter", "PipelineConsume");
+    const ftl::TimePoint start = ftl::TimePoint::Now();
+    consumer(std::move(resource));
+    last_consume_duration_.store(
+        (ftl::TimePoint::Now() - start).ToNanoseconds(),
+        std::memory_order_relaxed);
+  }
 
-  void ProducerCommit(ResourcePtr resource, size_t trace_id) {
-    {
-      ftl::MutexLocker lock(&queue_mutex_);
-      queue_.emplace(std::move(resource), trace_id);
-    }
+  void ProducerCommit(ResourcePtr resource) {
+    const size_t committed = committed_.value.load(std::memory_order_relaxed);
+
+    // The spot reserved for this resource guarantees that fewer than |depth_|
+    // resources are waiting for the consumer, so this slot is free.
+    FTL_DCHECK(committed - consumed_.value.load(std::memory_order_acquire) <
+               depth_);
 
-    // Ensure the queue mutex is not held as that would be a pessimization.
-    available_.Signal();
+    slots_[committed % depth_] = std::move(resource);
+
+    committed_.value.store(committed + 1, std::memory_order_release);
   }
 
   FTL_DISALLOW_COPY_AND_ASSIGN(Pipeline);
 };
 
+template <class R>
+constexpr uint32_t Pipeline<R>::kDefaultDepth;
+
 }  // namespace flutter
 
 #endif  // SYNCHRONIZATION_PIPELINE_H_
@@ -0,0 +1,154 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Hands a stream of resources from one thread to another through the
+// lock-free pipeline and through the semaphore and mutex based pipeline it
+// replaced. Both sides spin, yielding whenever the pipeline is full or empty,
+// so the pipeline itself is the only point of contention.
+
+#include <stdio.h>
+
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+#include "flutter/synchronization/pipeline.h"
+#include "flutter/synchronization/semaphore.h"
+#include "lib/ftl/time/time_delta.h"
+#include "lib/ftl/time/time_point.h"
+
+namespace {
+
+constexpr size_t kItems = 200000;
+
+struct Frame {
+  size_t number;
+};
+
+// The previous implementation, reduced to what the benchmark exercises.
+class LegacyPipeline {
+ public:
+  using ResourcePtr = std::unique_ptr<Frame>;
+  using Continuation = std::function<void(ResourcePtr, size_t)>;
+
+  explicit LegacyPipeline(uint32_t depth) : empty_(depth), available_(0) {}
+
+  Continuation Produce() {
+    if (!empty_.TryWait()) {
+      return nullptr;
+    }
+    return std::bind(&LegacyPipeline::ProducerCommit, this,
+                     std::placeholders::_1, std::placeholders::_2);
+  }
+
+  bool Consume(const std::function<void(ResourcePtr)>& consumer) {
+    if (!available_.TryWait()) {
+      return false;
+    }
+
+    ResourcePtr resource;
+    size_t trace_id = 0;
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      std::tie(resource, trace_id) = std::move(queue_.front());
+      queue_.pop();
+    }
+
+    consumer(std::move(resource));
+    empty_.Signal();
+    return true;
+  }
+
+ private:
+  flutter::Semaphore empty_;
+  flutter::Semaphore available_;
+  std::mutex queue_mutex_;
+  std::queue<std::pair<ResourcePtr, size_t>> queue_;
+
+  void ProducerCommit(ResourcePtr resource, size_t trace_id) {
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      queue_.emplace(std::move(resource), trace_id);
+    }
+    available_.Signal();
+  }
+};
+
+ftl::TimeDelta MeasureLegacy(uint32_t depth) {
+  LegacyPipeline pipeline(depth);
+  size_t consumed = 0;
+
+  const auto start = ftl::TimePoint::Now();
+  std::thread consumer([&pipeline, &consumed]() {
+    const std::function<void(std::unique_ptr<Frame>)> consume =
+        [&consumed](std::unique_ptr<Frame> frame) { consumed++; };
+    while (consumed < kItems) {
+      if (!pipeline.Consume(consume)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  for (size_t i = 0; i < kItems;) {
+    auto continuation = pipeline.Produce();
+    if (!continuation) {
+      std::this_thread::yield();
+      continue;
+    }
+    continuation(std::unique_ptr<Frame>(new Frame{i}), i);
+    i++;
+  }
+
+  consumer.join();
+  return ftl::TimePoint::Now() - start;
+}
+
+ftl::TimeDelta MeasureRing(uint32_t depth) {
+  auto pipeline = ftl::MakeRefCounted<flutter::Pipeline<Frame>>(depth);
+  size_t consumed = 0;
+
+  const auto start = ftl::TimePoint::Now();
+  std::thread consumer([&pipeline, &consumed]() {
+    auto consume = [&consumed](std::unique_ptr<Frame> frame) { consumed++; };
+    while (consumed < kItems) {
+      if (pipeline->Consume(consume) ==
+          flutter::PipelineConsumeResult::NoneAvailable) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  for (size_t i = 0; i < kItems;) {
+    auto continuation = pipeline->Produce();
+    if (!continuation) {
+      std::this_thread::yield();
+      continue;
+    }
+    continuation.Complete(std::unique_ptr<Frame>(new Frame{i}));
+    i++;
+  }
+
+  consumer.join();
+  return ftl::TimePoint::Now() - start;
+}
+
+double NanosecondsPerItem(ftl::TimeDelta delta) {
+  return static_cast<double>(delta.ToNanoseconds()) / kItems;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  printf("%zu items\n", kItems);
+  printf("%6s %16s %16s\n", "depth", "legacy (ns)", "ring (ns)");
+
+  for (uint32_t depth : {1, 2, 3, 8}) {
+    printf("%6u %16.1f %16.1f\n", depth,
+           NanosecondsPerItem(MeasureLegacy(depth)),
+           NanosecondsPerItem(MeasureRing(depth)));
+  }
+
+  return 0;
+}
@@ -0,0 +1,117 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <thread>
+
+#include "flutter/synchronization/pipeline.h"
+#include "gtest/gtest.h"
+
+using IntPipeline = flutter::Pipeline<int>;
+
+TEST(PipelineTest, SimpleValidity) {
+  auto pipeline = ftl::MakeRefCounted<IntPipeline>(3);
+  ASSERT_TRUE(pipeline->IsValid());
+  ASSERT_EQ(pipeline->depth(), 3u);
+}
+
+TEST(PipelineTest, ProduceIsLimitedByDepth) {
+  auto pipeline = ftl::MakeRefCounted<IntPipeline>(2);
+  auto first = pipeline->Produce();
+  auto second = pipeline->Produce();
+  ASSERT_TRUE(first);
+  ASSERT_TRUE(second);
+  ASSERT_FALSE(pipeline->Produce());
+
+  first.Complete(std::unique_ptr<int>(new int(1)));
+  // The spot is only freed up once the resource has been consumed.
+  ASSERT_FALSE(pipeline->Produce());
+
+  int value = 0;
+  auto result = pipeline->Consume(
+      [&value](std::unique_ptr<int> resource) { value = *resource; });
+  ASSERT_EQ(result, flutter::PipelineConsumeResult::Done);
+  ASSERT_EQ(value, 1);
+  ASSERT_TRUE(pipeline->Produce());
+}
+
+TEST(PipelineTest, ConsumeReportsMoreAvailable) {
+  auto pipeline = ftl::MakeRefCounted<IntPipeline>(3);
+  pipeline->Produce().Complete(std::unique_ptr<int>(new int(1)));
+  pipeline->Produce().Complete(std::unique_ptr<int>(new int(2)));
+
+  IntPipeline::Consumer consumer = [](std::unique_ptr<int> resource) {};
+  ASSERT_EQ(pipeline->Consume(consumer),
+            flutter::PipelineConsumeResult::MoreAvailable);
+  ASSERT_EQ(pipeline->Consume(consumer), flutter::PipelineConsumeResult::Done);
+  ASSERT_EQ(pipeline->Consume(consumer),
+            flutter::PipelineConsumeResult::NoneAvailable);
+}
+
+TEST(PipelineTest, DroppedContinuationCommitsNothing) {
+  auto pipeline = ftl::MakeRefCounted<IntPipeline>(1);
+  { auto continuation = pipeline->Produce(); }
+
+  bool got_null = false;
+  auto result = pipeline->Consume([&got_null](std::unique_ptr<int> resource) {
+    got_null = resource == nullptr;
+  });
+  ASSERT_EQ(result, flutter::PipelineConsumeResult::Done);
+  ASSERT_TRUE(got_null);
+}
+
+TEST(PipelineTest, HandsResourcesAcrossThreadsInOrder) {
+  const int kCount = 10000;
+  auto pipeline = ftl::MakeRefCounted<IntPipeline>(3);
+
+  std::thread producer([pipeline]() {
+    for (int i = 0; i < kCount;) {
+      auto continuation = pipeline->Produce();
+      if (!continuation) {
+        std::this_thread::yield();
+        continue;
+      }
+      continuation.Complete(std::unique_ptr<int>(new int(i++)));
+    }
+  });
+
+  int expected = 0;
+  bool in_order = true;
+  while (expected < kCount) {
+    auto result = pipeline->Consume([&](std::unique_ptr<int> resource) {
+      in_order = in_order && *resource == expected;
+      expected++;
+    });
+    if (result == flutter::PipelineConsumeResult::NoneAvailable) {
+      std::this_thread::yield();
+    }
+  }
+
+  producer.join();
+  ASSERT_TRUE(in_order);
+}
+
+TEST(PipelineTest, ConsumeLatestDropsOlderResources) {
+  auto pipeline = ftl::MakeRefCounted<IntPipeline>(4);
+  pipeline->Produce().Complete(std::unique_ptr<int>(new int(1)));
+  pipeline->Produce().Complete(std::unique_ptr<int>(new int(2)));
+  pipeline->Produce().Complete(std::unique_ptr<int>(new int(3)));
+  // Abandoned continuations commit null resources, which are skipped.
+  { auto continuation = pipeline->Produce(); }
+  ASSERT_EQ(pipeline->pending_count(), 4u);
+
+  int value = 0;
+  size_t dropped = 0;
+  auto result = pipeline->ConsumeLatest(
+      [&value](std::unique_ptr<int> resource) { value = *resource; },
+      &dropped);
+  ASSERT_EQ(result, flutter::PipelineConsumeResult::Done);
+  ASSERT_EQ(value, 3);
+  ASSERT_EQ(dropped, 2u);
+  ASSERT_EQ(pipeline->pending_count(), 0u);
+
+  // All spots are available again.
+  for (size_t i = 0; i < 4; i++) {
+    ASSERT_TRUE(pipeline->Produce());
+  }
+}